@@ -101,6 +101,7 @@ static Int traced_absmi(void) { return Yap_traced_absmi(); }
 #endif
 
 void **Yap_ABSMI_OPCODES;
+void **Yap_ABSMI_SUPERS;
 
 #ifdef PUSH_X
 #else
@@ -188,7 +189,7 @@ static Term push_live_regs(yamop *pco) {
 }
 #endif
 
-#if USE_THREADED_CODE && (defined(ANALYST) || defined(DEBUG))
+#if defined(ANALYST) || (USE_THREADED_CODE && defined(DEBUG))
 
 char *Yap_op_names[] = {
 #define OPCODE(OP, TYPE) #OP
@@ -1245,6 +1246,15 @@ Int Yap_absmi(int inp) {
 #undef OPCODE
   };
 
+  /* superinstructions, in the order of supers.h */
+  static void *SuperAddress[] = {
+#define SUPER2(S, A, B, TA) &&_##S,
+#define SUPER3(S, A, B, C, TA, TB) &&_##S,
+#include "supers.h"
+#undef SUPER2
+#undef SUPER3
+      NULL};
+
 #if YAP_JIT
   ExpEnv.config_struc.TOTAL_OF_OPCODES =
       sizeof(OpAddress) / (2 * sizeof(void *));
@@ -1302,6 +1312,7 @@ Int Yap_absmi(int inp) {
   /* absmadr */
   if (inp > 0) {
     Yap_ABSMI_OPCODES = OpAddress;
+    Yap_ABSMI_SUPERS = SuperAddress;
 #if YAP_JIT
     Yap_ABSMI_ControlLabels = control_labels;
 #endif
@@ -1363,7 +1374,7 @@ reset_absmi:
 
   {
     op_numbers opcode = _Ystop;
-    op_numbers old_op;
+    op_numbers old_op = _Ystop, older_op;
 #ifdef DEBUG_XX
     unsigned long ops_done;
 #endif
@@ -1372,20 +1383,23 @@ reset_absmi:
 
   nextop_write:
 
+    older_op = old_op;
     old_op = opcode;
     opcode = PREG->y_u.o.opcw;
     goto op_switch;
 
   nextop:
 
+    older_op = old_op;
     old_op = opcode;
     opcode = PREG->opc;
 
   op_switch:
 
 #ifdef ANALYST
-    GLOBAL_opcount[opcode]++;
-    GLOBAL_2opcount[old_op][opcode]++;
+    LOCAL_opcount[opcode]++;
+    LOCAL_opcount2[old_op * (_std_top + 1) + opcode]++;
+    Yap_CountOpTriple(older_op, old_op, opcode);
 #ifdef DEBUG_XX
     ops_done++;
 /*    if (B->cp_b > 0x103fff90)
@@ -1435,6 +1449,15 @@ notrailleft:
 // move instructions to separate file
 // so that they are easier to analyse.
 #include "absmi_insts.h"
+// instructions added after the opcode table was laid out: they come
+// last in the table, so that the older ones keep their numbers
+#include "native_absmi_insts.h"
+
+#if USE_THREADED_CODE
+// sequences of instructions run without dispatching between them,
+// generated by misc/buildsupers
+#include "super_absmi_insts.h"
+#endif
 
 #if !USE_THREADED_CODE
 default:
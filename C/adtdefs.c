@@ -215,7 +215,7 @@ LookupAtom(const unsigned char *atom) { /* lookup atom in atom table */
     sz =   strlen((const char *)atom);
   }
   size_t asz = (sizeof *ae) + ( sz+1);
-  ae = malloc(asz);
+  ae = (AtomEntry *)Yap_AllocAtomSpace(asz);
   if (ae == NULL) {
     WRITE_UNLOCK(HashChain[hash].AERWLock);
     return NIL;
@@ -759,7 +759,8 @@ Atom Yap_LookupAtomWithLength(const char *atom,
       return NIL;
     }
     INIT_LOCK(p->PELock);
-    p->StatisticsForPred = NULL : p->KindOfPE = PEProp;
+    p->StatisticsForPred = NULL;
+    p->KindOfPE = PEProp;
     p->ArityOfPE = ap->ArityOfPE;
     p->cs.p_code.FirstClause = p->cs.p_code.LastClause = NULL;
     p->cs.p_code.NOfClauses = 0;
@@ -827,7 +828,6 @@ Atom Yap_LookupAtomWithLength(const char *atom,
       p->ModuleOfPred = 0;
     else
       p->ModuleOfPred = cur_mod;
-    Yap_NewModulePred(cur_mod, p);
     p->TimeStampOfPred = 0L;
     p->LastCallOfPred = LUCALL_ASSERT;
 #ifdef TABLING
@@ -843,9 +843,11 @@ Atom Yap_LookupAtomWithLength(const char *atom,
     if (!trueGlobalPrologFlag(DEBUG_INFO_FLAG)) {
       p->PredFlags |= (NoTracePredFlag | NoSpyPredFlag);
     }
+    WRITE_UNLOCK(ae->ARWLock);
+    /* the module may be named by this very atom, and looking it up locks it */
+    Yap_NewModulePred(cur_mod, p);
     if (Yap_isSystemModule(CurrentModule))
       p->PredFlags |= StandardPredFlag;
-    WRITE_UNLOCK(ae->ARWLock);
     {
       Yap_inform_profiler_of_clause(&(p->OpcodeOfPred), &(p->OpcodeOfPred) + 1, p,
 				    GPROF_NEW_PRED_ATOM);
@@ -1136,6 +1138,25 @@ Atom Yap_LookupAtomWithLength(const char *atom,
     return true;
   }
 
+  /* fe was allocated with Yap_AllocAtomSpace(); if the atom got a
+     format meanwhile, fe is released and that one is returned */
+  FormatEntry *Yap_PutAtomFormat(Atom a, FormatEntry *fe) {
+    AtomEntry *ae = RepAtom(a);
+    Prop p0;
+
+    WRITE_LOCK(ae->ARWLock);
+    p0 = GetAPropHavingLock(ae, FormatProperty);
+    if (p0 == NIL) {
+      fe->KindOfPE = FormatProperty;
+      AddPropToAtom(RepAtom(a), (PropEntry *)fe);
+    } else {
+      Yap_FreeAtomSpace((char *)fe);
+      fe = RepFormatProp(p0);
+    }
+    WRITE_UNLOCK(ae->ARWLock);
+    return fe;
+  }
+
   Term Yap_ArrayToList(register Term *tp, size_t nof) {
     CACHE_REGS
       register Term *pt = tp + nof;
@@ -1268,6 +1289,7 @@ Atom Yap_LookupAtomWithLength(const char *atom,
   }
 
   const char *IndicatorOfPred(PredEntry *pe) {
+    CACHE_REGS
     const char *mods;
     Atom at;
     arity_t arity;
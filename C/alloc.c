@@ -78,6 +78,7 @@ static char SccsId[] = "%W% %G%";
 int write_malloc = 0;
 
 void *my_malloc(size_t sz) {
+  CACHE_REGS
   void *p;
 
   p = malloc(sz);
@@ -106,6 +107,7 @@ void *my_realloc(void *ptr, size_t sz) {
 }
 
 void my_free(void *p) {
+  CACHE_REGS
   // printf("f %p\n",p);
   if (Yap_do_low_level_trace)
     fprintf(stderr, "- %p\n @%p %ld\n", p, TR, (long int)(LCL0 - (CELL *)B) );
@@ -280,6 +282,40 @@ void Yap_FreeAtomSpace(void *p) {
 
 #endif
 
+/* how much we take at a time for counters */
+#define COUNTER_CHUNK (16 * 1024)
+
+/*
+ * Space for counters that running code updates, such as profile data.
+ * They come from page aligned chunks of their own, and are never freed:
+ * otherwise, every call would write to pages shared with code, and
+ * these pages could no longer be shared after a fork().
+ */
+void *Yap_AllocCounterSpace(size_t size) {
+  char *out;
+
+  size = AdjustSize(size);
+  if (size > COUNTER_CHUNK)
+    return Yap_AllocCodeSpace(size);
+  LOCK(GLOBAL_CounterSpaceLock);
+  if (GLOBAL_CounterSpaceLeft < size) {
+    char *chunk = Yap_AllocCodeSpace(COUNTER_CHUNK + Yap_page_size);
+
+    if (!chunk) {
+      UNLOCK(GLOBAL_CounterSpaceLock);
+      return NULL;
+    }
+    GLOBAL_CounterSpace =
+        (char *)(((CELL)chunk + Yap_page_size - 1) & ~(Yap_page_size - 1));
+    GLOBAL_CounterSpaceLeft = COUNTER_CHUNK;
+  }
+  out = GLOBAL_CounterSpace;
+  GLOBAL_CounterSpace += size;
+  GLOBAL_CounterSpaceLeft -= size;
+  UNLOCK(GLOBAL_CounterSpaceLock);
+  return out;
+}
+
 /* If you need to dinamically allocate space from the heap, this is
  * the macro you should use */
 ADDR Yap_InitPreAllocCodeSpace(int wid) {
@@ -502,6 +538,9 @@ UInt Yap_givemallinfo(void) {
 #include <stdlib.h>
 #endif
 
+/* where we write the messages LOCAL_ErrorMessage points to */
+static char alloc_error_say[MAX_ERROR_MSG_SIZE];
+
 #if !USE_DL_MALLOC
 
 static void FreeBlock(BlockHeader *);
@@ -856,7 +895,7 @@ static int ExtendWorkSpace(Int s, int fixed_allocation) {
   }
   b = VirtualAlloc(b, s, MEM_COMMIT, PAGE_READWRITE);
   if (!b) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "VirtualAlloc could not commit %ld bytes", (long int)s);
     LOCAL_PrologMode = OldPrologMode;
@@ -1049,7 +1088,7 @@ static MALLOC_T mmap_extension(Int s, MALLOC_T base, int fixed_allocation) {
     char file[256];
     strncpy(file, "/tmp/YAP.TMPXXXXXX", 256);
     if (mkstemp(file) == -1) {
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
 #if HAVE_STRERROR
       snprintf5(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mkstemp could not create temporary file %s (%s)", file,
@@ -1071,27 +1110,27 @@ static MALLOC_T mmap_extension(Int s, MALLOC_T base, int fixed_allocation) {
 #endif /* HAVE_MKSTEMP */
     fd = open(file, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
     if (fd < 0) {
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
       snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mmap could not open %s", file);
       return (MALLOC_T)-1;
     }
     if (lseek(fd, s, SEEK_SET) < 0) {
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
       snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mmap could not lseek in mmapped file %s", file);
       close(fd);
       return (MALLOC_T)-1;
     }
     if (write(fd, "", 1) < 0) {
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
       snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mmap could not write in mmapped file %s", file);
       close(fd);
       return (MALLOC_T)-1;
     }
     if (unlink(file) < 0) {
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
       snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mmap could not unlink mmapped file %s", file);
       close(fd);
@@ -1108,7 +1147,7 @@ static MALLOC_T mmap_extension(Int s, MALLOC_T base, int fixed_allocation) {
       ,
       fd, 0);
   if (close(fd) == -1) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
 #if HAVE_STRERROR
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "mmap could not close file (%s) ]\n", strerror(errno));
@@ -1148,7 +1187,7 @@ static int ExtendWorkSpace(Int s, int fixed_allocation) {
   a = mmap_extension(s, base, fixed_allocation);
   LOCAL_PrologMode = OldPrologMode;
   if (a == (MALLOC_T)-1) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
 #if HAVE_STRERROR
     snprintf5(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not allocate %d bytes (%s)", (int)s, strerror(errno));
@@ -1161,7 +1200,7 @@ static int ExtendWorkSpace(Int s, int fixed_allocation) {
   if (fixed_allocation) {
     if (a != WorkSpaceTop) {
       munmap((void *)a, (size_t)s);
-      LOCAL_ErrorMessage = LOCAL_ErrorSay;
+      LOCAL_ErrorMessage = alloc_error_say;
       snprintf5(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
                 "mmap could not grow memory at %p, got %p", WorkSpaceTop, a);
       LOCAL_PrologMode = OldPrologMode;
@@ -1224,21 +1263,21 @@ static int ExtendWorkSpace(Int s) {
   LOCAL_PrologMode = ExtendStackMode;
   /* mapping heap area */
   if ((shm_id = shmget(IPC_PRIVATE, (size_t)s, SHM_R | SHM_W)) == -1) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not shmget %d bytes", s);
     LOCAL_PrologMode = OldPrologMode;
     return (FALSE);
   }
   if ((ptr = (MALLOC_T)shmat(shm_id, WorkSpaceTop, 0)) == (MALLOC_T)-1) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE, "could not shmat at %p",
               MMAP_ADDR);
     LOCAL_PrologMode = OldPrologMode;
     return (FALSE);
   }
   if (shmctl(shm_id, IPC_RMID, 0) != 0) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not remove shm segment", shm_id);
     LOCAL_PrologMode = OldPrologMode;
@@ -1290,7 +1329,7 @@ static int ExtendWorkSpace(Int s) {
 
   LOCAL_PrologMode = ExtendStackMode;
   if (ptr == ((MALLOC_T)-1)) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not expand stacks over %d bytes", s);
     LOCAL_PrologMode = OldPrologMode;
@@ -1405,14 +1444,14 @@ static int ExtendWorkSpace(Int s) {
     return TRUE;
   ptr = (MALLOC_T)realloc((void *)Yap_HeapBase, total_space);
   if (ptr == NULL) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not allocate %d bytes", s);
     LOCAL_PrologMode = OldPrologMode;
     return FALSE;
   }
   if (ptr != (MALLOC_T)Yap_HeapBase) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf4(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "could not expand contiguous stacks  %d bytes", s);
     LOCAL_PrologMode = OldPrologMode;
@@ -1420,7 +1459,7 @@ static int ExtendWorkSpace(Int s) {
   }
 #if MBIT
   if ((CELL)ptr & MBIT) {
-    LOCAL_ErrorMessage = LOCAL_ErrorSay;
+    LOCAL_ErrorMessage = alloc_error_say;
     snprintf5(LOCAL_ErrorMessage, MAX_ERROR_MSG_SIZE,
               "memory at %p conflicts with MBIT %lx", ptr, (unsigned long)MBIT);
     LOCAL_PrologMode = OldPrologMode;
@@ -1517,7 +1556,9 @@ void Yap_InitMemory(UInt Trail, UInt Heap, UInt Stack) {
 #endif /* DEBUG */
 }
 
-void Yap_InitExStacks(int wid, int Trail, int Stack) {
+size_t Yap_HeapUsed(void) { return HeapUsed; }
+
+void Yap_InitExStacks(int wid, size_t Trail, size_t Stack) {
 #if USE_DL_MALLOC
   REMOTE_ScratchPad(wid).ptr = NULL;
   REMOTE_ScratchPad(wid).sz = REMOTE_ScratchPad(wid).msz = SCRATCH_START_SIZE;
@@ -302,8 +302,8 @@ profile_data *Yap_initProfiler(PredEntry *p) {
   profile_data *ptr;
   if (p->StatisticsForPred)
     return p->StatisticsForPred;
-  if ((ptr = (profile_data *)Yap_AllocCodeSpace(sizeof(profile_data))) ==
-      NULL) {
+  if ((ptr = (profile_data *)Yap_AllocCounterSpace(
+           sizeof(profile_data))) == NULL) {
     return NULL;
   }
   INIT_LOCK(ptr->lock);
@@ -423,6 +423,69 @@ static OPCODE opcode(op_numbers op) { return (emit_op(op)); }
 OPCODE
 Yap_opcode(op_numbers op) { return opcode(op); }
 
+#if USE_THREADED_CODE
+/* superinstructions, as listed in supers.h: the instructions they
+   stand for and the size of all but the last one */
+static struct super_entry {
+  op_numbers ops[3];
+  CELL sizes[2];
+} supers[] = {
+#define SUPER2(S, A, B, TA)                                                    \
+  {{_##A, _##B, _Ystop}, {(CELL)NEXTOP((yamop *)NULL, TA), 0}},
+#define SUPER3(S, A, B, C, TA, TB)                                             \
+  {{_##A, _##B, _##C},                                                         \
+   {(CELL)NEXTOP((yamop *)NULL, TA), (CELL)NEXTOP((yamop *)NULL, TB)}},
+#include "supers.h"
+#undef SUPER2
+#undef SUPER3
+    {{_Ystop, _Ystop, _Ystop}, {0, 0}}};
+
+/* the last instructions we emitted, most recent last */
+typedef struct super_history {
+  yamop *pc[2];
+  op_numbers op[2];
+} super_history;
+
+static int find_super(op_numbers o0, op_numbers o1, op_numbers o2) {
+  int k;
+
+  for (k = 0; supers[k].ops[0] != _Ystop; k++) {
+    if (supers[k].ops[0] == o0 && supers[k].ops[1] == o1 &&
+        supers[k].ops[2] == o2)
+      return k;
+  }
+  return -1;
+}
+
+/* we have just emitted an instruction at pc: if it closes a sequence
+   we have a superinstruction for, make the first instruction in the
+   sequence run the whole of it. Only the opcode of that instruction
+   changes, so whoever jumps into the middle of the sequence or walks
+   the code still finds the original instructions. */
+static void fuse_super(super_history *h, yamop *pc) {
+  op_numbers op = Yap_op_from_opcode(pc->opc);
+  int k;
+
+  if (op == _Nstop) {
+    h->pc[0] = h->pc[1] = NULL;
+    return;
+  }
+  if (h->pc[0] && (k = find_super(h->op[0], h->op[1], op)) >= 0 &&
+      (CELL)h->pc[1] - (CELL)h->pc[0] == supers[k].sizes[0] &&
+      (CELL)pc - (CELL)h->pc[1] == supers[k].sizes[1]) {
+    h->pc[0]->opc = (OPCODE)Yap_ABSMI_SUPERS[k];
+  }
+  if (h->pc[1] && (k = find_super(h->op[1], op, _Ystop)) >= 0 &&
+      (CELL)pc - (CELL)h->pc[1] == supers[k].sizes[0]) {
+    h->pc[1]->opc = (OPCODE)Yap_ABSMI_SUPERS[k];
+  }
+  h->pc[0] = h->pc[1];
+  h->op[0] = h->op[1];
+  h->pc[1] = pc;
+  h->op[1] = op;
+}
+#endif
+
 static void add_clref(CELL clause_code, int pass_no) {
   if (pass_no) {
     LogUpdClause *cl = ClauseCodeToLogUpdClause(clause_code);
@@ -2858,6 +2921,10 @@ static yamop *do_pass(int pass_no, yamop **entry_codep, int assembling,
   cmp_op_info cmp_info;
   clause_info clinfo;
   int do_not_optimise_uatom;
+#if USE_THREADED_CODE
+  super_history supers_seen;
+  bool fuse;
+#endif
 
   code_p = cip->code_addr;
   cl_u = (union clause_obj *)code_p;
@@ -2878,6 +2945,14 @@ static yamop *do_pass(int pass_no, yamop **entry_codep, int assembling,
   log_update = cip->CurrentPred->PredFlags & LogUpdatePredFlag;
   dynamic = cip->CurrentPred->PredFlags & DynamicPredFlag;
   tabled = cip->CurrentPred->PredFlags & TabledPredFlag;
+#if USE_THREADED_CODE
+  /* clauses that may be updated in place keep their instructions, and
+     so does everyone unless the superinstructions flag is on */
+  fuse = pass_no == 1 && assembling == ASSEMBLING_CLAUSE && !log_update &&
+         !dynamic && !tabled && supers[0].ops[0] != _Ystop &&
+         trueGlobalPrologFlag(SUPERINSTRUCTIONS_FLAG);
+  supers_seen.pc[0] = supers_seen.pc[1] = NULL;
+#endif
   if (assembling == ASSEMBLING_CLAUSE) {
     if (log_update) {
       if (pass_no) {
@@ -3009,6 +3084,9 @@ static yamop *do_pass(int pass_no, yamop **entry_codep, int assembling,
     }
   }
   while (cip->cpc) {
+#if USE_THREADED_CODE
+    yamop *inst_start = code_p;
+#endif
     switch ((int)cip->cpc->op) {
 #ifdef YAPOR
     case sync_op:
@@ -3671,6 +3749,17 @@ static yamop *do_pass(int pass_no, yamop **entry_codep, int assembling,
       save_machine_regs();
       siglongjmp(cip->CompilerBotch, 1);
     }
+#if USE_THREADED_CODE
+    if (fuse) {
+      if (cip->cpc->op == blob_op || cip->cpc->op == string_op ||
+          cip->cpc->op == align_float_op) {
+        /* data, not code */
+        supers_seen.pc[0] = supers_seen.pc[1] = NULL;
+      } else if (code_p != inst_start) {
+        fuse_super(&supers_seen, inst_start);
+      }
+    }
+#endif
     cip->cpc = cip->cpc->nextInst;
   }
   if (!ystop_found)
@@ -3874,6 +3963,202 @@ yamop *Yap_assemble(int mode, Term t, PredEntry *ap, int is_fact,
   return entry_code;
 }
 
+/*
+ * Ground facts for logical update predicates, what assert spends most
+ * of its time on, do not need the compiler: we emit the code for the
+ * head straight from the term, in a pass to find the size and a pass
+ * to write it. The code is the same the compiler would give, but for
+ * the optimisations that merge instructions.
+ */
+
+/* how deep we recurse, and how many cells we look at, before leaving
+   the fact to the compiler */
+#define FACT_MAX_DEPTH 128
+#define FACT_MAX_CELLS (64 * 1024)
+
+static bool simple_fact_arg(Term t, int depth, UInt *cells) {
+  if (depth > FACT_MAX_DEPTH)
+    return false;
+  while (true) {
+    t = Deref(t);
+    if (++*cells > FACT_MAX_CELLS || IsVarTerm(t))
+      return false;
+    if (IsAtomOrIntTerm(t)) {
+      return true;
+    } else if (IsPairTerm(t)) {
+      if (!simple_fact_arg(HeadOfTerm(t), depth + 1, cells))
+        return false;
+      t = TailOfTerm(t);
+    } else {
+      Functor f = FunctorOfTerm(t);
+      arity_t i, n;
+
+      /* numbers and strings go to blobs, leave them to the compiler */
+      if (IsExtensionFunctor(f))
+        return false;
+      n = ArityOfFunctor(f);
+      for (i = 1; i < n; i++) {
+        if (!simple_fact_arg(ArgOfTerm(i, t), depth + 1, cells))
+          return false;
+      }
+      t = ArgOfTerm(n, t);
+    }
+  }
+}
+
+static yamop *fact_unify(Term t, bool last, yamop *code_p, int pass_no) {
+  bool pop = !last && !IsAtomOrIntTerm(Deref(t));
+
+  while (true) {
+    t = Deref(t);
+    if (IsAtomOrIntTerm(t)) {
+      if (last)
+        code_p = a_uc(t, _unify_l_atom, _unify_l_atom_write, code_p, pass_no);
+      else
+        code_p = a_uc(t, _unify_atom, _unify_atom_write, code_p, pass_no);
+      break;
+    } else if (IsPairTerm(t)) {
+      if (last)
+        code_p = a_ue(_unify_l_list, _unify_l_list_write, code_p, pass_no);
+      else
+        code_p = a_ue(_unify_list, _unify_list_write, code_p, pass_no);
+      code_p = fact_unify(HeadOfTerm(t), false, code_p, pass_no);
+      t = TailOfTerm(t);
+    } else {
+      Functor f = FunctorOfTerm(t);
+      arity_t i, n = ArityOfFunctor(f);
+
+      if (last)
+        code_p = a_uf((CELL)f, _unify_l_struc, _unify_l_struc_write, code_p,
+                      pass_no);
+      else
+        code_p = a_uf((CELL)f, _unify_struct, _unify_struct_write, code_p,
+                      pass_no);
+      for (i = 1; i < n; i++)
+        code_p = fact_unify(ArgOfTerm(i, t), false, code_p, pass_no);
+      t = ArgOfTerm(n, t);
+    }
+    last = true;
+  }
+  if (pop)
+    code_p = a_e(_pop, code_p, pass_no);
+  return code_p;
+}
+
+static yamop *fact_code(PredEntry *ap, Term head, LogUpdClause *cl,
+                        int pass_no) {
+  yamop *code_p = cl->ClCode, *entry = code_p;
+  arity_t i, arity = ap->ArityOfPE;
+
+#if THREADS || YAPOR
+  code_p = a_e(_unlock_lu, code_p, pass_no);
+#endif
+  for (i = 1; i <= arity; i++) {
+    Term t = Deref(ArgOfTerm(i, head));
+
+    if (IsAtomOrIntTerm(t)) {
+      if (pass_no) {
+        code_p->opc = emit_op(_get_atom);
+        code_p->y_u.xc.x = emit_x(i);
+        code_p->y_u.xc.c = emit_c(t);
+      }
+      GONEXT(xc);
+    } else if (IsPairTerm(t)) {
+      code_p = a_r(i, _get_list, code_p, pass_no);
+      code_p = fact_unify(HeadOfTerm(t), false, code_p, pass_no);
+      code_p = fact_unify(TailOfTerm(t), true, code_p, pass_no);
+    } else {
+      Functor f = FunctorOfTerm(t);
+      arity_t j, n = ArityOfFunctor(f);
+
+      if (pass_no) {
+        code_p->opc = emit_op(_get_struct);
+        code_p->y_u.xfa.x = emit_x(i);
+        code_p->y_u.xfa.f = f;
+        code_p->y_u.xfa.a = n;
+      }
+      GONEXT(xfa);
+      for (j = 1; j <= n; j++)
+        code_p = fact_unify(ArgOfTerm(j, t), j == n, code_p, pass_no);
+    }
+  }
+  code_p = a_pl(_procceed, ap, code_p, pass_no);
+  if (pass_no) {
+    code_p->opc = emit_op(_Ystop);
+    code_p->y_u.l.l = entry;
+  }
+  GONEXT(l);
+  return code_p;
+}
+
+/**
+ * Assemble the ground fact t for its predicate, if the predicate is a
+ * logical update predicate and t only holds atoms, small integers,
+ * lists and compound terms. Otherwise, or if there is no space, return
+ * NULL and let the compiler do the work.
+ */
+yamop *Yap_assemble_fact(Term t, Term mod) {
+  Term head = t;
+  PredEntry *ap;
+  LogUpdClause *cl;
+  UInt size, cells = 0;
+  arity_t i;
+
+  if (IsApplTerm(t) && FunctorOfTerm(t) == FunctorAssert) {
+    if (Deref(ArgOfTerm(2, t)) != MkAtomTerm(AtomTrue))
+      return NULL;
+    head = Deref(ArgOfTerm(1, t));
+  }
+  if (IsVarTerm(head) || IsPairTerm(head) || IsAtomTerm(head) ||
+      IsNumTerm(head) || IsVarTerm(mod) || !IsAtomTerm(mod))
+    return NULL;
+  if (IsExtensionFunctor(FunctorOfTerm(head)) ||
+      FunctorOfTerm(head) == FunctorModule)
+    return NULL;
+  for (i = 1; i <= ArityOfFunctor(FunctorOfTerm(head)); i++) {
+    if (!simple_fact_arg(ArgOfTerm(i, head), 0, &cells))
+      return NULL;
+  }
+  if (PROFILING || CALL_COUNTING)
+    return NULL;
+  ap = RepPredProp(PredPropByFunc(FunctorOfTerm(head), mod));
+  PELOCK(87, ap);
+  if ((ap->PredFlags & (LogUpdatePredFlag | TabledPredFlag |
+                        ProfiledPredFlag | CountPredFlag)) !=
+      LogUpdatePredFlag) {
+    UNLOCKPE(87, ap);
+    return NULL;
+  }
+  size = (UInt)fact_code(ap, head, NULL, 0);
+  if (!(cl = (LogUpdClause *)Yap_AllocCodeSpace(size))) {
+    UNLOCKPE(87, ap);
+    return NULL;
+  }
+  Yap_inform_profiler_of_clause(cl, (char *)cl + size, ap, GPROF_CLAUSE);
+  Yap_LUClauseSpace += size;
+  cl->Id = FunctorDBRef;
+  cl->ClFlags = LogUpdMask;
+  cl->ClSize = size;
+  cl->ClRefCount = 0;
+  cl->ClPred = ap;
+  if (ap->LastCallOfPred != LUCALL_ASSERT) {
+    if (ap->TimeStampOfPred >= TIMESTAMP_RESET)
+      Yap_UpdateTimestamps(ap);
+    ++ap->TimeStampOfPred;
+    ap->LastCallOfPred = LUCALL_ASSERT;
+  }
+  cl->ClTimeStart = ap->TimeStampOfPred;
+  cl->ClTimeEnd = TIMESTAMP_EOT;
+  cl->ClExt = NULL;
+  cl->ClPrev = cl->ClNext = NULL;
+#if MULTIPLE_STACKS
+  INIT_CLREF_COUNT(cl);
+#endif
+  fact_code(ap, head, cl, 1);
+  UNLOCKPE(87, ap);
+  return cl->ClCode;
+}
+
 void Yap_InitComma(void) {
   yamop *code_p = COMMA_CODE;
   code_p->opc = opcode(_call);
@@ -24,6 +24,7 @@ static char SccsId[] = "%W% %G%";
 #ifdef ANALYST
 #include "Yatom.h"
 #include "yapio.h"
+#include "iopreds.h"
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
@@ -35,25 +36,66 @@ static Int p_reset_op_counters(void);
 static Int p_show_op_counters(void);
 static Int p_show_ops_by_group(void);
 
+/* triples of instructions are kept in an open hash table of
+   OPCOUNT3_SIZE entries, each a key and a counter. The key packs the
+   three op numbers, plus one so that zero marks a free entry. */
+#define OPCOUNT3_SIZE (1 << 16)
+#define OPCOUNT3_KEY(a, b, c)                                                  \
+  ((((YAP_ULONG_LONG)(a) << 20) | ((YAP_ULONG_LONG)(b) << 10) | (c)) + 1)
+
+void
+Yap_CountOpTriple(op_numbers a, op_numbers b, op_numbers c)
+{
+  CACHE_REGS
+  YAP_ULONG_LONG key = OPCOUNT3_KEY(a, b, c), *t = LOCAL_opcount3;
+  UInt i, n;
+
+  if (t == NULL) {
+    if ((t = calloc(2 * OPCOUNT3_SIZE, sizeof(YAP_ULONG_LONG))) == NULL)
+      return;
+    LOCAL_opcount3 = t;
+  }
+  i = (UInt)((key * 0x9E3779B97F4A7C15ULL) >> 40) & (OPCOUNT3_SIZE - 1);
+  /* give up on new triples once the table is three quarters full */
+  for (n = 0; n < OPCOUNT3_SIZE / 4 * 3; n++) {
+    if (t[2 * i] == key) {
+      t[2 * i + 1]++;
+      return;
+    }
+    if (t[2 * i] == 0) {
+      t[2 * i] = key;
+      t[2 * i + 1] = 1;
+      return;
+    }
+    i = (i + 1) & (OPCOUNT3_SIZE - 1);
+  }
+}
+
 static Int 
 p_reset_op_counters()
 {
+  CACHE_REGS
   int i;
 
   for (i = 0; i <= _std_top; ++i)
-    GLOBAL_opcount[i] = 0;
+    LOCAL_opcount[i] = 0;
+  memset(LOCAL_opcount2, 0, sizeof(LOCAL_opcount2));
+  if (LOCAL_opcount3)
+    memset(LOCAL_opcount3, 0,
+           2 * OPCOUNT3_SIZE * sizeof(YAP_ULONG_LONG));
   return TRUE;
 }
 
 static void 
 print_instruction(int inst)
 {
+  CACHE_REGS
   int j;
 
   fprintf(GLOBAL_stderr, "%s", Yap_op_names[inst]);
   for (j = strlen(Yap_op_names[inst]); j < 25; j++)
     putc(' ', GLOBAL_stderr);
-  j = GLOBAL_opcount[inst];
+  j = LOCAL_opcount[inst];
   if (j < 100000000) {
     putc(' ', GLOBAL_stderr);
     if (j < 10000000) {
@@ -78,12 +120,13 @@ print_instruction(int inst)
       }
     }
   }
-  fprintf(GLOBAL_stderr, "%llu\n", GLOBAL_opcount[inst]);
+  fprintf(GLOBAL_stderr, "%llu\n", LOCAL_opcount[inst]);
 }
 
 static Int 
 p_show_op_counters()
 {
+  CACHE_REGS
   int i;
   Term t1 = Deref(ARG1);
 
@@ -92,17 +135,7 @@ p_show_op_counters()
   } else {
     Atom at1 = AtomOfTerm(t1);
 
-    if (IsWideAtom(at1)) {
-      wchar_t *program;
-
-      program = RepAtom(at1)->WStrOfAE;
-      fprintf(GLOBAL_stderr, "\n Instructions Executed in %S\n", program);
-    } else {
-      char *program;
-
-      program = RepAtom(at1)->StrOfAE;
-      fprintf(GLOBAL_stderr, "\n Instructions Executed in %s\n", program);
-    }
+    fprintf(GLOBAL_stderr, "\n Instructions Executed in %s\n", RepAtom(at1)->StrOfAE);
   }
 
   for (i = 0; i <= _std_top; ++i)
@@ -303,6 +336,7 @@ typedef struct {
 static Int 
 p_show_ops_by_group(void)
 {
+  CACHE_REGS
 
   uGLOBAL_opcount c_get, c_unify, c_put, c_write;
   cGLOBAL_opcount c_control;
@@ -311,270 +345,258 @@ p_show_ops_by_group(void)
     total;
   Term t1;
   Atom at1;
+  const char *program;
 
   t1 = Deref(ARG1);
   if (IsVarTerm(t1) || !IsAtomTerm(t1))
     return (FALSE);
   at1 = AtomOfTerm(t1);
-  if (IsWideAtom(at1)) {
-    wchar_t *program;
-
-    program = RepAtom(at1)->WStrOfAE;
-    fprintf(GLOBAL_stderr, "\n Instructions Executed in %S\n", program);
-  } else {
-    char *program;
-
-    program = RepAtom(at1)->StrOfAE;
-    fprintf(GLOBAL_stderr, "\n Instructions Executed in %s\n", program);
-  }
+  program = RepAtom(at1)->StrOfAE;
+  fprintf(GLOBAL_stderr, "\n Instructions Executed in %s\n", program);
 
   c_get.nxvar =
-    GLOBAL_opcount[_get_x_var];
+    LOCAL_opcount[_get_x_var];
   c_get.nyvar =
-    GLOBAL_opcount[_get_y_var];
+    LOCAL_opcount[_get_y_var];
   c_get.nxval =
-    GLOBAL_opcount[_get_x_val];
+    LOCAL_opcount[_get_x_val];
   c_get.nyval =
-    GLOBAL_opcount[_get_y_val];
+    LOCAL_opcount[_get_y_val];
   c_get.ncons =
-    GLOBAL_opcount[_get_atom]+
-    GLOBAL_opcount[_get_2atoms]+
-    GLOBAL_opcount[_get_3atoms]+
-    GLOBAL_opcount[_get_4atoms]+
-    GLOBAL_opcount[_get_5atoms]+
-    GLOBAL_opcount[_get_6atoms];
+    LOCAL_opcount[_get_atom]+
+    LOCAL_opcount[_get_2atoms]+
+    LOCAL_opcount[_get_3atoms]+
+    LOCAL_opcount[_get_4atoms]+
+    LOCAL_opcount[_get_5atoms]+
+    LOCAL_opcount[_get_6atoms];
   c_get.nlist =
-    GLOBAL_opcount[_get_list] +
-    GLOBAL_opcount[_glist_valx] +
-    GLOBAL_opcount[_glist_valy] +
-    GLOBAL_opcount[_gl_void_varx] +
-    GLOBAL_opcount[_gl_void_vary] +
-    GLOBAL_opcount[_gl_void_valx] +
-    GLOBAL_opcount[_gl_void_valy];
+    LOCAL_opcount[_get_list] +
+    LOCAL_opcount[_glist_valx] +
+    LOCAL_opcount[_glist_valy] +
+    LOCAL_opcount[_gl_void_varx] +
+    LOCAL_opcount[_gl_void_vary] +
+    LOCAL_opcount[_gl_void_valx] +
+    LOCAL_opcount[_gl_void_valy];
   c_get.nstru =
-    GLOBAL_opcount[_get_struct];
+    LOCAL_opcount[_get_struct];
 
   gets = c_get.nxvar + c_get.nyvar + c_get.nxval + c_get.nyval +
     c_get.ncons + c_get.nlist + c_get.nstru;
 
   c_unify.nxvar =
-    GLOBAL_opcount[_unify_x_var] +
-    GLOBAL_opcount[_unify_void] +
-    GLOBAL_opcount[_unify_n_voids] +
-    2 * GLOBAL_opcount[_unify_x_var2] +
-    2 * GLOBAL_opcount[_gl_void_varx] +
-    GLOBAL_opcount[_gl_void_vary] +
-    GLOBAL_opcount[_gl_void_valx] +
-    GLOBAL_opcount[_unify_l_x_var] +
-    GLOBAL_opcount[_unify_l_void] +
-    GLOBAL_opcount[_unify_l_n_voids] +
-    2 * GLOBAL_opcount[_unify_l_x_var2] +
-    GLOBAL_opcount[_unify_x_var_write] +
-    GLOBAL_opcount[_unify_void_write] +
-    GLOBAL_opcount[_unify_n_voids_write] +
-    2 * GLOBAL_opcount[_unify_x_var2_write] +
-    GLOBAL_opcount[_unify_l_x_var_write] +
-    GLOBAL_opcount[_unify_l_void_write] +
-    GLOBAL_opcount[_unify_l_n_voids_write] +
-    2 * GLOBAL_opcount[_unify_l_x_var2_write];
+    LOCAL_opcount[_unify_x_var] +
+    LOCAL_opcount[_unify_void] +
+    LOCAL_opcount[_unify_n_voids] +
+    2 * LOCAL_opcount[_unify_x_var2] +
+    2 * LOCAL_opcount[_gl_void_varx] +
+    LOCAL_opcount[_gl_void_vary] +
+    LOCAL_opcount[_gl_void_valx] +
+    LOCAL_opcount[_unify_l_x_var] +
+    LOCAL_opcount[_unify_l_void] +
+    LOCAL_opcount[_unify_l_n_voids] +
+    2 * LOCAL_opcount[_unify_l_x_var2] +
+    LOCAL_opcount[_unify_x_var_write] +
+    LOCAL_opcount[_unify_void_write] +
+    LOCAL_opcount[_unify_n_voids_write] +
+    2 * LOCAL_opcount[_unify_x_var2_write] +
+    LOCAL_opcount[_unify_l_x_var_write] +
+    LOCAL_opcount[_unify_l_void_write] +
+    LOCAL_opcount[_unify_l_n_voids_write] +
+    2 * LOCAL_opcount[_unify_l_x_var2_write];
   c_unify.nyvar =
-    GLOBAL_opcount[_unify_y_var] +
-    GLOBAL_opcount[_gl_void_vary] +
-    GLOBAL_opcount[_unify_l_y_var] +
-    GLOBAL_opcount[_unify_y_var_write] +
-    GLOBAL_opcount[_unify_l_y_var_write];
+    LOCAL_opcount[_unify_y_var] +
+    LOCAL_opcount[_gl_void_vary] +
+    LOCAL_opcount[_unify_l_y_var] +
+    LOCAL_opcount[_unify_y_var_write] +
+    LOCAL_opcount[_unify_l_y_var_write];
   c_unify.nxval =
-    GLOBAL_opcount[_unify_x_val] +
-    GLOBAL_opcount[_unify_x_loc] +
-    GLOBAL_opcount[_glist_valx] +
-    GLOBAL_opcount[_gl_void_valx] +
-    GLOBAL_opcount[_unify_l_x_val] +
-    GLOBAL_opcount[_unify_l_x_loc] +
-    GLOBAL_opcount[_unify_x_val_write] +
-    GLOBAL_opcount[_unify_x_loc_write] +
-    GLOBAL_opcount[_unify_l_x_val_write] +
-    GLOBAL_opcount[_unify_l_x_loc_write];
+    LOCAL_opcount[_unify_x_val] +
+    LOCAL_opcount[_unify_x_loc] +
+    LOCAL_opcount[_glist_valx] +
+    LOCAL_opcount[_gl_void_valx] +
+    LOCAL_opcount[_unify_l_x_val] +
+    LOCAL_opcount[_unify_l_x_loc] +
+    LOCAL_opcount[_unify_x_val_write] +
+    LOCAL_opcount[_unify_x_loc_write] +
+    LOCAL_opcount[_unify_l_x_val_write] +
+    LOCAL_opcount[_unify_l_x_loc_write];
   c_unify.nyval =
-    GLOBAL_opcount[_unify_y_val] +
-    GLOBAL_opcount[_unify_y_loc] +
-    GLOBAL_opcount[_glist_valy] +
-    GLOBAL_opcount[_gl_void_valy] +
-    GLOBAL_opcount[_unify_l_y_val] +
-    GLOBAL_opcount[_unify_l_y_loc] +
-    GLOBAL_opcount[_unify_y_val_write] +
-    GLOBAL_opcount[_unify_y_loc_write] +
-    GLOBAL_opcount[_unify_l_y_val_write] +
-    GLOBAL_opcount[_unify_l_y_loc_write];
+    LOCAL_opcount[_unify_y_val] +
+    LOCAL_opcount[_unify_y_loc] +
+    LOCAL_opcount[_glist_valy] +
+    LOCAL_opcount[_gl_void_valy] +
+    LOCAL_opcount[_unify_l_y_val] +
+    LOCAL_opcount[_unify_l_y_loc] +
+    LOCAL_opcount[_unify_y_val_write] +
+    LOCAL_opcount[_unify_y_loc_write] +
+    LOCAL_opcount[_unify_l_y_val_write] +
+    LOCAL_opcount[_unify_l_y_loc_write];
   c_unify.ncons =
-    GLOBAL_opcount[_unify_atom] +
-    GLOBAL_opcount[_unify_n_atoms] +
-    GLOBAL_opcount[_unify_l_atom] +
-    GLOBAL_opcount[_unify_atom_write] +
-    GLOBAL_opcount[_unify_n_atoms_write] +
-    GLOBAL_opcount[_unify_l_atom_write];
+    LOCAL_opcount[_unify_atom] +
+    LOCAL_opcount[_unify_n_atoms] +
+    LOCAL_opcount[_unify_l_atom] +
+    LOCAL_opcount[_unify_atom_write] +
+    LOCAL_opcount[_unify_n_atoms_write] +
+    LOCAL_opcount[_unify_l_atom_write];
   c_unify.nlist =
-    GLOBAL_opcount[_unify_list] +
-    GLOBAL_opcount[_unify_l_list] +
-    GLOBAL_opcount[_unify_list_write] +
-    GLOBAL_opcount[_unify_l_list_write];
+    LOCAL_opcount[_unify_list] +
+    LOCAL_opcount[_unify_l_list] +
+    LOCAL_opcount[_unify_list_write] +
+    LOCAL_opcount[_unify_l_list_write];
   c_unify.nstru =
-    GLOBAL_opcount[_unify_struct] +
-    GLOBAL_opcount[_unify_l_struc] +
-    GLOBAL_opcount[_unify_struct_write] +
-    GLOBAL_opcount[_unify_l_struc_write];
+    LOCAL_opcount[_unify_struct] +
+    LOCAL_opcount[_unify_l_struc] +
+    LOCAL_opcount[_unify_struct_write] +
+    LOCAL_opcount[_unify_l_struc_write];
   c_unify.nmisc =
-    GLOBAL_opcount[_pop] +
-    GLOBAL_opcount[_pop_n];
+    LOCAL_opcount[_pop] +
+    LOCAL_opcount[_pop_n];
 
   unifies = c_unify.nxvar + c_unify.nyvar + c_unify.nxval + c_unify.nyval +
     c_unify.ncons + c_unify.nlist + c_unify.nstru + c_unify.nmisc;
 
   c_put.nxvar =
-    GLOBAL_opcount[_put_x_var];
+    LOCAL_opcount[_put_x_var];
   c_put.nyvar =
-    GLOBAL_opcount[_put_y_var];
+    LOCAL_opcount[_put_y_var];
   c_put.nxval =
-    GLOBAL_opcount[_put_x_val]+
-    2*GLOBAL_opcount[_put_xx_val];
+    LOCAL_opcount[_put_x_val]+
+    2*LOCAL_opcount[_put_xx_val];
   c_put.nyval =
-    GLOBAL_opcount[_put_y_val];
+    LOCAL_opcount[_put_y_val];
   c_put.ncons =
-    GLOBAL_opcount[_put_atom];
+    LOCAL_opcount[_put_atom];
   c_put.nlist =
-    GLOBAL_opcount[_put_list];
+    LOCAL_opcount[_put_list];
   c_put.nstru =
-    GLOBAL_opcount[_put_struct];
+    LOCAL_opcount[_put_struct];
 
   puts = c_put.nxvar + c_put.nyvar + c_put.nxval + c_put.nyval +
     c_put.ncons + c_put.nlist + c_put.nstru;
 
   c_write.nxvar =
-    GLOBAL_opcount[_write_x_var] +
-    GLOBAL_opcount[_write_void] +
-    GLOBAL_opcount[_write_n_voids];
+    LOCAL_opcount[_write_x_var] +
+    LOCAL_opcount[_write_void] +
+    LOCAL_opcount[_write_n_voids];
   c_write.nyvar =
-    GLOBAL_opcount[_write_y_var];
+    LOCAL_opcount[_write_y_var];
   c_write.nxval =
-    GLOBAL_opcount[_write_x_val];
+    LOCAL_opcount[_write_x_val];
   c_write.nyval =
-    GLOBAL_opcount[_write_y_val];
+    LOCAL_opcount[_write_y_val];
   c_write.ncons =
-    GLOBAL_opcount[_write_atom];
+    LOCAL_opcount[_write_atom];
   c_write.nlist =
-    GLOBAL_opcount[_write_list];
+    LOCAL_opcount[_write_list];
   c_write.nstru =
-    GLOBAL_opcount[_write_struct];
+    LOCAL_opcount[_write_struct];
 
   writes = c_write.nxvar + c_write.nyvar + c_write.nxval + c_write.nyval +
     c_write.ncons + c_write.nlist + c_write.nstru;
 
   c_control.nexecs =
-    GLOBAL_opcount[_execute] +
-    GLOBAL_opcount[_dexecute];
+    LOCAL_opcount[_execute] +
+    LOCAL_opcount[_dexecute];
 
   c_control.ncalls =
-    GLOBAL_opcount[_call] +
-    GLOBAL_opcount[_fcall];
+    LOCAL_opcount[_call] +
+    LOCAL_opcount[_fcall];
 
   c_control.nproceeds =
-    GLOBAL_opcount[_procceed];
+    LOCAL_opcount[_procceed];
 
   c_control.ncallbips =
-    GLOBAL_opcount[_call_cpred] +
-    GLOBAL_opcount[_call_c_wfail] +
-    GLOBAL_opcount[_try_c] +
-    GLOBAL_opcount[_retry_c] +
-    GLOBAL_opcount[_op_fail] +
-    GLOBAL_opcount[_trust_fail] +
-    GLOBAL_opcount[_p_atom_x] +
-    GLOBAL_opcount[_p_atom_y] +
-    GLOBAL_opcount[_p_atomic_x] +
-    GLOBAL_opcount[_p_atomic_y] +
-    GLOBAL_opcount[_p_compound_x] +
-    GLOBAL_opcount[_p_compound_y] +
-    GLOBAL_opcount[_p_float_x] +
-    GLOBAL_opcount[_p_float_y] +
-    GLOBAL_opcount[_p_integer_x] +
-    GLOBAL_opcount[_p_integer_y] +
-    GLOBAL_opcount[_p_nonvar_x] +
-    GLOBAL_opcount[_p_nonvar_y] +
-    GLOBAL_opcount[_p_number_x] +
-    GLOBAL_opcount[_p_number_y] +
-    GLOBAL_opcount[_p_var_x] +
-    GLOBAL_opcount[_p_var_y] +
-    GLOBAL_opcount[_p_db_ref_x] +
-    GLOBAL_opcount[_p_db_ref_y] +
-    GLOBAL_opcount[_p_cut_by_x] +
-    GLOBAL_opcount[_p_cut_by_y] +
-    GLOBAL_opcount[_p_primitive_x] +
-    GLOBAL_opcount[_p_primitive_y] +
-    GLOBAL_opcount[_p_equal] +
-    GLOBAL_opcount[_p_plus_vv] +
-    GLOBAL_opcount[_p_plus_vc] +
-    GLOBAL_opcount[_p_plus_y_vv] +
-    GLOBAL_opcount[_p_plus_y_vc] +
-    GLOBAL_opcount[_p_minus_vv] +
-    GLOBAL_opcount[_p_minus_cv] +
-    GLOBAL_opcount[_p_minus_y_vv] +
-    GLOBAL_opcount[_p_minus_y_cv] +
-    GLOBAL_opcount[_p_times_vv] +
-    GLOBAL_opcount[_p_times_vc] +
-    GLOBAL_opcount[_p_times_y_vv] +
-    GLOBAL_opcount[_p_times_y_vc] +
-    GLOBAL_opcount[_p_div_vv] +
-    GLOBAL_opcount[_p_div_vc] +
-    GLOBAL_opcount[_p_div_cv] +
-    GLOBAL_opcount[_p_div_y_vv] +
-    GLOBAL_opcount[_p_div_y_vc] +
-    GLOBAL_opcount[_p_div_y_cv] +
-    GLOBAL_opcount[_p_or_vv] +
-    GLOBAL_opcount[_p_or_vc] +
-    GLOBAL_opcount[_p_or_y_vv] +
-    GLOBAL_opcount[_p_or_y_vc] +
-    GLOBAL_opcount[_p_and_vv] +
-    GLOBAL_opcount[_p_and_vc] +
-    GLOBAL_opcount[_p_and_y_vv] +
-    GLOBAL_opcount[_p_and_y_vc] +
-    GLOBAL_opcount[_p_sll_vv] +
-    GLOBAL_opcount[_p_sll_vc] +
-    GLOBAL_opcount[_p_sll_y_vv] +
-    GLOBAL_opcount[_p_sll_y_vc] +
-    GLOBAL_opcount[_p_slr_vv] +
-    GLOBAL_opcount[_p_slr_vc] +
-    GLOBAL_opcount[_p_slr_y_vv] +
-    GLOBAL_opcount[_p_slr_y_vc] +
-    GLOBAL_opcount[_p_dif] +
-    GLOBAL_opcount[_p_eq] +
-    GLOBAL_opcount[_p_arg_vv] +
-    GLOBAL_opcount[_p_arg_cv] +
-    GLOBAL_opcount[_p_arg_y_vv] +
-    GLOBAL_opcount[_p_arg_y_cv] +
-    GLOBAL_opcount[_p_functor] +
-    GLOBAL_opcount[_p_func2s_vv] +
-    GLOBAL_opcount[_p_func2s_cv] +
-    GLOBAL_opcount[_p_func2s_vc] +
-    GLOBAL_opcount[_p_func2s_y_vv] +
-    GLOBAL_opcount[_p_func2s_y_cv] +
-    GLOBAL_opcount[_p_func2s_y_vc] +
-    GLOBAL_opcount[_p_func2f_xx] +
-    GLOBAL_opcount[_p_func2f_xy] +
-    GLOBAL_opcount[_p_func2f_yx] +
-    GLOBAL_opcount[_p_func2f_yy];
+    LOCAL_opcount[_call_cpred] +
+    LOCAL_opcount[_call_c_wfail] +
+    LOCAL_opcount[_try_c] +
+    LOCAL_opcount[_retry_c] +
+    LOCAL_opcount[_op_fail] +
+    LOCAL_opcount[_trust_fail] +
+    LOCAL_opcount[_p_atom_x] +
+    LOCAL_opcount[_p_atom_y] +
+    LOCAL_opcount[_p_atomic_x] +
+    LOCAL_opcount[_p_atomic_y] +
+    LOCAL_opcount[_p_compound_x] +
+    LOCAL_opcount[_p_compound_y] +
+    LOCAL_opcount[_p_float_x] +
+    LOCAL_opcount[_p_float_y] +
+    LOCAL_opcount[_p_integer_x] +
+    LOCAL_opcount[_p_integer_y] +
+    LOCAL_opcount[_p_nonvar_x] +
+    LOCAL_opcount[_p_nonvar_y] +
+    LOCAL_opcount[_p_number_x] +
+    LOCAL_opcount[_p_number_y] +
+    LOCAL_opcount[_p_var_x] +
+    LOCAL_opcount[_p_var_y] +
+    LOCAL_opcount[_p_db_ref_x] +
+    LOCAL_opcount[_p_db_ref_y] +
+    LOCAL_opcount[_p_primitive_x] +
+    LOCAL_opcount[_p_primitive_y] +
+    LOCAL_opcount[_p_equal] +
+    LOCAL_opcount[_p_plus_vv] +
+    LOCAL_opcount[_p_plus_vc] +
+    LOCAL_opcount[_p_plus_y_vv] +
+    LOCAL_opcount[_p_plus_y_vc] +
+    LOCAL_opcount[_p_minus_vv] +
+    LOCAL_opcount[_p_minus_cv] +
+    LOCAL_opcount[_p_minus_y_vv] +
+    LOCAL_opcount[_p_minus_y_cv] +
+    LOCAL_opcount[_p_times_vv] +
+    LOCAL_opcount[_p_times_vc] +
+    LOCAL_opcount[_p_times_y_vv] +
+    LOCAL_opcount[_p_times_y_vc] +
+    LOCAL_opcount[_p_div_vv] +
+    LOCAL_opcount[_p_div_vc] +
+    LOCAL_opcount[_p_div_cv] +
+    LOCAL_opcount[_p_div_y_vv] +
+    LOCAL_opcount[_p_div_y_vc] +
+    LOCAL_opcount[_p_div_y_cv] +
+    LOCAL_opcount[_p_or_vv] +
+    LOCAL_opcount[_p_or_vc] +
+    LOCAL_opcount[_p_or_y_vv] +
+    LOCAL_opcount[_p_or_y_vc] +
+    LOCAL_opcount[_p_and_vv] +
+    LOCAL_opcount[_p_and_vc] +
+    LOCAL_opcount[_p_and_y_vv] +
+    LOCAL_opcount[_p_and_y_vc] +
+    LOCAL_opcount[_p_sll_vv] +
+    LOCAL_opcount[_p_sll_vc] +
+    LOCAL_opcount[_p_sll_y_vv] +
+    LOCAL_opcount[_p_sll_y_vc] +
+    LOCAL_opcount[_p_slr_vv] +
+    LOCAL_opcount[_p_slr_vc] +
+    LOCAL_opcount[_p_slr_y_vv] +
+    LOCAL_opcount[_p_slr_y_vc] +
+    LOCAL_opcount[_p_arg_vv] +
+    LOCAL_opcount[_p_arg_cv] +
+    LOCAL_opcount[_p_arg_y_vv] +
+    LOCAL_opcount[_p_arg_y_cv] +
+    LOCAL_opcount[_p_functor] +
+    LOCAL_opcount[_p_func2s_vv] +
+    LOCAL_opcount[_p_func2s_cv] +
+    LOCAL_opcount[_p_func2s_vc] +
+    LOCAL_opcount[_p_func2s_y_vv] +
+    LOCAL_opcount[_p_func2s_y_cv] +
+    LOCAL_opcount[_p_func2s_y_vc] +
+    LOCAL_opcount[_p_func2f_xx] +
+    LOCAL_opcount[_p_func2f_xy] +
+    LOCAL_opcount[_p_func2f_yx] +
+    LOCAL_opcount[_p_func2f_yy];
 
   c_control.ncuts =
-    GLOBAL_opcount[_cut] +
-    GLOBAL_opcount[_cut_t] +
-    GLOBAL_opcount[_cut_e] +
-    GLOBAL_opcount[_commit_b_x] +
-    GLOBAL_opcount[_commit_b_y];
+    LOCAL_opcount[_cut] +
+    LOCAL_opcount[_cut_t] +
+    LOCAL_opcount[_cut_e] +
+    LOCAL_opcount[_commit_b_x] +
+    LOCAL_opcount[_commit_b_y];
 
   c_control.nallocs =
-    GLOBAL_opcount[_allocate] +
-    GLOBAL_opcount[_fcall];
+    LOCAL_opcount[_allocate] +
+    LOCAL_opcount[_fcall];
 
   c_control.ndeallocs =
-    GLOBAL_opcount[_dexecute] +
-    GLOBAL_opcount[_deallocate];
+    LOCAL_opcount[_dexecute] +
+    LOCAL_opcount[_deallocate];
 
   controls =
     c_control.nexecs +
@@ -583,30 +605,30 @@ p_show_ops_by_group(void)
     c_control.ncuts +
     c_control.nallocs +
     c_control.ndeallocs +
-    GLOBAL_opcount[_jump] +
-    GLOBAL_opcount[_move_back] +
-    GLOBAL_opcount[_try_in];
+    LOCAL_opcount[_jump] +
+    LOCAL_opcount[_move_back] +
+    LOCAL_opcount[_try_in];
 
 
 
   c_cp.ntries =
-    GLOBAL_opcount[_try_me] +
-    GLOBAL_opcount[_try_and_mark] +
-    GLOBAL_opcount[_try_c] +
-    GLOBAL_opcount[_try_clause] +
-    GLOBAL_opcount[_either];
+    LOCAL_opcount[_try_me] +
+    LOCAL_opcount[_try_and_mark] +
+    LOCAL_opcount[_try_c] +
+    LOCAL_opcount[_try_clause] +
+    LOCAL_opcount[_either];
 
   c_cp.nretries =
-    GLOBAL_opcount[_retry_me] +
-    GLOBAL_opcount[_retry_and_mark] +
-    GLOBAL_opcount[_retry_c] +
-    GLOBAL_opcount[_retry] +
-    GLOBAL_opcount[_or_else];
+    LOCAL_opcount[_retry_me] +
+    LOCAL_opcount[_retry_and_mark] +
+    LOCAL_opcount[_retry_c] +
+    LOCAL_opcount[_retry] +
+    LOCAL_opcount[_or_else];
 
   c_cp.ntrusts =
-    GLOBAL_opcount[_trust_me] +
-    GLOBAL_opcount[_trust] +
-    GLOBAL_opcount[_or_last];
+    LOCAL_opcount[_trust_me] +
+    LOCAL_opcount[_trust] +
+    LOCAL_opcount[_or_last];
 
   choice_pts =
     c_cp.ntries +
@@ -614,40 +636,40 @@ p_show_ops_by_group(void)
     c_cp.ntrusts;
 
   indexes =
-    GLOBAL_opcount[_jump_if_var] +
-    GLOBAL_opcount[_switch_on_type] +
-    GLOBAL_opcount[_switch_list_nl] +
-    GLOBAL_opcount[_switch_on_arg_type] +
-    GLOBAL_opcount[_switch_on_sub_arg_type] +
-    GLOBAL_opcount[_switch_on_cons] +
-    GLOBAL_opcount[_go_on_cons] +
-    GLOBAL_opcount[_if_cons] +
-    GLOBAL_opcount[_switch_on_func] +
-    GLOBAL_opcount[_go_on_func] +
-    GLOBAL_opcount[_if_func] +
-    GLOBAL_opcount[_if_not_then];
+    LOCAL_opcount[_jump_if_var] +
+    LOCAL_opcount[_switch_on_type] +
+    LOCAL_opcount[_switch_list_nl] +
+    LOCAL_opcount[_switch_on_arg_type] +
+    LOCAL_opcount[_switch_on_sub_arg_type] +
+    LOCAL_opcount[_switch_on_cons] +
+    LOCAL_opcount[_go_on_cons] +
+    LOCAL_opcount[_if_cons] +
+    LOCAL_opcount[_switch_on_func] +
+    LOCAL_opcount[_go_on_func] +
+    LOCAL_opcount[_if_func] +
+    LOCAL_opcount[_if_not_then];
   misc =
     c_control.ncallbips +
-    GLOBAL_opcount[_Ystop] +
-    GLOBAL_opcount[_Nstop] +
-    GLOBAL_opcount[_index_pred] +
-    GLOBAL_opcount[_lock_pred] +
+    LOCAL_opcount[_Ystop] +
+    LOCAL_opcount[_Nstop] +
+    LOCAL_opcount[_index_pred] +
+    LOCAL_opcount[_lock_pred] +
 #if THREADS
-    GLOBAL_opcount[_thread_local] +
+    LOCAL_opcount[_thread_local] +
 #endif
-    GLOBAL_opcount[_save_b_x] +
-    GLOBAL_opcount[_save_b_y] +
-    GLOBAL_opcount[_undef_p] +
-    GLOBAL_opcount[_spy_pred] +
-    GLOBAL_opcount[_spy_or_trymark] +
-    GLOBAL_opcount[_save_pair_x] +
-    GLOBAL_opcount[_save_pair_y] +
-    GLOBAL_opcount[_save_pair_x_write] +
-    GLOBAL_opcount[_save_pair_y_write] +
-    GLOBAL_opcount[_save_appl_x] +
-    GLOBAL_opcount[_save_appl_y] +
-    GLOBAL_opcount[_save_appl_x_write] +
-    GLOBAL_opcount[_save_appl_y_write];
+    LOCAL_opcount[_save_b_x] +
+    LOCAL_opcount[_save_b_y] +
+    LOCAL_opcount[_undef_p] +
+    LOCAL_opcount[_spy_pred] +
+    LOCAL_opcount[_spy_or_trymark] +
+    LOCAL_opcount[_save_pair_x] +
+    LOCAL_opcount[_save_pair_y] +
+    LOCAL_opcount[_save_pair_x_write] +
+    LOCAL_opcount[_save_pair_y_write] +
+    LOCAL_opcount[_save_appl_x] +
+    LOCAL_opcount[_save_appl_y] +
+    LOCAL_opcount[_save_appl_x_write] +
+    LOCAL_opcount[_save_appl_y_write];
   total = gets + unifies + puts + writes + controls + choice_pts + indexes + misc;
 
   /*  for (i = 0; i <= _std_top; ++i)
@@ -803,6 +825,7 @@ p_show_ops_by_group(void)
 static Int
 p_show_sequences(void)
 {
+  CACHE_REGS
   int i, j;
   YAP_ULONG_LONG min;
   YAP_ULONG_LONG sum = 0;
@@ -826,11 +849,11 @@ p_show_sequences(void)
     return FALSE;
   }
   for (i = 0; i <= _std_top; ++i) {
-    sum += GLOBAL_opcount[i];
+    sum += LOCAL_opcount[i];
   }
   for (i = 0; i <= _std_top; ++i) {
     for (j = 0; j <= _std_top; ++j) {
-      YAP_ULONG_LONG seqs = Yap_2opcount[i][j];
+      YAP_ULONG_LONG seqs = LOCAL_opcount2[i * (_std_top + 1) + j];
       if (seqs && sum/seqs <= min) {
 	/*
 	Term t[3], t0;
@@ -841,7 +864,7 @@ p_show_sequences(void)
 	t0 = MkApplTerm(
 	Yap_MkPairTerm(Yap_op_names[i]
 	*/
-	fprintf(stderr,"%f -> %s,%s\n",((double)seqs*100.0)/sum,Yap_op_names[i],Yap_op_names[j]);
+	fprintf(GLOBAL_stderr,"%f -> %s,%s\n",((double)seqs*100.0)/sum,Yap_op_names[i],Yap_op_names[j]);
 	/* we found one */
       }
     }  
@@ -849,6 +872,120 @@ p_show_sequences(void)
   return TRUE;
 }
 
+typedef struct {
+  YAP_ULONG_LONG count;
+  int ops[3];
+} op_sequence;
+
+static int
+cmp_sequences(const void *a, const void *b)
+{
+  YAP_ULONG_LONG ca = ((const op_sequence *)a)->count,
+    cb = ((const op_sequence *)b)->count;
+
+  return (ca < cb) - (ca > cb);
+}
+
+/* collect the sequences of n instructions that were seen, most frequent
+   first */
+static op_sequence *
+collect_sequences(int n, size_t *np)
+{
+  CACHE_REGS
+  op_sequence *seqs;
+  size_t k = 0, max;
+  UInt i, j;
+
+  if (n == 1)
+    max = _std_top + 1;
+  else if (n == 2)
+    max = (_std_top + 1) * (_std_top + 1);
+  else
+    max = OPCOUNT3_SIZE;
+  if ((seqs = malloc(max * sizeof(op_sequence))) == NULL)
+    return NULL;
+  if (n == 1) {
+    for (i = 0; i <= _std_top; i++)
+      if (LOCAL_opcount[i]) {
+        seqs[k].count = LOCAL_opcount[i];
+        seqs[k++].ops[0] = i;
+      }
+  } else if (n == 2) {
+    for (i = 0; i <= _std_top; i++)
+      for (j = 0; j <= _std_top; j++) {
+        YAP_ULONG_LONG c = LOCAL_opcount2[i * (_std_top + 1) + j];
+        if (c) {
+          seqs[k].count = c;
+          seqs[k].ops[0] = i;
+          seqs[k++].ops[1] = j;
+        }
+      }
+  } else if (LOCAL_opcount3) {
+    for (i = 0; i < OPCOUNT3_SIZE; i++) {
+      YAP_ULONG_LONG key = LOCAL_opcount3[2 * i];
+      if (key--) {
+        seqs[k].count = LOCAL_opcount3[2 * i + 1];
+        seqs[k].ops[0] = (key >> 20) & 1023;
+        seqs[k].ops[1] = (key >> 10) & 1023;
+        seqs[k++].ops[2] = key & 1023;
+      }
+    }
+  }
+  qsort(seqs, k, sizeof(op_sequence), cmp_sequences);
+  *np = k;
+  return seqs;
+}
+
+static Int
+p_profiler_sequences(USES_REGS1)
+{
+  Term t = Deref(ARG1), tl;
+  Functor fminus = Yap_MkFunctor(AtomMinus, 2);
+  op_sequence *seqs;
+  size_t n, i;
+  Int len;
+  int j;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "wam_profiler_sequences/2");
+    return FALSE;
+  }
+  if (!IsIntegerTerm(t)) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, "wam_profiler_sequences/2");
+    return FALSE;
+  }
+  len = IntegerOfTerm(t);
+  if (len < 1 || len > 3) {
+    Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, t, "wam_profiler_sequences/2");
+    return FALSE;
+  }
+  if ((seqs = collect_sequences(len, &n)) == NULL) {
+    Yap_Error(RESOURCE_ERROR_HEAP, t, "wam_profiler_sequences/2");
+    return FALSE;
+  }
+  while (HR + n * (3 + 2 * len + 6) > ASP - 1024) {
+    if (!Yap_gcl(n * (3 + 2 * len + 6) * sizeof(CELL), 2, ENV, gc_P(P, CP))) {
+      free(seqs);
+      Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+      return FALSE;
+    }
+  }
+  /* build the list back to front, so that it starts with the most
+     frequent sequence */
+  tl = TermNil;
+  for (i = n; i > 0; i--) {
+    Term ops = TermNil, targs[2];
+
+    for (j = len - 1; j >= 0; j--)
+      ops = MkPairTerm(MkAtomTerm(Yap_LookupAtom(Yap_op_names[seqs[i - 1].ops[j]])), ops);
+    targs[0] = MkIntegerTerm(seqs[i - 1].count);
+    targs[1] = ops;
+    tl = MkPairTerm(Yap_MkApplTerm(fminus, 2, targs), tl);
+  }
+  free(seqs);
+  return Yap_unify(ARG2, tl);
+}
+
 void 
 Yap_InitAnalystPreds(void)
 {
@@ -881,6 +1018,18 @@ label  _A_. The label must be an atom.
 
  */
   Yap_InitCPred("wam_profiler_show_sequences", 1, p_show_sequences, SafePredFlag |SyncPredFlag);
+  Yap_InitCPred("wam_profiler_sequences", 2, p_profiler_sequences, SafePredFlag |SyncPredFlag);
+/** @pred wam_profiler_sequences(+ _N_, - _L_) 
+
+
+Unify  _L_ with the sequences of  _N_ instructions, for  _N_ 1, 2
+or 3, that were executed since the counters were last reset. Each
+element has the form  _Count_-_Ops_, where  _Ops_ is the list of
+instruction names; the most frequent sequences come first. The list
+can be written out as facts for misc/buildsupers.
+
+ 
+*/
 }
 
 #endif /* ANALYST */
@@ -1293,6 +1293,7 @@ Yap_NameOfBinaryOp(int i)
 void
 Yap_InitBinaryExps(void)
 {
+  CACHE_REGS
   unsigned int    i;
   ExpEntry       *p;
 
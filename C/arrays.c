@@ -233,8 +233,8 @@ static Int CloseMmappedArray(StaticArrayEntry *pp, void *area USES_REGS) {
   mmap_array_block *ptr = GLOBAL_mmap_arrays, *optr = GLOBAL_mmap_arrays;
 
   while (ptr != NULL && ptr->start != area) {
-    ptr = ptr->next;
     optr = ptr;
+    ptr = ptr->next;
   }
   if (ptr == NULL) {
 #if !defined(USE_SYSTEM_MALLOC)
@@ -249,7 +249,10 @@ static Int CloseMmappedArray(StaticArrayEntry *pp, void *area USES_REGS) {
                   "close_mmapped_array (munmap: %s)", strerror(errno));
     return (FALSE);
   }
-  optr->next = ptr->next;
+  if (ptr == GLOBAL_mmap_arrays)
+    GLOBAL_mmap_arrays = ptr->next;
+  else
+    optr->next = ptr->next;
   pp->ValueOfVE.ints = NULL;
   pp->ArrayEArity = 0;
   if (close(ptr->fd) < 0) {
@@ -1347,12 +1350,13 @@ static Int clear_static_array(USES_REGS1) {
 
 Close an existing static array of name  _Name_. The  _Name_ must
 be an atom (named array). Space for the array will be recovered and
-further accesses to the array will return an error.
+further accesses to the array will return an error. Arrays created over
+memory given with `address(_)` are detached, but the memory is left to
+its owner.
 
 
 */
 static Int close_static_array(USES_REGS1) {
-  /* does not work for mmap arrays yet */
   Term t = Deref(ARG1);
 
   if (IsVarTerm(t)) {
@@ -1373,17 +1377,21 @@ static Int close_static_array(USES_REGS1) {
     } else {
       StaticArrayEntry *ptr = (StaticArrayEntry *)pp;
       if (ptr->ValueOfVE.ints != NULL) {
+        if (ptr->TypeOfAE & MMAP_ARRAY) {
 #if HAVE_MMAP
-        Int val =
-            CloseMmappedArray(ptr, (void *)ptr->ValueOfVE.chars PASS_REGS);
-#if USE_SYSTEM_MALLOC
-        if (val) {
+          mmap_array_block *mp = GLOBAL_mmap_arrays;
+
+          while (mp != NULL && mp->start != (void *)ptr->ValueOfVE.chars)
+            mp = mp->next;
+          if (mp != NULL)
+            return CloseMmappedArray(ptr,
+                                     (void *)ptr->ValueOfVE.chars PASS_REGS);
 #endif
-          return (val);
-#if USE_SYSTEM_MALLOC
+          /* storage given by address(_): it belongs to someone else */
+          ptr->ValueOfVE.ints = NULL;
+          ptr->ArrayEArity = 0;
+          return (TRUE);
         }
-#endif
-#endif
         Yap_FreeAtomSpace((char *)(ptr->ValueOfVE.ints));
         ptr->ValueOfVE.ints = NULL;
         ptr->ArrayEArity = 0;
@@ -2372,6 +2380,556 @@ static Int add_to_array_element(USES_REGS1) {
   }
 }
 
+/*
+  Bulk operations on static arrays of ints or floats.
+
+  They work on the storage of the array, so they also work on mmapped
+  arrays and arrays over memory given with `address(_)`. The loops
+  are simple enough for the C compiler to vectorise; floating-point
+  reductions keep several partial results, so that they are not
+  serialised by a single accumulator.
+*/
+
+#define BULK_LANES 4
+
+/* find the static array named by t, and check it holds numbers */
+static StaticArrayEntry *GetNumericArray(Term t, const char *caller) {
+  StaticArrayEntry *ptr;
+  AtomEntry *ae;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, caller);
+    return NULL;
+  }
+  if (!IsAtomTerm(t)) {
+    Yap_Error(TYPE_ERROR_ATOM, t, caller);
+    return NULL;
+  }
+  ae = RepAtom(AtomOfTerm(t));
+  READ_LOCK(ae->ARWLock);
+  ptr = RepStaticArrayProp(ae->PropsOfAE);
+  while (!EndOfPAEntr(ptr) && ptr->KindOfPE != ArrayProperty)
+    ptr = RepStaticArrayProp(ptr->NextOfPE);
+  READ_UNLOCK(ae->ARWLock);
+  if (EndOfPAEntr(ptr) || ArrayIsDynamic((ArrayEntry *)ptr) ||
+      ptr->ValueOfVE.ints == NULL) {
+    Yap_Error(EXISTENCE_ERROR_ARRAY, t, caller);
+    return NULL;
+  }
+  if (ptr->ArrayType != array_of_ints && ptr->ArrayType != array_of_doubles) {
+    Yap_Error(TYPE_ERROR_ARRAY, t, caller);
+    return NULL;
+  }
+  return ptr;
+}
+
+/* a non-negative integer argument */
+static bool GetArrayCount(Term t, Int *vp, const char *caller) {
+  CACHE_REGS
+  Term nt;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, caller);
+    return false;
+  }
+  if (!IsIntegerTerm(nt = Yap_Eval(t))) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, caller);
+    return false;
+  }
+  if ((*vp = IntegerOfTerm(nt)) < 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, t, caller);
+    return false;
+  }
+  return true;
+}
+
+static bool GetArrayNumber(Term t, Float *fp, Int *ip, bool *is_int,
+                           const char *caller) {
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, caller);
+    return false;
+  }
+  if (IsIntegerTerm(t)) {
+    *ip = IntegerOfTerm(t);
+    *fp = *ip;
+    *is_int = true;
+  } else if (IsFloatTerm(t)) {
+    *fp = FloatOfTerm(t);
+    *is_int = false;
+  } else {
+    Yap_Error(TYPE_ERROR_NUMBER, t, caller);
+    return false;
+  }
+  return true;
+}
+
+/*
+  When an operation works on two arrays, they are locked in the order
+  of their addresses, so that two threads working on the same pair
+  cannot deadlock. An array given twice is locked once, for writing if
+  either use writes.
+*/
+static void LockArray(StaticArrayEntry *ptr, bool write) {
+  if (write) {
+    WRITE_LOCK(ptr->ArRWLock);
+  } else {
+    READ_LOCK(ptr->ArRWLock);
+  }
+}
+
+static void UnlockArray(StaticArrayEntry *ptr, bool write) {
+  if (write) {
+    WRITE_UNLOCK(ptr->ArRWLock);
+  } else {
+    READ_UNLOCK(ptr->ArRWLock);
+  }
+}
+
+static void LockArrays(StaticArrayEntry *a, bool wa, StaticArrayEntry *b,
+                       bool wb) {
+  if (a == b) {
+    LockArray(a, wa || wb);
+  } else if (a < b) {
+    LockArray(a, wa);
+    LockArray(b, wb);
+  } else {
+    LockArray(b, wb);
+    LockArray(a, wa);
+  }
+}
+
+static void UnlockArrays(StaticArrayEntry *a, bool wa, StaticArrayEntry *b,
+                         bool wb) {
+  if (a == b) {
+    UnlockArray(a, wa || wb);
+  } else {
+    UnlockArray(a, wa);
+    UnlockArray(b, wb);
+  }
+}
+
+/* the sum of the n ints in a, or of the products a[i]*b[i], once it
+   does not fit in an Int */
+static Term BigSumInts(const Int *a, const Int *b, Int n) {
+#if USE_GMP
+  MP_INT sum, prod;
+  Term t;
+  Int i;
+
+  mpz_init(&sum);
+  mpz_init(&prod);
+  for (i = 0; i < n; i++) {
+    mpz_set_si(&prod, a[i]);
+    if (b)
+      mpz_mul_si(&prod, &prod, b[i]);
+    mpz_add(&sum, &sum, &prod);
+  }
+  t = Yap_MkBigIntTerm(&sum);
+  mpz_clear(&prod);
+  mpz_clear(&sum);
+  return t;
+#else
+  return 0;
+#endif
+}
+
+/* sum or dot product of ints: the Int loop overflows rarely, and then
+   we do it again with big integers. Returns 0 if there are no big
+   integers, and TermNil if there is no space for the result. */
+static Term SumInts(const Int *a, const Int *b, Int n USES_REGS) {
+  Int i, sum = 0, x;
+
+  for (i = 0; i < n; i++) {
+    if (b) {
+      if (__builtin_mul_overflow(a[i], b[i], &x))
+        break;
+    } else {
+      x = a[i];
+    }
+    if (__builtin_add_overflow(sum, x, &sum))
+      break;
+  }
+  if (i == n)
+    return MkIntegerTerm(sum);
+  return BigSumInts(a, b, n);
+}
+
+/* report why SumInts gave no sum, once the arrays are unlocked */
+static bool BadSum(Term t, const char *caller) {
+  if (t == 0) {
+    Yap_Error(EVALUATION_ERROR_INT_OVERFLOW, TermNil, caller);
+    return true;
+  }
+  if (t == TermNil) {
+    Yap_Error(RESOURCE_ERROR_STACK, TermNil, caller);
+    return true;
+  }
+  return false;
+}
+
+static Float SumFloats(const Float *v, Int n) {
+  Float acc[BULK_LANES] = {0.0, 0.0, 0.0, 0.0};
+  Int i, l;
+
+  for (i = 0; i + BULK_LANES <= n; i += BULK_LANES)
+    for (l = 0; l < BULK_LANES; l++)
+      acc[l] += v[i + l];
+  for (; i < n; i++)
+    acc[0] += v[i];
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+static Float DotFloats(const Float *a, const Float *b, Int n) {
+  Float acc[BULK_LANES] = {0.0, 0.0, 0.0, 0.0};
+  Int i, l;
+
+  for (i = 0; i + BULK_LANES <= n; i += BULK_LANES)
+    for (l = 0; l < BULK_LANES; l++)
+      acc[l] += a[i + l] * b[i + l];
+  for (; i < n; i++)
+    acc[0] += a[i] * b[i];
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/** @pred  static_array_fill(+ _Name_, + _Value_)
+
+Set every element of the static array  _Name_ of `int` or `float`
+to  _Value_.
+*/
+static Int static_array_fill(USES_REGS1) {
+  StaticArrayEntry *ptr = GetNumericArray(Deref(ARG1), "static_array_fill/2");
+  Float f;
+  Int i, n, v;
+  bool is_int;
+
+  if (!ptr ||
+      !GetArrayNumber(Deref(ARG2), &f, &v, &is_int, "static_array_fill/2"))
+    return false;
+  WRITE_LOCK(ptr->ArRWLock);
+  n = ptr->ArrayEArity;
+  if (ptr->ArrayType == array_of_ints) {
+    Int *p = ptr->ValueOfVE.ints;
+
+    if (!is_int) {
+      WRITE_UNLOCK(ptr->ArRWLock);
+      Yap_Error(TYPE_ERROR_INTEGER, Deref(ARG2), "static_array_fill/2");
+      return false;
+    }
+    for (i = 0; i < n; i++)
+      p[i] = v;
+  } else {
+    Float *p = ptr->ValueOfVE.floats;
+
+    for (i = 0; i < n; i++)
+      p[i] = f;
+  }
+  WRITE_UNLOCK(ptr->ArRWLock);
+  return true;
+}
+
+/** @pred  static_array_copy(+ _From_, + _FromIndex_, + _To_, + _ToIndex_, + _N_)
+
+Copy  _N_ elements of the static array  _From_, starting at
+ _FromIndex_, to the static array  _To_, starting at  _ToIndex_.
+The two arrays may be the same, and the slices may overlap. Both must
+have the same type, or  _From_ may be `int` and  _To_ `float`.
+*/
+static Int static_array_copy(USES_REGS1) {
+  StaticArrayEntry *from = GetNumericArray(Deref(ARG1), "static_array_copy/5");
+  StaticArrayEntry *to = GetNumericArray(Deref(ARG3), "static_array_copy/5");
+  Int fi, ti, n, i;
+
+  if (!from || !to || !GetArrayCount(Deref(ARG2), &fi, "static_array_copy/5") ||
+      !GetArrayCount(Deref(ARG4), &ti, "static_array_copy/5") ||
+      !GetArrayCount(Deref(ARG5), &n, "static_array_copy/5"))
+    return false;
+  if (from->ArrayType == array_of_doubles && to->ArrayType == array_of_ints) {
+    Yap_Error(TYPE_ERROR_ARRAY, Deref(ARG3), "static_array_copy/5");
+    return false;
+  }
+  LockArrays(from, false, to, true);
+  if (fi + n > from->ArrayEArity || ti + n > to->ArrayEArity) {
+    UnlockArrays(from, false, to, true);
+    Yap_Error(DOMAIN_ERROR_ARRAY_OVERFLOW, Deref(ARG5), "static_array_copy/5");
+    return false;
+  }
+  if (from->ArrayType == to->ArrayType) {
+    size_t sz = (to->ArrayType == array_of_ints ? sizeof(Int) : sizeof(Float));
+
+    memmove(to->ValueOfVE.chars + ti * sz, from->ValueOfVE.chars + fi * sz,
+            n * sz);
+  } else {
+    Int *src = from->ValueOfVE.ints + fi;
+    Float *dst = to->ValueOfVE.floats + ti;
+
+    for (i = 0; i < n; i++)
+      dst[i] = src[i];
+  }
+  UnlockArrays(from, false, to, true);
+  return true;
+}
+
+/** @pred  static_array_sum(+ _Name_, - _Sum_)
+
+Unify  _Sum_ with the sum of the elements of the static array
+ _Name_ of `int` or `float`.
+*/
+static Int static_array_sum(USES_REGS1) {
+  StaticArrayEntry *ptr = GetNumericArray(Deref(ARG1), "static_array_sum/2");
+  Term t;
+
+  if (!ptr)
+    return false;
+  READ_LOCK(ptr->ArRWLock);
+  if (ptr->ArrayType == array_of_ints) {
+    t = SumInts(ptr->ValueOfVE.ints, NULL, ptr->ArrayEArity PASS_REGS);
+    READ_UNLOCK(ptr->ArRWLock);
+    if (BadSum(t, "static_array_sum/2"))
+      return false;
+  } else {
+    Float sum = SumFloats(ptr->ValueOfVE.floats, ptr->ArrayEArity);
+
+    READ_UNLOCK(ptr->ArRWLock);
+    t = MkFloatTerm(sum);
+  }
+  return Yap_unify(ARG2, t);
+}
+
+/* minimum or maximum, and where it is; fails on empty arrays */
+static Int array_extreme(bool max, bool arg, const char *caller USES_REGS) {
+  StaticArrayEntry *ptr = GetNumericArray(Deref(ARG1), caller);
+  Int n, i, at = 0;
+  Term t;
+
+  if (!ptr)
+    return false;
+  READ_LOCK(ptr->ArRWLock);
+  if ((n = ptr->ArrayEArity) == 0) {
+    READ_UNLOCK(ptr->ArRWLock);
+    return false;
+  }
+  if (ptr->ArrayType == array_of_ints) {
+    Int *p = ptr->ValueOfVE.ints, best = p[0];
+
+    if (max) {
+      for (i = 1; i < n; i++)
+        best = (p[i] > best ? p[i] : best);
+    } else {
+      for (i = 1; i < n; i++)
+        best = (p[i] < best ? p[i] : best);
+    }
+    /* finding the value vectorises, finding where it is stops early */
+    if (arg)
+      while (p[at] != best)
+        at++;
+    t = MkIntegerTerm(best);
+  } else {
+    Float *p = ptr->ValueOfVE.floats, best = p[0];
+
+    if (max) {
+      for (i = 1; i < n; i++)
+        best = (p[i] > best ? p[i] : best);
+    } else {
+      for (i = 1; i < n; i++)
+        best = (p[i] < best ? p[i] : best);
+    }
+    if (arg)
+      while (at < n - 1 && p[at] != best)
+        at++;
+    t = MkFloatTerm(best);
+  }
+  READ_UNLOCK(ptr->ArRWLock);
+  if (arg)
+    return Yap_unify(ARG2, MkIntegerTerm(at));
+  return Yap_unify(ARG2, t);
+}
+
+/** @pred  static_array_max(+ _Name_, - _Max_)
+
+Unify  _Max_ with the largest element of the static array  _Name_
+of `int` or `float`. Fails if the array is empty.
+*/
+static Int static_array_max(USES_REGS1) {
+  return array_extreme(true, false, "static_array_max/2" PASS_REGS);
+}
+
+/** @pred  static_array_min(+ _Name_, - _Min_)
+
+Unify  _Min_ with the smallest element of the static array  _Name_
+of `int` or `float`. Fails if the array is empty.
+*/
+static Int static_array_min(USES_REGS1) {
+  return array_extreme(false, false, "static_array_min/2" PASS_REGS);
+}
+
+/** @pred  static_array_argmax(+ _Name_, - _Index_)
+
+Unify  _Index_ with the index of the first largest element of the
+static array  _Name_ of `int` or `float`. Fails if the array is
+empty.
+*/
+static Int static_array_argmax(USES_REGS1) {
+  return array_extreme(true, true, "static_array_argmax/2" PASS_REGS);
+}
+
+/** @pred  static_array_argmin(+ _Name_, - _Index_)
+
+Unify  _Index_ with the index of the first smallest element of the
+static array  _Name_ of `int` or `float`. Fails if the array is
+empty.
+*/
+static Int static_array_argmin(USES_REGS1) {
+  return array_extreme(false, true, "static_array_argmin/2" PASS_REGS);
+}
+
+/** @pred  static_array_dot(+ _Name1_, + _Name2_, - _Dot_)
+
+Unify  _Dot_ with the dot product of the static arrays  _Name1_ and
+ _Name2_, which must have the same size. The result is an integer if
+both arrays are of `int`, and a float otherwise.
+*/
+static Int static_array_dot(USES_REGS1) {
+  StaticArrayEntry *a = GetNumericArray(Deref(ARG1), "static_array_dot/3");
+  StaticArrayEntry *b = GetNumericArray(Deref(ARG2), "static_array_dot/3");
+  Int n, i;
+  Term t;
+
+  if (!a || !b)
+    return false;
+  LockArrays(a, false, b, false);
+  if ((n = a->ArrayEArity) != b->ArrayEArity) {
+    UnlockArrays(a, false, b, false);
+    Yap_Error(DOMAIN_ERROR_ARRAY_OVERFLOW, Deref(ARG2), "static_array_dot/3");
+    return false;
+  }
+  if (a->ArrayType == array_of_ints && b->ArrayType == array_of_ints) {
+    t = SumInts(a->ValueOfVE.ints, b->ValueOfVE.ints, n PASS_REGS);
+  } else if (a->ArrayType == array_of_doubles &&
+             b->ArrayType == array_of_doubles) {
+    t = MkFloatTerm(DotFloats(a->ValueOfVE.floats, b->ValueOfVE.floats, n));
+  } else {
+    Int *pi;
+    Float *pf, sum = 0.0;
+
+    if (a->ArrayType == array_of_ints) {
+      pi = a->ValueOfVE.ints;
+      pf = b->ValueOfVE.floats;
+    } else {
+      pi = b->ValueOfVE.ints;
+      pf = a->ValueOfVE.floats;
+    }
+    for (i = 0; i < n; i++)
+      sum += pi[i] * pf[i];
+    t = MkFloatTerm(sum);
+  }
+  UnlockArrays(a, false, b, false);
+  if (BadSum(t, "static_array_dot/3"))
+    return false;
+  return Yap_unify(ARG3, t);
+}
+
+/** @pred  static_array_histogram(+ _Name_, + _Min_, + _Max_, + _Hist_)
+
+Count the elements of the static array  _Name_ into the bins of the
+static array  _Hist_ of `int`. The interval [ _Min_, _Max_) is split
+into as many bins of the same width as there are elements in
+ _Hist_; elements outside the interval are not counted. The previous
+contents of  _Hist_ are discarded.
+*/
+static Int static_array_histogram(USES_REGS1) {
+  StaticArrayEntry *ptr =
+      GetNumericArray(Deref(ARG1), "static_array_histogram/4");
+  StaticArrayEntry *hist =
+      GetNumericArray(Deref(ARG4), "static_array_histogram/4");
+  Float lo, hi, scale;
+  Int ilo, ihi, n, nbins, i, *h;
+  bool lo_int, hi_int;
+
+  if (!ptr || !hist ||
+      !GetArrayNumber(Deref(ARG2), &lo, &ilo, &lo_int,
+                      "static_array_histogram/4") ||
+      !GetArrayNumber(Deref(ARG3), &hi, &ihi, &hi_int,
+                      "static_array_histogram/4"))
+    return false;
+  if (hist->ArrayType != array_of_ints || hist == ptr) {
+    Yap_Error(TYPE_ERROR_ARRAY, Deref(ARG4), "static_array_histogram/4");
+    return false;
+  }
+  if (hi <= lo) {
+    Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, Deref(ARG3),
+              "static_array_histogram/4");
+    return false;
+  }
+  LockArrays(ptr, false, hist, true);
+  n = ptr->ArrayEArity;
+  nbins = hist->ArrayEArity;
+  h = hist->ValueOfVE.ints;
+  for (i = 0; i < nbins; i++)
+    h[i] = 0;
+  if (ptr->ArrayType == array_of_ints && lo_int && hi_int &&
+      ihi - ilo == nbins) {
+    /* one bin per integer, the common case for counters */
+    Int *p = ptr->ValueOfVE.ints;
+
+    for (i = 0; i < n; i++) {
+      UInt b = (UInt)(p[i] - ilo);
+      if (b < (UInt)nbins)
+        h[b]++;
+    }
+  } else if (ptr->ArrayType == array_of_ints) {
+    Int *p = ptr->ValueOfVE.ints;
+
+    scale = nbins / (hi - lo);
+    for (i = 0; i < n; i++) {
+      if (p[i] >= lo && p[i] < hi) {
+        Int b = (Int)((p[i] - lo) * scale);
+        h[b < nbins ? b : nbins - 1]++;
+      }
+    }
+  } else {
+    Float *p = ptr->ValueOfVE.floats;
+
+    scale = nbins / (hi - lo);
+    for (i = 0; i < n; i++) {
+      if (p[i] >= lo && p[i] < hi) {
+        Int b = (Int)((p[i] - lo) * scale);
+        h[b < nbins ? b : nbins - 1]++;
+      }
+    }
+  }
+  UnlockArrays(ptr, false, hist, true);
+  return true;
+}
+
+/** @pred  static_array_prefix_sum(+ _Name_)
+
+Replace every element of the static array  _Name_ of `int` or
+`float` by the sum of itself and all elements before it.
+*/
+static Int static_array_prefix_sum(USES_REGS1) {
+  StaticArrayEntry *ptr =
+      GetNumericArray(Deref(ARG1), "static_array_prefix_sum/1");
+  Int n, i;
+
+  if (!ptr)
+    return false;
+  WRITE_LOCK(ptr->ArRWLock);
+  n = ptr->ArrayEArity;
+  if (ptr->ArrayType == array_of_ints) {
+    Int *p = ptr->ValueOfVE.ints;
+
+    for (i = 1; i < n; i++)
+      p[i] += p[i - 1];
+  } else {
+    Float *p = ptr->ValueOfVE.floats;
+
+    for (i = 1; i < n; i++)
+      p[i] += p[i - 1];
+  }
+  WRITE_UNLOCK(ptr->ArRWLock);
+  return true;
+}
+
 static Int compile_array_refs(USES_REGS1) {
   compile_arrays = TRUE;
   return (TRUE);
@@ -2606,6 +3164,18 @@ void Yap_InitArrayPreds(void) {
                 SafePredFlag);
   Yap_InitCPred("static_array_to_term", 2, static_array_to_term, 0L);
   Yap_InitCPred("static_array_location", 2, static_array_location, 0L);
+  Yap_InitCPred("static_array_fill", 2, static_array_fill, SafePredFlag);
+  Yap_InitCPred("static_array_copy", 5, static_array_copy, SafePredFlag);
+  Yap_InitCPred("static_array_sum", 2, static_array_sum, SafePredFlag);
+  Yap_InitCPred("static_array_max", 2, static_array_max, SafePredFlag);
+  Yap_InitCPred("static_array_min", 2, static_array_min, SafePredFlag);
+  Yap_InitCPred("static_array_argmax", 2, static_array_argmax, SafePredFlag);
+  Yap_InitCPred("static_array_argmin", 2, static_array_argmin, SafePredFlag);
+  Yap_InitCPred("static_array_dot", 3, static_array_dot, SafePredFlag);
+  Yap_InitCPred("static_array_histogram", 4, static_array_histogram,
+                SafePredFlag);
+  Yap_InitCPred("static_array_prefix_sum", 1, static_array_prefix_sum,
+                SafePredFlag);
 }
 
 /**
@@ -39,6 +39,9 @@ static char SccsId[] = "%W% %G%";
  */
 
 #define HAS_CACHE_REGS 1
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 /*
  * This file includes the definition of a miscellania of standard operations
  * for yap refering to sequences of characters conversions.
@@ -1332,7 +1335,7 @@ restart_aux:
   if (*tailp != TermNil) {
     LOCAL_Error_TYPE = TYPE_ERROR_LIST;
   } else {
-    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t)), out;
+    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t) PASS_REGS), out;
     int i = 0;
     Atom at;
 
@@ -1381,8 +1384,8 @@ restart_aux:
   if (*tailp != TermNil) {
     LOCAL_Error_TYPE = TYPE_ERROR_LIST;
   } else {
-    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t));
-    seq_tv_t *out = (seq_tv_t *)Malloc(sizeof(seq_tv_t));
+    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t) PASS_REGS);
+    seq_tv_t *out = (seq_tv_t *)Malloc(sizeof(seq_tv_t) PASS_REGS);
     int i = 0;
     if (!inpv) {
       LOCAL_Error_TYPE = RESOURCE_ERROR_HEAP;
@@ -1440,8 +1443,8 @@ restart_aux:
       pop_text_stack(l);
       return rc;
     }
-    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t));
-    seq_tv_t *out = (seq_tv_t *)Malloc(sizeof(seq_tv_t));
+    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t) PASS_REGS);
+    seq_tv_t *out = (seq_tv_t *)Malloc(sizeof(seq_tv_t) PASS_REGS);
     if (!inpv) {
       LOCAL_Error_TYPE = RESOURCE_ERROR_HEAP;
       goto error;
@@ -1487,7 +1490,7 @@ restart_aux:
   if (*tailp != TermNil) {
     LOCAL_Error_TYPE = TYPE_ERROR_LIST;
   } else {
-    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t)), out;
+    seq_tv_t *inpv = (seq_tv_t *)Malloc(n * sizeof(seq_tv_t) PASS_REGS), out;
     int i = 0;
     Atom at;
 
@@ -1537,7 +1540,7 @@ restart_aux:
   if (*tailp != TermNil) {
     LOCAL_Error_TYPE = TYPE_ERROR_LIST;
   } else {
-    seq_tv_t *inpv = (seq_tv_t *)Malloc((n * 2 - 1) * sizeof(seq_tv_t)), out;
+    seq_tv_t *inpv = (seq_tv_t *)Malloc((n * 2 - 1) * sizeof(seq_tv_t) PASS_REGS), out;
     int i = 0;
     Atom at;
 
@@ -1758,7 +1761,7 @@ static Int downcase_text_to_atom(USES_REGS1) {
     }
   }
   while (true) {
-    Atom at = Yap_AtomicToLowAtom(t1);
+    Atom at = Yap_AtomicToLowAtom(t1 PASS_REGS);
     if (at == NULL) {
       if (LOCAL_Error_TYPE && Yap_HandleError("downcase_text_to_atom/2"))
         continue;
@@ -1804,7 +1807,7 @@ static Int upcase_text_to_atom(USES_REGS1) {
     }
   }
   while (true) {
-    Atom at = Yap_AtomicToUpAtom(t1);
+    Atom at = Yap_AtomicToUpAtom(t1 PASS_REGS);
     if (at == NULL) {
       if (LOCAL_Error_TYPE && Yap_HandleError("upcase_text_to_atom/2"))
         continue;
@@ -1844,7 +1847,7 @@ static Int downcase_text_to_string(USES_REGS1) {
       return (FALSE);
     }
     while (true) {
-      Term t = Yap_AtomicToLowString(t1);
+      Term t = Yap_AtomicToLowString(t1 PASS_REGS);
       if (t == TermZERO) {
         if (LOCAL_Error_TYPE && Yap_HandleError("downcase_text_to_string/2"))
           continue;
@@ -1881,7 +1884,7 @@ static Int upcase_text_to_string(USES_REGS1) {
   }
   int l = push_text_stack();
   while (true) {
-    Term t = Yap_AtomicToUpString(t1);
+    Term t = Yap_AtomicToUpString(t1 PASS_REGS);
 
     if (t == TermZERO) {
       if (LOCAL_Error_TYPE && Yap_HandleError("upcase_text_to_string/2"))
@@ -1922,7 +1925,7 @@ static Int downcase_text_to_codes(USES_REGS1) {
   }
   int l = push_text_stack();
   while (true) {
-    Term t = Yap_AtomicToLowListOfCodes(t1);
+    Term t = Yap_AtomicToLowListOfCodes(t1 PASS_REGS);
     if (t == TermZERO) {
       if (LOCAL_Error_TYPE && Yap_HandleError("downcase_text_to_codes/2"))
         continue;
@@ -1960,7 +1963,7 @@ static Int upcase_text_to_codes(USES_REGS1) {
   }
   int l = push_text_stack();
   while (true) {
-    Term t = Yap_AtomicToUpListOfCodes(t1);
+    Term t = Yap_AtomicToUpListOfCodes(t1 PASS_REGS);
     if (t == TermZERO) {
       if (LOCAL_Error_TYPE && Yap_HandleError("upcase_text_to_codes/2"))
         continue;
@@ -1998,7 +2001,7 @@ static Int downcase_text_to_chars(USES_REGS1) {
   }
   int l = push_text_stack();
   while (true) {
-    Term t = Yap_AtomicToLowListOfAtoms(t1);
+    Term t = Yap_AtomicToLowListOfAtoms(t1 PASS_REGS);
 
     if (t == TermZERO) {
       if (LOCAL_Error_TYPE && Yap_HandleError("downcase_text_to_to_chars/2"))
@@ -2037,7 +2040,7 @@ static Int upcase_text_to_chars(USES_REGS1) {
   }
   int l = push_text_stack();
   while (true) {
-    Term t = Yap_AtomicToUpListOfAtoms(t1);
+    Term t = Yap_AtomicToUpListOfAtoms(t1 PASS_REGS);
     if (t == TermZERO) {
       if (LOCAL_Error_TYPE && Yap_HandleError("upcase_text_to_chars/2"))
         continue;
@@ -2088,7 +2091,7 @@ static Int atom_split(USES_REGS1) {
     return false;
   }
   size_t b_mid = skip_utf8(s0, u_mid) - s0;
-  s1 = s10 = Malloc(b_mid + 1);
+  s1 = s10 = Malloc(b_mid + 1 PASS_REGS);
   memmove(s1, s, b_mid);
   s1[b_mid] = '\0';
   to1 = MkAtomTerm(Yap_ULookupAtom(s10));
@@ -2187,39 +2190,60 @@ restart_aux:
 
 static Term build_new_atomic(int mask, const unsigned char *p, size_t minv,
                              size_t len USES_REGS) {
-  int n;
-  seq_tv_t outv[5], inp;
-  size_t cuts[3];
-  if (minv) {
-    cuts[0] = minv;
-    cuts[1] = minv + len;
-    cuts[2] = 0;
-    outv[0].type = 0;
-    n = 1;
-  } else {
-    cuts[0] = minv + len;
-    cuts[1] = 0;
-    n = 0;
-  }
-  inp.type = YAP_STRING_CHARS;
-  inp.enc = ENC_ISO_UTF8;
-  inp.val.uc0 = p;
-  outv[n + 1].type = 0;
-  if (mask & SUB_ATOM_HAS_ATOM) {
-    outv[n].type = YAP_STRING_ATOM;
-  } else {
-    outv[n].type = YAP_STRING_STRING;
-  }
+  /* cut the bytes straight out of the atom or string */
+  const unsigned char *s = skip_utf8(p, minv);
+  size_t nb = skip_utf8(s, len) - s;
+  unsigned char *buf;
+  seq_tv_t out;
+  Term t;
+
   int l = push_text_stack();
-  bool rc = Yap_Splice_Text(2 + n, cuts, &inp, outv PASS_REGS);
-  pop_text_stack(l);
-  if (!rc) {
-    return (false);
-  }
+  buf = Malloc(nb + 1 PASS_REGS);
+  memcpy(buf, s, nb);
+  buf[nb] = '\0';
   if (mask & SUB_ATOM_HAS_ATOM) {
-    return (MkAtomTerm(outv[n].val.a));
+    Atom at = Yap_ULookupAtom(buf);
+    pop_text_stack(l);
+    return at ? MkAtomTerm(at) : 0;
   }
-  return (outv[n].val.t);
+  out.type = YAP_STRING_STRING;
+  out.val.t = 0;
+  out.max = 0;
+  t = write_Text(buf, &out PASS_REGS) ? out.val.t : 0;
+  pop_text_stack(l);
+  return t;
+}
+
+/* where the text of needle, nb bytes long, first occurs in the hb bytes at
+   hay. Both are UTF-8, so a match always starts at a character. */
+static const unsigned char *search_sub_text(const unsigned char *hay,
+                                            size_t hb,
+                                            const unsigned char *needle,
+                                            size_t nb) {
+#if HAVE_MEMMEM
+  return memmem(hay, hb, needle, nb);
+#else
+  const unsigned char *end = hay + hb;
+
+  if (nb == 0)
+    return hay;
+  while ((size_t)(end - hay) >= nb) {
+    hay = memchr(hay, needle[0], (end - hay) - nb + 1);
+    if (hay == NULL || memcmp(hay + 1, needle + 1, nb - 1) == 0)
+      return hay;
+    hay++;
+  }
+  return NULL;
+#endif
+}
+
+/* the number of characters in the nb bytes at s */
+static size_t utf8_chars(const unsigned char *s, size_t nb) {
+  size_t n = 0;
+
+  while (nb--)
+    n += ((*s++ & 0xC0) != 0x80);
+  return n;
 }
 
 static bool check_sub_string_at(int minv, const unsigned char *p1,
@@ -2276,40 +2300,25 @@ static Int cont_sub_atomic(USES_REGS1) {
   }
   /* we can have one of two cases: A5 bound or unbound */
   if (mask & SUB_ATOM_HAS_VAL) {
-    bool found = false;
-    {
-      const unsigned char *p1 = p;
-
-      while (!found) {
-        p = skip_utf8(p1, minv);
-        if (cmpn_utf8(p, p5, len) == 0) {
-          Yap_unify(ARG2, MkIntegerTerm(minv));
-          Yap_unify(ARG3, MkIntegerTerm(len));
-          Yap_unify(ARG4, MkIntegerTerm(after));
-          found = true;
-          /* found one, check if there is any left */
-          while (minv <= sz - len) {
-            int chr;
-            p += get_utf8((unsigned char *)p, -1, &chr);
-            after--;
-            minv++;
-            if (cmpn_utf8(p, p5, len) == 0)
-              break;
-          }
-        } else {
-          if (minv == sz - len)
-            break;
-          after--;
-          minv++;
-        }
-      }
-    }
-    if (found) {
-      if (minv > sz - len)
-        cut_succeed();
-    } else {
+    /* minv is where the next match starts, searching from there */
+    const unsigned char *p0 = skip_utf8(p, minv), *q, *q1;
+    size_t hb = strlen((const char *)p0), nb = strlen((const char *)p5);
+    utf8proc_int32_t chr;
+
+    if ((q = search_sub_text(p0, hb, p5, nb)) == NULL)
       cut_fail();
-    }
+    minv += utf8_chars(p0, q - p0);
+    after = sz - (minv + len);
+    Yap_unify(ARG2, MkIntegerTerm(minv));
+    Yap_unify(ARG3, MkIntegerTerm(len));
+    Yap_unify(ARG4, MkIntegerTerm(after));
+    /* found one, check if there is any left */
+    if (q[0] == '\0')
+      cut_succeed();
+    q1 = q + get_utf8(q, -1, &chr);
+    if ((q = search_sub_text(q1, hb - (q1 - p0), p5, nb)) == NULL)
+      cut_succeed();
+    minv += 1 + utf8_chars(q1, q - q1);
   } else if (mask & SUB_ATOM_HAS_SIZE) {
     Term nat = build_new_atomic(mask, p, minv, len PASS_REGS);
     if (nat == 0)
@@ -2389,7 +2398,7 @@ static Int sub_atomic(bool sub_atom, bool sub_string USES_REGS) {
     if (sub_atom) {
       if (IsAtomTerm(tat1)) {
         p = AtomOfTerm(tat1)->UStrOfAE;
-        sz = strlen_utf8(p);
+        sz = Yap_AtomCharLength(AtomOfTerm(tat1) PASS_REGS);
       } else {
         Yap_Error(TYPE_ERROR_ATOM, tat1, "sub_atom/5");
         { return false; }
@@ -2470,7 +2479,7 @@ static Int sub_atomic(bool sub_atom, bool sub_string USES_REGS) {
         Atom oat;
         mask |= SUB_ATOM_HAS_VAL | SUB_ATOM_HAS_SIZE;
         oat = AtomOfTerm(tout);
-        len = strlen_utf8(RepAtom(oat)->UStrOfAE);
+        len = Yap_AtomCharLength(oat PASS_REGS);
       }
     } else {
       if (!IsStringTerm(tout)) {
@@ -2571,29 +2580,13 @@ static Int sub_atomic(bool sub_atom, bool sub_string USES_REGS) {
                     Yap_unify(ARG5, nat));
     } else if ((mask & (SUB_ATOM_HAS_SIZE | SUB_ATOM_HAS_VAL)) ==
                (SUB_ATOM_HAS_SIZE | SUB_ATOM_HAS_VAL)) {
-      if (!sub_atom) {
-        out = (strlen_utf8(UStringOfTerm(tout)) == len);
-        if (!out) {
-          cut_fail();
-        }
-      } else {
-        out = (strlen(RepAtom(AtomOfTerm(tout))->StrOfAE) == len);
-        if (!out) {
-          cut_fail();
-        }
-        if (len == sz) {
-          out = out && Yap_unify(ARG1, ARG5) &&
-                Yap_unify(ARG2, MkIntegerTerm(0)) &&
-                Yap_unify(ARG4, MkIntegerTerm(0));
-        } else if (len > sz) {
-          cut_fail();
-        } else {
-          mask |= SUB_ATOM_HAS_SIZE;
-          minv = 0;
-          after = sz - len;
-          goto backtrackable;
-        }
+      /* len is the length of Sub, search for it */
+      if (len > sz) {
+        cut_fail();
       }
+      minv = 0;
+      after = sz - len;
+      goto backtrackable;
     }
     if (out) {
       cut_succeed();
@@ -55,10 +55,9 @@ Term Yap_MkBigIntTerm(MP_INT *big) {
     long int out = mpz_get_si(big);
     return MkIntegerTerm((Int)out);
   }
-  //  bytes = big->_mp_alloc * sizeof(mp_limb_t);
-  //  nlimbs = ALIGN_YAPTYPE(bytes,CELL)/CellSize;
-  // this works, but it shouldn't need to do this...
-  nlimbs = big->_mp_alloc;
+  /* only copy the limbs in use: big may be a scratch number that
+     once held something much larger */
+  nlimbs = mpz_size(big);
   bytes = nlimbs * sizeof(CELL);
   if (nlimbs > (ASP - ret) - 1024) {
     return TermNil;
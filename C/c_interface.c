@@ -468,10 +468,11 @@ X_API const char *YAP_AtomName(YAP_Atom a) {
 }
 
 X_API const wchar_t *YAP_WideAtomName(YAP_Atom a) {
+  CACHE_REGS
   int32_t v;
   const unsigned char *s = RepAtom(a)->UStrOfAE;
   size_t n = strlen_utf8(s);
-  wchar_t *dest = Malloc((n + 1) * sizeof(wchar_t)), *o = dest;
+  wchar_t *dest = Malloc((n + 1) * sizeof(wchar_t) PASS_REGS), *o = dest;
   while (*s) {
     size_t n = get_utf8(s, 1, &v);
     if (n == 0)
@@ -505,7 +506,7 @@ X_API YAP_Atom YAP_LookupWideAtom(const wchar_t *c) {
   Atom a;
 
   while (TRUE) {
-    a = Yap_NWCharsToAtom(c, -1 USES_REGS);
+    a = Yap_NWCharsToAtom(c, -1 PASS_REGS);
     if (a == NIL || Yap_get_signal(YAP_CDOVF_SIGNAL)) {
       if (!Yap_locked_growheap(FALSE, 0, NULL)) {
         Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "YAP failed to grow heap: %s",
@@ -1916,6 +1917,7 @@ X_API YAP_opaque_tag_t YAP_NewOpaqueType(struct YAP_opaque_handler_struct *f) {
 }
 
 X_API Term YAP_NewOpaqueObject(YAP_opaque_tag_t blob_tag, size_t bytes) {
+  CACHE_REGS
   CELL *pt;
   Term t = Yap_AllocExternalDataInStack((CELL)blob_tag, bytes, &pt);
   if (t == TermNil)
@@ -2114,7 +2116,7 @@ X_API bool YAP_GoalHasException(Term *t) {
 X_API void YAP_ClearExceptions(void) {
   CACHE_REGS
 
-  Yap_ResetException(worker_id);
+  Yap_ResetException(LOCAL_ActiveError);
 }
 
 X_API int YAP_InitConsult(int mode, const char *fname, char **full,
@@ -2139,7 +2141,7 @@ int   lvl = push_text_stack();
   }
     __android_log_print(
             ANDROID_LOG_INFO, "YAPDroid", "done init_ consult %s ",fl);
-  char *d = Malloc(strlen(fl) + 1);
+  char *d = Malloc(strlen(fl) + 1 PASS_REGS);
   strcpy(d, fl);
   bool consulted = (mode == YAP_CONSULT_MODE);
   Term tat = MkAtomTerm(Yap_LookupAtom(d));
@@ -2153,7 +2155,7 @@ int   lvl = push_text_stack();
     return -1;
   }
   LOCAL_PrologMode = UserMode;
-*full = pop_output_text_stack__(lvl, fl);
+*full = pop_output_text_stack__(lvl, fl PASS_REGS);
   Yap_init_consult(consulted,*full);
   RECOVER_MACHINE_REGS();
   UNLOCK(GLOBAL_Stream[sno].streamlock);
@@ -2179,10 +2181,11 @@ X_API FILE *YAP_TermToStream(Term t) {
 }
 
 X_API void YAP_EndConsult(int sno, int *osnop, const char *full) {
+  CACHE_REGS
   BACKUP_MACHINE_REGS();
   Yap_CloseStream(sno);
   int lvl = push_text_stack();
-  char *d = Malloc(strlen(full) + 1);
+  char *d = Malloc(strlen(full) + 1 PASS_REGS);
   strcpy(d, full);
   Yap_ChDir(dirname(d));
   if (osnop >= 0)
@@ -2210,6 +2213,7 @@ X_API Term YAP_Read(FILE *f) {
 }
 
 X_API Term YAP_ReadFromStream(int sno) {
+  CACHE_REGS
   Term o;
 
   BACKUP_MACHINE_REGS();
@@ -2227,6 +2231,7 @@ X_API Term YAP_ReadFromStream(int sno) {
 }
 
 X_API Term YAP_ReadClauseFromStream(int sno, Term vs, Term pos) {
+  CACHE_REGS
 
   BACKUP_MACHINE_REGS();
   Term t = Yap_read_term(
@@ -2400,6 +2405,7 @@ X_API void YAP_FlushAllStreams(void) {
 }
 
 X_API void YAP_Throw(Term t) {
+  CACHE_REGS
   BACKUP_MACHINE_REGS();
   LOCAL_ActiveError->errorNo = THROW_EVENT;
   LOCAL_ActiveError->errorGoal = Yap_TermToBuffer(t, 0);
@@ -3184,7 +3190,10 @@ X_API void *YAP_foreign_stream(int sno) {
 
 X_API YAP_Functor YAP_IntToFunctor(Int i) { return TR_Functors[i]; }
 
-X_API void *YAP_shared(void) { return LOCAL_shared; }
+X_API void *YAP_shared(void) {
+  CACHE_REGS
+  return LOCAL_shared;
+}
 
 X_API YAP_PredEntryPtr YAP_TopGoal(void) {
   Functor f = Yap_MkFunctor(Yap_LookupAtom("yap_query"), 3);
@@ -49,6 +49,8 @@ static int not_was_reconsulted(PredEntry *, Term, int);
 static int RemoveIndexation(PredEntry *);
 static Int number_of_clauses(USES_REGS1);
 static Int p_compile(USES_REGS1);
+static Int p_assertz_facts(USES_REGS1);
+static Int p_index_all_preds(USES_REGS1);
 static Int p_purge_clauses(USES_REGS1);
 static Int p_setspy(USES_REGS1);
 static Int p_rmspy(USES_REGS1);
@@ -289,6 +291,38 @@ void Yap_IPred(PredEntry *p, UInt NSlots, yamop *next_pc) {
   IPred(p, NSlots, next_pc);
 }
 
+/*
+  '$index_all_preds': build the main index of every static predicate
+  that does not have one yet, as if it had been called with all
+  arguments unbound. Used before forking, so that workers share the
+  indices instead of building their own.
+*/
+static Int p_index_all_preds(USES_REGS1) {
+  ModEntry *me;
+
+  for (me = CurrentModules; me; me = me->NextME) {
+    PredEntry *pe;
+
+    for (pe = me->PredForME; pe; pe = pe->NextPredOfModule) {
+      arity_t i;
+
+      PELOCK(91, pe);
+      if (pe->OpcodeOfPred != INDEX_OPCODE ||
+          pe->PredFlags & (IndexedPredFlag | LogUpdatePredFlag |
+                           DynamicPredFlag | CPredFlag | UDIPredFlag) ||
+          pe->cs.p_code.NOfClauses < 2 || pe->ModuleOfPred == IDB_MODULE) {
+        UNLOCKPE(91, pe);
+        continue;
+      }
+      for (i = 1; i <= pe->ArityOfPE; i++)
+        XREGS[i] = (CELL)(XREGS + i);
+      IPred(pe, 0, CP);
+      UNLOCKPE(91, pe);
+    }
+  }
+  return true;
+}
+
 #define GONEXT(TYPE) code_p = ((yamop *)(&(code_p->y_u.TYPE.next)))
 
 static void RemoveMainIndex(PredEntry *ap) {
@@ -935,6 +969,7 @@ static void add_first_static(PredEntry *p, yamop *cp, int spy_flag) {
 
 /* p is already locked */
 static void add_first_dynamic(PredEntry *p, yamop *cp, int spy_flag) {
+  CACHE_REGS
   yamop *ncp = ((DynamicClause *)NULL)->ClCode;
   DynamicClause *cl;
 
@@ -1680,6 +1715,8 @@ bool Yap_addclause(Term t, yamop *cp, Term tmode, Term mod, Term *t4ref)
     }
 #endif
   }
+  /* single clause static predicates may go native */
+  Yap_NativeWatch(p);
   UNLOCKPE(32, p);
   if (pflags & LogUpdatePredFlag) {
     LogUpdClause *cl = (LogUpdClause *)ClauseCodeToLogUpdClause(cp);
@@ -1849,10 +1886,15 @@ static Int p_compile(USES_REGS1) { /* '$compile'(+C,+Flags,+C0,-Ref) */
     if (mode == assertz && LOCAL_consult_level && mod == CurrentModule)
       mode = consult;
   */
-  code_adr = Yap_cclause(t, 5, mod, Deref(ARG3)); /* vsc: give the number of
-                               arguments to cclause() in case there is a
-                               overflow */
-  t = Deref(ARG1); /* just in case there was an heap overflow */
+  /* ground facts for logical update predicates skip the compiler */
+  if ((code_adr = Yap_assemble_fact(t, mod))) {
+    LOCAL_ErrorMessage = NULL;
+  } else {
+    code_adr = Yap_cclause(t, 5, mod, Deref(ARG3)); /* vsc: give the number of
+                                 arguments to cclause() in case there is a
+                                 overflow */
+    t = Deref(ARG1); /* just in case there was an heap overflow */
+  }
   if (!LOCAL_ErrorMessage) {
     YAPEnterCriticalSection();
     Yap_addclause(t, code_adr, t1, mod, &ARG5);
@@ -1866,6 +1908,59 @@ static Int p_compile(USES_REGS1) { /* '$compile'(+C,+Flags,+C0,-Ref) */
   return true;
 }
 
+/*
+ * '$assertz_facts'(+L, +Mod, -Rest): add the leading ground facts in L
+ * for logical update predicates, in order, and return what is left to
+ * the Prolog code. Instead of updating the indices for every new
+ * clause, we drop them once per run of facts for the same predicate.
+ */
+static Int p_assertz_facts(USES_REGS1) {
+  Term l = Deref(ARG1);
+  Term mod0 = Deref(ARG2);
+  PredEntry *last = NULL;
+
+  if (IsVarTerm(mod0) || !IsAtomTerm(mod0))
+    return false;
+  while (IsPairTerm(l)) {
+    Term mod = mod0, t, head;
+    yamop *code_adr;
+    PredEntry *ap;
+
+    t = Yap_YapStripModule(HeadOfTerm(l), &mod);
+    if (IsVarTerm(t) || IsVarTerm(mod) || !IsAtomTerm(mod))
+      break;
+    /* every new clause is trailed */
+    if ((ADDR)TR >= LOCAL_TrailTop - 1024 &&
+        !Yap_growtrail(K64, false)) {
+      Yap_Error(RESOURCE_ERROR_TRAIL, TermNil, LOCAL_ErrorMessage);
+      return false;
+    }
+    if (!(code_adr = Yap_assemble_fact(t, mod)))
+      break;
+    head = t;
+    if (IsApplTerm(t) && FunctorOfTerm(t) == FunctorAssert)
+      head = Deref(ArgOfTerm(1, t));
+    ap = RepPredProp(PredPropByFunc(FunctorOfTerm(head), mod));
+    if (ap != last) {
+      PELOCK(88, ap);
+      if (ap->PredFlags & IndexedPredFlag)
+        RemoveIndexation(ap);
+      UNLOCKPE(88, ap);
+      last = ap;
+    }
+    LOCAL_ErrorMessage = NULL;
+    YAPEnterCriticalSection();
+    Yap_addclause(t, code_adr, TermAssertz, mod, NULL);
+    YAPLeaveCriticalSection();
+    if (LOCAL_ErrorMessage) {
+      Yap_Error(LOCAL_Error_TYPE, t, LOCAL_ErrorMessage);
+      return false;
+    }
+    l = Deref(TailOfTerm(l));
+  }
+  return Yap_unify(ARG3, l);
+}
+
 Atom Yap_ConsultingFile(USES_REGS1) {
   int sno;
   if ((sno = Yap_CheckAlias(AtomLoopStream)) >= 0) {
@@ -2885,6 +2980,7 @@ static Int p_clean_up_dead_clauses(USES_REGS1) {
 }
 
 void Yap_HidePred(PredEntry *pe) {
+  CACHE_REGS
 
   if (pe->PredFlags & HiddenPredFlag)
     return;
@@ -3258,6 +3354,10 @@ p_log_update_clause_erase(USES_REGS1) {
   pe = Yap_get_pred(t1, Deref(ARG2), "clause/3");
   if (pe == NULL || EndOfPAEntr(pe))
     return FALSE;
+  /* like a call to a logical update predicate, retract holds no
+     uncounted pointers to clauses */
+  if (LOCAL_LUEpoch != GLOBAL_LUEpoch)
+    Yap_LUSeenEpoch();
   PELOCK(43, pe);
   ret = fetch_next_lu_clause_erase(pe, pe->CodeOfPred, t1, ARG3, ARG4, new_cp,
                                    TRUE);
@@ -4287,6 +4387,8 @@ void Yap_InitCdMgr(void) {
         now unsafe */
   Yap_InitCPred("$predicate_flags", 4, predicate_flags, SyncPredFlag| NoTracePredFlag);
   Yap_InitCPred("$compile", 5, p_compile, SyncPredFlag| NoTracePredFlag);
+  Yap_InitCPred("$assertz_facts", 3, p_assertz_facts, SyncPredFlag);
+  Yap_InitCPred("$index_all_preds", 0, p_index_all_preds, SyncPredFlag);
   Yap_InitCPred("$purge_clauses", 2, p_purge_clauses,
                 SafePredFlag | SyncPredFlag| NoTracePredFlag);
   Yap_InitCPred("$is_dynamic", 2, p_is_dynamic, TestPredFlag | SafePredFlag| NoTracePredFlag);
@@ -223,6 +223,7 @@ ructions                                       *
         save_pc();
         ENV_YREG[E_CB] = d0;
         ENDD(d0);
+        alloc_profile(pt0, true);
 #ifdef DEPTH_LIMIT
         if (DEPTH <= MkIntTerm(1)) {/* I assume Module==0 is prolog */
           if (pt0->ModuleOfPred) {
@@ -281,6 +282,7 @@ ructions                                       *
         PREG = pt0->CodeOfPred;
         /* for profiler */
         save_pc();
+        alloc_profile(pt0, true);
         ALWAYS_LOOKAHEAD(pt0->OpcodeOfPred);
         /* do deallocate */
         CPREG = (yamop *) ENV_YREG[E_CP];
@@ -354,6 +356,7 @@ ructions                                       *
         PREG = pt->CodeOfPred;
         /* for profiler */
         save_pc();
+        alloc_profile(pt, true);
 #ifdef DEPTH_LIMIT
         if (DEPTH <= MkIntTerm(1)) {/* I assume Module==0 is primitives */
           if (pt->ModuleOfPred) {
@@ -398,6 +401,7 @@ ructions                                       *
       PREG = CPREG;
       /* for profiler */
       save_pc();
+      alloc_profile(EnvPreg(CPREG), false);
       ENV_YREG = ENV;
 #ifdef DEPTH_LIMIT
       DEPTH = ENV_YREG[E_DEPTH];
@@ -3901,6 +3901,125 @@ static Int p_jump_to_next_dynamic_clause(USES_REGS1) {
   return TRUE;
 }
 
+/*
+ * Erased logical update clauses that nobody counts as in use are not
+ * freed on the spot: a worker may still hold a pointer it took before
+ * the clause was erased, and not have counted it yet. Instead, they go
+ * to limbo stamped with the current epoch. A worker that calls a
+ * logical update predicate only holds counted clause pointers, so it
+ * says there which epoch it has seen. Once every worker has seen a
+ * later epoch than a clause's, the clause is freed, in bulk with its
+ * neighbours.
+ */
+struct lu_limbo {
+  LogUpdClause *cl;
+  UInt epoch;
+};
+
+/* past this many clauses in limbo, whoever adds one tries to free some */
+#define LU_LIMBO_MAX 4096
+
+/* the oldest epoch some worker may still be working in */
+static UInt lu_oldest_epoch(void) {
+  UInt min = GLOBAL_LUEpoch;
+#if THREADS
+  int wid;
+
+  for (wid = 0; wid < MAX_THREADS; wid++) {
+    if (!Yap_local[wid])
+      break;
+    if (REMOTE_ThreadHandle(wid).in_use && REMOTE_LUEpoch(wid) &&
+        REMOTE_LUEpoch(wid) < min)
+      min = REMOTE_LUEpoch(wid);
+  }
+#else
+  CACHE_REGS
+  if (LOCAL_LUEpoch && LOCAL_LUEpoch < min)
+    min = LOCAL_LUEpoch;
+#endif
+  return min;
+}
+
+/* free what nobody can see, everything if all is set */
+static void lu_reclaim(bool all) {
+  UInt seen, i;
+
+  LOCK(GLOBAL_LUEpochLock);
+  seen = (all ? GLOBAL_LUEpoch + 1 : lu_oldest_epoch());
+  /* the limbo is sorted by epoch */
+  for (i = 0; i < GLOBAL_LULimboN && GLOBAL_LULimbo[i].epoch < seen; i++) {
+    LogUpdClause *cl = GLOBAL_LULimbo[i].cl;
+
+    Yap_InformOfRemoval(cl);
+    Yap_LUClauseSpace -= cl->ClSize;
+    Yap_FreeCodeSpace((char *)cl);
+  }
+  if (i) {
+    GLOBAL_LULimboN -= i;
+    memmove(GLOBAL_LULimbo, GLOBAL_LULimbo + i,
+            GLOBAL_LULimboN * sizeof(struct lu_limbo));
+  }
+  /* everyone has caught up, so what is left can go once they move on */
+  if (GLOBAL_LULimboN && seen == GLOBAL_LUEpoch)
+    GLOBAL_LUEpoch++;
+  UNLOCK(GLOBAL_LUEpochLock);
+}
+
+static void lu_retire(LogUpdClause *cl) {
+  bool full;
+
+  LOCK(GLOBAL_LUEpochLock);
+  if (GLOBAL_LULimboN == GLOBAL_LULimboSz) {
+    UInt sz = (GLOBAL_LULimboSz ? 2 * GLOBAL_LULimboSz : 256);
+    struct lu_limbo *nl =
+        realloc(GLOBAL_LULimbo, sz * sizeof(struct lu_limbo));
+
+    if (!nl) {
+      /* no space to wait in, do as if nobody could see it */
+      UNLOCK(GLOBAL_LUEpochLock);
+      Yap_InformOfRemoval(cl);
+      Yap_LUClauseSpace -= cl->ClSize;
+      Yap_FreeCodeSpace((char *)cl);
+      return;
+    }
+    GLOBAL_LULimbo = nl;
+    GLOBAL_LULimboSz = sz;
+  }
+  GLOBAL_LULimbo[GLOBAL_LULimboN].cl = cl;
+  GLOBAL_LULimbo[GLOBAL_LULimboN].epoch = GLOBAL_LUEpoch;
+  full = ++GLOBAL_LULimboN >= LU_LIMBO_MAX;
+  UNLOCK(GLOBAL_LUEpochLock);
+  if (full)
+    lu_reclaim(false);
+}
+
+/*
+  Called when entering a logical update predicate, with no uncounted
+  pointers to clauses, if the epoch moved since we last looked.
+*/
+void Yap_LUSeenEpoch(void) {
+  CACHE_REGS
+  LOCAL_LUEpoch = GLOBAL_LUEpoch;
+  if (GLOBAL_LULimboN)
+    lu_reclaim(false);
+}
+
+/*
+  Called before a worker blocks: until it calls a logical update
+  predicate again it holds no uncounted pointers, so it need not keep
+  the limbo waiting.
+*/
+void Yap_LULeaveEpoch(void) {
+  CACHE_REGS
+  LOCAL_LUEpoch = 0;
+}
+
+/* free the whole limbo, there must be a single worker running */
+void Yap_LUReclaimAll(void) {
+  if (GLOBAL_LULimboN)
+    lu_reclaim(true);
+}
+
 static void complete_lu_erase(LogUpdClause *clau) {
   DBRef *cp;
 
@@ -3944,9 +4063,7 @@ static void complete_lu_erase(LogUpdClause *clau) {
       }
     }
   }
-  Yap_InformOfRemoval(clau);
-  Yap_LUClauseSpace -= clau->ClSize;
-  Yap_FreeCodeSpace((char *)clau);
+  lu_retire(clau);
 }
 
 static void EraseLogUpdCl(LogUpdClause *clau) {
@@ -4249,6 +4366,10 @@ static Int p_erase(USES_REGS1) {
     Yap_Error(TYPE_ERROR_DBREF, t1, "erase");
     return FALSE;
   }
+  /* like a call to a logical update predicate, a builtin holds no
+     uncounted pointers to clauses */
+  if (LOCAL_LUEpoch != GLOBAL_LUEpoch)
+    Yap_LUSeenEpoch();
   EraseEntry(DBRefOfTerm(t1));
   return TRUE;
 }
@@ -4353,6 +4474,10 @@ static Int p_erase_clause(USES_REGS1) {
   } else {
     entryref = DBRefOfTerm(t1);
   }
+  /* like a call to a logical update predicate, a builtin holds no
+     uncounted pointers to clauses */
+  if (LOCAL_LUEpoch != GLOBAL_LUEpoch)
+    Yap_LUSeenEpoch();
   EraseEntry(entryref);
   return TRUE;
 }
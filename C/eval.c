@@ -101,8 +101,221 @@ static Term get_matrix_element(Term t1, Term t2 USES_REGS) {
   return Eval(t1 PASS_REGS);
 }
 
-static Term Eval(Term t USES_REGS) {
+/*
+ * Floats in the middle of an expression are not boxed: EvalUnboxed()
+ * returns UNBOXED_FLOAT and leaves the value in *flp, so that
+ * X is sqrt(A*A+B*B) only builds one float in the global stack, the
+ * result. We only do it for operations whose result is a float no
+ * matter what, and only when the result is finite: anything else is
+ * left to the usual code, that knows about big numbers and errors.
+ */
+#define UNBOXED_FLOAT TermNil
+
+static inline bool unboxed_arg(Term t, Float fl, Float *out, bool *isfl) {
+  if (t == UNBOXED_FLOAT) {
+    *out = fl;
+    *isfl = true;
+  } else if (IsIntTerm(t)) {
+    *out = IntOfTerm(t);
+  } else if (IsFloatTerm(t)) {
+    *out = FloatOfTerm(t);
+    *isfl = true;
+  } else if (IsLongIntTerm(t)) {
+    *out = LongIntOfTerm(t);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool unboxed_unary(Int op, Term t, Float fl, Float *flp) {
+  Float d, out;
+  bool isfl = false;
+
+  if (!unboxed_arg(t, fl, &d, &isfl))
+    return false;
+  switch (op) {
+  case op_uminus:
+    if (!isfl)
+      return false;
+    out = -d;
+    break;
+  case op_float:
+    out = d;
+    break;
+  case op_exp:
+    out = exp(d);
+    break;
+  case op_log:
+    if (d < 0)
+      return false;
+    out = log(d);
+    break;
+  case op_sqrt:
+    out = sqrt(d);
+    break;
+  case op_sin:
+    out = sin(d);
+    break;
+  case op_cos:
+    out = cos(d);
+    break;
+  case op_tan:
+    out = tan(d);
+    break;
+  case op_atan:
+    out = atan(d);
+    break;
+  default:
+    return false;
+  }
+  if (!isfinite(out))
+    return false;
+  *flp = out;
+  return true;
+}
+
+static bool unboxed_binary(Int op, Term t1, Float f1, Term t2, Float f2,
+                           Float *flp) {
+  Float d1, d2, out;
+  bool isfl = false;
+
+  if (!unboxed_arg(t1, f1, &d1, &isfl) || !unboxed_arg(t2, f2, &d2, &isfl))
+    return false;
+  switch (op) {
+  case op_plus:
+    out = d1 + d2;
+    break;
+  case op_minus:
+    out = d1 - d2;
+    break;
+  case op_times:
+    out = d1 * d2;
+    break;
+  case op_fdiv:
+    /* two integers give a float too */
+    isfl = true;
+    out = d1 / d2;
+    break;
+  default:
+    return false;
+  }
+  if (!isfl || !isfinite(out))
+    return false;
+  *flp = out;
+  return true;
+}
+
+#if USE_GMP
+/*
+ * Big integers get the same treatment: an intermediate result stays in
+ * a scratch MP_INT, and EvalUnboxed() returns UNBOXED_BIG. Scratch
+ * numbers belong to the thread and are never freed, so once they have
+ * grown a loop that adds or multiplies big numbers does not call
+ * malloc at all. An operation at depth d leaves its result in
+ * scratch[d], and evaluates its second argument at depth d+1, so a
+ * chain such as A*B*C*D only needs two of them.
+ */
+#define UNBOXED_BIG TermTrue
+#define BIG_SCRATCH 16
+
+static MP_INT *big_scratch(USES_REGS1) {
+  if (!LOCAL_BigScratch) {
+    int i;
+    MP_INT *s = malloc(BIG_SCRATCH * sizeof(MP_INT));
+
+    if (!s)
+      return NULL;
+    for (i = 0; i < BIG_SCRATCH; i++)
+      mpz_init(s + i);
+    LOCAL_BigScratch = s;
+  }
+  return LOCAL_BigScratch;
+}
+
+/* an integer argument as an MP_INT, using s if it must be built */
+static inline MP_INT *unboxed_big_arg(Term t, MP_INT *s) {
+  if (t == UNBOXED_BIG)
+    return s;
+  if (IsIntegerTerm(t)) {
+    mpz_set_si(s, IntegerOfTerm(t));
+    return s;
+  }
+  if (IsBigIntTerm(t) && RepAppl(t)[1] == BIG_INT)
+    return Yap_BigIntOfTerm(t);
+  return NULL;
+}
+
+static inline bool is_big(Term t) {
+  return t == UNBOXED_BIG || (IsBigIntTerm(t) && RepAppl(t)[1] == BIG_INT);
+}
+
+/* leave the result in scratch[d], unless it is small enough for a
+   plain integer */
+static inline Term unboxed_big_out(MP_INT *s USES_REGS) {
+  if (mpz_fits_slong_p(s))
+    return MkIntegerTerm(mpz_get_si(s));
+  return UNBOXED_BIG;
+}
+
+static Term unboxed_big_unary(Int op, Term t, int d USES_REGS) {
+  MP_INT *s, *b;
+
+  if (op != op_uminus || d >= BIG_SCRATCH || !is_big(t) ||
+      !(s = big_scratch(PASS_REGS1)))
+    return 0;
+  b = unboxed_big_arg(t, s + d);
+  mpz_neg(s + d, b);
+  return unboxed_big_out(s + d PASS_REGS);
+}
+
+static Term unboxed_big_binary(Int op, Term t1, Term t2, int d USES_REGS) {
+  MP_INT *s, *b1, *b2;
+
+  if (op != op_plus && op != op_minus && op != op_times)
+    return 0;
+  if (d + 1 >= BIG_SCRATCH || (!is_big(t1) && !is_big(t2)) ||
+      !(s = big_scratch(PASS_REGS1)))
+    return 0;
+  if (!(b1 = unboxed_big_arg(t1, s + d)) ||
+      !(b2 = unboxed_big_arg(t2, s + d + 1)))
+    return 0;
+  switch (op) {
+  case op_plus:
+    mpz_add(s + d, b1, b2);
+    break;
+  case op_minus:
+    mpz_sub(s + d, b1, b2);
+    break;
+  default:
+    mpz_mul(s + d, b1, b2);
+    break;
+  }
+  return unboxed_big_out(s + d PASS_REGS);
+}
+#endif
+
+static inline Term box_num(Term t, Float fl, int d USES_REGS) {
+  if (t == UNBOXED_FLOAT)
+    return MkFloatTerm(fl);
+#if USE_GMP
+  if (t == UNBOXED_BIG) {
+    Term out = Yap_MkBigIntTerm(LOCAL_BigScratch + d);
+    if (out == TermNil) {
+      Yap_ArithError(RESOURCE_ERROR_STACK, TermNil, "in arithmetic");
+    }
+    return out;
+  }
+#endif
+  return t;
+}
+
+static Term EvalUnboxed(Term t, Float *flp, int d USES_REGS) {
   eval_context_t ctx;
+  Float f1, f2;
+#if USE_GMP
+  Term out;
+#endif
   ctx.p = LOCAL_ctx;
 
   if (IsVarTerm(t)) {
@@ -151,16 +364,29 @@ static Term Eval(Term t USES_REGS) {
       ctx.fp = RepAppl(t);
       LOCAL_ctx = &ctx;
       *RepAppl(t) = (CELL)AtomFoundVar;
-      t1 = Eval(ArgOfTerm(1, t) PASS_REGS);
+      t1 = EvalUnboxed(ArgOfTerm(1, t), &f1, d PASS_REGS);
       if (n == 1) {
         *RepAppl(t) = (CELL)fun;
         LOCAL_ctx = ctx.p;
-        return Yap_eval_unary(p->FOfEE, t1);
+        if (unboxed_unary(p->FOfEE, t1, f1, flp))
+          return UNBOXED_FLOAT;
+#if USE_GMP
+        if ((out = unboxed_big_unary(p->FOfEE, t1, d PASS_REGS)))
+          return out;
+#endif
+        return Yap_eval_unary(p->FOfEE, box_num(t1, f1, d PASS_REGS));
       }
-      t2 = Eval(ArgOfTerm(2, t) PASS_REGS);
+      t2 = EvalUnboxed(ArgOfTerm(2, t), &f2, d + 1 PASS_REGS);
       *RepAppl(t) = (CELL)fun;
       LOCAL_ctx = ctx.p;
-      return Yap_eval_binary(p->FOfEE, t1, t2);
+      if (unboxed_binary(p->FOfEE, t1, f1, t2, f2, flp))
+        return UNBOXED_FLOAT;
+#if USE_GMP
+      if ((out = unboxed_big_binary(p->FOfEE, t1, t2, d PASS_REGS)))
+        return out;
+#endif
+      return Yap_eval_binary(p->FOfEE, box_num(t1, f1, d PASS_REGS),
+                             box_num(t2, f2, d + 1 PASS_REGS));
     }
   } /* else if (IsPairTerm(t)) */
   {
@@ -169,10 +395,17 @@ static Term Eval(Term t USES_REGS) {
                             "string must contain a single character to be "
                             "evaluated as an arithmetic expression");
     }
-    return Eval(HeadOfTerm(t) PASS_REGS);
+    return EvalUnboxed(HeadOfTerm(t), flp, d PASS_REGS);
   }
 }
 
+static Term Eval(Term t USES_REGS) {
+  Float fl;
+  Term out = EvalUnboxed(t, &fl, 0 PASS_REGS);
+
+  return box_num(out, fl, 0 PASS_REGS);
+}
+
 Term Yap_InnerEval__(Term t USES_REGS) {
   return Eval(t PASS_REGS);
  }
@@ -219,7 +452,7 @@ static Int p_is(USES_REGS1) { /* X is Y	 */
   }
   do {
     go = false;
-    out = Yap_Eval(t PASS_REGS);
+    out = Yap_Eval(t);
     go = Yap_CheckArithError();
   } while (go);
   return Yap_unify_constant(ARG1, out);
@@ -48,6 +48,7 @@ static Int execute(USES_REGS1);
 static Int execute0(USES_REGS1);
 
 static bool should_creep() {
+  CACHE_REGS
     return
     !(LOCAL_PrologMode & (AbortMode | InterruptMode | SystemMode|BootMode))
     &&
@@ -267,7 +268,7 @@ static Int parent_choice_point(USES_REGS1) {
     if (!IsVarTerm(t)) {
         Yap_ThrowError(INSTANTIATION_ERROR, t, "child choicr-point missing");
     }
-    choiceptr cp = cp_from_integer(t);
+    choiceptr cp = cp_from_integer(t PASS_REGS);
     if (cp == NULL || cp->cp_b == NULL)
         return false;
     td = cp_as_integer(cp->cp_b PASS_REGS);
@@ -348,6 +349,7 @@ static PredEntry *new_pred(Term t, Term tmod, char *pname) {
 }
 
 static bool CommaCall(Term t, Term mod) {
+  CACHE_REGS
     PredEntry *pen;
     arity_t i;
     if (IsVarTerm(t) || (pen = new_pred(t, mod, "_,_")))
@@ -398,7 +400,7 @@ inline static bool do_execute(Term t, Term mod USES_REGS) {
             t = t1;
             pen = new_pred(t, mod, "_,_");
             if (pen == NULL || (arity = pen->ArityOfPE) == 0) {
-                return do_execute(t, mod);
+                return do_execute(t, mod PASS_REGS);
             }
         } else if (IsExtensionFunctor(f)) {
             return CallError(TYPE_ERROR_CALLABLE, t0, mod0 PASS_REGS);
@@ -820,6 +822,7 @@ static Int execute_in_mod(USES_REGS1) { /* '$execute'(Goal)	 */
  * @method prune_inner_computation
  */
 static void prune_inner_computation(choiceptr parent) {
+  CACHE_REGS
     /* code */
     choiceptr cut_pt;
 
@@ -846,6 +849,7 @@ static void prune_inner_computation(choiceptr parent) {
  * @method complete_inner_computation
  */
 static void complete_inner_computation(choiceptr old_B) {
+  CACHE_REGS
     choiceptr myB = B;
     if (myB == NULL) {
         return;
@@ -893,6 +897,7 @@ static Int Yap_ignore(Term t, bool fail USES_REGS) {
 extern void *Yap_blob_info(Term t);
 
 static bool set_watch(Int Bv, Term task) {
+  CACHE_REGS
     CELL *pt;
     Term t = Yap_AllocExternalDataInStack((CELL) setup_call_catcher_cleanup_tag,
                                           sizeof(Int), &pt);
@@ -906,9 +911,10 @@ static bool set_watch(Int Bv, Term task) {
     return true;
 }
 
-static bool watch_cut(Term ext USES_REGS) {
+static bool watch_cut(Term ext) {
     // called after backtracking..
     //
+    CACHE_REGS
     Term task = TailOfTerm(ext);
     Term cleanup = ArgOfTerm(3, task);
     Term e = 0;
@@ -938,7 +944,7 @@ static bool watch_cut(Term ext USES_REGS) {
     } else {
         completion_pt[0] = port_pt[0] = TermCut;
     }
-    Yap_ignore(cleanup, false);
+    Yap_ignore(cleanup, false PASS_REGS);
     CELL *complete_pt = deref_ptr(RepAppl(task) + 4);
     complete_pt[0] = TermTrue;
     if (ex_mode) {
@@ -958,9 +964,10 @@ static bool watch_cut(Term ext USES_REGS) {
  * @param  USES_REGS1                 [env for threaded execution]
  * @return                       c
  */
-static bool watch_retry(Term d0 USES_REGS) {
+static bool watch_retry(Term d0) {
     // called after backtracking..
     //
+    CACHE_REGS
     Term task = TailOfTerm(d0);
     bool box = ArgOfTerm(1, task) == TermTrue;
     Term cleanup = ArgOfTerm(3, task);
@@ -1002,7 +1009,7 @@ static bool watch_retry(Term d0 USES_REGS) {
         return true;
     }
     port_pt[0] = t;
-    Yap_ignore(cleanup, true);
+    Yap_ignore(cleanup, true PASS_REGS);
     if (ex_mode) {
         // Yap_PutException(e);
         return true;
@@ -1089,7 +1096,7 @@ static Int cleanup_on_exit(USES_REGS1) {
         catcher_pt[0] = TermExit;
         complete_pt[0] = TermExit;
     }
-    Yap_ignore(cleanup, false);
+    Yap_ignore(cleanup, false PASS_REGS);
     if (Yap_RaiseException()) {
         return false;
     }
@@ -1271,7 +1278,7 @@ static Int do_term_expansion(USES_REGS1) {
     } else {
         //Yap_ThrowError(TYPE_ERROR_CALLABLE, t, "call/1");
         //return false;
-        return CallMetaCall(t, mod);
+        return CallMetaCall(t, mod PASS_REGS);
     }
     /*	N = arity; */
     /* call may not define new system predicates!! */
@@ -1327,7 +1334,7 @@ static Int creep_step(USES_REGS1) { /* '$execute_nonstop'(Goal,Mod)
 #endif
         }
     } else {
-        return CallMetaCall(t, mod);
+        return CallMetaCall(t, mod PASS_REGS);
     }
     /*	N = arity; */
     /* call may not define new system predicates!! */
@@ -1650,7 +1657,7 @@ void Yap_PrepGoal(arity_t arity, CELL *pt, choiceptr saved_b USES_REGS) {
     /* create an initial pseudo environment so that when garbage
        collection is going up in the environment chain it doesn't get
        confused */
-    Yap_ResetException(worker_id);
+    Yap_ResetException(LOCAL_ActiveError);
     //  sl = Yap_InitSlot(t);
     YENV = ASP;
     YENV[E_CP] = (CELL) YESCODE;
@@ -2152,7 +2159,7 @@ bool Yap_Reset(yap_reset_t mode, bool hard) {
     CACHE_REGS
     int res = TRUE;
 
-    Yap_ResetException(worker_id);
+    Yap_ResetException(LOCAL_ActiveError);
     /* first, backtrack to the root */
     while (B) {
         P = FAILCODE;
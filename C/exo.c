@@ -38,6 +38,15 @@
 #if HAVE_STDBOOL_H
 #include <stdbool.h>
 #endif
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 bool YAP_NewExo( PredEntry *ap, size_t data, struct udi_info *udi);
 bool YAP_AssertTuples( PredEntry *pe, const Term *ts, size_t offset, size_t m);
@@ -580,16 +589,64 @@ Yap_NextExo(choiceptr cptr, struct index_t *it)
   return next;
 }
 
+/* room for ncls facts of ap, not yet visible */
+static MegaClause *
+exo_alloc( PredEntry *ap, UInt ncls )
+{
+  MegaClause *mcl;
+  UInt required;
+  struct index_t **li;
+
+  required = ncls*ap->ArityOfPE*sizeof(CELL)+sizeof(MegaClause)+2*sizeof(struct index_t *);
+  while (!(mcl = (MegaClause *)Yap_AllocCodeSpace(required))) {
+    if (!Yap_growheap(FALSE, required, NULL)) {
+      /* just fail, the system will keep on going */
+      return NULL;
+    }
+  }
+  Yap_ClauseSpace += required;
+  mcl->ClFlags = MegaMask|ExoMask;
+  mcl->ClSize = required;
+  mcl->ClPred = ap;
+  mcl->ClItemSize = ap->ArityOfPE*sizeof(CELL);
+  mcl->ClNext = NULL;
+  li = (struct index_t **)(mcl->ClCode);
+  li[0] = li[1] = NULL;
+  return mcl;
+}
+
+static void
+exo_free( MegaClause *mcl )
+{
+  Yap_ClauseSpace -= mcl->ClSize;
+  Yap_FreeCodeSpace((char *)mcl);
+}
+
+/* make the ncls facts in mcl the code for ap */
+static void
+exo_install( PredEntry *ap, MegaClause *mcl, UInt ncls )
+{
+  /* cool, it's our turn to do the conversion */
+  ap->cs.p_code.FirstClause =
+    ap->cs.p_code.LastClause =
+    mcl->ClCode;
+  ap->PredFlags |= MegaClausePredFlag;
+  ap->cs.p_code.NOfClauses = ncls;
+  if (ap->PredFlags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag)) {
+    ap->OpcodeOfPred = Yap_opcode(_spy_pred);
+  } else {
+    ap->OpcodeOfPred = Yap_opcode(_enter_exo);
+  }
+  ap->CodeOfPred = ap->cs.p_code.TrueCodeOfPred = (yamop *)(&(ap->OpcodeOfPred));
+}
+
 static MegaClause *
 exodb_get_space( Term t, Term mod, Term tn )
 {
-  UInt            arity;
   Prop            pe;
   PredEntry      *ap;
   MegaClause *mcl;
   UInt ncls;
-  UInt required;
-  struct index_t **li;
 
 
   if (IsVarTerm(mod)  || !IsAtomTerm(mod)) {
@@ -597,11 +654,9 @@ exodb_get_space( Term t, Term mod, Term tn )
   }
   if (IsAtomTerm(t)) {
     Atom a = AtomOfTerm(t);
-    arity = 0;
     pe = PredPropByAtom(a, mod);
   } else if (IsApplTerm(t)) {
     register Functor f = FunctorOfTerm(t);
-    arity = ArityOfFunctor(f);
     pe = PredPropByFunc(f, mod);
   } else {
     return NULL;
@@ -625,33 +680,9 @@ exodb_get_space( Term t, Term mod, Term tn )
     return NULL;
   }
 
-  required = ncls*arity*sizeof(CELL)+sizeof(MegaClause)+2*sizeof(struct index_t *);
-  while (!(mcl = (MegaClause *)Yap_AllocCodeSpace(required))) {
-    if (!Yap_growheap(FALSE, required, NULL)) {
-      /* just fail, the system will keep on going */
-      return NULL;
-    }
-  }
-  Yap_ClauseSpace += required;
-  /* cool, it's our turn to do the conversion */
-  mcl->ClFlags = MegaMask|ExoMask;
-  mcl->ClSize = required;
-  mcl->ClPred = ap;
-  mcl->ClItemSize = arity*sizeof(CELL);
-  mcl->ClNext = NULL;
-  li = (struct index_t **)(mcl->ClCode);
-  li[0] = li[1] = NULL;
-  ap->cs.p_code.FirstClause =
-    ap->cs.p_code.LastClause =
-    mcl->ClCode;
-  ap->PredFlags |= MegaClausePredFlag;
-  ap->cs.p_code.NOfClauses = ncls;
-  if (ap->PredFlags & (SpiedPredFlag|CountPredFlag|ProfiledPredFlag)) {
-    ap->OpcodeOfPred = Yap_opcode(_spy_pred);
-  } else {
-    ap->OpcodeOfPred = Yap_opcode(_enter_exo);
-  }
-  ap->CodeOfPred = ap->cs.p_code.TrueCodeOfPred = (yamop *)(&(ap->OpcodeOfPred));
+  if (!(mcl = exo_alloc(ap, ncls)))
+    return NULL;
+  exo_install(ap, mcl, ncls);
   return mcl;
 }
 
@@ -774,6 +805,429 @@ p_exoassert( USES_REGS1 )
   return TRUE;
 }
 
+/*
+  Loading delimited text straight into exo storage.
+
+  The file is mapped into memory and read twice: once to count the
+  records, so that the mega clause can be allocated in one go, and once
+  to parse every field into its cell. Fields are never made into
+  terms: integers are tagged directly, and text becomes an atom. Fields
+  follow RFC 4180, that is, they may be quoted with `"`, and inside
+  quotes `""` stands for a quote, and separators and newlines are
+  text. Empty lines are skipped.
+
+  Exo cells can only hold atoms and small integers, so string columns
+  are stored as atoms, and float columns are refused.
+*/
+
+typedef enum {
+  csv_integer,
+  csv_atom
+} csv_type_t;
+
+typedef struct csv_column {
+  csv_type_t type;
+  char *last;                   /* text of the last atom in the column */
+  size_t lastsz;
+  Atom atom;
+} csv_column_t;
+
+static const char *
+csv_map_file(const char *name, size_t *sizep)
+{
+  struct stat st;
+  char *data;
+  int fd;
+
+  if ((fd = open(name, O_RDONLY)) < 0)
+    return NULL;
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    return NULL;
+  }
+  *sizep = st.st_size;
+  if (st.st_size == 0) {
+    close(fd);
+    return "";
+  }
+#if HAVE_MMAP
+  data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    data = NULL;
+#ifdef MADV_SEQUENTIAL
+  else
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+#endif
+#else
+  if ((data = malloc(st.st_size))) {
+    size_t n = 0;
+    ssize_t r;
+
+    while (n < (size_t)st.st_size &&
+           (r = read(fd, data + n, st.st_size - n)) > 0)
+      n += r;
+    if (n < (size_t)st.st_size) {
+      free(data);
+      data = NULL;
+    }
+  }
+#endif
+  close(fd);
+  return data;
+}
+
+static void
+csv_unmap_file(const char *data, size_t size)
+{
+  if (size == 0)
+    return;
+#if HAVE_MMAP
+  munmap((void *)data, size);
+#else
+  free((void *)data);
+#endif
+}
+
+/*
+  Return the newline that ends the record at p, or end. A field is
+  quoted only if it starts with a quote, so that a quote inside a
+  bare field is kept as a character, as csv_field() does.
+*/
+static const char *
+csv_record_end(const char *p, const char *end, int sep)
+{
+  bool field_start = true;
+
+  for (; p < end; p++) {
+    if (field_start && *p == '"') {
+      for (p++; p < end; p++) {
+        if (*p == '"') {
+          if (p + 1 < end && p[1] == '"')
+            p++;
+          else
+            break;
+        }
+      }
+      if (p == end)
+        break;
+      field_start = false;
+    } else if (*p == '\n') {
+      break;
+    } else {
+      field_start = (*p == sep);
+    }
+  }
+  return p;
+}
+
+/* records with nothing but an optional carriage return are skipped */
+#define csv_empty_record(p, eol) \
+  ((eol) == (p) || ((eol) == (p) + 1 && *(p) == '\r'))
+
+/* number of non-empty records */
+static UInt
+csv_count_records(const char *p, const char *end, int sep)
+{
+  UInt n = 0;
+
+  while (p < end) {
+    const char *eol = csv_record_end(p, end, sep);
+
+    n += !csv_empty_record(p, eol);
+    p = eol + 1;
+  }
+  return n;
+}
+
+/*
+  Read the field at *pp into buf, which must have room for the whole
+  record, and leave *pp after the separator, or at the end of the
+  record. Returns the length of the field, and sets *last if the
+  record ends here.
+*/
+static size_t
+csv_field(const char **pp, const char *end, int sep, char *buf, bool *last)
+{
+  const char *p = *pp;
+  size_t n = 0;
+
+  if (p < end && *p == '"') {
+    for (p++; p < end; p++) {
+      if (*p == '"') {
+        if (p + 1 < end && p[1] == '"')
+          p++;
+        else {
+          p++;
+          break;
+        }
+      }
+      buf[n++] = *p;
+    }
+  }
+  /* anything left before the separator is kept, as most readers do */
+  while (p < end && *p != sep && *p != '\n')
+    buf[n++] = *p++;
+  if (n && buf[n - 1] == '\r' && (p == end || *p == '\n'))
+    n--;
+  buf[n] = '\0';
+  *last = (p == end || *p == '\n');
+  *pp = (p < end ? p + 1 : p);
+  return n;
+}
+
+static bool
+csv_integer_field(const char *s, Int *ip)
+{
+  UInt v = 0;
+  bool neg = false;
+
+  while (*s == ' ' || *s == '\t')
+    s++;
+  if (*s == '-' || *s == '+')
+    neg = (*s++ == '-');
+  if (*s < '0' || *s > '9')
+    return false;
+  while (*s >= '0' && *s <= '9') {
+    UInt d = *s++ - '0';
+
+    if (v > ((UInt)Int_MAX - d) / 10)
+      return false;
+    v = v * 10 + d;
+  }
+  while (*s == ' ' || *s == '\t')
+    s++;
+  if (*s)
+    return false;
+  *ip = (neg ? -(Int)v : (Int)v);
+  return IntInBnd(*ip);
+}
+
+static Atom
+csv_atom_field(csv_column_t *col, const char *s, size_t n)
+{
+  if (col->atom && col->lastsz > n && memcmp(col->last, s, n + 1) == 0)
+    return col->atom;
+  if (col->lastsz <= n) {
+    char *nlast = realloc(col->last, n + 1);
+
+    if (!nlast)
+      return Yap_ULookupAtom((const unsigned char *)s);
+    col->last = nlast;
+    col->lastsz = n + 1;
+  }
+  memcpy(col->last, s, n + 1);
+  return (col->atom = Yap_ULookupAtom((const unsigned char *)s));
+}
+
+static bool
+csv_column_types(Term t, csv_column_t *cols, UInt *arityp)
+{
+  UInt n = 0;
+
+  while (IsPairTerm(t)) {
+    Term th = Deref(HeadOfTerm(t));
+    const char *s;
+
+    if (IsVarTerm(th)) {
+      Yap_Error(INSTANTIATION_ERROR, th, "load_exo_csv/3");
+      return false;
+    }
+    if (!IsAtomTerm(th)) {
+      Yap_Error(TYPE_ERROR_ATOM, th, "load_exo_csv/3");
+      return false;
+    }
+    if (n == MAX_ARITY) {
+      Yap_Error(REPRESENTATION_ERROR_MAX_ARITY, t, "load_exo_csv/3");
+      return false;
+    }
+    s = RepAtom(AtomOfTerm(th))->StrOfAE;
+    if (!strcmp(s, "integer")) {
+      cols[n].type = csv_integer;
+    } else if (!strcmp(s, "atom") || !strcmp(s, "string")) {
+      cols[n].type = csv_atom;
+    } else {
+      /* float included: exo cells hold atoms and small integers only */
+      Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, th,
+                "load_exo_csv/3: column types are integer, atom or string");
+      return false;
+    }
+    cols[n].last = NULL;
+    cols[n].lastsz = 0;
+    cols[n].atom = NULL;
+    n++;
+    t = Deref(TailOfTerm(t));
+  }
+  if (t != TermNil || n == 0) {
+    Yap_Error(TYPE_ERROR_LIST, t, "load_exo_csv/3");
+    return false;
+  }
+  *arityp = n;
+  return true;
+}
+
+/* parse the records in p..end into the cells at base */
+static bool
+csv_store(const char *file, const char *p, const char *end, int sep,
+          csv_column_t *cols, UInt arity, UInt nrecords, CELL *base)
+{
+  CACHE_REGS
+  size_t bufsz = 256;
+  char *buf = malloc(bufsz);
+  UInt line = 1, rec = 0;
+
+  if (!buf) {
+    Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "load_exo_csv/3");
+    return false;
+  }
+  while (p < end && rec < nrecords) {
+    /* find the end of the record, to size the buffer */
+    const char *eol = csv_record_end(p, end, sep), *start = p;
+    bool last = false;
+    UInt i;
+
+    if ((size_t)(eol - p) >= bufsz) {
+      char *nbuf;
+
+      bufsz = (eol - p) + 1;
+      if (!(nbuf = realloc(buf, bufsz))) {
+        free(buf);
+        Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "load_exo_csv/3");
+        return false;
+      }
+      buf = nbuf;
+    }
+    if (csv_empty_record(p, eol)) {
+      p = eol + 1;
+      line++;
+      continue;
+    }
+    for (i = 0; i < arity; i++) {
+      size_t n;
+      Int v;
+
+      if (last) {
+        free(buf);
+        Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, MkIntegerTerm(i),
+                  "%s:%lu: %lu fields, expected %lu", file,
+                  (unsigned long)line, (unsigned long)i,
+                  (unsigned long)arity);
+        return false;
+      }
+      n = csv_field(&p, end, sep, buf, &last);
+      if (cols[i].type == csv_integer) {
+        if (!csv_integer_field(buf, &v)) {
+          Term t = MkAtomTerm(Yap_ULookupAtom((const unsigned char *)buf));
+
+          free(buf);
+          Yap_Error(TYPE_ERROR_INTEGER, t, "%s:%lu: field %lu", file,
+                    (unsigned long)line, (unsigned long)i + 1);
+          return false;
+        }
+        base[i] = MkIntTerm(v);
+      } else {
+        base[i] = MkAtomTerm(csv_atom_field(cols + i, buf, n));
+      }
+    }
+    if (!last) {
+      free(buf);
+      Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, MkIntegerTerm(arity + 1),
+                "%s:%lu: more than %lu fields", file, (unsigned long)line,
+                (unsigned long)arity);
+      return false;
+    }
+    for (; start < p; start++)
+      line += (*start == '\n');
+    base += arity;
+    rec++;
+  }
+  free(buf);
+  return true;
+}
+
+/** @pred '$exo_load_csv'(+ _File_, + _Module_, + _Name_, + _Types_, + _Separator_, + _Header_, - _Rows_)
+ *
+ * Make the records of the delimited text file _File_ the facts of the
+ * exo predicate _Module_:_Name_/_N_, where _N_ is the length of the
+ * list _Types_. _Separator_ is the code of the field separator, and
+ * if _Header_ is `true` the first record is skipped. _Rows_ is
+ * unified with the number of facts. See load_exo_csv/3.
+ *
+ */
+static Int
+p_exo_load_csv( USES_REGS1 )
+{
+  Term tfile = Deref(ARG1), tmod = Deref(ARG2), tname = Deref(ARG3);
+  Term tsep = Deref(ARG5);
+  csv_column_t cols[MAX_ARITY];
+  const char *file, *data, *p, *end;
+  size_t size;
+  UInt arity, nrecords, i;
+  PredEntry *ap;
+  MegaClause *mcl = NULL;
+  bool ok = true;
+
+  if (IsVarTerm(tfile) || IsVarTerm(tmod) || IsVarTerm(tname) ||
+      IsVarTerm(tsep)) {
+    Yap_Error(INSTANTIATION_ERROR, TermNil, "load_exo_csv/3");
+    return false;
+  }
+  if (!IsAtomTerm(tfile) || !IsAtomTerm(tmod) || !IsAtomTerm(tname)) {
+    Yap_Error(TYPE_ERROR_ATOM, TermNil, "load_exo_csv/3");
+    return false;
+  }
+  if (!IsIntTerm(tsep) || IntOfTerm(tsep) <= 0 || IntOfTerm(tsep) > 127 ||
+      IntOfTerm(tsep) == '"' || IntOfTerm(tsep) == '\n') {
+    Yap_Error(DOMAIN_ERROR_OUT_OF_RANGE, tsep, "load_exo_csv/3");
+    return false;
+  }
+  if (!csv_column_types(Deref(ARG4), cols, &arity))
+    return false;
+  ap = RepPredProp(PredPropByFunc(Yap_MkFunctor(AtomOfTerm(tname), arity),
+                                  tmod));
+  if (ap->PredFlags & (DynamicPredFlag|LogUpdatePredFlag
+#ifdef TABLING
+                       |TabledPredFlag
+#endif /* TABLING */
+                       ) || ap->cs.p_code.NOfClauses) {
+    Yap_Error(PERMISSION_ERROR_MODIFY_STATIC_PROCEDURE,
+              Yap_PredicateToIndicator(ap), "load_exo_csv/3");
+    return false;
+  }
+  file = RepAtom(AtomOfTerm(tfile))->StrOfAE;
+  if (!(data = csv_map_file(file, &size))) {
+    Yap_Error(PERMISSION_ERROR_OPEN_SOURCE_SINK, tfile, "load_exo_csv/3: %s",
+              strerror(errno));
+    return false;
+  }
+  p = data;
+  end = data + size;
+  if (Deref(ARG6) == TermTrue) {
+    /* skip the header: one record, possibly with quoted newlines */
+    p = csv_record_end(p, end, IntOfTerm(tsep));
+    if (p < end)
+      p++;
+  }
+  nrecords = csv_count_records(p, end, IntOfTerm(tsep));
+  if (nrecords) {
+    if (!(mcl = exo_alloc(ap, nrecords))) {
+      Yap_Error(RESOURCE_ERROR_HEAP, tfile, "load_exo_csv/3");
+      ok = false;
+    } else if (!csv_store(file, p, end, IntOfTerm(tsep), cols, arity,
+                          nrecords,
+                          (CELL *)((ADDR)mcl->ClCode +
+                                   2 * sizeof(struct index_t *)))) {
+      exo_free(mcl);
+      ok = false;
+    } else {
+      exo_install(ap, mcl, nrecords);
+    }
+  }
+  csv_unmap_file(data, size);
+  for (i = 0; i < arity; i++)
+    free(cols[i].last);
+  return ok && Yap_unify(ARG7, MkIntegerTerm(nrecords));
+}
+
 void
 Yap_InitExoPreds(void)
 {
@@ -783,5 +1237,6 @@ Yap_InitExoPreds(void)
   CurrentModule = DBLOAD_MODULE;
   Yap_InitCPred("exo_db_get_space", 4, p_exodb_get_space, 0L);
   Yap_InitCPred("exoassert", 3, p_exoassert, 0L);
+  Yap_InitCPred("$exo_load_csv", 7, p_exo_load_csv, SyncPredFlag);
   CurrentModule = cm;
 }
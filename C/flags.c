@@ -112,6 +112,7 @@ static Int set_prolog_flag(USES_REGS1);
 #include "YapLFlagInfo.h"
 
 static Term indexer(Term inp) {
+  CACHE_REGS
   if (IsStringTerm(inp)) {
     inp = MkStringTerm(RepAtom(AtomOfTerm(inp))->StrOfAE);
   }
@@ -260,6 +261,7 @@ static bool dollar_to_lc(Term inp) {
   }
 
 static Term isaccess(Term inp) {
+  CACHE_REGS
   if (inp == TermReadWrite || inp == TermReadOnly)
     return inp;
 
@@ -288,18 +290,21 @@ static Term stream(Term inp) {
 }
 
 static bool set_error_stream(Term inp) {
+  CACHE_REGS
   if (IsVarTerm(inp))
     return Yap_unify(inp, Yap_StreamUserName(LOCAL_c_error_stream));
   return Yap_SetErrorStream(inp);
 }
 
 static bool set_input_stream(Term inp) {
+  CACHE_REGS
   if (IsVarTerm(inp))
     return Yap_unify(inp, Yap_StreamUserName(LOCAL_c_input_stream));
   return Yap_SetInputStream(inp);
 }
 
 static bool set_output_stream(Term inp) {
+  CACHE_REGS
   if (IsVarTerm(inp))
     return Yap_unify(inp, Yap_StreamUserName(LOCAL_c_output_stream));
   return Yap_SetOutputStream(inp);
@@ -310,6 +315,7 @@ static Term isground(Term inp) {
 }
 
 static Term flagscope(Term inp) {
+  CACHE_REGS
   if (inp == TermGlobal || inp == TermThread || inp == TermModule)
     return inp;
 
@@ -552,6 +558,7 @@ x                    static bool list_atom( Term inp ) {
 #endif
 
 static Term list_option(Term inp) {
+  CACHE_REGS
   if (IsVarTerm(inp)) {
     Yap_ThrowError(INSTANTIATION_ERROR, inp, "set_prolog_flag in \"...\"");
     return inp;
@@ -1138,6 +1145,7 @@ void Yap_setModuleFlags(ModEntry *new, ModEntry *cme) {
 }
 
 bool setYapFlag(Term tflag, Term t2) {
+  CACHE_REGS
   FlagEntry *fv;
   flag_term *tarr;
   if (IsVarTerm(tflag)) {
@@ -1223,6 +1231,7 @@ Term Yap_UnknownFlag(Term mod) {
 }
 
 Term getYapFlag(Term tflag) {
+  CACHE_REGS
   FlagEntry *fv;
    flag_term *tarr;
    tflag = Deref(tflag);
@@ -1773,7 +1782,7 @@ void Yap_InitFlags(bool bootstrap) {
   tr_fr_ptr tr0 = TR;
   flag_info *f = global_flags_setup;
   int lvl = push_text_stack();
-  char *buf = Malloc(4098);
+  char *buf = Malloc(4098 PASS_REGS);
   GLOBAL_flagCount = 0;
   if (bootstrap) {
     GLOBAL_Flags = (union flagTerm *)Yap_AllocCodeSpace(
@@ -1802,7 +1811,7 @@ void Yap_InitFlags(bool bootstrap) {
       s = buf;
       strcpy(buf, f->init);
     } else {
-      s = Malloc(strlen(f->init)+1);
+      s = Malloc(strlen(f->init)+1 PASS_REGS);
       strcpy(s, f->init);
     }
     bool itf = setInitialValue(bootstrap, f->def, s,
@@ -54,6 +54,8 @@
 #endif /* LOW_LEVEL_TRACE */
       BEGD(d0);
       CPredicate f = PREG->y_u.Osbpp.p->cs.f_code;
+      PredEntry *caller = PREG->y_u.Osbpp.p0;
+      alloc_profile(PREG->y_u.Osbpp.p, true);
       PREG = NEXTOP(PREG, Osbpp);
       saveregs();
       d0 = f(PASS_REGS1);
@@ -61,6 +63,7 @@
 #ifdef SHADOW_S
       SREG = Yap_REGS.S_;
 #endif
+      alloc_profile(caller, false);
       if (!d0) {
         FAIL();
       }
@@ -133,6 +136,7 @@
         {
           CPredicate f = PREG->y_u.Osbpp.p->cs.f_code;
           yamop *oldPREG = PREG;
+          alloc_profile(pt0, true);
           saveregs();
           d0 = f(PASS_REGS1);
           setregs();
@@ -146,6 +150,7 @@
             /* we did not update PREG */
             /* we can proceed */
             PREG = CPREG;
+            alloc_profile(EnvPreg(CPREG), false);
             ENV_YREG = ENV;
 #ifdef DEPTH_LIMIT
             DEPTH = ENV_YREG[E_DEPTH];
@@ -383,7 +388,7 @@
       save_machine_regs();
       SREG = (CELL *)YAP_ExecuteFirst(PREG->y_u.OtapFs.p,
                                       (CPredicate)(PREG->y_u.OtapFs.f));
-      Yap_ResetException( worker_id );
+      Yap_ResetException(LOCAL_ActiveError);
       restore_machine_regs();
       setregs();
       LOCAL_PrologMode &= UserMode;
@@ -424,7 +429,7 @@
       save_machine_regs();
       SREG = (CELL *)YAP_ExecuteNext(PREG->y_u.OtapFs.p,
                                      (CPredicate)(PREG->y_u.OtapFs.f));
-      Yap_ResetException( worker_id);
+      Yap_ResetException(LOCAL_ActiveError);
       restore_machine_regs();
       setregs();
       LOCAL_PrologMode &= ~UserCCallMode;
@@ -148,12 +148,14 @@ typedef struct cell_space {
 } cell_space_t;
 
 INLINE_ONLY void enter_cell_space(cell_space_t *cs) {
+  CACHE_REGS
     cs->oH = HR;
     cs->oHB = HB;
     cs->oASP = ASP;
 }
 
 INLINE_ONLY void exit_cell_space(cell_space_t *cs) {
+  CACHE_REGS
     HR = cs->oH;
     HB = cs->oHB;
     ASP = cs->oASP;
@@ -367,7 +369,7 @@ static int copy_complex_term(register CELL *pt0, register CELL *pt0_end,
                              CELL *HLow USES_REGS) {
 
   int lvl = push_text_stack();
-  struct cp_frame *to_visit0, *to_visit = Malloc(1024*sizeof(struct cp_frame));
+  struct cp_frame *to_visit0, *to_visit = Malloc(1024*sizeof(struct cp_frame) PASS_REGS);
   struct cp_frame *to_visit_max;
 
    tr_fr_ptr TR0 = TR;
@@ -1665,6 +1667,7 @@ static Int p_nb_queue_enqueue(USES_REGS1) {
   cell_space_t cspace;
   arena = newarena;
   /* garbage collection ? */
+  enter_cell_space(&cspace);
   HR = HB = ArenaPt(arena);
   old_sz = ArenaSz(arena);
   qd = GetQueue(ARG1, "enqueue");
@@ -2058,6 +2061,770 @@ static Int p_nb_heap_size(USES_REGS1) {
   return Yap_unify(ARG2, qd[HEAP_SIZE]);
 }
 
+/* an addressable heap is a 4-ary heap of the form
+ * aheap(Size,Max,Arena,Free,K1,V1,H1,...,KMax,VMax,HMax,P1,...,PMax)
+ * plus an Arena. Every entry gets an integer handle Hi, and Pi gives the
+ * current position of the entry with handle i, or links free handles
+ * together. Handles allow changing the key or removing an entry in
+ * O(log n), without looking for it first. */
+
+#define AHEAP_SIZE 0
+#define AHEAP_MAX 1
+#define AHEAP_ARENA 2
+#define AHEAP_FREE 3
+#define AHEAP_START 4
+
+#define AHEAP_D 4
+
+#define AHeapPos(qd, max) ((qd) + AHEAP_START + 3 * (max))
+/* free handles are stored as -2-Next, so that -1 closes the list */
+#define AHeapFreeLink(next) MkIntTerm(-2 - (Int)(next))
+
+static CELL *GetAHeap(Term t, char *caller) {
+  t = Deref(t);
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, caller);
+    return NULL;
+  }
+  if (!IsApplTerm(t)) {
+    Yap_Error(TYPE_ERROR_COMPOUND, t, caller);
+    return NULL;
+  }
+  if (NameOfFunctor(FunctorOfTerm(t)) != AtomHeapA) {
+    Yap_Error(DOMAIN_ERROR_ARRAY_TYPE, t, caller);
+    return NULL;
+  }
+  return RepAppl(t) + 1;
+}
+
+/* position of a live handle, or -1 */
+static Int AHeapHandle(CELL *qd, Term th, char *caller) {
+  Int h, max = IntegerOfTerm(qd[AHEAP_MAX]);
+
+  th = Deref(th);
+  if (IsVarTerm(th)) {
+    Yap_Error(INSTANTIATION_ERROR, th, caller);
+    return -1;
+  }
+  if (!IsIntTerm(th)) {
+    Yap_Error(TYPE_ERROR_INTEGER, th, caller);
+    return -1;
+  }
+  h = IntOfTerm(th);
+  if (h < 0 || h >= max)
+    return -1;
+  return IntOfTerm(AHeapPos(qd, max)[h]);
+}
+
+static void AHeapSet(CELL *pt, CELL *pos, UInt i, Term k, Term v, Term h) {
+  pt[3 * i] = k;
+  pt[3 * i + 1] = v;
+  pt[3 * i + 2] = h;
+  pos[IntOfTerm(h)] = MkIntTerm(i);
+}
+
+static void AHeapSiftUp(CELL *pt, CELL *pos, UInt i) {
+  Term k = pt[3 * i], v = pt[3 * i + 1], h = pt[3 * i + 2];
+
+  while (i) {
+    UInt p = (i - 1) / AHEAP_D;
+    if (Yap_compare_terms(k, pt[3 * p]) >= 0)
+      break;
+    AHeapSet(pt, pos, i, pt[3 * p], pt[3 * p + 1], pt[3 * p + 2]);
+    i = p;
+  }
+  AHeapSet(pt, pos, i, k, v, h);
+}
+
+static void AHeapSiftDown(CELL *pt, CELL *pos, UInt i, UInt sz) {
+  Term k = pt[3 * i], v = pt[3 * i + 1], h = pt[3 * i + 2];
+
+  while (TRUE) {
+    UInt c = AHEAP_D * i + 1, best = c, j, last = c + AHEAP_D;
+
+    if (c >= sz)
+      break;
+    if (last > sz)
+      last = sz;
+    for (j = c + 1; j < last; j++) {
+      if (Yap_compare_terms(pt[3 * j], pt[3 * best]) < 0)
+        best = j;
+    }
+    if (Yap_compare_terms(pt[3 * best], k) >= 0)
+      break;
+    AHeapSet(pt, pos, i, pt[3 * best], pt[3 * best + 1], pt[3 * best + 2]);
+    i = best;
+  }
+  AHeapSet(pt, pos, i, k, v, h);
+}
+
+/* move the entry at i to where it belongs */
+static void AHeapFix(CELL *pt, CELL *pos, UInt i, UInt sz) {
+  if (i && Yap_compare_terms(pt[3 * i], pt[3 * ((i - 1) / AHEAP_D)]) < 0)
+    AHeapSiftUp(pt, pos, i);
+  else
+    AHeapSiftDown(pt, pos, i, sz);
+}
+
+static void AHeapRemoveAt(CELL *qd, UInt i) {
+  CACHE_REGS
+  UInt sz = IntegerOfTerm(qd[AHEAP_SIZE]) - 1,
+       max = IntegerOfTerm(qd[AHEAP_MAX]);
+  CELL *pt = qd + AHEAP_START, *pos = AHeapPos(qd, max);
+  Int h = IntOfTerm(pt[3 * i + 2]);
+
+  pos[h] = AHeapFreeLink(IntOfTerm(qd[AHEAP_FREE]));
+  qd[AHEAP_FREE] = MkIntTerm(h);
+  if (i != sz) {
+    AHeapSet(pt, pos, i, pt[3 * sz], pt[3 * sz + 1], pt[3 * sz + 2]);
+    AHeapFix(pt, pos, i, sz);
+  }
+  pt[3 * sz] = pt[3 * sz + 1] = pt[3 * sz + 2] = TermNil;
+  qd[AHEAP_SIZE] = Global_MkIntegerTerm(sz);
+}
+
+static void AHeapInitSlots(CELL *qd, UInt from, UInt max, Int next_free) {
+  CELL *pt = qd + AHEAP_START, *pos = AHeapPos(qd, max);
+  UInt i;
+
+  for (i = from; i < max; i++) {
+    pt[3 * i] = pt[3 * i + 1] = pt[3 * i + 2] = TermNil;
+    pos[i] = AHeapFreeLink(i + 1 < max ? (Int)i + 1 : next_free);
+  }
+}
+
+static Int nb_aheap(UInt hsize, UInt arg USES_REGS) {
+  Term heap_arena, heap, *ar, *nar;
+  UInt arena_sz = (ASP - HR) / 16;
+
+  if (hsize < 8)
+    hsize = 8;
+  while ((heap = MkZeroApplTerm(
+              Yap_MkFunctor(AtomHeapA, 4 * hsize + AHEAP_START),
+              4 * hsize + AHEAP_START PASS_REGS)) == TermNil) {
+    if (!Yap_gcl((4 * hsize + AHEAP_START + 1) * sizeof(CELL), arg, ENV, P)) {
+      Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+      return FALSE;
+    }
+  }
+  ar = RepAppl(heap) + 1;
+  ar[AHEAP_MAX] = MkIntegerTerm(hsize);
+  ar[AHEAP_FREE] = MkIntTerm(0);
+  AHeapInitSlots(ar, 0, hsize, -1);
+  if (!Yap_unify(heap, XREGS[arg]))
+    return FALSE;
+  if (arena_sz < hsize)
+    arena_sz = hsize;
+  if (arena_sz < 1024)
+    arena_sz = 1024;
+  heap_arena = NewArena(arena_sz, arg, NULL, worker_id);
+  if (heap_arena == 0L) {
+    return FALSE;
+  }
+  nar = RepAppl(Deref(XREGS[arg])) + 1;
+  nar[AHEAP_ARENA] = heap_arena;
+  return TRUE;
+}
+
+static Int p_nb_aheap(USES_REGS1) {
+  Term tsize = Deref(ARG1);
+
+  if (IsVarTerm(tsize)) {
+    Yap_Error(INSTANTIATION_ERROR, tsize, "nb_aheap");
+    return FALSE;
+  }
+  if (!IsIntegerTerm(tsize)) {
+    Yap_Error(TYPE_ERROR_INTEGER, tsize, "nb_aheap");
+    return FALSE;
+  }
+  if (IntegerOfTerm(tsize) < 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, tsize, "nb_aheap");
+    return FALSE;
+  }
+  return nb_aheap(IntegerOfTerm(tsize), 2 PASS_REGS);
+}
+
+/* double the heap in place: handles stay valid */
+static CELL *GrowAHeap(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_add"), *top;
+  UInt hmsize, extra_size, extra_cells, i;
+
+  if (!qd)
+    return NULL;
+  hmsize = IntegerOfTerm(qd[AHEAP_MAX]);
+  top = qd + (AHEAP_START + 4 * hmsize);
+  if ((extra_size = Yap_InsertInGlobal(top, hmsize * 4 * sizeof(CELL))) == 0) {
+    Yap_Error(RESOURCE_ERROR_STACK, TermNil,
+              "No Stack Space for Non-Backtrackable terms");
+    return NULL;
+  }
+  extra_cells = extra_size / sizeof(CELL);
+  extra_size = extra_cells / 4;
+  qd = GetAHeap(ARG1, "nb_aheap_add");
+  top = qd + (AHEAP_START + 4 * hmsize);
+  /* leftovers from page rounding must still be valid cells */
+  for (i = 4 * extra_size; i < extra_cells; i++) {
+    top[i] = MkIntTerm(0);
+  }
+  /* the position table goes after the larger entry table */
+  memmove(AHeapPos(qd, hmsize + extra_size), AHeapPos(qd, hmsize),
+          hmsize * sizeof(CELL));
+  qd[-1] =
+      (CELL)Yap_MkFunctor(AtomHeapA, 4 * (hmsize + extra_size) + AHEAP_START);
+  qd[AHEAP_MAX] = Global_MkIntegerTerm(hmsize + extra_size);
+  AHeapInitSlots(qd, hmsize, hmsize + extra_size,
+                 IntOfTerm(qd[AHEAP_FREE]));
+  qd[AHEAP_FREE] = MkIntTerm(hmsize);
+  return qd;
+}
+
+static Int p_nb_aheap_add(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_add"), *pt, *pos;
+  UInt hsize, hmsize, mingrow;
+  Term arena, key, to;
+  Int h;
+
+  if (!qd)
+    return FALSE;
+  hsize = IntegerOfTerm(qd[AHEAP_SIZE]);
+  hmsize = IntegerOfTerm(qd[AHEAP_MAX]);
+  if (hsize == hmsize) {
+    if ((qd = GrowAHeap(PASS_REGS1)) == NULL)
+      return FALSE;
+    hmsize = IntegerOfTerm(qd[AHEAP_MAX]);
+  }
+  arena = qd[AHEAP_ARENA];
+  mingrow = garena_overflow_size(ArenaPt(arena) PASS_REGS);
+  key = CopyTermToArena(ARG2, arena, FALSE, TRUE, 4, &arena, mingrow PASS_REGS);
+  if (key == 0L)
+    return FALSE;
+  /* protect key in ARG2 in case there is an overflow while copying to */
+  ARG2 = key;
+  qd = GetAHeap(ARG1, "nb_aheap_add");
+  qd[AHEAP_ARENA] = arena;
+  to = CopyTermToArena(ARG3, arena, FALSE, TRUE, 4, &arena, mingrow PASS_REGS);
+  if (to == 0L)
+    return FALSE;
+  qd = GetAHeap(ARG1, "nb_aheap_add");
+  qd[AHEAP_ARENA] = arena;
+  pt = qd + AHEAP_START;
+  pos = AHeapPos(qd, hmsize);
+  h = IntOfTerm(qd[AHEAP_FREE]);
+  qd[AHEAP_FREE] = MkIntTerm(-2 - IntOfTerm(pos[h]));
+  AHeapSet(pt, pos, hsize, ARG2, to, MkIntTerm(h));
+  AHeapSiftUp(pt, pos, hsize);
+  qd[AHEAP_SIZE] = Global_MkIntegerTerm(hsize + 1);
+  return Yap_unify(ARG4, MkIntTerm(h));
+}
+
+static Int p_nb_aheap_del(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_del");
+  Term tk, tv;
+
+  if (!qd)
+    return FALSE;
+  if (qd[AHEAP_SIZE] == MkIntTerm(0))
+    return FALSE;
+  tk = qd[AHEAP_START];
+  tv = qd[AHEAP_START + 1];
+  AHeapRemoveAt(qd, 0);
+  return Yap_unify(tk, ARG2) && Yap_unify(tv, ARG3);
+}
+
+static Int p_nb_aheap_peek(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_peek");
+
+  if (!qd)
+    return FALSE;
+  if (qd[AHEAP_SIZE] == MkIntTerm(0))
+    return FALSE;
+  return Yap_unify(qd[AHEAP_START], ARG2) &&
+         Yap_unify(qd[AHEAP_START + 1], ARG3);
+}
+
+static Int p_nb_aheap_get(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_get");
+  Int i;
+
+  if (!qd)
+    return FALSE;
+  if ((i = AHeapHandle(qd, ARG2, "nb_aheap_get")) < 0)
+    return FALSE;
+  return Yap_unify(qd[AHEAP_START + 3 * i], ARG3) &&
+         Yap_unify(qd[AHEAP_START + 3 * i + 1], ARG4);
+}
+
+static Int aheap_set_key(bool decrease, char *caller USES_REGS) {
+  CELL *qd = GetAHeap(ARG1, caller);
+  Term arena, key;
+  Int i;
+
+  if (!qd)
+    return FALSE;
+  if ((i = AHeapHandle(qd, ARG2, caller)) < 0)
+    return FALSE;
+  if (decrease && Yap_compare_terms(Deref(ARG3), qd[AHEAP_START + 3 * i]) > 0)
+    return FALSE;
+  arena = qd[AHEAP_ARENA];
+  key = CopyTermToArena(ARG3, arena, FALSE, TRUE, 3, &arena,
+                        garena_overflow_size(ArenaPt(arena) PASS_REGS)
+                            PASS_REGS);
+  if (key == 0L)
+    return FALSE;
+  qd = GetAHeap(ARG1, caller);
+  qd[AHEAP_ARENA] = arena;
+  qd[AHEAP_START + 3 * i] = key;
+  if (decrease)
+    AHeapSiftUp(qd + AHEAP_START, AHeapPos(qd, IntegerOfTerm(qd[AHEAP_MAX])),
+                i);
+  else
+    AHeapFix(qd + AHEAP_START, AHeapPos(qd, IntegerOfTerm(qd[AHEAP_MAX])), i,
+             IntegerOfTerm(qd[AHEAP_SIZE]));
+  return TRUE;
+}
+
+static Int p_nb_aheap_update_key(USES_REGS1) {
+  return aheap_set_key(false, "nb_aheap_update_key" PASS_REGS);
+}
+
+/* the new key may not be larger, so the entry can only move up */
+static Int p_nb_aheap_decrease_key(USES_REGS1) {
+  return aheap_set_key(true, "nb_aheap_decrease_key" PASS_REGS);
+}
+
+static Int p_nb_aheap_delete(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_delete");
+  Int i;
+
+  if (!qd)
+    return FALSE;
+  if ((i = AHeapHandle(qd, ARG2, "nb_aheap_delete")) < 0)
+    return FALSE;
+  AHeapRemoveAt(qd, i);
+  return TRUE;
+}
+
+static Int p_nb_aheap_from_list(USES_REGS1) {
+  Term l = Deref(ARG1), arena;
+  CELL *qd, *pt, *pos;
+  UInt n = 0, i;
+
+  while (IsPairTerm(l)) {
+    Term hd = Deref(HeadOfTerm(l));
+    if (IsVarTerm(hd)) {
+      Yap_Error(INSTANTIATION_ERROR, hd, "nb_aheap_from_list");
+      return FALSE;
+    }
+    if (!IsApplTerm(hd) || FunctorOfTerm(hd) != FunctorMinus) {
+      Yap_Error(TYPE_ERROR_COMPOUND, hd, "nb_aheap_from_list");
+      return FALSE;
+    }
+    n++;
+    l = Deref(TailOfTerm(l));
+  }
+  if (IsVarTerm(l)) {
+    Yap_Error(INSTANTIATION_ERROR, l, "nb_aheap_from_list");
+    return FALSE;
+  }
+  if (l != TermNil) {
+    Yap_Error(TYPE_ERROR_LIST, ARG1, "nb_aheap_from_list");
+    return FALSE;
+  }
+  if (!nb_aheap(n, 2 PASS_REGS))
+    return FALSE;
+  qd = GetAHeap(ARG2, "nb_aheap_from_list");
+  arena = qd[AHEAP_ARENA];
+  /* one copy for the whole list */
+  l = CopyTermToArena(ARG1, arena, FALSE, TRUE, 2, &arena,
+                      garena_overflow_size(ArenaPt(arena) PASS_REGS) PASS_REGS);
+  if (l == 0L)
+    return FALSE;
+  qd = GetAHeap(ARG2, "nb_aheap_from_list");
+  qd[AHEAP_ARENA] = arena;
+  pt = qd + AHEAP_START;
+  pos = AHeapPos(qd, IntegerOfTerm(qd[AHEAP_MAX]));
+  for (i = 0; i < n; i++) {
+    Term hd = HeadOfTerm(l);
+    AHeapSet(pt, pos, i, ArgOfTerm(1, hd), ArgOfTerm(2, hd), MkIntTerm(i));
+    l = TailOfTerm(l);
+  }
+  qd[AHEAP_SIZE] = Global_MkIntegerTerm(n);
+  qd[AHEAP_FREE] =
+      MkIntTerm(n < (UInt)IntegerOfTerm(qd[AHEAP_MAX]) ? (Int)n : -1);
+  /* Floyd's bottom-up construction, O(n) */
+  if (n > 1) {
+    i = (n - 2) / AHEAP_D + 1;
+    while (i--) {
+      AHeapSiftDown(pt, pos, i, n);
+    }
+  }
+  return TRUE;
+}
+
+static Int p_nb_aheap_empty(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_empty");
+
+  if (!qd)
+    return FALSE;
+  return (IntegerOfTerm(qd[AHEAP_SIZE]) == 0);
+}
+
+static Int p_nb_aheap_size(USES_REGS1) {
+  CELL *qd = GetAHeap(ARG1, "nb_aheap_size");
+
+  if (!qd)
+    return FALSE;
+  return Yap_unify(ARG2, qd[AHEAP_SIZE]);
+}
+
+/* a non-backtrackable map is an open-addressing hash table of the form
+ * nb_map(Size,Max,Arena,H1,K1,V1,...,HMax,KMax,VMax) plus an Arena. Keys
+ * must be ground. Updating an entry only copies the new value (and the
+ * key, if new) to the arena, so the cost is independent of the size of
+ * the map. Replaced values become unreachable and are recovered by the
+ * garbage collector, as any other dead term. */
+
+#define MAP_SIZE 0
+#define MAP_MAX 1
+#define MAP_ARENA 2
+#define MAP_START 3
+
+#define MAP_EMPTY MkIntTerm(-1)
+#define MAP_HASH_MASK 0xffffffL
+
+#define MAP_MIX(H, V) ((((H) ^ (V)) * 2654435761UL) + ((H) >> 7))
+
+static UInt map_key_hash(Term t) {
+  UInt h = 0;
+
+  while (TRUE) {
+    t = Deref(t);
+    if (IsAtomOrIntTerm(t)) {
+      return MAP_MIX(h, (UInt)t);
+    } else if (IsPairTerm(t)) {
+      h = MAP_MIX(h, map_key_hash(HeadOfTerm(t)));
+      t = TailOfTerm(t);
+    } else {
+      Functor f = FunctorOfTerm(t);
+      CELL *ap = RepAppl(t);
+
+      if (IsExtensionFunctor(f)) {
+        if (f == FunctorString) {
+          const unsigned char *s = UStringOfTerm(t);
+          while (*s)
+            h = MAP_MIX(h, *s++);
+          return h;
+        }
+        /* good enough for floats and long ints, collisions are
+           sorted out by Yap_eq() */
+        return MAP_MIX(h, ap[1]);
+      } else {
+        UInt i, arity = ArityOfFunctor(f);
+
+        h = MAP_MIX(h, (UInt)f);
+        for (i = 1; i < arity; i++)
+          h = MAP_MIX(h, map_key_hash(ap[i]));
+        t = ap[arity];
+      }
+    }
+  }
+}
+
+static CELL *GetMap(Term t, char *caller) {
+  t = Deref(t);
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, caller);
+    return NULL;
+  }
+  if (!IsApplTerm(t)) {
+    Yap_Error(TYPE_ERROR_COMPOUND, t, caller);
+    return NULL;
+  }
+  if (NameOfFunctor(FunctorOfTerm(t)) != AtomNbMap) {
+    Yap_Error(DOMAIN_ERROR_ARRAY_TYPE, t, caller);
+    return NULL;
+  }
+  return RepAppl(t) + 1;
+}
+
+static UInt MapKeyHash(Term key, char *caller) {
+  if (!Yap_IsGroundTerm(key)) {
+    Yap_Error(INSTANTIATION_ERROR, key, caller);
+    return MAP_HASH_MASK + 1;
+  }
+  return map_key_hash(key) & MAP_HASH_MASK;
+}
+
+/* find the slot holding key, or the empty slot where it should go */
+static UInt MapSlot(CELL *pt, UInt max, UInt h, Term key, bool *found) {
+  UInt i = h % max;
+
+  while (TRUE) {
+    CELL *s = pt + 3 * i;
+    if (s[0] == MAP_EMPTY) {
+      *found = false;
+      return i;
+    }
+    if (s[0] == MkIntTerm(h) && Yap_eq(s[1], key)) {
+      *found = true;
+      return i;
+    }
+    i = (i + 1) % max;
+  }
+}
+
+static void ResetMapSlots(CELL *pt, UInt n) {
+  while (n--) {
+    pt[0] = MAP_EMPTY;
+    pt[1] = pt[2] = TermNil;
+    pt += 3;
+  }
+}
+
+static Int nb_map(UInt msize, UInt arg USES_REGS) {
+  Term map_arena, map, *ar, *nar;
+  UInt arena_sz = (ASP - HR) / 16;
+
+  if (msize < 8)
+    msize = 8;
+  while ((map = MkZeroApplTerm(Yap_MkFunctor(AtomNbMap, 3 * msize + MAP_START),
+                               3 * msize + MAP_START PASS_REGS)) == TermNil) {
+    if (!Yap_gcl((3 * msize + MAP_START + 1) * sizeof(CELL), arg, ENV, P)) {
+      Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+      return FALSE;
+    }
+  }
+  ar = RepAppl(map) + 1;
+  ar[MAP_MAX] = MkIntegerTerm(msize);
+  ResetMapSlots(ar + MAP_START, msize);
+  if (!Yap_unify(map, XREGS[arg]))
+    return FALSE;
+  if (arena_sz < MIN_ARENA_SIZE)
+    arena_sz = MIN_ARENA_SIZE;
+  if (arena_sz > MAX_ARENA_SIZE)
+    arena_sz = MAX_ARENA_SIZE;
+  map_arena = NewArena(arena_sz, arg, NULL, worker_id);
+  if (map_arena == 0L) {
+    return FALSE;
+  }
+  nar = RepAppl(Deref(XREGS[arg])) + 1;
+  nar[MAP_ARENA] = map_arena;
+  return TRUE;
+}
+
+static Int p_nb_map(USES_REGS1) { return nb_map(64, 1 PASS_REGS); }
+
+static Int p_nb_map_sized(USES_REGS1) {
+  Term t = Deref(ARG1);
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "nb_map");
+    return FALSE;
+  }
+  if (!IsIntegerTerm(t)) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, "nb_map");
+    return FALSE;
+  }
+  if (IntegerOfTerm(t) < 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, t, "nb_map");
+    return FALSE;
+  }
+  return nb_map((UInt)IntegerOfTerm(t), 2 PASS_REGS);
+}
+
+/* double the number of slots in place, and rehash the entries */
+static CELL *GrowMap(USES_REGS1) {
+  CELL *qd = GetMap(ARG1, "nb_map_put"), *top, *old;
+  UInt hmsize, extra_size, extra_cells, i;
+  int lvl;
+
+  if (!qd)
+    return NULL;
+  hmsize = IntegerOfTerm(qd[MAP_MAX]);
+  top = qd + (MAP_START + 3 * hmsize);
+  if ((extra_size = Yap_InsertInGlobal(top, hmsize * 3 * sizeof(CELL))) == 0) {
+    Yap_Error(RESOURCE_ERROR_STACK, TermNil,
+              "No Stack Space for Non-Backtrackable terms");
+    return NULL;
+  }
+  extra_cells = extra_size / sizeof(CELL);
+  extra_size = extra_cells / 3;
+  qd = GetMap(ARG1, "nb_map_put");
+  top = qd + (MAP_START + 3 * hmsize);
+  /* leftovers from page rounding must still be valid cells */
+  for (i = 3 * extra_size; i < extra_cells; i++) {
+    top[i] = MkIntTerm(0);
+  }
+  lvl = push_text_stack();
+  old = Malloc(3 * hmsize * sizeof(CELL) PASS_REGS);
+  memcpy(old, qd + MAP_START, 3 * hmsize * sizeof(CELL));
+  qd[-1] = (CELL)Yap_MkFunctor(AtomNbMap, 3 * (hmsize + extra_size) + MAP_START);
+  qd[MAP_MAX] = Global_MkIntegerTerm(hmsize + extra_size);
+  ResetMapSlots(qd + MAP_START, hmsize + extra_size);
+  for (i = 0; i < hmsize; i++) {
+    CELL *src = old + 3 * i;
+    if (src[0] != MAP_EMPTY) {
+      UInt j = IntOfTerm(src[0]) % (hmsize + extra_size);
+      CELL *dst;
+
+      while (qd[MAP_START + 3 * j] != MAP_EMPTY)
+        j = (j + 1) % (hmsize + extra_size);
+      dst = qd + MAP_START + 3 * j;
+      dst[0] = src[0];
+      dst[1] = src[1];
+      dst[2] = src[2];
+    }
+  }
+  pop_text_stack(lvl);
+  return qd;
+}
+
+static Int p_nb_map_put(USES_REGS1) {
+  CELL *qd = GetMap(ARG1, "nb_map_put"), *pt;
+  UInt h, hsize, hmsize, slot, mingrow;
+  Term key, arena, to;
+  bool found;
+
+  if (!qd)
+    return FALSE;
+  h = MapKeyHash(Deref(ARG2), "nb_map_put");
+  if (h > MAP_HASH_MASK)
+    return FALSE;
+  hsize = IntegerOfTerm(qd[MAP_SIZE]);
+  hmsize = IntegerOfTerm(qd[MAP_MAX]);
+  /* keep the load factor below 3/4 */
+  if (4 * (hsize + 1) > 3 * hmsize) {
+    if ((qd = GrowMap(PASS_REGS1)) == NULL)
+      return FALSE;
+    hmsize = IntegerOfTerm(qd[MAP_MAX]);
+  }
+  key = Deref(ARG2);
+  slot = MapSlot(qd + MAP_START, hmsize, h, key, &found);
+  arena = qd[MAP_ARENA];
+  mingrow = garena_overflow_size(ArenaPt(arena) PASS_REGS);
+  if (!found) {
+    key = CopyTermToArena(key, arena, FALSE, TRUE, 3, &arena,
+                          mingrow PASS_REGS);
+    if (key == 0L)
+      return FALSE;
+    /* protect the new key in case there is an overflow while copying the
+     * value */
+    ARG2 = key;
+    qd = GetMap(ARG1, "nb_map_put");
+    qd[MAP_ARENA] = arena;
+  }
+  to = CopyTermToArena(ARG3, arena, FALSE, TRUE, 3, &arena, mingrow PASS_REGS);
+  if (to == 0L)
+    return FALSE;
+  qd = GetMap(ARG1, "nb_map_put");
+  qd[MAP_ARENA] = arena;
+  pt = qd + MAP_START + 3 * slot;
+  if (!found) {
+    pt[0] = MkIntTerm(h);
+    pt[1] = ARG2;
+    qd[MAP_SIZE] = Global_MkIntegerTerm(hsize + 1);
+  }
+  pt[2] = to;
+  return TRUE;
+}
+
+static Int p_nb_map_get(USES_REGS1) {
+  CELL *qd = GetMap(ARG1, "nb_map_get");
+  UInt h, slot;
+  bool found;
+
+  if (!qd)
+    return FALSE;
+  h = MapKeyHash(Deref(ARG2), "nb_map_get");
+  if (h > MAP_HASH_MASK)
+    return FALSE;
+  slot = MapSlot(qd + MAP_START, IntegerOfTerm(qd[MAP_MAX]), h, Deref(ARG2),
+                 &found);
+  if (!found)
+    return FALSE;
+  return Yap_unify(ARG3, qd[MAP_START + 3 * slot + 2]);
+}
+
+static Int p_nb_map_del(USES_REGS1) {
+  CELL *qd = GetMap(ARG1, "nb_map_del"), *pt;
+  UInt h, i, j, max;
+  bool found;
+
+  if (!qd)
+    return FALSE;
+  h = MapKeyHash(Deref(ARG2), "nb_map_del");
+  if (h > MAP_HASH_MASK)
+    return FALSE;
+  max = IntegerOfTerm(qd[MAP_MAX]);
+  pt = qd + MAP_START;
+  i = MapSlot(pt, max, h, Deref(ARG2), &found);
+  if (!found)
+    return FALSE;
+  /* backward shift deletion: no tombstones are ever left behind */
+  j = i;
+  while (TRUE) {
+    UInt k;
+
+    j = (j + 1) % max;
+    if (pt[3 * j] == MAP_EMPTY)
+      break;
+    k = IntOfTerm(pt[3 * j]) % max;
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+      continue;
+    pt[3 * i] = pt[3 * j];
+    pt[3 * i + 1] = pt[3 * j + 1];
+    pt[3 * i + 2] = pt[3 * j + 2];
+    i = j;
+  }
+  ResetMapSlots(pt + 3 * i, 1);
+  qd[MAP_SIZE] = Global_MkIntegerTerm(IntegerOfTerm(qd[MAP_SIZE]) - 1);
+  return TRUE;
+}
+
+static Int p_nb_map_size(USES_REGS1) {
+  CELL *qd = GetMap(ARG1, "nb_map_size");
+
+  if (!qd)
+    return FALSE;
+  return Yap_unify(ARG2, qd[MAP_SIZE]);
+}
+
+static Int p_nb_map_to_list(USES_REGS1) {
+  CELL *qd, *pt, *ho;
+  UInt qmax, i;
+
+restart:
+  qd = GetMap(ARG1, "nb_map_to_list");
+  if (!qd)
+    return FALSE;
+  if (qd[MAP_SIZE] == MkIntTerm(0))
+    return Yap_unify(ARG2, TermNil);
+  qmax = IntegerOfTerm(qd[MAP_MAX]);
+  ho = HR;
+  pt = qd + MAP_START;
+  for (i = 0; i < qmax; i++, pt += 3) {
+    if (pt[0] == MAP_EMPTY)
+      continue;
+    if (HR > ASP - 1024) {
+      HR = ho;
+      if (!Yap_gcl(((ASP - HR) - 1024) * sizeof(CELL), 2, ENV, P)) {
+        Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+        return FALSE;
+      }
+      goto restart;
+    }
+    HR[0] = AbsAppl(HR + 2);
+    HR[1] = AbsPair(HR + 5);
+    HR[2] = (CELL)FunctorMinus;
+    HR[3] = pt[1];
+    HR[4] = pt[2];
+    HR += 5;
+  }
+  HR[-4] = TermNil;
+  return Yap_unify(ARG2, AbsPair(ho));
+}
+
 static Int p_nb_beam(USES_REGS1) {
   Term beam_arena, beam, *ar, *nar;
   UInt hsize;
@@ -2741,6 +3508,24 @@ void Yap_InitGlobals(void) {
   Yap_InitCPred("nb_heap_peek", 3, p_nb_heap_peek, SafePredFlag);
   Yap_InitCPred("nb_heap_empty", 1, p_nb_heap_empty, SafePredFlag);
   Yap_InitCPred("nb_heap_size", 2, p_nb_heap_size, SafePredFlag);
+  Yap_InitCPred("nb_aheap", 2, p_nb_aheap, 0L);
+  Yap_InitCPred("nb_aheap_from_list", 2, p_nb_aheap_from_list, 0L);
+  Yap_InitCPred("nb_aheap_add", 4, p_nb_aheap_add, 0L);
+  Yap_InitCPred("nb_aheap_del", 3, p_nb_aheap_del, SafePredFlag);
+  Yap_InitCPred("nb_aheap_peek", 3, p_nb_aheap_peek, SafePredFlag);
+  Yap_InitCPred("nb_aheap_get", 4, p_nb_aheap_get, SafePredFlag);
+  Yap_InitCPred("nb_aheap_update_key", 3, p_nb_aheap_update_key, 0L);
+  Yap_InitCPred("nb_aheap_decrease_key", 3, p_nb_aheap_decrease_key, 0L);
+  Yap_InitCPred("nb_aheap_delete", 2, p_nb_aheap_delete, SafePredFlag);
+  Yap_InitCPred("nb_aheap_empty", 1, p_nb_aheap_empty, SafePredFlag);
+  Yap_InitCPred("nb_aheap_size", 2, p_nb_aheap_size, SafePredFlag);
+  Yap_InitCPred("nb_map", 1, p_nb_map, 0L);
+  Yap_InitCPred("nb_map", 2, p_nb_map_sized, 0L);
+  Yap_InitCPred("nb_map_put", 3, p_nb_map_put, 0L);
+  Yap_InitCPred("nb_map_get", 3, p_nb_map_get, SafePredFlag);
+  Yap_InitCPred("nb_map_del", 2, p_nb_map_del, SafePredFlag);
+  Yap_InitCPred("nb_map_size", 2, p_nb_map_size, SafePredFlag);
+  Yap_InitCPred("nb_map_to_list", 2, p_nb_map_to_list, 0L);
   Yap_InitCPred("nb_beam", 2, p_nb_beam, 0L);
   Yap_InitCPred("nb_beam_close", 1, p_nb_beam_close, SafePredFlag);
   Yap_InitCPred("nb_beam_add", 3, p_nb_beam_add_to_beam, 0L);
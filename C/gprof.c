@@ -79,6 +79,22 @@
  * +  showprofres/0 and showprofres/1
  *    Stop tick counts per predicate.
  * 
+ * The same ticks can instead sample the call stack of a thread, and
+ * give the stacks to flame graph tools:
+ *
+ * + stack_profon/1, stack_profoff/0
+ *   Start and stop sampling the current thread.
+ *
+ * + stack_profres/1
+ *   Write the stacks seen so far to a file, in collapsed format.
+ *
+ * + stack_profreset/0
+ *   Forget the stacks.
+ *
+ * Allocation does not need ticks: alloc_profon/0 and alloc_profoff/0
+ * charge each predicate with the global stack, trail and choice points
+ * it uses, and alloc_profres/1 reports it.
+ *
  *  
   */
 
@@ -1085,14 +1101,21 @@ static Int profinit( USES_REGS1 )
   return(TRUE);
 }
 
+struct stack_profile;
+static bool stack_sampling(struct stack_profile *);
+
 static Int start_profilers(int msec)
 {
+  CACHE_REGS
   struct itimerval t;
   struct sigaction sa;
   
   if (GLOBAL_ProfilerOn!=-1) {
     return FALSE; /* have to go through profinit */
   }
+  if (stack_sampling(LOCAL_StackProfile)) {
+    return FALSE; /* both want SIGPROF */
+  }
   sa.sa_sigaction=prof_alrm;
   sigemptyset(&sa.sa_mask);
   sa.sa_flags=SA_SIGINFO;
@@ -1197,8 +1220,577 @@ static Int profres0( USES_REGS1 ) {
   return(showprofres( PASS_REGS1 ));
 }
 
+/*
+ * Stack sampling: at every tick we walk the environment chain and
+ * record the predicates that are waiting for an answer. Stacks are
+ * counted in a fixed size hash table that belongs to the thread, so
+ * the signal handler never allocates or locks. Calls that reuse the
+ * environment of their caller (last calls) do not show up.
+ */
+
+#if HAVE_TIMER_CREATE && defined(__linux__)
+#include <time.h>
+#include <sys/syscall.h>
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#define THREAD_TIMERS 1
+#endif
+
+#define STACK_DEPTH 32
+#define STACK_TABLE_SIZE 4096 /* must be a power of 2 */
+#define STACK_PROBES 16
+
+/* frames that are not predicates */
+#define STACK_GC ((void *)0x10)
+#define STACK_SHIFT ((void *)0x20)
+#define STACK_SYSTEM ((void *)0x30)
+#define STACK_TOO_DEEP ((void *)0x40)
+
+typedef struct stack_entry {
+  UInt count;
+  UInt hash;
+  UInt depth;
+  /* leaf first; the leaf is a code address if its lower bit is set */
+  void *frames[STACK_DEPTH];
+} stack_entry;
+
+typedef struct stack_profile {
+  UInt samples;
+  UInt lost;
+  int usecs;
+#if THREAD_TIMERS
+  timer_t timer;
+  bool has_timer;
+#endif
+  stack_entry table[STACK_TABLE_SIZE];
+} stack_profile;
+
+static bool
+stack_sampling(stack_profile *sp)
+{
+  return sp && sp->usecs;
+}
+
+static void
+store_stack(stack_profile *sp, void **frames, UInt depth)
+{
+  UInt h = depth, i, j;
+
+  for (i = 0; i < depth; i++)
+    h = (h ^ (CELL)frames[i]) * 0x9E3779B97F4A7C15ULL;
+  h ^= h >> 29;
+  for (j = 0; j < STACK_PROBES; j++) {
+    stack_entry *e = sp->table + ((h + j) & (STACK_TABLE_SIZE - 1));
+
+    if (e->count == 0) {
+      e->hash = h;
+      e->depth = depth;
+      memcpy(e->frames, frames, depth * sizeof(void *));
+      e->count = 1;
+      return;
+    }
+    if (e->hash == h && e->depth == depth &&
+        !memcmp(e->frames, frames, depth * sizeof(void *))) {
+      e->count++;
+      return;
+    }
+  }
+  sp->lost++;
+}
+
+static void
+stack_alrm(int signo, siginfo_t *si, void *scv)
+{
+  CACHE_REGS
+  stack_profile *sp = LOCAL_StackProfile;
+  void *oldpc = (void *) CONTEXT_PC(scv);
+  void *frames[STACK_DEPTH];
+  UInt n = 0;
+  CELL *env;
+
+  if (!sp || !P)
+    return;
+  sp->samples++;
+  if (LOCAL_PrologMode & GCMode) {
+    frames[n++] = STACK_GC;
+  } else if (LOCAL_PrologMode & (GrowHeapMode | GrowStackMode)) {
+    frames[n++] = STACK_SHIFT;
+  } else if (LOCAL_PrologMode & TestMode) {
+    frames[n++] = STACK_SYSTEM;
+  }
+  if (oldpc>(void *) &Yap_absmi && oldpc <= (void *) &Yap_absmiEND) { 
+    frames[n++] = (void *)((CELL)P | 1);
+  } else {
+    op_numbers oop = Yap_op_from_opcode(PREVOP(P,Osbpp)->opc);
+
+    if (oop == _call_cpred || oop == _call_usercpred) {
+      frames[n++] = PREVOP(P,Osbpp)->y_u.Osbpp.p;
+    } else if (Yap_op_from_opcode(P->opc) == _execute_cpred) {
+      frames[n++] = P->y_u.Osbpp.p;
+    } else {
+      frames[n++] = (void *)((CELL)P | 1);
+    }
+  }
+  env = ENV;
+  /* the predicate that owns the current environment, it may well
+     be the leaf */
+  if (env && env >= HR && env < LCL0 && env[E_CP] &&
+      ENV_ToP((yamop *)env[E_CP]) != PredFail)
+    frames[n++] = ENV_ToP((yamop *)env[E_CP]);
+  while (env && env >= HR && env < LCL0) {
+    yamop *cp = (yamop *)env[E_CP];
+    PredEntry *pe;
+
+    if (!cp)
+      break;
+    pe = EnvPreg(cp);
+    if (pe && pe != PredFail) {
+      if (n == STACK_DEPTH - 1) {
+        frames[n++] = STACK_TOO_DEEP;
+        break;
+      }
+      frames[n++] = pe;
+    }
+    if ((CELL *)env[E_E] <= env)
+      break;
+    env = (CELL *)env[E_E];
+  }
+  store_stack(sp, frames, n);
+}
+
+static Int
+stack_timer(stack_profile *sp, int usecs)
+{
+#if THREAD_TIMERS
+  /* each thread counts its own CPU time */
+  struct itimerspec its;
+
+  if (!sp->has_timer) {
+    struct sigevent sev;
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev.sigev_notify_thread_id = syscall(SYS_gettid);
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &sp->timer) < 0)
+      return FALSE;
+    sp->has_timer = true;
+  }
+  its.it_interval.tv_sec = usecs / 1000000;
+  its.it_interval.tv_nsec = (usecs % 1000000) * 1000;
+  its.it_value = its.it_interval;
+  return timer_settime(sp->timer, 0, &its, NULL) == 0;
+#else
+  struct itimerval t;
+
+  t.it_interval.tv_sec = usecs / 1000000;
+  t.it_interval.tv_usec = usecs % 1000000;
+  t.it_value = t.it_interval;
+  return setitimer(ITIMER_PROF, &t, NULL) == 0;
+#endif
+}
+
+/** @pred stack_profon(+ _Usecs_)
+
+    Start sampling the call stack of the current thread every _Usecs_
+    microseconds of CPU time. Samples are added to the ones we already
+    have. The tick profiler cannot run at the same time.
+*/
+static Int
+stack_profon( USES_REGS1 )
+{
+  Term t = Deref(ARG1);
+  stack_profile *sp;
+  struct sigaction sa;
+  Int usecs;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "stack_profon/1");
+    return FALSE;
+  }
+  if (!IsIntegerTerm(t)) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, "stack_profon/1");
+    return FALSE;
+  }
+  usecs = IntegerOfTerm(t);
+  if (usecs <= 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, t, "stack_profon/1");
+    return FALSE;
+  }
+  if (GLOBAL_ProfilerOn > 0)
+    return FALSE;
+  if (!(sp = LOCAL_StackProfile)) {
+    if (!(sp = calloc(1, sizeof(stack_profile)))) {
+      Yap_Error(RESOURCE_ERROR_HEAP, t, "stack_profon/1");
+      return FALSE;
+    }
+    LOCAL_StackProfile = sp;
+  }
+  sa.sa_sigaction = stack_alrm;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_SIGINFO | SA_RESTART;
+  if (sigaction(SIGPROF, &sa, NULL) == -1)
+    return FALSE;
+  sp->usecs = usecs;
+  return stack_timer(sp, usecs);
+}
+
+/** @pred stack_profoff
+
+    Stop sampling the call stack of the current thread.
+*/
+static Int
+stack_profoff( USES_REGS1 )
+{
+  stack_profile *sp = LOCAL_StackProfile;
+
+  if (!sp || !sp->usecs)
+    return FALSE;
+  sp->usecs = 0;
+  return stack_timer(sp, 0);
+}
+
+/** @pred stack_profreset
+
+    Stop sampling and forget the call stacks of the current thread.
+*/
+static Int
+stack_profreset( USES_REGS1 )
+{
+  stack_profile *sp = LOCAL_StackProfile;
+
+  if (!sp)
+    return TRUE;
+  if (sp->usecs)
+    stack_timer(sp, 0);
+#if THREAD_TIMERS
+  if (sp->has_timer)
+    timer_delete(sp->timer);
+#endif
+  LOCAL_StackProfile = NULL;
+  free(sp);
+  return TRUE;
+}
+
+static void
+frame_name(FILE *f, Term mod, Atom name, UInt arity)
+{
+  if (mod != TermProlog && mod != USER_MODULE && IsAtomTerm(mod))
+    fprintf(f, "%s:", RepAtom(AtomOfTerm(mod))->StrOfAE);
+  fprintf(f, "%s/%lu", RepAtom(name)->StrOfAE, (unsigned long)arity);
+}
+
+static void
+pred_frame(FILE *f, PredEntry *pe)
+{
+  Term mod = pe->ModuleOfPred;
+
+  if (pe->ModuleOfPred == IDB_MODULE) {
+    if (pe->PredFlags & NumberDBPredFlag) {
+      fprintf(f, "%ld", (long)pe->src.IndxId);
+      return;
+    } else if (pe->PredFlags & AtomDBPredFlag) {
+      frame_name(f, mod, (Atom)pe->FunctorOfPred, 0);
+      return;
+    }
+  }
+  if (!mod)
+    mod = TermProlog;
+  if (pe->ArityOfPE)
+    frame_name(f, mod, NameOfFunctor(pe->FunctorOfPred), pe->ArityOfPE);
+  else
+    frame_name(f, mod, (Atom)pe->FunctorOfPred, 0);
+}
+
+/* write a stack the way flame graph tools like it: root first, frames
+   separated by semicolons, and then the number of samples */
+static void
+write_stack(FILE *f, stack_entry *e)
+{
+  Int i;
+  Atom name = NULL;
+  UInt arity = 0;
+  Term mod = TermProlog;
+  Int first = 0;
+
+  while (first < e->depth && (CELL)e->frames[first] <= (CELL)STACK_TOO_DEEP)
+    first++;
+  if (first < e->depth && ((CELL)e->frames[first] & 1)) {
+    if (!Yap_PredForCode((yamop *)((CELL)e->frames[first] - 1),
+                         FIND_PRED_FROM_ANYWHERE, &name, &arity, &mod))
+      name = NULL;
+  }
+  for (i = e->depth - 1; i >= 0; i--) {
+    void *fr = e->frames[i];
+
+    /* the owner of the environment is often the leaf itself */
+    if (i == first + 1 && (CELL)fr > (CELL)STACK_TOO_DEEP) {
+      PredEntry *pe = fr;
+      if (fr == e->frames[first])
+        continue;
+      if (name && pe->ArityOfPE == arity &&
+          (arity ? NameOfFunctor(pe->FunctorOfPred)
+                 : (Atom)pe->FunctorOfPred) == name)
+        continue;
+    }
+    if (fr == STACK_GC) {
+      fputs("$garbage_collector", f);
+    } else if (fr == STACK_SHIFT) {
+      fputs("$stack_shifter", f);
+    } else if (fr == STACK_SYSTEM) {
+      fputs("$system", f);
+    } else if (fr == STACK_TOO_DEEP) {
+      fputs("...", f);
+    } else if ((CELL)fr & 1) {
+      if (name)
+        frame_name(f, mod, name, arity);
+      else
+        fputs("?", f);
+    } else {
+      pred_frame(f, fr);
+    }
+    fputc(i ? ';' : ' ', f);
+  }
+  fprintf(f, UInt_FORMAT "\n", e->count);
+}
+
+/** @pred stack_profres(+ _File_)
+
+    Write the call stacks sampled for the current thread to _File_,
+    one line per stack in the collapsed format read by flame graph
+    tools, such as `flamegraph.pl`.
+*/
+static Int
+stack_profres( USES_REGS1 )
+{
+  stack_profile *sp = LOCAL_StackProfile;
+  Term t = Deref(ARG1);
+  const char *s;
+  FILE *f;
+  UInt i;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "stack_profres/1");
+    return FALSE;
+  }
+  if (!(s = Yap_TextTermToText(t PASS_REGS))) {
+    Yap_Error(TYPE_ERROR_ATOM, t, "stack_profres/1");
+    return FALSE;
+  }
+  if (!sp)
+    return FALSE;
+  if ((f = fopen(s, "w")) == NULL) {
+    Yap_Error(PERMISSION_ERROR_OUTPUT_STREAM, t, "stack_profres/1");
+    return FALSE;
+  }
+  for (i = 0; i < STACK_TABLE_SIZE; i++) {
+    if (sp->table[i].count)
+      write_stack(f, sp->table + i);
+  }
+  if (sp->lost)
+    fprintf(f, "$lost " UInt_FORMAT "\n", sp->lost);
+  fclose(f);
+  return TRUE;
+}
+
 #endif /* LOW_PROF */
 
+/*
+ * Allocation profiling: the emulator calls Yap_AllocProfile() whenever
+ * it enters a predicate or returns to one. Whatever the global stack,
+ * the trail and the choice point stack grew since the previous call
+ * is charged to the predicate that was running meanwhile. Failure is
+ * not seen, so after backtracking the predicate that failed keeps
+ * being charged until the next call or exit.
+ */
+
+#define ALLOC_TABLE_SIZE 4096 /* must be a power of 2 */
+#define ALLOC_PROBES 16
+#define ALLOC_MAX_CPS 256
+
+typedef struct alloc_entry {
+  PredEntry *pe;
+  UInt calls;
+  UInt cells;        /* on the global stack */
+  UInt trail;        /* trail entries */
+  UInt choicepoints; /* left behind */
+} alloc_entry;
+
+typedef struct alloc_profile {
+  PredEntry *current;
+  CELL *h;
+  tr_fr_ptr tr;
+  choiceptr b;
+  UInt lost;
+  alloc_entry table[ALLOC_TABLE_SIZE];
+} alloc_profile;
+
+static alloc_entry *
+alloc_entry_for(alloc_profile *ap, PredEntry *pe)
+{
+  UInt h = ((CELL)pe >> 3) * 0x9E3779B97F4A7C15ULL, j;
+
+  h ^= h >> 29;
+  for (j = 0; j < ALLOC_PROBES; j++) {
+    alloc_entry *e = ap->table + ((h + j) & (ALLOC_TABLE_SIZE - 1));
+
+    if (e->pe == pe)
+      return e;
+    if (e->pe == NULL) {
+      e->pe = pe;
+      return e;
+    }
+  }
+  ap->lost++;
+  return NULL;
+}
+
+void
+Yap_AllocProfile(PredEntry *pe, bool call USES_REGS)
+{
+  alloc_profile *ap = LOCAL_AllocProfile;
+  alloc_entry *e;
+
+  /* stacks may have moved since we last looked */
+  if (ap->current && ap->h >= H0 && ap->h <= HR &&
+      (e = alloc_entry_for(ap, ap->current))) {
+    e->cells += HR - ap->h;
+    if (TR > ap->tr)
+      e->trail += TR - ap->tr;
+    if (B < ap->b) {
+      choiceptr b = B;
+      UInt n = 0;
+
+      while (b && b < ap->b && n < ALLOC_MAX_CPS) {
+        n++;
+        b = b->cp_b;
+      }
+      e->choicepoints += n;
+    }
+  }
+  ap->h = HR;
+  ap->tr = TR;
+  ap->b = B;
+  ap->current = pe;
+  if (call && pe && (e = alloc_entry_for(ap, pe)))
+    e->calls++;
+}
+
+/** @pred alloc_profon
+
+    Start charging predicates called by the current thread with what
+    they allocate. Counts are added to the ones we already have.
+*/
+static Int
+alloc_profon( USES_REGS1 )
+{
+  alloc_profile *ap;
+
+  if (!(ap = LOCAL_AllocProfileData)) {
+    if (!(ap = calloc(1, sizeof(alloc_profile)))) {
+      Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "alloc_profon/0");
+      return FALSE;
+    }
+    LOCAL_AllocProfileData = ap;
+  }
+  ap->current = NULL;
+  LOCAL_AllocProfile = ap;
+  return TRUE;
+}
+
+/** @pred alloc_profoff
+
+    Stop profiling allocation, but keep the counts.
+*/
+static Int
+alloc_profoff( USES_REGS1 )
+{
+  LOCAL_AllocProfile = NULL;
+  return TRUE;
+}
+
+/** @pred alloc_profreset
+
+    Stop profiling allocation and forget the counts.
+*/
+static Int
+alloc_profreset( USES_REGS1 )
+{
+  LOCAL_AllocProfile = NULL;
+  if (LOCAL_AllocProfileData) {
+    free(LOCAL_AllocProfileData);
+    LOCAL_AllocProfileData = NULL;
+  }
+  return TRUE;
+}
+
+static int
+cmp_alloc(const void *a, const void *b)
+{
+  const alloc_entry *e1 = a, *e2 = b;
+
+  if (e1->cells != e2->cells)
+    return e1->cells < e2->cells ? 1 : -1;
+  if (e1->trail != e2->trail)
+    return e1->trail < e2->trail ? 1 : -1;
+  return e1->choicepoints < e2->choicepoints
+             ? 1
+             : e1->choicepoints > e2->choicepoints ? -1 : 0;
+}
+
+/** @pred alloc_profres(- _L_)
+
+    Unify _L_ with a list of elements _P_-alloc(_Calls_, _Bytes_,
+    _Trail_, _ChoicePoints_), one per predicate: the number of calls,
+    the bytes it allocated on the global stack, the number of trail
+    entries and of choice points it left behind. The predicates that
+    allocated the most come first.
+*/
+static Int
+alloc_profres( USES_REGS1 )
+{
+  alloc_profile *ap = LOCAL_AllocProfileData;
+  alloc_entry *es;
+  Functor falloc = Yap_MkFunctor(Yap_LookupAtom("alloc"), 4);
+  Functor fminus = Yap_MkFunctor(AtomMinus, 2);
+  Term tl = TermNil;
+  UInt i, n = 0;
+
+  if (!ap)
+    return Yap_unify(ARG1, TermNil);
+  if (!(es = malloc(sizeof(alloc_entry) * ALLOC_TABLE_SIZE))) {
+    Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "alloc_profres/1");
+    return FALSE;
+  }
+  for (i = 0; i < ALLOC_TABLE_SIZE; i++) {
+    if (ap->table[i].pe)
+      es[n++] = ap->table[i];
+  }
+  qsort(es, n, sizeof(alloc_entry), cmp_alloc);
+  while (HR + n * 20 > ASP - 1024) {
+    if (!Yap_gcl(n * 20 * sizeof(CELL), 1, ENV, gc_P(P, CP))) {
+      free(es);
+      Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+      return FALSE;
+    }
+  }
+  for (i = n; i > 0; i--) {
+    alloc_entry *e = es + (i - 1);
+    Term ts[4], tp[2];
+
+    ts[0] = MkIntegerTerm(e->calls);
+    ts[1] = MkIntegerTerm(e->cells * sizeof(CELL));
+    ts[2] = MkIntegerTerm(e->trail);
+    ts[3] = MkIntegerTerm(e->choicepoints);
+    tp[0] = Yap_PredicateToIndicator(e->pe);
+    tp[1] = Yap_MkApplTerm(falloc, 4, ts);
+    tl = MkPairTerm(Yap_MkApplTerm(fminus, 2, tp), tl);
+  }
+  free(es);
+  return Yap_unify(ARG1, tl);
+}
+
 void
 Yap_InitLowProf(void)
 {
@@ -1217,7 +1809,15 @@ Yap_InitLowProf(void)
   Yap_InitCPred("$profison",0 , profison, SafePredFlag);
   Yap_InitCPred("$get_pred_pinfo", 4, getpredinfo, SafePredFlag);
   Yap_InitCPred("showprofres", 4, getpredinfo, SafePredFlag);
+  Yap_InitCPred("stack_profon", 1, stack_profon, SafePredFlag);
+  Yap_InitCPred("stack_profoff", 0, stack_profoff, SafePredFlag);
+  Yap_InitCPred("stack_profreset", 0, stack_profreset, SafePredFlag);
+  Yap_InitCPred("stack_profres", 1, stack_profres, SafePredFlag);
 #endif
+  Yap_InitCPred("alloc_profon", 0, alloc_profon, SafePredFlag);
+  Yap_InitCPred("alloc_profoff", 0, alloc_profoff, SafePredFlag);
+  Yap_InitCPred("alloc_profreset", 0, alloc_profreset, SafePredFlag);
+  Yap_InitCPred("alloc_profres", 1, alloc_profres, SafePredFlag);
 }
 
 
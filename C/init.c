@@ -984,6 +984,7 @@ void Yap_InitCPredBack_(const char *Name, arity_t Arity, arity_t Extra,
 
 static void InitStdPreds(struct yap_boot_params *yapi)
 {
+  CACHE_REGS
   CurrentModule = PROLOG_MODULE;
   Yap_InitCPreds();
   Yap_InitBackCPreds();
@@ -1347,6 +1348,8 @@ void Yap_InitWorkspace(struct yap_boot_params *yapi,
 #ifdef THREADS
   Yap_regp = ((REGSTORE *)pthread_getspecific(Yap_yaamregs_key));
   LOCAL = REMOTE(0);
+  /* the flags need it before the worker is set up */
+  LOCAL_TextBuffer = Yap_InitTextAllocator();
 #endif /* THREADS */
 #if defined(YAPOR_COPY) || defined(YAPOR_COW) || defined(YAPOR_SBA)
   LOCAL = REMOTE(0);
@@ -14,6 +14,7 @@
       /* enter logical pred               */
       BOp(enter_lu_pred, Illss);
       check_trail(TR);
+      LU_SEE_EPOCH();
       /* mark the indexing code */
       {
         LogUpdIndex *cl = PREG->y_u.Illss.I;
@@ -589,6 +590,7 @@
   /* lock logical updates predicate.  */
   Op(lock_lu, p);
 #if PARALLEL_YAP
+  LU_SEE_EPOCH();
   if (PP) {
     GONext();
   }
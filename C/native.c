@@ -0,0 +1,750 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V. Santos Costa and Universidade do Porto 1985-2016 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		native.c						 *
+ * comments:	copy-and-patch native code for hot predicates		 *
+ *									 *
+ *************************************************************************/
+
+/**
+ * @file native.c
+ *
+ * A baseline native code tier. Once switched on, every static predicate
+ * with a single clause starts at a `native_run` instruction that counts
+ * calls. When a predicate is called often enough, we take the longest
+ * run of instructions at the start of its clause that we have stencils
+ * for, copy the stencils (see native_stencils.c) one after the other
+ * into executable memory, and patch in the operands. From then on,
+ * `native_run` calls the native code, and the emulator carries on from
+ * the first instruction we could not compile.
+ *
+ * The clause is never changed: the emulator remains the fallback for
+ * whatever the native code does not handle, and switching the tier off
+ * just makes predicates point at their clauses again.
+ *
+ * While counting, one call in NATIVE_SAMPLE has the emulator run a copy
+ * of the same instructions, closed by a `native_run` that notes the
+ * time taken; every other sample just goes through a `native_run` on
+ * to the clause, to find out what getting there costs. Native runs are sampled as well, so we can tell
+ * how much faster the native code is for each predicate.
+ */
+
+#include "absmi.h"
+#include "native.h"
+#if NATIVE_STENCILS
+#include <sys/mman.h>
+#include <time.h>
+#endif
+
+#define NATIVE_THRESHOLD 1000 /* calls before we compile */
+#define NATIVE_MIN_INSTS 2    /* not worth it for less */
+#define NATIVE_MAX_INSTS 64
+#define NATIVE_SAMPLE 64 /* must be a power of 2 */
+
+/* counters the native code bumps as it runs, without taking a lock */
+#if THREADS
+#define NATIVE_ADD(X, N) __sync_fetch_and_add(&(X), (N))
+#else
+#define NATIVE_ADD(X, N) ((X) += (N))
+#endif
+
+/* runs, leaves and native_* are only ever added to, with NATIVE_ADD;
+   the other fields change with the predicate locked */
+typedef struct native_block {
+  struct native_block *next;
+  PredEntry *pe;
+  yamop *clause; /* what we compile, and where the emulator starts */
+  yamop *exit;   /* first instruction we do not compile */
+  yamop *copy;   /* the same instructions, for the emulator to time */
+  yamop *mark;   /* the native_run closing the copy */
+  yamop *skip;   /* a native_run that just goes on to the clause */
+  UInt insts;
+  native_fn code; /* NULL until the predicate is hot */
+  UInt size;
+  UInt calls;      /* before we compiled */
+  UInt runs;       /* of the native code */
+  UInt leaves;     /* native code gave up before the exit */
+  UInt compile_ns; /* time taken to compile */
+  uint64_t emu_start;
+  bool emu_empty; /* timing an empty copy */
+  uint64_t emu_ticks, emu_samples;
+  uint64_t base_ticks, base_samples;
+  uint64_t native_ticks, native_samples;
+  yamop *entry; /* the native_run the predicate starts at */
+} native_block;
+
+/* a native_run and the block it belongs to */
+#define NATIVE_RUN_SIZE                                                        \
+  ((UInt)NEXTOP((yamop *)NULL, lp) + sizeof(native_block *))
+
+#if NATIVE_STENCILS
+
+/* the entry of a block, or the native_run closing its copy: the block
+   comes after the instruction, as the emulator may fetch the opcode
+   that follows the copy before it gets there */
+static native_block *block_of(yamop *pc) {
+  return *(native_block **)NEXTOP(pc, lp);
+}
+
+static void native_run_to(yamop *pc, yamop *to, native_block *nb) {
+  pc->opc = Yap_opcode(_native_run);
+  pc->y_u.lp.l = to;
+  pc->y_u.lp.p = nb->pe;
+  *(native_block **)NEXTOP(pc, lp) = nb;
+}
+
+#define MAX_STENCIL 1024
+#define MAX_HOLE_USES 4
+
+typedef struct stencil_info {
+  const unsigned char *code;
+  UInt size;  /* what we copy */
+  bool falls; /* ends by running into the next stencil */
+  unsigned char uses[NATIVE_HOLES];
+  unsigned short holes[NATIVE_HOLES][MAX_HOLE_USES];
+} stencil_info;
+
+typedef struct native_inst {
+  native_stencil s;
+  yamop *pc;
+  CELL args[4];
+} native_inst;
+
+static struct {
+  bool on, ready;
+  UInt threshold;
+  native_block *blocks;
+  stencil_info stencils[NATIVE_STENCILS_N];
+} Native;
+
+static uint64_t ticks(void) { return __builtin_ia32_rdtsc(); }
+
+static UInt now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (UInt)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* bytes the compiler may use to pad after a function */
+static bool only_padding(const unsigned char *p, UInt n) {
+  UInt i = 0;
+
+  while (i < n) {
+    while (i < n && (p[i] == 0x66 || p[i] == 0x2e))
+      i++;
+    if (i == n)
+      return false;
+    if (p[i] == 0x90 || p[i] == 0xcc) {
+      i++;
+    } else if (i + 2 < n && p[i] == 0x0f && p[i + 1] == 0x1f &&
+               (p[i + 2] & 0x38) == 0) {
+      /* nopl/nopw with a memory operand */
+      unsigned char modrm = p[i + 2];
+      i += 3;
+      if ((modrm & 7) == 4)
+        i++;
+      if ((modrm >> 6) == 1)
+        i += 1;
+      else if ((modrm >> 6) == 2)
+        i += 4;
+      if (i > n)
+        return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* find the holes in a stencil and how to glue it to the next */
+static bool analyse_stencil(native_stencil s) {
+  stencil_info *si = Native.stencils + s;
+  const unsigned char *p = (const unsigned char *)Yap_NativeStencils[s];
+  const unsigned char *e = (const unsigned char *)Yap_NativeStencils[s + 1];
+  UInt i, o, size;
+  int reg;
+
+  if (!p || e <= p || e - p > MAX_STENCIL)
+    return false;
+  size = e - p;
+  memset(si, 0, sizeof(stencil_info));
+  si->code = p;
+  si->size = size;
+  for (i = 0; i + sizeof(CELL) <= size; i++) {
+    CELL v;
+    UInt h;
+
+    memcpy(&v, p + i, sizeof(CELL));
+    if (v < NATIVE_HOLE_NEXT || v >= NATIVE_HOLE_NEXT + NATIVE_HOLES)
+      continue;
+    h = v - NATIVE_HOLE_NEXT;
+    /* must be the immediate of a movabs, so that we can patch it */
+    if (i < 2 || (p[i - 2] & 0xfe) != 0x48 || (p[i - 1] & 0xf8) != 0xb8 ||
+        si->uses[h] == MAX_HOLE_USES)
+      return false;
+    si->holes[h][si->uses[h]++] = i;
+    i += sizeof(CELL) - 1;
+  }
+  /* movabs $next,%r; jmp *%r as the last instruction: drop it, and just
+     run into the next stencil */
+  if (si->uses[0] != 1)
+    return true;
+  o = si->holes[0][0];
+  reg = ((p[o - 2] & 1) << 3) | (p[o - 1] & 7);
+  i = o + sizeof(CELL);
+  if (reg >= 8) {
+    if (i >= size || p[i] != 0x41)
+      return true;
+    i++;
+  }
+  if (i + 1 >= size || p[i] != 0xff || p[i + 1] != (0xe0 | (reg & 7)) ||
+      !only_padding(p + i + 2, size - (i + 2)))
+    return true;
+  for (i = 1; i < NATIVE_HOLES; i++) {
+    UInt j;
+
+    for (j = 0; j < si->uses[i]; j++)
+      if (si->holes[i][j] > o)
+        return true;
+  }
+  si->size = o - 2;
+  si->falls = true;
+  return true;
+}
+
+static bool native_ready(void) {
+  native_stencil s;
+
+  if (Native.ready)
+    return true;
+  for (s = 0; s < NATIVE_STENCILS_N; s++) {
+    if (!analyse_stencil(s))
+      return false;
+  }
+  return Native.ready = true;
+}
+
+/* the instructions at the start of the clause we have stencils for */
+static UInt translate(yamop *pc, native_inst *is, yamop **exitp) {
+  UInt n = 0;
+
+  while (n < NATIVE_MAX_INSTS) {
+    native_inst *i = is + n;
+
+    i->pc = pc;
+    switch (Yap_op_from_opcode(pc->opc)) {
+    case _get_x_var:
+      i->s = NATIVE_MOVE;
+      i->args[0] = pc->y_u.xx.xr;
+      i->args[1] = pc->y_u.xx.xl;
+      pc = NEXTOP(pc, xx);
+      break;
+    case _put_x_val:
+      i->s = NATIVE_MOVE;
+      i->args[0] = pc->y_u.xx.xl;
+      i->args[1] = pc->y_u.xx.xr;
+      pc = NEXTOP(pc, xx);
+      break;
+    case _put_xx_val:
+      i->s = NATIVE_MOVE2;
+      i->args[0] = pc->y_u.xxxx.xl1;
+      i->args[1] = pc->y_u.xxxx.xr1;
+      i->args[2] = pc->y_u.xxxx.xl2;
+      i->args[3] = pc->y_u.xxxx.xr2;
+      pc = NEXTOP(pc, xxxx);
+      break;
+    case _get_y_var:
+      i->s = NATIVE_STORE_Y;
+      i->args[0] = pc->y_u.yx.y;
+      i->args[1] = pc->y_u.yx.x;
+      pc = NEXTOP(pc, yx);
+      break;
+    case _put_y_val:
+      i->s = NATIVE_LOAD_Y;
+      i->args[0] = pc->y_u.yx.y;
+      i->args[1] = pc->y_u.yx.x;
+      pc = NEXTOP(pc, yx);
+      break;
+    case _put_x_var:
+      i->s = NATIVE_NEW_X;
+      i->args[0] = pc->y_u.xx.xl;
+      i->args[1] = pc->y_u.xx.xr;
+      pc = NEXTOP(pc, xx);
+      break;
+    case _put_y_var:
+      i->s = NATIVE_NEW_Y;
+      i->args[0] = pc->y_u.yx.y;
+      i->args[1] = pc->y_u.yx.x;
+      pc = NEXTOP(pc, yx);
+      break;
+    case _put_atom:
+      i->s = NATIVE_CONST;
+      i->args[0] = pc->y_u.xc.x;
+      i->args[1] = pc->y_u.xc.c;
+      pc = NEXTOP(pc, xc);
+      break;
+    case _put_float:
+      i->s = NATIVE_CONST;
+      i->args[0] = pc->y_u.xd.x;
+      i->args[1] = AbsAppl(pc->y_u.xd.d);
+      pc = NEXTOP(pc, xd);
+      break;
+    case _put_longint:
+      i->s = NATIVE_CONST;
+      i->args[0] = pc->y_u.xi.x;
+      i->args[1] = AbsAppl(pc->y_u.xi.i);
+      pc = NEXTOP(pc, xi);
+      break;
+    case _put_bigint:
+      i->s = NATIVE_CONST;
+      i->args[0] = pc->y_u.xN.x;
+      i->args[1] = pc->y_u.xN.b;
+      pc = NEXTOP(pc, xN);
+      break;
+    case _put_dbterm:
+      i->s = NATIVE_CONST;
+      i->args[0] = pc->y_u.xD.x;
+      i->args[1] = pc->y_u.xD.D;
+      pc = NEXTOP(pc, xD);
+      break;
+    case _get_atom:
+      i->s = NATIVE_GET_CONST;
+      i->args[0] = pc->y_u.xc.x;
+      i->args[1] = pc->y_u.xc.c;
+      pc = NEXTOP(pc, xc);
+      break;
+    case _allocate:
+      i->s = NATIVE_ALLOCATE;
+      pc = NEXTOP(pc, e);
+      break;
+    default:
+      *exitp = pc;
+      return n;
+    }
+    n++;
+  }
+  *exitp = pc;
+  return n;
+}
+
+/* called with the predicate locked, so a block is compiled only once */
+static native_fn compile(native_block *nb) {
+  native_inst is[NATIVE_MAX_INSTS + 1];
+  UInt n, i, size = 0, page = sysconf(_SC_PAGESIZE), alloc;
+  UInt offsets[NATIVE_MAX_INSTS + 2];
+  unsigned char *text;
+  yamop *exit;
+
+  n = translate(nb->clause, is, &exit);
+  if (n != nb->insts || exit != nb->exit)
+    return NULL;
+  is[n].s = NATIVE_EXIT;
+  is[n].pc = exit;
+  for (i = 0; i <= n; i++) {
+    offsets[i] = size;
+    size += Native.stencils[is[i].s].size;
+  }
+  offsets[n + 1] = size;
+  alloc = (size + page - 1) & ~(page - 1);
+  text = mmap(NULL, alloc, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+              -1, 0);
+  if (text == MAP_FAILED)
+    return NULL;
+  for (i = 0; i <= n; i++) {
+    stencil_info *si = Native.stencils + is[i].s;
+    unsigned char *code = text + offsets[i];
+    CELL vals[NATIVE_HOLES];
+    UInt h, j;
+
+    memcpy(code, si->code, si->size);
+    vals[0] = (CELL)(text + offsets[i + 1]);
+    vals[1] = (CELL)is[i].pc;
+    for (h = 2; h < NATIVE_HOLES; h++)
+      vals[h] = is[i].args[h - 2];
+    for (h = 0; h < NATIVE_HOLES; h++) {
+      for (j = 0; j < si->uses[h]; j++) {
+        /* the tail we dropped */
+        if (si->holes[h][j] >= si->size)
+          continue;
+        memcpy(code + si->holes[h][j], vals + h, sizeof(CELL));
+      }
+    }
+  }
+  if (mprotect(text, alloc, PROT_READ | PROT_EXEC) < 0) {
+    munmap(text, alloc);
+    return NULL;
+  }
+  nb->size = size;
+  return (native_fn)text;
+}
+
+static void release_code(native_block *nb) {
+  UInt page = sysconf(_SC_PAGESIZE);
+
+  if (nb->code)
+    munmap((void *)nb->code, (nb->size + page - 1) & ~(page - 1));
+  nb->code = NULL;
+}
+
+/* the emulator runs copy, and then the native_run that closes it; skip
+   comes just before, and times getting to the clause */
+static yamop *make_copy(native_block *nb, native_inst *is, UInt n) {
+  UInt bytes = (char *)nb->exit - (char *)nb->clause;
+  char *copy;
+  UInt i;
+
+  if (!(copy = Yap_AllocCodeSpace(bytes + 2 * NATIVE_RUN_SIZE)))
+    return NULL;
+  nb->skip = (yamop *)copy;
+  native_run_to(nb->skip, nb->clause, nb);
+  copy += NATIVE_RUN_SIZE;
+  memcpy(copy, nb->clause, bytes);
+  /* a superinstruction would run past the copy */
+  for (i = 0; i < n; i++) {
+    yamop *pc = (yamop *)(copy + ((char *)is[i].pc - (char *)nb->clause));
+
+    pc->opc = Yap_opcode(Yap_op_from_opcode(pc->opc));
+  }
+  nb->mark = (yamop *)(copy + bytes);
+  native_run_to(nb->mark, nb->exit, nb);
+  return (yamop *)copy;
+}
+
+static bool watchable(PredEntry *pe) {
+  yamop *cl = pe->cs.p_code.FirstClause;
+
+  return !(pe->PredFlags &
+           (CPredFlag | AsmPredFlag | DynamicPredFlag | LogUpdatePredFlag |
+            TabledPredFlag | SpiedPredFlag | CountPredFlag | ProfiledPredFlag |
+            MegaClausePredFlag | UDIPredFlag)) &&
+         pe->OpcodeOfPred != UNDEF_OPCODE && pe->cs.p_code.NOfClauses == 1 &&
+         cl != NULL && pe->CodeOfPred == cl &&
+         pe->cs.p_code.TrueCodeOfPred == cl && pe->OpcodeOfPred == cl->opc;
+}
+
+static bool installed(native_block *nb) {
+  return nb->pe->CodeOfPred == nb->entry;
+}
+
+static void watch(PredEntry *pe) {
+  native_inst is[NATIVE_MAX_INSTS];
+  native_block *nb;
+  yamop *exit;
+  UInt n;
+
+  if (!watchable(pe))
+    return;
+  n = translate(pe->cs.p_code.FirstClause, is, &exit);
+  if (n < NATIVE_MIN_INSTS)
+    return;
+  if (!(nb = Yap_AllocCodeSpace(sizeof(native_block) + NATIVE_RUN_SIZE)))
+    return;
+  memset(nb, 0, sizeof(native_block));
+  nb->pe = pe;
+  nb->clause = pe->cs.p_code.FirstClause;
+  nb->exit = exit;
+  nb->insts = n;
+  nb->copy = make_copy(nb, is, n);
+  nb->entry = (yamop *)(nb + 1);
+  native_run_to(nb->entry, nb->clause, nb);
+  LOCK(GLOBAL_NativeLock);
+  nb->next = Native.blocks;
+  Native.blocks = nb;
+  UNLOCK(GLOBAL_NativeLock);
+  pe->CodeOfPred = nb->entry;
+  pe->OpcodeOfPred = nb->entry->opc;
+}
+
+/* the emulator closed a timed copy */
+static void end_timing(native_block *nb) {
+  PELOCK(91, nb->pe);
+  if (nb->emu_start) {
+    uint64_t t = ticks() - nb->emu_start;
+
+    if (nb->emu_empty) {
+      nb->base_ticks += t;
+      nb->base_samples++;
+    } else {
+      nb->emu_ticks += t;
+      nb->emu_samples++;
+    }
+    nb->emu_start = 0;
+  }
+  UNLOCKPE(91, nb->pe);
+}
+
+/* not compiled yet: count the call, and compile once it is hot */
+static yamop *count_call(native_block *nb) {
+  yamop *out = nb->clause;
+
+  PELOCK(91, nb->pe);
+  /* another worker may have got here first */
+  if (nb->code) {
+    UNLOCKPE(91, nb->pe);
+    return out;
+  }
+  /* a timed copy that failed */
+  nb->emu_start = 0;
+  if (++nb->calls >= Native.threshold && installed(nb)) {
+    UInt t0 = now_ns();
+    native_fn code = compile(nb);
+
+    nb->compile_ns = now_ns() - t0;
+    if (code) {
+      /* the code must be in place before others can see it */
+      __sync_synchronize();
+      nb->code = code;
+    } else {
+      /* give up on this one */
+      nb->pe->CodeOfPred = nb->clause;
+      nb->pe->OpcodeOfPred = nb->clause->opc;
+    }
+  } else if (nb->copy && !(nb->calls & (NATIVE_SAMPLE - 1))) {
+    nb->emu_empty = !nb->emu_empty;
+    nb->emu_start = ticks();
+    out = nb->emu_empty ? nb->skip : nb->copy;
+  }
+  UNLOCKPE(91, nb->pe);
+  return out;
+}
+
+yamop *Yap_NativeRun(yamop *pc USES_REGS) {
+  native_block *nb = block_of(pc);
+  native_fn code;
+  yamop *out;
+
+  if (pc != nb->entry) {
+    end_timing(nb);
+    return pc->y_u.lp.l;
+  }
+  if (!(code = nb->code))
+    return count_call(nb);
+  if (NATIVE_ADD(nb->runs, 1) & (NATIVE_SAMPLE - 1)) {
+    out = code(&Yap_REGS);
+  } else {
+    uint64_t t0 = ticks();
+
+    out = code(&Yap_REGS);
+    if (out == nb->exit) {
+      NATIVE_ADD(nb->native_ticks, ticks() - t0);
+      NATIVE_ADD(nb->native_samples, 1);
+    }
+  }
+  if (out != nb->exit)
+    NATIVE_ADD(nb->leaves, 1);
+  return out;
+}
+
+void Yap_NativeWatch(PredEntry *pe) {
+  if (Native.on)
+    watch(pe);
+}
+
+void Yap_NativeReset(void) {
+  native_block *nb;
+
+  LOCK(GLOBAL_NativeLock);
+  nb = Native.blocks;
+  Native.on = false;
+  Native.blocks = NULL;
+  UNLOCK(GLOBAL_NativeLock);
+  while (nb) {
+    native_block *next = nb->next;
+
+    PELOCK(92, nb->pe);
+    if (installed(nb)) {
+      nb->pe->CodeOfPred = nb->clause;
+      nb->pe->OpcodeOfPred = nb->clause->opc;
+    }
+    UNLOCKPE(92, nb->pe);
+#if !THREADS
+    /* other threads may still be running this code */
+    release_code(nb);
+    if (nb->copy)
+      Yap_FreeCodeSpace((void *)nb->skip);
+    Yap_FreeCodeSpace((void *)nb);
+#endif
+    nb = next;
+  }
+}
+
+#else
+
+yamop *Yap_NativeRun(yamop *pc USES_REGS) { return pc->y_u.lp.l; }
+
+void Yap_NativeWatch(PredEntry *pe) {}
+
+void Yap_NativeReset(void) {}
+
+#endif /* NATIVE_STENCILS */
+
+static Int start_native(Int calls USES_REGS) {
+#if NATIVE_STENCILS
+  if (!native_ready()) {
+    Yap_Error(SYSTEM_ERROR_JIT_NOT_AVAILABLE, TermNil,
+              "native_on/1: cannot use the stencils in this binary");
+    return FALSE;
+  }
+  Native.threshold = calls;
+  if (!Native.on) {
+    ModEntry *me;
+
+    Native.on = true;
+    for (me = CurrentModules; me; me = me->NextME) {
+      PredEntry *pe;
+
+      for (pe = me->PredForME; pe; pe = pe->NextPredOfModule) {
+        PELOCK(90, pe);
+        watch(pe);
+        UNLOCKPE(90, pe);
+      }
+    }
+  }
+  return TRUE;
+#else
+  Yap_Error(SYSTEM_ERROR_JIT_NOT_AVAILABLE, TermNil,
+            "native_on/1: no native code for this machine");
+  return FALSE;
+#endif
+}
+
+/** @pred native_on(+ _Calls_)
+
+    Compile to native code the static predicates with a single clause
+    once they are called _Calls_ times from now on, and the ones
+    defined later on as well. Raises a system error if we cannot
+    generate native code for this machine.
+*/
+static Int native_on(USES_REGS1) {
+  Term t = Deref(ARG1);
+  Int calls;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "native_on/1");
+    return FALSE;
+  }
+  if (!IsIntegerTerm(t)) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, "native_on/1");
+    return FALSE;
+  }
+  if ((calls = IntegerOfTerm(t)) < 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, t, "native_on/1");
+    return FALSE;
+  }
+  return start_native(calls PASS_REGS);
+}
+
+/** @pred native_on
+
+    Same as native_on/1, with a threshold of 1000 calls.
+*/
+static Int native_on0(USES_REGS1) {
+  return start_native(NATIVE_THRESHOLD PASS_REGS);
+}
+
+/** @pred native_off
+
+    Go back to emulating every predicate, and release the native code.
+*/
+static Int native_off(USES_REGS1) {
+  Yap_NativeReset();
+  return TRUE;
+}
+
+#if NATIVE_STENCILS
+static int cmp_native(const void *a, const void *b) {
+  const native_block *n1 = *(native_block *const *)a,
+                     *n2 = *(native_block *const *)b;
+
+  return n1->runs < n2->runs ? 1 : n1->runs > n2->runs ? -1 : 0;
+}
+#endif
+
+/** @pred native_statistics(- _L_)
+
+    Unify _L_ with a list of elements _P_-native(_Calls_, _Insts_,
+    _Bytes_, _CompileNs_, _Runs_, _Leaves_, _Speedup_), one per
+    predicate in native code: the calls it took to compile it, the
+    number of instructions and bytes of native code, the nanoseconds
+    it took to compile, how often the native code ran and how often
+    it gave up before the end, and how many times faster it is than
+    the emulator on the same instructions, or 0.0 if we have not timed
+    both yet. The predicates that ran native code the most come first.
+*/
+static Int native_statistics(USES_REGS1) {
+  Term tl = TermNil;
+#if NATIVE_STENCILS
+  Functor fnative = Yap_MkFunctor(Yap_LookupAtom("native"), 7);
+  Functor fminus = Yap_MkFunctor(AtomMinus, 2);
+  native_block *nb, **ns;
+  UInt i, n = 0;
+
+  LOCK(GLOBAL_NativeLock);
+  for (nb = Native.blocks; nb; nb = nb->next)
+    if (nb->code)
+      n++;
+  if (!n) {
+    UNLOCK(GLOBAL_NativeLock);
+    return Yap_unify(ARG1, TermNil);
+  }
+  if (!(ns = malloc(sizeof(native_block *) * n))) {
+    UNLOCK(GLOBAL_NativeLock);
+    Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "native_statistics/1");
+    return FALSE;
+  }
+  n = 0;
+  for (nb = Native.blocks; nb; nb = nb->next)
+    if (nb->code)
+      ns[n++] = nb;
+  UNLOCK(GLOBAL_NativeLock);
+  qsort(ns, n, sizeof(native_block *), cmp_native);
+  while (HR + n * 24 > ASP - 1024) {
+    if (!Yap_gcl(n * 24 * sizeof(CELL), 1, ENV, gc_P(P, CP))) {
+      free(ns);
+      Yap_Error(RESOURCE_ERROR_STACK, TermNil, LOCAL_ErrorMessage);
+      return FALSE;
+    }
+  }
+  for (i = n; i > 0; i--) {
+    Term ts[7], tp[2];
+    Float speedup = 0.0;
+
+    nb = ns[i - 1];
+    if (nb->emu_samples && nb->base_samples && nb->native_samples &&
+        nb->native_ticks) {
+      Float emu = (Float)nb->emu_ticks / nb->emu_samples -
+                  (Float)nb->base_ticks / nb->base_samples;
+
+      if (emu > 0.0)
+        speedup = emu / ((Float)nb->native_ticks / nb->native_samples);
+    }
+    ts[0] = MkIntegerTerm(nb->calls);
+    ts[1] = MkIntegerTerm(nb->insts);
+    ts[2] = MkIntegerTerm(nb->size);
+    ts[3] = MkIntegerTerm(nb->compile_ns);
+    ts[4] = MkIntegerTerm(nb->runs);
+    ts[5] = MkIntegerTerm(nb->leaves);
+    ts[6] = MkFloatTerm(speedup);
+    tp[0] = Yap_PredicateToIndicator(nb->pe);
+    tp[1] = Yap_MkApplTerm(fnative, 7, ts);
+    tl = MkPairTerm(Yap_MkApplTerm(fminus, 2, tp), tl);
+  }
+  free(ns);
+#endif
+  return Yap_unify(ARG1, tl);
+}
+
+void Yap_InitNativePreds(void) {
+  Yap_InitCPred("native_on", 0, native_on0, SafePredFlag | SyncPredFlag);
+  Yap_InitCPred("native_on", 1, native_on, SafePredFlag | SyncPredFlag);
+  Yap_InitCPred("native_off", 0, native_off, SafePredFlag | SyncPredFlag);
+  Yap_InitCPred("native_statistics", 1, native_statistics, SafePredFlag);
+}
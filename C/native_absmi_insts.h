@@ -0,0 +1,21 @@
+/************************************************************************\
+ *    Native Code                                                     *
+\************************************************************************/
+
+#ifdef INDENT_CODE
+{
+  {
+#endif /* INDENT_CODE */
+
+      /* native_run    Clause,Pred    run native code for a hot predicate */
+      BOp(native_run, lp);
+      {
+        yamop *new;
+
+        saveregs();
+        new = Yap_NativeRun(PREG PASS_REGS);
+        setregs();
+        PREG = new;
+        JMPNext();
+      }
+      ENDBOp();
@@ -0,0 +1,139 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V. Santos Costa and Universidade do Porto 1985-2016 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		native_stencils.c					 *
+ * comments:	machine code templates for the native code tier	 *
+ *									 *
+ *************************************************************************/
+
+/*
+ * This file is not code that runs as it is: native.c copies the bytes
+ * of each function, patches the holes, and glues the copies together.
+ * So it must be compiled with optimisation, functions kept in source
+ * order, no jump tables, no stack protector, and nothing shared between
+ * functions; see CMakeLists.txt. Stencils must not touch global data
+ * or call functions: the only way out is through a hole.
+ */
+
+#include "Yap.h"
+#include "native.h"
+
+#if NATIVE_STENCILS && defined(__OPTIMIZE__)
+
+/* an immediate the optimiser cannot see through */
+#define HOLE(N)                                                                \
+  ({                                                                           \
+    CELL _hole;                                                                \
+    __asm__("movabsq $" #N ", %0" : "=r"(_hole));                              \
+    _hole;                                                                     \
+  })
+
+#define NEXT() return ((native_fn)HOLE(0x5ae7c0de5ae7c001))(regs)
+#define LEAVE() return (yamop *)HOLE(0x5ae7c0de5ae7c002)
+#define OP_A HOLE(0x5ae7c0de5ae7c003)
+#define OP_B HOLE(0x5ae7c0de5ae7c004)
+#define OP_C HOLE(0x5ae7c0de5ae7c005)
+#define OP_D HOLE(0x5ae7c0de5ae7c006)
+
+#if PRECOMPUTE_REGADDRESS
+#define XR(I) (*(CELL *)(I))
+#else
+#define XR(I) (regs->XTERMS[I])
+#endif
+
+#define STENCIL __attribute__((noinline, noclone, used)) yamop *
+
+STENCIL native_move(REGSTORE *regs) {
+  XR(OP_B) = XR(OP_A);
+  NEXT();
+}
+
+STENCIL native_move2(REGSTORE *regs) {
+  CELL d0 = XR(OP_A), d1 = XR(OP_C);
+  XR(OP_B) = d0;
+  XR(OP_D) = d1;
+  NEXT();
+}
+
+STENCIL native_store_y(REGSTORE *regs) {
+  regs->YENV_[(Int)OP_A] = XR(OP_B);
+  NEXT();
+}
+
+STENCIL native_load_y(REGSTORE *regs) {
+  XR(OP_B) = regs->YENV_[(Int)OP_A];
+  NEXT();
+}
+
+STENCIL native_new_x(REGSTORE *regs) {
+  CELL *pt0 = regs->H_;
+
+  regs->H_ = pt0 + 1;
+  RESET_VARIABLE(pt0);
+  XR(OP_A) = (CELL)pt0;
+  XR(OP_B) = (CELL)pt0;
+  NEXT();
+}
+
+STENCIL native_new_y(REGSTORE *regs) {
+  CELL *pt0 = regs->YENV_ + (Int)OP_A;
+
+  RESET_VARIABLE(pt0);
+  XR(OP_B) = (CELL)pt0;
+  NEXT();
+}
+
+STENCIL native_const(REGSTORE *regs) {
+  XR(OP_A) = OP_B;
+  NEXT();
+}
+
+/* only the common case, the argument is already bound to the
+   constant; binding or failing is left to the emulator */
+STENCIL native_get_const(REGSTORE *regs) {
+  CELL d0 = XR(OP_A);
+
+  while (IsVarTerm(d0)) {
+    CELL d1 = *(CELL *)d0;
+    if (d1 == d0)
+      LEAVE();
+    d0 = d1;
+  }
+  if (d0 != OP_B)
+    LEAVE();
+  NEXT();
+}
+
+STENCIL native_allocate(REGSTORE *regs) {
+  CELL *pt0 = regs->YENV_;
+
+  pt0[E_CP] = (CELL)regs->CP_;
+  pt0[E_E] = (CELL)regs->ENV_;
+#ifdef DEPTH_LIMIT
+  pt0[E_DEPTH] = regs->DEPTH_;
+#endif
+  regs->ENV_ = pt0;
+  NEXT();
+}
+
+STENCIL native_exit(REGSTORE *regs) { LEAVE(); }
+
+STENCIL native_end(REGSTORE *regs) { return NULL; }
+
+native_fn Yap_NativeStencils[NATIVE_STENCILS_N + 1] = {
+    native_move,      native_move2,   native_store_y,  native_load_y,
+    native_new_x,     native_new_y,   native_const,    native_get_const,
+    native_allocate,  native_exit,    native_end};
+
+#elif NATIVE_STENCILS
+
+native_fn Yap_NativeStencils[NATIVE_STENCILS_N + 1];
+
+#endif /* NATIVE_STENCILS */
@@ -57,6 +57,13 @@ static char SccsId[] = "@(#)save.c	1.3 3/15/90";
 #endif
 #include "iopreds.h"
 
+/* where the heap lives in pages of its own, we can map the saved heap
+   instead of reading it */
+#if !USE_SYSTEM_MALLOC && USE_SYSTEM_MMAP && HAVE_SYS_MMAN_H && !defined(_WIN32)
+#include <sys/mman.h>
+#define MAP_SAVED_HEAP 1
+#endif
+
 /*********  hack for accesing several kinds of terms. Should be cleaned **/
 
 static char end_msg[256] = "*** End of YAP saved state *****";
@@ -96,7 +103,7 @@ static CELL *get_cellptr(/* CELL * */ void);
 static int put_info(int, int CACHE_TYPE);
 static int save_regs(int CACHE_TYPE);
 static int save_code_info(void);
-static int save_heap(void);
+static int save_heap(int);
 static int save_stacks(int CACHE_TYPE);
 static int save_crc(void);
 static Int do_save(int CACHE_TYPE);
@@ -107,9 +114,9 @@ static int get_heap_info(CACHE_TYPE1);
 static int get_regs(int CACHE_TYPE);
 static int get_insts(OPCODE[]);
 static int get_hash(void);
-static int CopyCode(CACHE_TYPE1);
+static int CopyCode(CELL CACHE_TYPE);
 static int CopyStacks(CACHE_TYPE1);
-static int get_coded(int, OPCODE[] CACHE_TYPE);
+static int get_coded(int, CELL, OPCODE[] CACHE_TYPE);
 static void restore_codes(void);
 static void RestoreDB(DBEntry *CACHE_TYPE);
 static void RestoreDBTerm(DBTerm *, bool, int CACHE_TYPE);
@@ -131,6 +138,7 @@ static int check_opcodes(OPCODE[]);
 #endif
 static void RestoreHeap(OPCODE[] CACHE_TYPE);
 static Int p_restore(CACHE_TYPE1);
+static Int p_saved_heap_layout(CACHE_TYPE1);
 static void restore_heap_regs(CACHE_TYPE1);
 static void restore_regs(int CACHE_TYPE);
 #ifdef MACYAP
@@ -200,7 +208,7 @@ inline static Int mywrite(FILE *fd, char *buff, Int len) {
 
   while (len > 0) {
     nwritten = fwrite(buff, 1, (size_t)len, fd);
-    if ((long int)nwritten < 0) {
+    if (nwritten == 0) {
       return do_SYSTEM_ERROR_INTERNAL(SYSTEM_ERROR_INTERNAL,
                                       "bad write on saved state");
     }
@@ -211,6 +219,13 @@ inline static Int mywrite(FILE *fd, char *buff, Int len) {
 }
 
 #define FullSaved 1
+/* the heap image starts at a multiple of HEAP_FILE_ALIGN in the file */
+#define AlignedHeap 2
+/* the header says where FAILCODE was */
+#define HeapRegsAt 4
+
+/* as large as any page size we expect to map it with */
+#define HEAP_FILE_ALIGN (64 * K)
 
 /* Where the code was before */
 
@@ -230,6 +245,10 @@ static FILE *errout;
 
 static Int OldHeapUsed;
 
+/* '$saved_heap_layout'/2 can make us save and restore the heap the way
+   older versions did */
+static bool align_saved_heap = true, map_saved_heap = true;
+
 static CELL which_save;
 
 /* Open a file to read or to write */
@@ -238,7 +257,8 @@ static FILE *open_file(const char *my_file, int flag) {
   char flags[6];
   int i = 0;
 
-  if (flag & O_RDONLY) {
+  /* O_RDONLY is usually 0 */
+  if (!(flag & (O_WRONLY | O_CREAT | O_APPEND))) {
     flags[i++] = 'r';
   }
   if (flag & O_CREAT) {
@@ -281,6 +301,20 @@ static Int putcellptr(CELL *l) {
   return mywrite(splfild, (char *)&l, sizeof(CELLPOINTER));
 }
 
+/* where the heap image starts, at the first aligned offset from here */
+static long heap_offset(void) {
+  long off = ftell(splfild);
+
+  if (off < 0)
+    return do_SYSTEM_ERROR_INTERNAL(SYSTEM_ERROR_INTERNAL,
+                                    "bad seek on saved state");
+  off = (off + HEAP_FILE_ALIGN - 1) / HEAP_FILE_ALIGN * HEAP_FILE_ALIGN;
+  if (fseek(splfild, off, SEEK_SET) < 0)
+    return do_SYSTEM_ERROR_INTERNAL(SYSTEM_ERROR_INTERNAL,
+                                    "bad seek on saved state");
+  return off;
+}
+
 /* gets a cell from a file */
 static CELL get_cell(void) {
   CELL l;
@@ -353,6 +387,9 @@ static int put_info(int info, int mode USES_REGS) {
   /* Space used for trail */
   if (putout(Unsigned(TR) - Unsigned(LOCAL_TrailBase)) < 0)
     return -1;
+  /* the code in the heap points to the heap registers */
+  if ((info & HeapRegsAt) && putout((CELL)FAILCODE) < 0)
+    return -1;
   return 0;
 }
 
@@ -480,13 +517,12 @@ static int save_code_info(void) {
   return 0;
 }
 
-static int save_heap(void) {
-#ifdef USE_SYSTEM_MALLOC
-  return -1;
-#endif
+static int save_heap(int info) {
   int j;
   /* Then save the whole heap */
-  Yap_ResetConsultStack();
+  /* aligned, so that restore can map it */
+  if ((info & AlignedHeap) && heap_offset() < 0)
+    return -1;
   j = Unsigned(HeapTop) - Unsigned(Yap_HeapBase);
   /* store 10 more cells because of the memory manager */
   if (mywrite(splfild, (char *)Yap_HeapBase, j) < 0)
@@ -545,41 +581,76 @@ static int save_crc(void) {
   return mywrite(splfild, end_msg, 256);
 }
 
+/* the file we were writing is no good: remove it, and say why */
+static Int save_failed(const char *msg) {
+  CACHE_REGS
+  int err = errno;
+
+  if (splfild) {
+    fclose(splfild);
+    splfild = NULL;
+  }
+  unlink(LOCAL_FileNameBuf);
+  Yap_Error(SYSTEM_ERROR_SAVED_STATE,
+            MkAtomTerm(Yap_LookupAtom(LOCAL_FileNameBuf)), "save/1: %s (%s)",
+            msg, strerror(err));
+  return FALSE;
+}
+
 static Int do_save(int mode USES_REGS) {
   Term t1 = Deref(ARG1);
+  int info;
 
+  /* find out whether we can save before we touch anything */
+  if (!Yap_GetName(LOCAL_FileNameBuf, YAP_FILENAME_MAX, t1)) {
+    Yap_Error(TYPE_ERROR_LIST, t1, "save/1");
+    return FALSE;
+  }
+#if USE_SYSTEM_MALLOC
+  Yap_Error(SYSTEM_ERROR_SAVED_STATE,
+            MkAtomTerm(Yap_LookupAtom(LOCAL_FileNameBuf)),
+            "save/1: the data base is in system malloc, and cannot be saved");
+  return FALSE;
+#endif
   if (Yap_HoleSize) {
-    Yap_Error(SYSTEM_ERROR_INTERNAL,
+    Yap_Error(SYSTEM_ERROR_SAVED_STATE,
               MkAtomTerm(Yap_LookupAtom(LOCAL_FileNameBuf)),
-              "restore/1: address space has holes of size %ld, cannot save",
+              "save/1: address space has holes of size %ld, cannot save",
               (long int)Yap_HoleSize);
     return FALSE;
   }
-  if (!Yap_GetName(LOCAL_FileNameBuf, YAP_FILENAME_MAX, t1)) {
-    Yap_Error(TYPE_ERROR_LIST, t1, "save/1");
+#if MAP_SAVED_HEAP
+  /* write a new file: whoever restored from the old one may still
+     have its heap mapped */
+  unlink(LOCAL_FileNameBuf);
+#endif
+  if ((splfild = open_file(LOCAL_FileNameBuf, O_WRONLY | O_CREAT)) == NULL) {
+    Yap_Error(SYSTEM_ERROR_SAVED_STATE,
+              MkAtomTerm(Yap_LookupAtom(LOCAL_FileNameBuf)),
+              "save/1: open(%s)", strerror(errno));
     return FALSE;
   }
   Yap_CloseStreams();
-  if ((splfild = open_file(LOCAL_FileNameBuf, O_WRONLY | O_CREAT)) < 0) {
-    Yap_Error(SYSTEM_ERROR_INTERNAL,
-              MkAtomTerm(Yap_LookupAtom(LOCAL_FileNameBuf)),
-              "restore/1, open(%s)", strerror(errno));
-    return (FALSE);
-  }
-  if (put_info(FullSaved, mode PASS_REGS) < 0)
-    return -1;
-  if (save_regs(mode PASS_REGS) < 0)
-    return -1;
-  if (save_code_info() < 0)
-    return -1;
-  if (save_heap() < 0)
-    return -1;
-  if (save_stacks(mode PASS_REGS) < 0)
-    return -1;
-  if (save_crc() < 0)
-    return -1;
-  close_file();
-  return (TRUE);
+  /* native code does not survive a restore */
+  Yap_NativeReset();
+  /* nobody else is running, erased clauses can go now */
+  Yap_LUReclaimAll();
+  /* before we write down where the heap ends */
+  Yap_ResetConsultStack();
+  info = FullSaved | HeapRegsAt;
+  if (align_saved_heap)
+    info |= AlignedHeap;
+  if (put_info(info, mode PASS_REGS) < 0 ||
+      save_regs(mode PASS_REGS) < 0 || save_code_info() < 0 ||
+      save_heap(info) < 0 || save_stacks(mode PASS_REGS) < 0 ||
+      save_crc() < 0)
+    return save_failed("cannot write the saved state");
+  if (fclose(splfild) < 0) {
+    splfild = NULL;
+    return save_failed("cannot close the saved state");
+  }
+  splfild = NULL;
+  return TRUE;
 }
 
 /* Saves a complete prolog environment */
@@ -605,13 +676,12 @@ static Int p_save2(USES_REGS1) {
   /* avoid double saves */
   if (IsNonVarTerm(t = Deref(ARG2)))
     return TRUE;
-  if (!Yap_unify(ARG2, MkIntTerm(1)))
-    return FALSE;
   which_save = 2;
   CurSlot = Yap_StartSlots();
   res = do_save(DO_EVERYTHING PASS_REGS);
   Yap_CloseSlots(CurSlot);
-  return res;
+  /* only now: the saved state leaves it free, for restore to set to 0 */
+  return res && Yap_unify(ARG2, MkIntTerm(1));
 }
 
 /* Just save the program, not the stacks */
@@ -731,6 +801,22 @@ static int check_header(CELL *info, CELL *ATrail, CELL *AStack,
     if (LOCAL_ErrorMessage)
       return FAIL_RESTORE;
   }
+  if (*info & HeapRegsAt) {
+    CELL regs = get_cell();
+
+    if (LOCAL_ErrorMessage)
+      return FAIL_RESTORE;
+#if !YAPOR
+    /* the heap registers are not in the heap, but next to our own code,
+       and we cannot tell which code in the heap points to them */
+    if (regs != (CELL)FAILCODE) {
+      LOCAL_ErrorMessage =
+          "saved state needs YAP loaded where it was when it was saved";
+      LOCAL_Error_TYPE = SYSTEM_ERROR_SAVED_STATE;
+      return FAIL_RESTORE;
+    }
+#endif
+  }
   return (mode);
 }
 
@@ -915,10 +1001,49 @@ static int get_hash(void) {
                 NUMBER_OF_CHARS * sizeof(char_kind_t));
 }
 
+#if MAP_SAVED_HEAP
+/* map the whole pages of the heap image: they are read when first
+   touched, and copied only if written to. Returns how much we mapped. */
+static UInt map_heap(long off, UInt sz) {
+  UInt len = sz & ~(Yap_page_size - 1);
+
+  if (len == 0 || ((Unsigned(Yap_HeapBase) | off) & (Yap_page_size - 1)))
+    return 0;
+  if (mmap(Yap_HeapBase, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+           fileno(splfild), off) != MAP_FAILED)
+    return len;
+  /* a failed MAP_FIXED may have taken the old pages with it */
+  if (mmap(Yap_HeapBase, len, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+    Yap_Error(SYSTEM_ERROR_FATAL, TermNil,
+              "restore could not map the heap back at %p", Yap_HeapBase);
+  return 0;
+}
+#endif
+
 /* Copy all of the old code to the new Heap */
-static int CopyCode(USES_REGS1) {
-  if (myread(splfild, (char *)Yap_HeapBase,
-             (Unsigned(LOCAL_OldHeapTop) - Unsigned(LOCAL_OldHeapBase))) < 0) {
+static int CopyCode(CELL info USES_REGS) {
+  char *base = (char *)Yap_HeapBase;
+  UInt sz = Unsigned(LOCAL_OldHeapTop) - Unsigned(LOCAL_OldHeapBase);
+
+  if (info & AlignedHeap) {
+    long off = heap_offset();
+
+    if (off < 0)
+      return -1;
+#if MAP_SAVED_HEAP
+    if (map_saved_heap) {
+      UInt mapped = map_heap(off, sz);
+
+      if (mapped && fseek(splfild, off + mapped, SEEK_SET) < 0)
+        return do_SYSTEM_ERROR_INTERNAL(SYSTEM_ERROR_INTERNAL,
+                                        "bad seek on saved state");
+      base += mapped;
+      sz -= mapped;
+    }
+#endif
+  }
+  if (myread(splfild, base, sz) < 0) {
     return -1;
   }
   return 1;
@@ -958,7 +1083,7 @@ static int CopyTrailEntries(USES_REGS1) {
 }
 
 /* get things which are saved in the file */
-static int get_coded(int flag, OPCODE old_ops[] USES_REGS) {
+static int get_coded(int flag, CELL info, OPCODE old_ops[] USES_REGS) {
   char my_end_msg[256];
 
   if (get_regs(flag PASS_REGS) < 0)
@@ -967,7 +1092,7 @@ static int get_coded(int flag, OPCODE old_ops[] USES_REGS) {
     return -1;
   if (get_hash() < 0)
     return -1;
-  if (CopyCode(PASS_REGS1) < 0)
+  if (CopyCode(info PASS_REGS) < 0)
     return -1;
   switch (flag) {
   case DO_EVERYTHING:
@@ -1343,7 +1468,7 @@ static int try_open(const char *inpf, CELL *Astate, CELL *ATrail, CELL *AStack,
     }
     return FAIL_RESTORE;
   }
-  if ((splfild = open_file(inpf, O_RDONLY)) < 0) {
+  if ((splfild = open_file(inpf, O_RDONLY)) == NULL) {
     return FAIL_RESTORE;
   }
   if ((mode = commit_to_saved_state(inpf, Astate, ATrail, AStack, AHeap)) !=
@@ -1558,12 +1683,14 @@ static int Restore(char *s_dir USES_REGS) {
     return (FALSE);
   Yap_ShutdownLoadForeign();
   in_limbo = TRUE;
-  if (get_coded(restore_mode, old_ops PASS_REGS) < 0)
+  if (get_coded(restore_mode, MyState, old_ops PASS_REGS) < 0)
     return FAIL_RESTORE;
   restore_regs(restore_mode PASS_REGS);
   in_limbo = FALSE;
   /*#endif*/
   RestoreHeap(old_ops PASS_REGS);
+  /* the atoms have moved */
+  LOCAL_AtomLengthEpoch = -1;
   switch (restore_mode) {
   case DO_EVERYTHING:
     if (LOCAL_OldHeapBase != Yap_HeapBase || LOCAL_OldLCL0 != LCL0 ||
@@ -1639,8 +1766,28 @@ static Int p_restore(USES_REGS1) {
   return (mode != FAIL_RESTORE);
 }
 
+static bool saved_heap_option(Term t, bool *opt) {
+  if (IsVarTerm(t))
+    return Yap_unify(t, *opt ? TermTrue : TermFalse);
+  if (t != TermTrue && t != TermFalse) {
+    Yap_Error(TYPE_ERROR_BOOLEAN, t, "$saved_heap_layout/2");
+    return false;
+  }
+  *opt = (t == TermTrue);
+  return true;
+}
+
+/* '$saved_heap_layout'(?Aligned, ?Mapped): whether save aligns the heap
+   in the file, and whether restore maps an aligned heap instead of
+   reading it */
+static Int p_saved_heap_layout(USES_REGS1) {
+  return saved_heap_option(Deref(ARG1), &align_saved_heap) &&
+         saved_heap_option(Deref(ARG2), &map_saved_heap);
+}
+
 void Yap_InitSavePreds(void) {
   Yap_InitCPred("$save", 2, p_save2, SyncPredFlag);
   Yap_InitCPred("$save_program", 1, p_save_program, SyncPredFlag);
   Yap_InitCPred("$restore", 1, p_restore, SyncPredFlag);
+  Yap_InitCPred("$saved_heap_layout", 2, p_saved_heap_layout, SafePredFlag);
 }
@@ -598,7 +598,7 @@ static char *AllocScannerMemory(unsigned int size) {
     struct scanner_extra_alloc *ptr;
 
     if (!(ptr = (struct scanner_extra_alloc *)Malloc(
-              size + sizeof(ScannerExtraBlock)))) {
+              size + sizeof(ScannerExtraBlock) PASS_REGS))) {
       return NULL;
     }
     ptr->next = LOCAL_ScannerExtraBlocks;
@@ -613,7 +613,7 @@ static char *AllocScannerMemory(unsigned int size) {
       struct scanner_extra_alloc *ptr;
 
       if (!(ptr = (struct scanner_extra_alloc *)Malloc(
-                size + sizeof(ScannerExtraBlock)))) {
+                size + sizeof(ScannerExtraBlock) PASS_REGS))) {
         return NULL;
       }
       ptr->next = LOCAL_ScannerExtraBlocks;
@@ -630,6 +630,47 @@ char *Yap_AllocScannerMemory(unsigned int size) {
   return AllocScannerMemory(size);
 }
 
+/*
+  The token image is where the text of a token is put together. It is
+  kept from one read to the next, so that reading a term does not
+  start by allocating it, unless a huge token made it grow too much.
+*/
+#define TOKEN_IMAGE_SIZE 1024
+#define TOKEN_IMAGE_KEEP (64 * 1024)
+
+static char *token_image(size_t *szp) {
+  CACHE_REGS
+  if (LOCAL_ScannerImageSize > TOKEN_IMAGE_KEEP) {
+    free(LOCAL_ScannerImage);
+    LOCAL_ScannerImage = NULL;
+  }
+  if (LOCAL_ScannerImage == NULL) {
+    if (!(LOCAL_ScannerImage = malloc(TOKEN_IMAGE_SIZE))) {
+      LOCAL_ScannerImageSize = 0;
+      return NULL;
+    }
+    LOCAL_ScannerImageSize = TOKEN_IMAGE_SIZE;
+  }
+  *szp = LOCAL_ScannerImageSize;
+  return LOCAL_ScannerImage;
+}
+
+static char *grow_token_image(size_t *szp) {
+  CACHE_REGS
+  size_t sz = Yap_Min(LOCAL_ScannerImageSize * 2,
+                      LOCAL_ScannerImageSize + MBYTE);
+  char *image = realloc(LOCAL_ScannerImage, sz);
+
+  if (image == NULL)
+    return NULL;
+  LOCAL_ScannerImage = image;
+  *szp = LOCAL_ScannerImageSize = sz;
+  return image;
+}
+
+/* room left in the token image, keeping space for a wide character */
+#define image_room(image, sz, p) ((unsigned char *)(image) + ((sz)-4) - (p))
+
 extern double atof(const char *);
 
 static Term float_send(char *s, int sign) {
@@ -864,16 +905,29 @@ static int num_send_error_message(char s[]) {
 
 #define number_overflow()                                                      \
   {                                                                            \
-    imgsz = Yap_Min(imgsz * 2, imgsz);                              \
-    char *nbuf;                                                                \
-      nbuf = Realloc(buf, imgsz);                                                left = imgsz - max_size;                                                   \
-      max_size = imgsz;                                                          \
-      buf = nbuf;                                                              \
+    size_t used = sp - buf;                                                    \
+    if (!(buf = grow_token_image(&imgsz)))                                     \
+      return num_send_error_message("Number Too Long");                        \
+    left += imgsz - max_size;                                                  \
+    max_size = imgsz;                                                          \
+    sp = buf + used;                                                           \
+    *bufp = buf;                                                               \
+    *szp = imgsz;                                                              \
+  }
+
+/* copy the digits that follow straight from the stream buffer */
+#define digit_run()                                                            \
+  {                                                                            \
+    size_t n = Yap_StreamScanRun(st, scan_run_digits, 0, (unsigned char *)sp, \
+                                 left - 1);                                    \
+    sp += n;                                                                   \
+    left -= n;                                                                 \
   }
 
 /* reads a number, either integer or float */
 
 static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **bufp, size_t *szp) {
+  CACHE_REGS
   int ch = *chp;
   Int val = 0L, base = ch - '0';
   int might_be_float = TRUE, has_overflow = FALSE;
@@ -944,8 +998,8 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
     *sp++ = ch;
     ch = getchr(st);
     if (!my_isxdigit(ch, 'F', 'f'))  {
-        Term t = ( Yap_local.ActiveError->errorRawTerm ?  Yap_local.ActiveError->errorRawTerm : MkIntegerTerm(ch) );
-        Yap_local.ActiveError->errorRawTerm = 0;
+        Term t = ( LOCAL_ActiveError->errorRawTerm ?  LOCAL_ActiveError->errorRawTerm : MkIntegerTerm(ch) );
+        LOCAL_ActiveError->errorRawTerm = 0;
       Yap_ThrowError(SYNTAX_ERROR, t, "invalid hexadecimal digit 0x%C",ch)   ;
       return 0;
     }
@@ -969,8 +1023,8 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
     base = 8;
     ch = getchr(st);
       if (ch < '0' || ch > '7') {
-          Term t = ( Yap_local.ActiveError->errorRawTerm ?  Yap_local.ActiveError->errorRawTerm : MkIntegerTerm(ch) );
-          Yap_local.ActiveError->errorRawTerm = 0;
+          Term t = ( LOCAL_ActiveError->errorRawTerm ?  LOCAL_ActiveError->errorRawTerm : MkIntegerTerm(ch) );
+          LOCAL_ActiveError->errorRawTerm = 0;
           Yap_ThrowError(SYNTAX_ERROR, t, "invalid octal digit 0x%C",ch)   ;
         return 0;
       }
@@ -979,8 +1033,8 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
     base = 2;
     ch = getchr(st);
     if (ch < '0' || ch > '1') {
-        Term t = ( Yap_local.ActiveError->errorRawTerm ?  Yap_local.ActiveError->errorRawTerm : MkIntegerTerm(ch) );
-        Yap_local.ActiveError->errorRawTerm = 0;
+        Term t = ( LOCAL_ActiveError->errorRawTerm ?  LOCAL_ActiveError->errorRawTerm : MkIntegerTerm(ch) );
+        LOCAL_ActiveError->errorRawTerm = 0;
         Yap_ThrowError(SYNTAX_ERROR, t, "invalid binary digit 0x%C",ch)   ;
       return 0;
     }
@@ -1006,6 +1060,17 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
     val = val * base + ch - '0';
     if (val / base != oval || val - oval * base != ch - '0') /* overflow */
       has_overflow = true;
+    if (base == 10 && val != 0) {
+      char *dp = sp;
+
+      digit_run();
+      for (; dp < sp; dp++) {
+        oval = val;
+        val = val * 10 + *dp - '0';
+        if (val / 10 != oval || val - oval * 10 != *dp - '0')
+          has_overflow = true;
+      }
+    }
     ch = getchr(st);
   }
   if (might_be_float && (ch == '.' || ch == 'e' || ch == 'E')) {
@@ -1048,6 +1113,7 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
           if (--left == 0)
             number_overflow();
           *sp++ = ch;
+          digit_run();
         } while (chtype(ch = getchr(st)) == NU);
       }
     }
@@ -1074,6 +1140,7 @@ static Term get_num(int *chp, int *chbuffp, StreamDesc *st, int sign, char **buf
         if (--left == 0)
           number_overflow();
         *sp++ = ch;
+        digit_run();
       } while (chtype(ch = getchr(st)) == NU);
     }
     *sp = '\0';
@@ -1142,11 +1209,15 @@ Term Yap_scan_num(StreamDesc *inp, bool error_on) {
       LOCAL_Error_TYPE = RESOURCE_ERROR_STACK;
       return 0;
     }
-    size_t sz = 1024;
-    char *buf = Malloc(sz);
-    int lvl = push_text_stack();
+    size_t sz;
+    char *buf = token_image(&sz);
+    if (!buf) {
+      Yap_clean_tokenizer(old_tr, NULL, NULL);
+      LOCAL_ErrorMessage = "Code Space Overflow";
+      LOCAL_Error_TYPE = RESOURCE_ERROR_HEAP;
+      return 0;
+    }
     out = get_num(&ch, &cherr, inp, sign, &buf, &sz); /*  */
-    pop_text_stack(lvl);
   } else {
     out = 0;
   }
@@ -1240,16 +1311,16 @@ const char *Yap_tokText(void *tokptre) {
     return "<QQ>";
   case Number_tok:
     if (IsIntegerTerm(info)) {
-      char *s = Malloc(36);
+      char *s = Malloc(36 PASS_REGS);
       snprintf(s, 35, Int_FORMAT, IntegerOfTerm(info));
       return s;
     } else if (IsFloatTerm(info)) {
-      char *s = Malloc(64);
+      char *s = Malloc(64 PASS_REGS);
       snprintf(s, 63, "%6g", FloatOfTerm(info));
       return s;
     } else {
       size_t len = Yap_gmp_to_size(info, 10);
-      char *s = Malloc(len + 2);
+      char *s = Malloc(len + 2 PASS_REGS);
       return Yap_gmp_to_string(info, s, len + 1, 10);
     }
     break;
@@ -1279,7 +1350,7 @@ static void open_comment(int ch, StreamDesc *st USES_REGS) {
   h0[1] = Yap_StreamPosition(st - GLOBAL_Stream);
   h0[2] = TermNil;
   LOCAL_CommentsNextChar = h0 + 2;
-  LOCAL_CommentsBuff = (wchar_t *)Malloc(1024 * sizeof(wchar_t));
+  LOCAL_CommentsBuff = (wchar_t *)Malloc(1024 * sizeof(wchar_t) PASS_REGS);
   LOCAL_CommentsBuffLim = 1024;
   LOCAL_CommentsBuff[0] = ch;
   LOCAL_CommentsBuffPos = 1;
@@ -1298,7 +1369,7 @@ static void extend_comment(int ch USES_REGS) {
 static void close_comment(USES_REGS1) {
   LOCAL_CommentsBuff[LOCAL_CommentsBuffPos] = '\0';
   *LOCAL_CommentsNextChar = Yap_WCharsToString(LOCAL_CommentsBuff PASS_REGS);
-  Free(LOCAL_CommentsBuff);
+  Free(LOCAL_CommentsBuff PASS_REGS);
   LOCAL_CommentsBuff = NULL;
   LOCAL_CommentsBuffLim = 0;
 }
@@ -1323,10 +1394,14 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
   int32_t ch, och = ' ';
   struct qq_struct_t *cur_qq = NULL;
   int sign = 1;
-  size_t imgsz = 1024;
-  char *TokImage = Malloc(imgsz PASS_REGS);
+  size_t imgsz;
+  char *TokImage = token_image(&imgsz);
   bool store_comments = params->store_comments;
 
+  if (TokImage == NULL) {
+    pop_text_stack(lvl);
+    return CodeSpaceError(NULL, NULL, NULL);
+  }
   InitScannerMemory();
   LOCAL_VarTable = NULL;
   LOCAL_AnonVarTable = NULL;
@@ -1335,6 +1410,7 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
   ch = getchr(st);
   while (chtype(ch) == BS) {
     och=ch;
+    Yap_StreamScanRun(st, scan_run_layout, 0, NULL, 0);
     ch = getchr(st);
   }
   params->tposOUTPUT = Yap_StreamPosition(st - GLOBAL_Stream);
@@ -1359,6 +1435,7 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
     p = t;
   restart:
     while (chtype(ch) == BS) {
+      Yap_StreamScanRun(st, scan_run_layout, 0, NULL, 0);
       ch = getchr(st);
     }
     t->TokPos = GetCurInpPos(st);
@@ -1384,7 +1461,7 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
         close_comment(PASS_REGS1);
       } else {
         while ((ch = getchr(st)) != 10 && chtype(ch) != EF)
-          ;
+          Yap_StreamScanRun(st, scan_run_line, 0, NULL, 0);
       }
       if (chtype(ch) != EF) {
         /* blank space */
@@ -1415,23 +1492,27 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
       isvar = (chtype(och) != LC);
       add_ch_to_buff(och);
       for (; chtype(ch) <= NU; ch = getchr(st)) {
-        if (charp == (unsigned char *)TokImage + (imgsz - 1)) {
-          unsigned char *p0 = (unsigned char *)TokImage;
-          imgsz = Yap_Min(imgsz * 2, imgsz + MBYTE);
-          TokImage = Realloc(p0, imgsz);
-          if (TokImage == NULL) {
+        if (charp >= (unsigned char *)TokImage + (imgsz - 8)) {
+          size_t sz = charp - (unsigned char *)TokImage;
+          if (!(TokImage = grow_token_image(&imgsz))) {
               pop_text_stack(lvl);
               return CodeSpaceError(t, p, l);
           }
-          charp =(unsigned char *) TokImage + (charp - p0);
+          charp =(unsigned char *) TokImage + sz;
         }
         add_ch_to_buff(ch);
+        charp += Yap_StreamScanRun(st, scan_run_alnum, 0, charp,
+                                   image_room(TokImage, imgsz, charp));
       }
       while (ch == '\'' && isvar &&
              params->ce) {
-        if (charp == (unsigned char *)AuxSp - 1024) {
-            pop_text_stack(lvl);
-            return CodeSpaceError(t, p, l);
+        if (charp >= (unsigned char *)TokImage + (imgsz - 8)) {
+          size_t sz = charp - (unsigned char *)TokImage;
+          if (!(TokImage = grow_token_image(&imgsz))) {
+              pop_text_stack(lvl);
+              return CodeSpaceError(t, p, l);
+          }
+          charp =(unsigned char *) TokImage + sz;
         }
         add_ch_to_buff(ch);
         ch = getchr(st);
@@ -1576,15 +1657,13 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
       ch = getchrq(st);
 
       while (TRUE) {
-        if (charp > (unsigned char *)TokImage + (imgsz - 1)) {
+        if (charp >= (unsigned char *)TokImage + (imgsz - 8)) {
 	  size_t sz = charp-(unsigned char *)TokImage;
-          TokImage = Realloc(TokImage, (imgsz = Yap_Min(imgsz * 2, imgsz + MBYTE)));
-          if (TokImage == NULL) {
+          if (!(TokImage = grow_token_image(&imgsz))) {
               pop_text_stack(lvl);
               return CodeSpaceError(t, p, l);
           }
 	  charp = (unsigned char *)TokImage+sz;
-          break;
         }
         if (ch == 10 && (trueGlobalPrologFlag(ISO_FLAG) ||
 			 trueLocalPrologFlag(MULTILINE_QUOTED_TEXT_FLAG))) {
@@ -1611,7 +1690,13 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
             ch = getchrq(st);
           }
         } else {
+          size_t n;
+
           add_ch_to_buff(ch);
+          n = Yap_StreamScanRun(st, scan_run_quoted, quote, charp,
+                                image_room(TokImage, imgsz, charp));
+          charp += n;
+          len += n;
           ch = getchrq(st);
         }
         ++len;
@@ -1764,9 +1849,7 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
         for (; chtype(ch) == SY; ch = getchr(st)) {
           if (charp >= (unsigned char *)TokImage + (imgsz - 10)) {
 	    size_t sz = charp - (unsigned char *)TokImage;
-            imgsz = Yap_Min(imgsz * 2, imgsz + MBYTE);
-            TokImage = Realloc(TokImage, imgsz);
-            if (!TokImage) {
+            if (!(TokImage = grow_token_image(&imgsz))) {
                 pop_text_stack(lvl);
                 return CodeSpaceError(t, p, l);
             }
@@ -1888,7 +1971,7 @@ TokEntry *Yap_tokenizer(struct stream_desc *st,
         if (!qq) {
           LOCAL_ErrorMessage = "quasi quoted's || without {|";
           Yap_ReleasePreAllocCodeSpace((CODEADDR)TokImage);
-          Free(cur_qq);
+          Free(cur_qq PASS_REGS);
           cur_qq = NULL;
           t->Tok = Ord(kind = eot_tok);
           t->TokInfo = TermError;
@@ -2006,14 +2089,14 @@ void Yap_clean_tokenizer(TokEntry *tokstart, VarEntry *vartable,
   struct scanner_extra_alloc *ptr = LOCAL_ScannerExtraBlocks;
   while (ptr) {
     struct scanner_extra_alloc *next = ptr->next;
-    Free(ptr);
+    Free(ptr PASS_REGS);
     ptr = next;
   }
   TR = (tr_fr_ptr)tokstart;
   LOCAL_Comments = TermNil;
   LOCAL_CommentsNextChar = LOCAL_CommentsTail = NULL;
   if (LOCAL_CommentsBuff) {
-    Free(LOCAL_CommentsBuff);
+    Free(LOCAL_CommentsBuff PASS_REGS);
     LOCAL_CommentsBuff = NULL;
   }
   LOCAL_ScannerStack = NULL;
@@ -114,6 +114,7 @@ static PredEntry *get_pred(Term t, Term tmod, char *pname) {
 extern char * Yap_output_bug_location(yamop *yap_pc, int where_from, int psize);
 
 static PredEntry *PredForChoicePt(yamop *p_code, op_numbers *opn) {
+  CACHE_REGS
   while (TRUE) {
     op_numbers opnum;
     if (!p_code)
@@ -1169,7 +1170,8 @@ static Term error_culprit(bool internal USES_REGS) {
 }
 
 yap_error_descriptor_t *
-Yap_prolog_add_culprit(yap_error_descriptor_t *t PASS_REGS) {
+Yap_prolog_add_culprit(yap_error_descriptor_t *t) {
+  CACHE_REGS
   PredEntry *pe;
   void *startp, *endp;
   // case number 1: Yap_Error called from built-in.
@@ -1496,6 +1498,7 @@ static Int p_cpc_info(USES_REGS1) {
 
 static PredEntry *choicepoint_owner(choiceptr cptr, Term *tp, yamop **nclp)
 {
+  CACHE_REGS
   PredEntry *pe =
     NULL;
   int go_on = TRUE;
@@ -1793,7 +1796,7 @@ typedef struct buf_struct_t {
 	lbufsz -= sz;					\
 	break;						\
       }							\
-      char *nbuf = Realloc(buf, bufsize += 1024);	\
+      char *nbuf = Realloc(buf, bufsize += 1024 PASS_REGS);	\
       lbuf = nbuf + (lbuf-buf);				\
       buf  = nbuf;					\
       lbufsz += 1024;					\
@@ -1802,6 +1805,7 @@ typedef struct buf_struct_t {
 
 
 static char *ADDSTR( const char *STR, struct buf_struct_t *bufp ) {					\
+  CACHE_REGS							\
     while (true) {					\
       size_t sz = strlen(STR);					\
       if (sz < lbufsz-256){ \
@@ -1810,7 +1814,7 @@ static char *ADDSTR( const char *STR, struct buf_struct_t *bufp ) {					\
 	lbufsz -= sz;					\
 	break;						\
       }							\
-      char *nbuf = Realloc(buf, bufsize += 1024);	\
+      char *nbuf = Realloc(buf, bufsize += 1024 PASS_REGS);	\
       lbuf = nbuf + (lbuf-buf);				\
       buf  = nbuf;					\
       lbufsz += 1024;					\
@@ -1866,7 +1870,7 @@ static void shortstack( choiceptr b_ptr, CELL * env_ptr , buf_struct_t *bufp) {
     CACHE_REGS
       int lvl = push_text_stack();
     struct buf_struct_t b, *bufp = &b;
-    buf = Malloc(4096);
+    buf = Malloc(4096 PASS_REGS);
     lbuf = buf;
     bufsize = 4096;
     lbufsz = bufsize-256;
@@ -1999,6 +2003,7 @@ static void shortstack( choiceptr b_ptr, CELL * env_ptr , buf_struct_t *bufp) {
 
 
   static bool outputep( CELL *ep, struct buf_struct_t *bufp) {
+    CACHE_REGS
     PredEntry *pe = EnvPreg((yamop *)ep);
     if (!ONLOCAL(ep) || (Unsigned(ep) & (sizeof(CELL) - 1)))
       return false;
@@ -2029,6 +2034,7 @@ static void shortstack( choiceptr b_ptr, CELL * env_ptr , buf_struct_t *bufp) {
   }
 
   static bool outputcp( choiceptr cp, struct buf_struct_t *bufp) {
+    CACHE_REGS
     choiceptr b_ptr = cp;
     PredEntry *pe = Yap_PredForChoicePt(b_ptr,NULL);
     ADDBUF(snprintf(lbuf, lbufsz, "%% %p ", cp));
@@ -2118,7 +2124,7 @@ static void shortstack( choiceptr b_ptr, CELL * env_ptr , buf_struct_t *bufp) {
     PredEntry *pe;
     struct buf_struct_t buf0, *bufp = &buf0;
 
-    buf = Malloc(4096);
+    buf = Malloc(4096 PASS_REGS);
     lbuf = buf;
     bufsize = 4096;
     lbufsz = bufsize-256;
@@ -2158,12 +2164,13 @@ static void shortstack( choiceptr b_ptr, CELL * env_ptr , buf_struct_t *bufp) {
      *
      */
     char * Yap_output_bug_location(yamop *yap_pc, int where_from, int psize) {
+      CACHE_REGS
       Atom pred_name;
       UInt pred_arity;
       Term pred_module;
       Int cl;
 
-      char *o = Malloc(256);
+      char *o = Malloc(256 PASS_REGS);
       if ((cl = Yap_PredForCode(yap_pc, where_from, &pred_name, &pred_arity,
 				&pred_module)) == 0) {
 	/* system predicate */
@@ -1354,7 +1354,7 @@ static Int p_executable(USES_REGS1) {
 
     Yap_AbsoluteFile(GLOBAL_argv[0], true);
     if (!tmp || tmp[0] == '\0' ) {
-      tmp = Malloc(YAP_FILENAME_MAX + 1);
+      tmp = Malloc(YAP_FILENAME_MAX + 1 PASS_REGS);
       strncpy((char *)tmp, Yap_FindExecutable(), YAP_FILENAME_MAX);
     }
   Atom at = Yap_LookupAtom(tmp);
@@ -1608,6 +1608,7 @@ void Yap_InitCPreds(void) {
   Yap_InitEval();
   Yap_InitGrowPreds();
   Yap_InitLowProf();
+  Yap_InitNativePreds();
 #if defined(YAPOR) || defined(TABLING)
   Yap_init_optyap_preds();
 #endif /* YAPOR || TABLING */
@@ -0,0 +1,1137 @@
+
+  /* This file was generated automatically by "yap -L misc/buildsupers"
+     please do not update */
+
+      /* unify_l_y_var */
+      Op(super_unify_l_y_var__get_y_var, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_l_y_var__get_y_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_unify_l_y_var__get_y_var_1, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      GONext();
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_atom__put_x_val, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      goto _super_put_atom__put_x_val_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_atom__put_x_val_1, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      GONext();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__put_x_val, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__put_x_val_1;
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_y_val__put_x_val_1, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      GONext();
+      ENDOp();
+
+      /* unify_y_var */
+      Op(super_unify_y_var__unify_l_x_var, oy);
+      BEGD(d0);
+      d0 = *SREG++;
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)(SREG-1));
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_y_var__unify_l_x_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* unify_l_x_var */
+      BOp(super_unify_y_var__unify_l_x_var_1, ox);
+      ALWAYS_START_PREFETCH(ox);
+      BEGP(pt0);
+      BEGD(d0);
+      d0 = SREG[0];
+      pt0 = &XREG(PREG->y_u.ox.x);
+      PREG = NEXTOP(PREG, ox);
+#ifdef YAPOR_SBA
+      if (d0 == 0)
+	d0 = (CELL)SREG;
+#endif
+      *pt0 = d0;
+      ALWAYS_GONext();
+      ENDD(d0);
+      ENDP(pt0);
+      ALWAYS_END_PREFETCH();
+      ENDBOp();
+
+      /* put_x_var */
+      Op(super_put_x_var__put_atom__put_x_val, xx);
+      BEGP(pt0);
+      pt0 = HR;
+      XREG(PREG->y_u.xx.xl) = Unsigned(pt0);
+      HR = pt0 + 1;
+      XREG(PREG->y_u.xx.xr) = Unsigned(pt0);
+      PREG = NEXTOP(PREG, xx);
+      RESET_VARIABLE(pt0);
+      ENDP(pt0);
+      goto _super_put_x_var__put_atom__put_x_val_1;
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_x_var__put_atom__put_x_val_1, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      goto _super_put_x_var__put_atom__put_x_val_2;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_x_var__put_atom__put_x_val_2, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      GONext();
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_x_val__put_y_val__allocate, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      goto _super_put_x_val__put_y_val__allocate_1;
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_x_val__put_y_val__allocate_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_x_val__put_y_val__allocate_2;
+      ENDOp();
+
+      /* allocate */
+      Op(super_put_x_val__put_y_val__allocate_2, e);
+      CACHE_Y_AS_ENV(YREG);
+      PREG = NEXTOP(PREG, e);
+      ENV_YREG[E_CP] = (CELL) CPREG;
+      ENV_YREG[E_E] = (CELL) ENV;
+#ifdef DEPTH_LIMIT
+      ENV_YREG[E_DEPTH] = DEPTH;
+#endif  /* DEPTH_LIMIT */
+      ENV = ENV_YREG;
+      ENDCACHE_Y_AS_ENV();
+      GONext();
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_l_y_var__get_y_var__put_x_var, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_l_y_var__get_y_var__put_x_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_unify_l_y_var__get_y_var__put_x_var_1, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_unify_l_y_var__get_y_var__put_x_var_2;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_var */
+      Op(super_unify_l_y_var__get_y_var__put_x_var_2, xx);
+      BEGP(pt0);
+      pt0 = HR;
+      XREG(PREG->y_u.xx.xl) = Unsigned(pt0);
+      HR = pt0 + 1;
+      XREG(PREG->y_u.xx.xr) = Unsigned(pt0);
+      PREG = NEXTOP(PREG, xx);
+      RESET_VARIABLE(pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_get_y_var__put_x_var__put_atom, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_get_y_var__put_x_var__put_atom_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_var */
+      Op(super_get_y_var__put_x_var__put_atom_1, xx);
+      BEGP(pt0);
+      pt0 = HR;
+      XREG(PREG->y_u.xx.xl) = Unsigned(pt0);
+      HR = pt0 + 1;
+      XREG(PREG->y_u.xx.xr) = Unsigned(pt0);
+      PREG = NEXTOP(PREG, xx);
+      RESET_VARIABLE(pt0);
+      ENDP(pt0);
+      goto _super_get_y_var__put_x_var__put_atom_2;
+      ENDOp();
+
+      /* put_atom */
+      Op(super_get_y_var__put_x_var__put_atom_2, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      GONext();
+      ENDD(d0);
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_atom__put_x_val__put_y_val, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      goto _super_put_atom__put_x_val__put_y_val_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_atom__put_x_val__put_y_val_1, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      goto _super_put_atom__put_x_val__put_y_val_2;
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_atom__put_x_val__put_y_val_2, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__allocate, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__allocate_1;
+      ENDOp();
+
+      /* allocate */
+      Op(super_put_y_val__allocate_1, e);
+      CACHE_Y_AS_ENV(YREG);
+      PREG = NEXTOP(PREG, e);
+      ENV_YREG[E_CP] = (CELL) CPREG;
+      ENV_YREG[E_E] = (CELL) ENV;
+#ifdef DEPTH_LIMIT
+      ENV_YREG[E_DEPTH] = DEPTH;
+#endif  /* DEPTH_LIMIT */
+      ENV = ENV_YREG;
+      ENDCACHE_Y_AS_ENV();
+      GONext();
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_x_val__put_y_val, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      goto _super_put_x_val__put_y_val_1;
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_x_val__put_y_val_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
+      /* put_x_var */
+      Op(super_put_x_var__put_atom, xx);
+      BEGP(pt0);
+      pt0 = HR;
+      XREG(PREG->y_u.xx.xl) = Unsigned(pt0);
+      HR = pt0 + 1;
+      XREG(PREG->y_u.xx.xr) = Unsigned(pt0);
+      PREG = NEXTOP(PREG, xx);
+      RESET_VARIABLE(pt0);
+      ENDP(pt0);
+      goto _super_put_x_var__put_atom_1;
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_x_var__put_atom_1, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      GONext();
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_get_y_var__put_x_var, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_get_y_var__put_x_var_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_x_var */
+      Op(super_get_y_var__put_x_var_1, xx);
+      BEGP(pt0);
+      pt0 = HR;
+      XREG(PREG->y_u.xx.xl) = Unsigned(pt0);
+      HR = pt0 + 1;
+      XREG(PREG->y_u.xx.xr) = Unsigned(pt0);
+      PREG = NEXTOP(PREG, xx);
+      RESET_VARIABLE(pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__put_y_val, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      goto _super_get_yy_var__put_y_val_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_get_yy_var__put_y_val_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_l_y_var__get_y_var__put_y_vals, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_l_y_var__get_y_var__put_y_vals_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_unify_l_y_var__get_y_var__put_y_vals_1, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_unify_l_y_var__get_y_var__put_y_vals_2;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_vals */
+      Op(super_unify_l_y_var__get_y_var__put_y_vals_2, yyxx);
+      ALWAYS_START_PREFETCH(yyxx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yyxx.y1];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yyxx.x1) = (CELL)(YREG+PREG->y_u.yyxx.y1);
+      else
+#endif
+	XREG(PREG->y_u.yyxx.x1) = d0;
+      ENDD(d0);
+      /* allow for some prefetching */
+      PREG = NEXTOP(PREG, yyxx);
+      BEGD(d1);
+      d1 = YREG[PREVOP(PREG,yyxx)->y_u.yyxx.y2];
+#ifdef YAPOR_SBA
+      if (d1 == 0) /* new variable */
+	XREG(PREVOP(PREG->y_u.yyxx,yyxx).x2) = (CELL)(YREG+PREG->y_u.yyxx.y2);
+      else
+#endif
+	XREG(PREVOP(PREG,yyxx)->y_u.yyxx.x2) = d1;
+      ENDD(d1);
+      ALWAYS_GONext();
+      ALWAYS_END_PREFETCH();
+      ENDOp();
+
+      /* unify_y_var */
+      Op(super_unify_y_var__unify_l_y_var__get_y_var, oy);
+      BEGD(d0);
+      d0 = *SREG++;
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)(SREG-1));
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_y_var__unify_l_y_var__get_y_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_y_var__unify_l_y_var__get_y_var_1, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_y_var__unify_l_y_var__get_y_var_2;
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_unify_y_var__unify_l_y_var__get_y_var_2, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      GONext();
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* unify_y_var */
+      Op(super_unify_y_var__unify_l_y_var, oy);
+      BEGD(d0);
+      d0 = *SREG++;
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)(SREG-1));
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_y_var__unify_l_y_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_y_var__unify_l_y_var_1, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      GONext();
+      ENDD(d0);
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_get_y_var__put_y_vals, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_get_y_var__put_y_vals_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_vals */
+      Op(super_get_y_var__put_y_vals_1, yyxx);
+      ALWAYS_START_PREFETCH(yyxx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yyxx.y1];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yyxx.x1) = (CELL)(YREG+PREG->y_u.yyxx.y1);
+      else
+#endif
+	XREG(PREG->y_u.yyxx.x1) = d0;
+      ENDD(d0);
+      /* allow for some prefetching */
+      PREG = NEXTOP(PREG, yyxx);
+      BEGD(d1);
+      d1 = YREG[PREVOP(PREG,yyxx)->y_u.yyxx.y2];
+#ifdef YAPOR_SBA
+      if (d1 == 0) /* new variable */
+	XREG(PREVOP(PREG->y_u.yyxx,yyxx).x2) = (CELL)(YREG+PREG->y_u.yyxx.y2);
+      else
+#endif
+	XREG(PREVOP(PREG,yyxx)->y_u.yyxx.x2) = d1;
+      ENDD(d1);
+      ALWAYS_GONext();
+      ALWAYS_END_PREFETCH();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__put_y_var, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__put_y_var_1;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_val__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__put_y_val__put_y_var, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      goto _super_get_yy_var__put_y_val__put_y_var_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_get_yy_var__put_y_val__put_y_var_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_get_yy_var__put_y_val__put_y_var_2;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_get_yy_var__put_y_val__put_y_var_2, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__put_list, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__put_list_1;
+      ENDOp();
+
+      /* put_list */
+      Op(super_put_y_val__put_list_1, x);
+      CACHE_S();
+      READ_IN_S();
+      S_SREG = HR;
+      HR += 2;
+      BEGD(d0);
+      d0 = AbsPair(S_SREG);
+      XREG(PREG->y_u.x.x) = d0;
+      PREG = NEXTOP(PREG, x);
+      ENDD(d0);
+      WRITEBACK_S(S_SREG);
+      ENDCACHE_S();
+      GONext();
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_var__put_y_var, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      goto _super_put_y_var__put_y_var_1;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_var__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__put_y_var__put_y_var, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__put_y_var__put_y_var_1;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_val__put_y_var__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      goto _super_put_y_val__put_y_var__put_y_var_2;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_val__put_y_var__put_y_var_2, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_y_var__put_y_val, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      goto _super_put_y_var__put_y_val_1;
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_var__put_y_val_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
+      /* get_y_var */
+      Op(super_get_y_var__put_y_var, yx);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      d0 = XREG(PREG->y_u.yx.x);
+      PREG = NEXTOP(PREG, yx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      goto _super_get_y_var__put_y_var_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_get_y_var__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* put_x_val */
+      Op(super_put_x_val__put_y_var, xx);
+      BEGD(d0);
+      d0 = XREG(PREG->y_u.xx.xl);
+      XREG(PREG->y_u.xx.xr) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, xx);
+      goto _super_put_x_val__put_y_var_1;
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_x_val__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__get_yy_var, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      goto _super_get_yy_var__get_yy_var_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__get_yy_var_1, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      GONext();
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_atom__put_y_var, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      goto _super_put_atom__put_y_var_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_var */
+      Op(super_put_atom__put_y_var_1, yx);
+      BEGP(pt0);
+      pt0 = YREG + PREG->y_u.yx.y;
+      XREG(PREG->y_u.yx.x) = (CELL) pt0;
+      PREG = NEXTOP(PREG, yx);
+#if defined(YAPOR_SBA) && defined(FROZEN_STACKS)
+      /* We must initialize a shared variable to point to the SBA */
+      if (Unsigned((Int)(pt0)-(Int)(H_FZ)) >
+	  Unsigned((Int)(B_FZ)-(Int)(H_FZ))) {
+	*pt0 =  (CELL)STACK_TO_SBA(pt0);
+      } else
+#endif /* YAPOR_SBA && FROZEN_STACKS */
+	INITIALIZE_PERMVAR(pt0, (CELL)pt0);
+      ENDP(pt0);
+      GONext();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__get_yy_var__put_y_val, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      goto _super_get_yy_var__get_yy_var__put_y_val_1;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* get_yy_var */
+      Op(super_get_yy_var__get_yy_var__put_y_val_1, yyxx);
+      CACHE_Y(YREG);
+      BEGD(d0);
+      BEGP(pt0);
+      pt0 = S_YREG + PREG->y_u.yyxx.y1;
+      d0 = XREG(PREG->y_u.yyxx.x1);
+      BEGD(d1);
+      BEGP(pt1);
+      pt1 = S_YREG + PREG->y_u.yyx.y2;
+      d1 = XREG(PREG->y_u.yyxx.x2);
+      PREG = NEXTOP(PREG, yyxx);
+      INITIALIZE_PERMVAR(pt0,d0);
+      INITIALIZE_PERMVAR(pt1,d1);
+      ENDP(pt1);
+      ENDD(d1);
+      goto _super_get_yy_var__get_yy_var__put_y_val_2;
+      ENDP(pt0);
+      ENDD(d0);
+      ENDCACHE_Y();
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_get_yy_var__get_yy_var__put_y_val_2, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_l_y_var__put_y_val__put_atom, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_l_y_var__put_y_val__put_atom_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_unify_l_y_var__put_y_val__put_atom_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_unify_l_y_var__put_y_val__put_atom_2;
+      ENDOp();
+
+      /* put_atom */
+      Op(super_unify_l_y_var__put_y_val__put_atom_2, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      GONext();
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_put_y_val__put_atom, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      goto _super_put_y_val__put_atom_1;
+      ENDOp();
+
+      /* put_atom */
+      Op(super_put_y_val__put_atom_1, xc);
+      BEGD(d0);
+      d0 = PREG->y_u.xc.c;
+      XREG(PREG->y_u.xc.x) = d0;
+      PREG = NEXTOP(PREG, xc);
+      GONext();
+      ENDD(d0);
+      ENDOp();
+
+      /* unify_l_y_var */
+      Op(super_unify_l_y_var__put_y_val, oy);
+      BEGD(d0);
+      d0 = SREG[0];
+#ifdef YAPOR_SBA
+      if (d0 == 0) {
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,(CELL)SREG);
+      } else
+#else
+	INITIALIZE_PERMVAR(YREG+PREG->y_u.oy.y,d0);
+#endif /* YAPOR_SBA */
+      PREG = NEXTOP(PREG, oy);
+      goto _super_unify_l_y_var__put_y_val_1;
+      ENDD(d0);
+      ENDOp();
+
+      /* put_y_val */
+      Op(super_unify_l_y_var__put_y_val_1, yx);
+      BEGD(d0);
+      d0 = YREG[PREG->y_u.yx.y];
+#ifdef YAPOR_SBA
+      if (d0 == 0) /* new variable */
+	XREG(PREG->y_u.yx.x) = (CELL)(YREG+PREG->y_u.yx.y);
+      else
+#endif
+	XREG(PREG->y_u.yx.x) = d0;
+      ENDD(d0);
+      PREG = NEXTOP(PREG, yx);
+      GONext();
+      ENDOp();
+
@@ -84,7 +84,7 @@ typedef struct non_single_struct_t {
 \
  reset:\
  lvl = push_text_stack();\
-  to_visit0 = Malloc(auxsz);				    \
+  to_visit0 = Malloc(auxsz PASS_REGS);				    \
 pt0 = pt0_; pt0_end = pt0_end_;						\
 to_visit = to_visit0,							\
     to_visit_max = to_visit +  auxsz/sizeof(struct non_single_struct_t);\
@@ -297,7 +297,7 @@ bool Yap_IsCyclicTerm(Term t USES_REGS) {
 */
 static Int cyclic_term(USES_REGS1) /* cyclic_term(+T)		 */
 {
-  return Yap_IsCyclicTerm(Deref(ARG1));
+  return Yap_IsCyclicTerm(Deref(ARG1) PASS_REGS);
 }
 
 static Term BREAK_LOOP(CELL d0,struct non_single_struct_t  *to_visit ) {
@@ -319,7 +319,7 @@ static int cycles_in_complex_term( CELL *pt0_, CELL *pt0_end_ USES_REGS) {
  reset:
   lvl = push_text_stack();
   pt0 = pt0_, pt0_end = pt0_end_;
-    to_visit0 = Malloc(auxsz);
+    to_visit0 = Malloc(auxsz PASS_REGS);
   to_visit= to_visit0;
   to_visit_max = to_visit0 + auxsz/sizeof(struct non_single_struct_t);
   CELL *InitialH = HR;
@@ -465,7 +465,7 @@ Term Yap_CyclesInTerm(Term t USES_REGS) {
 */
 static Int cycles_in_term(USES_REGS1) /* cyclic_term(+T)		 */
 {
-  return Yap_CyclesInTerm(Deref(ARG1));
+  return Yap_CyclesInTerm(Deref(ARG1) PASS_REGS);
 }
 
 /**
@@ -1035,7 +1035,7 @@ static Int free_variables_in_term(
    if (IsPrimitiveTerm(t))
     out = TermNil;
   else {
-    out = new_vars_in_complex_term(&(t)-1, &(t), Yap_TermVariables(bounds, 3) PASS_REGS);
+    out = new_vars_in_complex_term(&(t)-1, &(t), Yap_TermVariables(bounds, 3 PASS_REGS) PASS_REGS);
   }
 
 if (found_module && t != t0) {
@@ -1246,7 +1246,7 @@ static int max_numbered_var(CELL * pt0_, CELL * pt0_end_,
   def_overflow();
 }
 
-static Int MaxNumberedVar(Term inp, UInt arity PASS_REGS) {
+static Int MaxNumberedVar(Term inp, UInt arity USES_REGS) {
   Term t = Deref(inp);
 
   if (IsPrimitiveTerm(t)) {
@@ -1275,6 +1275,7 @@ static Int largest_numbervar(USES_REGS1) {
 }
 
 static Term UNFOLD_LOOP(Term t, Term * b) {
+  CACHE_REGS
   Term os[2], o;
   os[0] = o = MkVarTerm();
   os[1] = t;
@@ -1300,6 +1301,7 @@ static Int t_ref(cl_connector *d, cl_connector * q, Int *mep, Int max) {
 }
 
 static Int create_entry(Term t, Int i, Int j,  cl_connector * q, Int max) {
+  CACHE_REGS
   Term ref, h, *s, *ostart;
   ssize_t n;
   //  fprintf(stderr,"[%ld,%ld]/%ld, %lx\n",i,j,max,t);
@@ -1385,7 +1387,7 @@ Term Yap_BreakCycles(Term inp, UInt arity, Term * listp USES_REGS) {
 
   Term t = Deref(inp);
   ssize_t qsize = 2048, qlen = 0;
-  cl_connector *q = Malloc(qsize * sizeof(cl_connector));
+  cl_connector *q = Malloc(qsize * sizeof(cl_connector) PASS_REGS);
   Term *s;
   Int i = 0;
 
@@ -1451,6 +1453,7 @@ static Int rational_term_to_tree(USES_REGS1) {
 }
 
 void Yap_InitTermCPreds(void) {
+  CACHE_REGS
   Yap_InitCPred("cycles_in_term", 2, cycles_in_term, 0);
   Yap_InitCPred("term_variables", 2, term_variables, 0);
   Yap_InitCPred("term_variables", 3, term_variables3, 0);
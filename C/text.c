@@ -59,9 +59,13 @@ typedef struct TextBuffer_manager {
   int lvl;
 } text_buffer_t;
 
-int AllocLevel(void) { return LOCAL_TextBuffer->lvl; }
+int AllocLevel(void) {
+  CACHE_REGS
+  return LOCAL_TextBuffer->lvl;
+}
 //	void pop_text_stack(int i) { LOCAL_TextBuffer->lvl = i; }
 void insert_block(struct mblock *o) {
+  CACHE_REGS
   int lvl = o->lvl;
   o->prev = LOCAL_TextBuffer->last[lvl];
   if (o->prev) {
@@ -76,6 +80,7 @@ void insert_block(struct mblock *o) {
 }
 
 void release_block(struct mblock *o) {
+  CACHE_REGS
   int lvl = o->lvl;
   if (LOCAL_TextBuffer->first[lvl] == o) {
     if (LOCAL_TextBuffer->last[lvl] == o) {
@@ -99,7 +104,7 @@ int push_text_stack__(USES_REGS1) {
   return i;
 }
 
-int pop_text_stack__(int i) {
+int pop_text_stack__(int i USES_REGS) {
   int lvl = LOCAL_TextBuffer->lvl;
   while (lvl >= i) {
     struct mblock *p = LOCAL_TextBuffer->first[lvl];
@@ -116,7 +121,7 @@ int pop_text_stack__(int i) {
   return lvl;
 }
 
-void *pop_output_text_stack__(int i, const void *export) {
+void *pop_output_text_stack__(int i, const void *export USES_REGS) {
   int lvl = LOCAL_TextBuffer->lvl;
   bool found = false;
   while (lvl >= i) {
@@ -260,7 +265,7 @@ static void *codes2buf(Term t0, void *b0, bool get_codes,
   size_t length = 0;
 
   if (t == TermNil) {
-    st0 = Malloc(4);
+    st0 = Malloc(4 PASS_REGS);
     st0[0] = 0;
     return st0;
   }
@@ -347,7 +352,7 @@ static void *codes2buf(Term t0, void *b0, bool get_codes,
     }
   }
 
-  st0 = st = Malloc(length + 1);
+  st0 = st = Malloc(length + 1 PASS_REGS);
   t = t0;
   if (codes) {
     while (IsPairTerm(t)) {
@@ -376,11 +381,12 @@ st +=2;
 }
 
 static unsigned char *latin2utf8(seq_tv_t *inp) {
+  CACHE_REGS
   unsigned char *b0 = inp->val.uc;
   size_t sz = strlen(inp->val.c);
   sz *= 2;
   int ch;
-  unsigned char *buf = Malloc(sz + 1), *pt = buf;
+  unsigned char *buf = Malloc(sz + 1 PASS_REGS), *pt = buf;
   if (!buf)
     return NULL;
   while ((ch = *b0++)) {
@@ -395,9 +401,10 @@ static unsigned char *latin2utf8(seq_tv_t *inp) {
 }
 
 static unsigned char *wchar2utf8(seq_tv_t *inp) {
+  CACHE_REGS
   size_t sz = wcslen(inp->val.w) * 4;
   wchar_t *b0 = inp->val.w;
-  unsigned char *buf = Malloc(sz + 1), *pt = buf;
+  unsigned char *buf = Malloc(sz + 1 PASS_REGS), *pt = buf;
   int ch;
   if (!buf)
     return NULL;
@@ -486,7 +493,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
   }
   if ((inp->val.t == TermNil) && inp->type & YAP_STRING_PREFER_LIST )
   {
-    out = Malloc(4);
+    out = Malloc(4 PASS_REGS);
       memset(out, 0, 4);
       POPRET( out );
     }
@@ -495,7 +502,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
     // Yap_DebugPlWriteln(inp->val.t);
     Atom at = AtomOfTerm(inp->val.t);
     if (RepAtom(at)->UStrOfAE[0] == 0) {
-      out = Malloc(4);
+      out = Malloc(4 PASS_REGS);
       memset(out, 0, 4);
       POPRET( out );
     }
@@ -505,7 +512,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
     }
     {
       size_t sz = strlen(at->StrOfAE);
-      out = Malloc(sz + 1);
+      out = Malloc(sz + 1 PASS_REGS);
       strcpy(out, at->StrOfAE);
       POPRET( out );
     }
@@ -515,7 +522,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
     // Yap_DebugPlWriteln(inp->val.t);
     const char *s = StringOfTerm(inp->val.t);
     if (s[0] == 0) {
-      out = Malloc(4);
+      out = Malloc(4 PASS_REGS);
       memset(out, 0, 4);
       POPRET( out );
     }
@@ -526,7 +533,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
     {
       inp->type |= YAP_STRING_IN_TMP;
       size_t sz = strlen(s);
-      out = Malloc(sz + 1);
+      out = Malloc(sz + 1 PASS_REGS);
       strcpy(out, s);
       POPRET( out );
     }
@@ -554,7 +561,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
   if (inp->type & YAP_STRING_INT && IsIntegerTerm(inp->val.t)) {
     // ASCII, so both LATIN1 and UTF-8
     // Yap_DebugPlWriteln(inp->val.t);
-    out = Malloc(2 * MaxTmp(PASS_REGS1));
+    out = Malloc(2 * MaxTmp(PASS_REGS1) PASS_REGS);
     if (snprintf(out, MaxTmp(PASS_REGS1) - 1, Int_FORMAT,
                  IntegerOfTerm(inp->val.t)) < 0) {
       AUX_ERROR(inp->val.t, 2 * MaxTmp(PASS_REGS1), out, char);
@@ -562,7 +569,7 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
     POPRET( out );
   }
   if (inp->type & YAP_STRING_FLOAT && IsFloatTerm(inp->val.t)) {
-    out = Malloc(2 * MaxTmp(PASS_REGS1));
+    out = Malloc(2 * MaxTmp(PASS_REGS1) PASS_REGS);
     if (!Yap_FormatFloat(FloatOfTerm(inp->val.t), &out, 1024)) {
       pop_text_stack(lvl);
       return NULL;
@@ -572,8 +579,8 @@ unsigned char *Yap_readText(seq_tv_t *inp USES_REGS) {
 #if USE_GMP
   if (inp->type & YAP_STRING_BIG && IsBigIntTerm(inp->val.t)) {
     // Yap_DebugPlWriteln(inp->val.t);
-    out = Malloc(MaxTmp());
-    if (!Yap_mpz_to_string(Yap_BigIntOfTerm(inp->val.t), out, MaxTmp() - 1,
+    out = Malloc(MaxTmp(PASS_REGS1) PASS_REGS);
+    if (!Yap_mpz_to_string(Yap_BigIntOfTerm(inp->val.t), out, MaxTmp(PASS_REGS1) - 1,
                            10)) {
       AUX_ERROR(inp->val.t, MaxTmp(PASS_REGS1), out, char);
     }
@@ -743,7 +750,7 @@ static Atom write_atom(void *s0, seq_tv_t *out USES_REGS) {
     return Yap_LookupAtom(s0);
   } else {
     size_t n = get_utf8(s, -1, &ch);
-    unsigned char *buf = Malloc(n + 1);
+    unsigned char *buf = Malloc(n + 1 PASS_REGS);
     memmove(buf, s0, n + 1);
     return Yap_ULookupAtom(buf);
   }
@@ -755,10 +762,10 @@ void *write_buffer(unsigned char *s0, seq_tv_t *out USES_REGS) {
   size_t min = 0, max = leng;
   if (out->enc == ENC_ISO_UTF8) {
     if (out->val.uc == NULL) { // this should always be the case
-      out->val.uc = Malloc(leng + 1);
+      out->val.uc = Malloc(leng + 1 PASS_REGS);
       strcpy(out->val.c, (char *)s0);
     } else if (out->val.uc != s0) {
-      out->val.c = Malloc(leng + 1);
+      out->val.c = Malloc(leng + 1 PASS_REGS);
       strcpy(out->val.c, (char *)s0);
     }
   } else if (out->enc == ENC_ISO_LATIN1) {
@@ -974,7 +981,7 @@ bool Yap_CVT_Text(seq_tv_t *inp, seq_tv_t *out USES_REGS) {
       if (out->max < leng) {
         const unsigned char *ptr = skip_utf8(buf, out->max);
         size_t diff = (ptr - buf);
-        char *nbuf = Malloc(diff + 1);
+        char *nbuf = Malloc(diff + 1 PASS_REGS);
         memmove(nbuf, buf, diff);
         nbuf[diff] = '\0';
         leng = diff;
@@ -984,13 +991,13 @@ bool Yap_CVT_Text(seq_tv_t *inp, seq_tv_t *out USES_REGS) {
     }
     if (out->type & (YAP_STRING_UPCASE | YAP_STRING_DOWNCASE)) {
       if (out->type & YAP_STRING_UPCASE) {
-        if (!upcase(buf, out)) {
+        if (!upcase(buf, out PASS_REGS)) {
           pop_text_stack(l);
           return false;
         }
       }
       if (out->type & YAP_STRING_DOWNCASE) {
-        if (!downcase(buf, out)) {
+        if (!downcase(buf, out PASS_REGS)) {
           pop_text_stack(l);
           return false;
         }
@@ -1025,7 +1032,7 @@ static unsigned char *concat(int n, void *sv[] USES_REGS) {
     if (s[0])
       room += strlen(s);
   }
-  buf = Malloc(room + 1);
+  buf = Malloc(room + 1 PASS_REGS);
   buf0 = buf;
   for (i = 0; i < n; i++) {
     char *s = sv[i];
@@ -1042,19 +1049,52 @@ static unsigned char *concat(int n, void *sv[] USES_REGS) {
 }
 
 static void *slice(size_t min, size_t max, const unsigned char *buf USES_REGS) {
-  unsigned char *nbuf = BaseMalloc((max - min) * 4 + 1);
   const unsigned char *ptr = skip_utf8(buf, min);
-  unsigned char *nptr = nbuf;
-  utf8proc_int32_t chr;
+  const unsigned char *end = skip_utf8(ptr, max - min);
+  unsigned char *nbuf = BaseMalloc((end - ptr) + 1);
 
-  while (min++ < max) {
-    ptr += get_utf8(ptr, -1, &chr);
-    nptr += put_utf8(nptr, chr);
-  }
-  nptr[0] = '\0';
+  memcpy(nbuf, ptr, end - ptr);
+  nbuf[end - ptr] = '\0';
   return nbuf;
 }
 
+/**
+ * The number of characters in the name of an atom.
+ *
+ * Long or non-ASCII names are remembered in a small per-thread cache indexed by the
+ * atom address, so that atom_length/2 and sub_atom/5 do not rescan the
+ * text at every call. Atom garbage collection may free an atom and reuse
+ * its address, so the cache is dropped whenever a collection has run.
+ *
+ * @param at the atom
+ *
+ * @return the length in characters
+ */
+size_t Yap_AtomCharLength(Atom at USES_REGS) {
+  const unsigned char *s = RepAtom(at)->UStrOfAE;
+  size_t i, len;
+
+  if (IsBlob(at))
+    return strlen_utf8(s);
+  if (LOCAL_AtomLengthEpoch != GLOBAL_agc_calls) {
+    memset(LOCAL_AtomLengthKey, 0, sizeof(LOCAL_AtomLengthKey));
+    LOCAL_AtomLengthEpoch = GLOBAL_agc_calls;
+  }
+  i = ((CELL)at / sizeof(CELL)) & (ATOM_LENGTH_CACHE - 1);
+  if (LOCAL_AtomLengthKey[i] == at)
+    return LOCAL_AtomLengthValue[i];
+  len = utf8_ascii_prefix(s, (size_t)-1);
+  if (s[len] == '\0') {
+    if (len < 64)
+      return len;
+  } else {
+    len += strlen_utf8(s + len);
+  }
+  LOCAL_AtomLengthKey[i] = at;
+  LOCAL_AtomLengthValue[i] = len;
+  return len;
+}
+
 //
 // Out must be an atom or a string
 bool Yap_Concat_Text(int tot, seq_tv_t inp[], seq_tv_t *out USES_REGS) {
@@ -1063,7 +1103,7 @@ bool Yap_Concat_Text(int tot, seq_tv_t inp[], seq_tv_t *out USES_REGS) {
   int i, j;
 
   int lvl = push_text_stack();
-  bufv = Malloc(tot * sizeof(unsigned char *));
+  bufv = Malloc(tot * sizeof(unsigned char *) PASS_REGS);
   if (!bufv) {
      pop_text_stack(lvl);
     return NULL;
@@ -1081,7 +1121,7 @@ bool Yap_Concat_Text(int tot, seq_tv_t inp[], seq_tv_t *out USES_REGS) {
     bufv[j++] = nbuf;
   }
   if (j == 0) {
-    buf = Malloc(8);
+    buf = Malloc(8 PASS_REGS);
     memset(buf, 0, 4);
   } else if (j == 1) {
     buf = bufv[0];
@@ -1101,7 +1141,7 @@ bool Yap_Splice_Text(int n, size_t cuts[], seq_tv_t *inp,
   const unsigned char *buf;
   size_t b_l, u_l;
 
-  inp->type |= YAP_STRING_IN_TMP;
+  inp->type |= YAP_STRING_WITH_BUFFER;
   buf = Yap_readText(inp PASS_REGS);
   if (!buf) {
     pop_text_stack(lvl);
@@ -1202,7 +1242,7 @@ const char *Yap_PredIndicatorToUTF8String(PredEntry *ap) {
   smax = s + 1024;
   Term tmod = ap->ModuleOfPred;
   if (tmod) {
-    char *sn = Yap_AtomToUTF8Text(AtomOfTerm(tmod));
+    char *sn = Yap_AtomToUTF8Text(AtomOfTerm(tmod) PASS_REGS);
     stpcpy(s, sn);
     if (smax - s > 1) {
       strcat(s, ":");
@@ -1225,7 +1265,7 @@ const char *Yap_PredIndicatorToUTF8String(PredEntry *ap) {
       return LOCAL_FileNameBuf;
     } else if (ap->PredFlags & AtomDBPredFlag) {
       at = (Atom)(ap->FunctorOfPred);
-      if (!stpcpy(s, Yap_AtomToUTF8Text(at)))
+      if (!stpcpy(s, Yap_AtomToUTF8Text(at PASS_REGS)))
         return NULL;
     } else {
       f = ap->FunctorOfPred;
@@ -1240,7 +1280,7 @@ const char *Yap_PredIndicatorToUTF8String(PredEntry *ap) {
       at = (Atom)(ap->FunctorOfPred);
     }
   }
-  if (!stpcpy(s, Yap_AtomToUTF8Text(at))) {
+  if (!stpcpy(s, Yap_AtomToUTF8Text(at PASS_REGS))) {
     return NULL;
   }
   s += strlen(s);
@@ -198,6 +198,7 @@ mboxReceive( mbox_t *mboxp, Term t USES_REGS )
     return false; 	// don't try to read if someone else already closed down...
   }
   mboxp->nclients++;
+  Yap_LULeaveEpoch();
   do {
     rc = mboxp->nmsgs && Yap_dequeue_tqueue(msgsp, t, false,  true PASS_REGS);
     if (rc) {
@@ -375,6 +376,9 @@ setup_engine(int myworker_id, int init_thread)
   standard_regs = (REGSTORE *)calloc(1,sizeof(REGSTORE));
   if (!standard_regs)
     return FALSE;
+  /* Yap_InitYaamRegs already looks at the new worker's locals */
+  standard_regs->worker_id_ = myworker_id;
+  standard_regs->worker_local_ = REMOTE(myworker_id);
   regcache = standard_regs;
   /* create the YAAM descriptor */
   REMOTE_ThreadHandle(myworker_id).default_yaam_regs = standard_regs;
@@ -384,7 +388,7 @@ setup_engine(int myworker_id, int init_thread)
   // create a mbox
   mboxCreate( MkIntTerm(myworker_id), &REMOTE_ThreadHandle(myworker_id).mbox_handle PASS_REGS );
   Yap_InitTime( myworker_id );
-  Yap_InitYaamRegs( myworker_id, true] );
+  Yap_InitYaamRegs( myworker_id, true );
   REFRESH_CACHE_REGS
     Yap_ReleasePreAllocCodeSpace(Yap_PreAllocCodeSpace());
   /* I exist */
@@ -448,7 +452,7 @@ thread_run(void *widp)
   REMOTE_ThreadHandle(myworker_id).tgoal = NULL;
   tgs[1] = LOCAL_ThreadHandle.tdetach;
   tgoal = Yap_MkApplTerm(FunctorThreadRun, 2, tgs);
-  Yap_RunTopGoal(tgoal);
+  Yap_RunTopGoal(tgoal PASS_REGS);
 #ifdef TABLING
   {
     tab_ent_ptr tab_ent;
@@ -550,6 +554,7 @@ static Int
 p_thread_sleep( USES_REGS1 )
 {
   UInt time = IntegerOfTerm(Deref(ARG1));
+  Yap_LULeaveEpoch();
 #if HAVE_NANOSLEEP
   UInt ntime = IntegerOfTerm(Deref(ARG2));
   struct timespec req, oreq ;
@@ -742,6 +747,7 @@ p_thread_join( USES_REGS1 )
   thread = REMOTE_ThreadHandle(tid).pthread_handle;
   MUTEX_UNLOCK(&(REMOTE_ThreadHandle(tid).tlock));
   /* make sure this lock is accessible */
+  Yap_LULeaveEpoch();
   if (pthread_join(thread, NULL) < 0) {
     /* ERROR */
     return FALSE;
@@ -990,6 +996,7 @@ static Int p_destroy_mutex( USES_REGS1 )
 static bool
 LockMutex( SWIMutex *mut USES_REGS)
 {
+  Yap_LULeaveEpoch();
 #if DEBUG_LOCKS
   MUTEX_LOCK(&mut->m);
 #else
@@ -1118,7 +1125,7 @@ p_unlock_mutex( USES_REGS1 )
 static Int
 p_with_mutex( USES_REGS1 )
 {
-  Term excep;
+  bool excep;
   Int rc = FALSE;
   Int creeping = Yap_get_signal(YAP_CREEP_SIGNAL);
   PredEntry *pe;
@@ -1174,14 +1181,14 @@ p_with_mutex( USES_REGS1 )
     rc = TRUE;
   }
  end:
-  excep = Yap_GetException(LOCAL_ComiittedError);
+  excep = LOCAL_ActiveError->errorNo != YAP_NO_ERROR;
   if ( !UnLockMutex(mut PASS_REGS) ) {
-    return FALSE;c
+    return FALSE;
   }
   if (creeping) {
     Yap_signal( YAP_CREEP_SIGNAL );
-  } else if ( excep != 0) {
-    return Yap_JumpToEnv(excep);
+  } else if ( excep ) {
+    return Yap_JumpToEnv();
   }
   return rc;
 }
@@ -1432,6 +1439,7 @@ static Int
  {
    pthread_cond_t *condp = (pthread_cond_t *)IntegerOfTerm(Deref(ARG1));
    SWIMutex *mut = (SWIMutex*)IntegerOfTerm(Deref(ARG2));
+   Yap_LULeaveEpoch();
    pthread_cond_wait(condp, &mut->m);
    return TRUE;
 }
@@ -1599,6 +1607,7 @@ Yap_InitFirstWorkerThreadHandle(void)
   pthread_mutex_init(&REMOTE_ThreadHandle(0).tlock_status, NULL);
   LOCAL_ThreadHandle.tdetach = MkAtomTerm(AtomFalse);
   LOCAL_ThreadHandle.ref_count = 1;
+  Yap_InitTime(0);
 }
 
 void Yap_InitThreadPreds(void)
@@ -703,6 +703,7 @@ CACHE_Y(YREG);
       EMIT_SIMPLE_BLOCK(LOCK_LU_INSTINIT);
 	  EMIT_SIMPLE_BLOCK(LOCK_LU_END);
 #if PARALLEL_YAP
+      LU_SEE_EPOCH();
       if (PP) {
 	GONext();
       }
@@ -7481,6 +7482,7 @@ S_SREG = RepAppl(d0);
       /* enter logical pred               */
       BOp(enter_lu_pred, Illss);
       check_trail(TR);
+      LU_SEE_EPOCH();
       /* mark the indexing code */
       {
 	LogUpdIndex *cl = PREG->y_u.Illss.I;
@@ -635,6 +635,29 @@ InitReverseLookupOpcode(void)
     opeptr[j].opnum = i;
     opeptr[j].opc = opc;
   }
+  /* a superinstruction is seen as its first instruction, so that
+     code walkers and saved states just find the unfused sequence */
+  {
+    static op_numbers super_first[] = {
+#define SUPER2(S, A, B, TA) _##A,
+#define SUPER3(S, A, B, C, TA, TB) _##A,
+#include "supers.h"
+#undef SUPER2
+#undef SUPER3
+      _Ystop};
+    int k;
+
+    for (k = 0; Yap_ABSMI_SUPERS[k]; k++) {
+      OPCODE opc = (OPCODE)Yap_ABSMI_SUPERS[k];
+      int j = rtable_hash_op(opc,hash_size_mask);
+      while (opeptr[j].opc) {
+	if (++j > hash_size_mask)
+	  j = 0;
+      }
+      opeptr[j].opnum = super_first[k];
+      opeptr[j].opc = opc;
+    }
+  }
 }
 #endif
 
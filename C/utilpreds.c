@@ -167,7 +167,7 @@ int Yap_copy_complex_term(register CELL *pt0, register CELL *pt0_end,
   int lvl = push_text_stack();
 
   struct cp_frame *to_visit0,
-    *to_visit = Malloc(1024*sizeof(struct cp_frame));
+    *to_visit = Malloc(1024*sizeof(struct cp_frame) PASS_REGS);
   struct cp_frame *to_visit_max;
 
   CELL *HB0 = HB;
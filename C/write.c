@@ -48,7 +48,7 @@ typedef enum {
   symbol     /* the previous term was a symbol like +, -, *, .... */
 } wtype;
 
-typedef StreamDesc *wrf;
+typedef struct write_globs *wrf;
 
 typedef struct union_slots {
   Int old;
@@ -78,27 +78,36 @@ typedef struct write_globs {
   UInt MaxDepth, MaxArgs;
   wtype lw;
   CELL *visited, *visited0, *visited_top;
+  /* text is put together here, and goes to the stream a block at a time */
+  unsigned char *out, *out0, *out_end;
 } wglbs;
 
 #define lastw wglb->lw
 #define last_minus wglb->last_atom_minus
 
-static bool callPortray(Term t, int sno USES_REGS) {
+static void wrflush(struct write_globs *wglb);
+
+static bool callPortray(Term t, struct write_globs *wglb USES_REGS) {
   PredEntry *pe;
   Int b0 = LCL0 - (CELL *)B;
+  int old_out = LOCAL_c_output_stream;
+  bool rc = false;
 
-  UNLOCK(GLOBAL_Stream[sno].streamlock);
+  /* portray/1 writes to the current output, after the text we kept */
+  wrflush(wglb);
+  UNLOCK(wglb->stream->streamlock);
+  LOCAL_c_output_stream = wglb->stream - GLOBAL_Stream;
   if ((pe = RepPredProp(Yap_GetPredPropByFunc(FunctorPortray, USER_MODULE))) &&
       pe->OpcodeOfPred != FAIL_OPCODE && pe->OpcodeOfPred != UNDEF_OPCODE &&
       Yap_execute_pred(pe, &t, true PASS_REGS)) {
     choiceptr B0 = (choiceptr)(LCL0 - b0);
     Yap_fail_all(B0 PASS_REGS);
-    LOCK(GLOBAL_Stream[sno].streamlock);
-    return true;
+    rc = true;
   }
-  LOCK(GLOBAL_Stream[sno].streamlock);
+  LOCAL_c_output_stream = old_out;
+  LOCK(wglb->stream->streamlock);
 
-  return false;
+  return rc;
 }
 
 #define PROTECT(t, F)                                                          \
@@ -118,15 +127,46 @@ static void putAtom(Atom, int, struct write_globs *);
 static void writeTerm(Term, int, int, int, struct write_globs *,
                       struct rewind_term *);
 
-#define wrputc(WF, X)                                                          \
-  (X)->stream_wputc(X - GLOBAL_Stream, WF) /* writes a character */
+/* size of the block where a term is put together before it is written */
+#define WRITE_BLOCK 4096
+
+static void wrflush(struct write_globs *wglb) {
+  if (wglb->out > wglb->out0) {
+    Yap_StreamWriteBlock(wglb->stream, wglb->out0, wglb->out - wglb->out0);
+    wglb->out = wglb->out0;
+  }
+}
+
+/* use buf as the block, if the stream can take it */
+static void wrblock(struct write_globs *wglb, unsigned char *buf) {
+  if (Yap_StreamWritesBlocks(wglb->stream)) {
+    wglb->out = wglb->out0 = buf;
+    wglb->out_end = buf + WRITE_BLOCK;
+  } else {
+    wglb->out = wglb->out0 = wglb->out_end = NULL;
+  }
+}
+
+/* writes a character */
+static inline void wrputc(int ch, struct write_globs *wglb) {
+  if (wglb->out) {
+    if (wglb->out + 4 > wglb->out_end)
+      wrflush(wglb);
+    if (ch < 0x80)
+      *wglb->out++ = ch;
+    else if (ch < 0x200000)
+      wglb->out += put_utf8(wglb->out, ch);
+  } else {
+    wglb->stream->stream_wputc(wglb->stream - GLOBAL_Stream, ch);
+  }
+}
 
 /*
   protect bracket from merging with previoous character.
   avoid stuff like not (2,3) -> not(2,3) or
 */
 static void wropen_bracket(struct write_globs *wglb, int protect) {
-  StreamDesc *stream = wglb->stream;
+  wrf stream = wglb;
 
   if (lastw != separator && protect)
     wrputc(' ', stream);
@@ -135,7 +175,7 @@ static void wropen_bracket(struct write_globs *wglb, int protect) {
 }
 
 static void wrclose_bracket(struct write_globs *wglb, int protect) {
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
 
   wrputc(')', stream);
   lastw = separator;
@@ -143,7 +183,7 @@ static void wrclose_bracket(struct write_globs *wglb, int protect) {
 
 static int protect_open_number(struct write_globs *wglb, int lm,
                                int minus_required) {
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
 
   if (lastw == symbol && lm && !minus_required) {
     wropen_bracket(wglb, TRUE);
@@ -166,7 +206,7 @@ static void protect_close_number(struct write_globs *wglb, int used_bracket) {
 static void wrputn(Int n,
                    struct write_globs *wglb) /* writes an integer	 */
 {
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
   char s[256], *s1 = s; /* that should be enough for most integers */
   int has_minus = (n < 0);
   int ob;
@@ -182,7 +222,7 @@ static void wrputn(Int n,
   protect_close_number(wglb, ob);
 }
 
-inline static void wrputs(char *s, StreamDesc *stream) {
+inline static void wrputs(char *s, wrf stream) {
   int c;
   while ((c = *s++))
     wrputc(c, stream);
@@ -239,11 +279,11 @@ static void write_mpint(MP_INT *big, struct write_globs *wglb) {
     s = mpz_get_str(NULL, 10, big);
     if (!s)
       return;
-    wrputs(s, wglb->stream);
+    wrputs(s, wglb);
     free(s);
   } else {
     mpz_get_str(s, 10, big);
-    wrputs(s, wglb->stream);
+    wrputs(s, wglb);
   }
   protect_close_number(wglb, ob);
 }
@@ -256,9 +296,9 @@ static void writebig(Term t, int p, int depth, int rinfixarg,
   CELL big_tag = pt[0];
 
   if (big_tag == ARRAY_INT || big_tag == ARRAY_FLOAT) {
-    wrputc('{', wglb->stream);
-    wrputs("...", wglb->stream);
-    wrputc('}', wglb->stream);
+    wrputc('{', wglb);
+    wrputs("...", wglb);
+    wrputc('}', wglb);
     lastw = separator;
     return;
 #ifdef USE_GMP
@@ -278,11 +318,12 @@ static void writebig(Term t, int p, int depth, int rinfixarg,
     blob_info = big_tag;
     if (GLOBAL_OpaqueHandlers &&
         (f = GLOBAL_OpaqueHandlers[blob_info].write_handler)) {
+      wrflush(wglb);
       (f)(wglb->stream->file, big_tag, ExternalBlobFromTerm(t), 0);
       return;
     }
   }
-  wrputs("0", wglb->stream);
+  wrputs("0", wglb);
 }
 
 static void wrputf(Float f, struct write_globs *wglb) /* writes a float	 */
@@ -291,7 +332,7 @@ static void wrputf(Float f, struct write_globs *wglb) /* writes a float	 */
 #if THREADS
   char s[256];
 #endif
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
   int sgn;
   int ob;
 
@@ -315,6 +356,17 @@ static void wrputf(Float f, struct write_globs *wglb) /* writes a float	 */
   }
 #endif
   ob = protect_open_number(wglb, last_minus, sgn);
+  if (floatFormat()[0] == '\0') {
+    /* the shortest text that reads back as f */
+    char buf[32];
+
+    if (lastw == symbol || lastw == alphanum) {
+      wrputc(' ', stream);
+    }
+    wrputs(Yap_FormatShortestFloat(f, buf), stream);
+    protect_close_number(wglb, ob);
+    return;
+  }
 #if THREADS
   /* old style writing */
   int found_dot = FALSE;
@@ -388,6 +440,7 @@ int Yap_FormatFloat(Float f, char **s, size_t sz) {
     return false;
   wglb.lw = separator;
   wglb.stream = GLOBAL_Stream + sno;
+  wglb.out = NULL;
   wrputf(f, &wglb);
   *s = Yap_MemExportStreamPtr(sno);
   Yap_CloseStream(sno);
@@ -398,7 +451,7 @@ int Yap_FormatFloat(Float f, char **s, size_t sz) {
 static void wrputref(CODEADDR ref, int Quote_illegal,
                      struct write_globs *wglb) {
   char s[256];
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
 
   putAtom(AtomDBref, Quote_illegal, wglb);
 #if defined(__linux__) || defined(__APPLE__)
@@ -429,9 +482,9 @@ static inline bool was_visited(Term t, wglbs *wg, Term *ta) {
     CELL *pt = (CELL *)AtomOfTerm(*tp);
     if (pt >= wg->visited0 && pt < wg->visited) {
       int depth = (wg->visited) - pt;
-      wrputs(" @[-", wg->stream);
+      wrputs(" @[-", wg);
       wrputn(depth, wg);
-      wrputs("] ", wg->stream);
+      wrputs("] ", wg);
       return true;
     }
   }
@@ -464,11 +517,19 @@ static inline void done_visiting(Term t, wglbs *wg) {
 /* writes a blob (default) */
 static int wrputblob(AtomEntry *ref, int Quote_illegal,
                      struct write_globs *wglb) {
-  wrf stream = wglb->stream;
+  FILE *f = wglb->stream->file;
   int rc;
-  int Yap_write_blob(AtomEntry * ref, StreamDesc * stream);
+  int Yap_write_blob(AtomEntry * ref, FILE * stream);
+
+  /* the blob goes straight to the FILE, after the text we kept */
+  wrflush(wglb);
+  if (f == NULL) {
+    char s[256];
 
-  if ((rc = Yap_write_blob(ref, stream))) {
+    snprintf(s, sizeof(s), "'%s'(%p)", RepAtom(AtomSWIStream)->StrOfAE,
+             (void *)ref);
+    wrputs(s, wglb);
+  } else if ((rc = Yap_write_blob(ref, f))) {
     return rc;
   }
   lastw = alphanum;
@@ -604,7 +665,7 @@ static void write_quoted(wchar_t ch, wchar_t quote, wrf stream) {
 static void write_string(const unsigned char *s,
                          struct write_globs *wglb) /* writes an integer	 */
 {
-  StreamDesc *stream = wglb->stream;
+  wrf stream = wglb;
   utf8proc_int32_t chr, qt;
   unsigned char *ptr = (unsigned char *)s;
 
@@ -632,7 +693,7 @@ static void write_string(const unsigned char *s,
 static void putAtom(Atom atom, int Quote_illegal, struct write_globs *wglb) {
   unsigned char *s;
   wtype atom_or_symbol;
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
   if (atom == NULL)
     return;
   s = RepAtom(atom)->UStrOfAE;
@@ -680,6 +741,7 @@ void Yap_WriteAtom(StreamDesc *s, Atom atom) {
   struct write_globs wglb;
   wglb.stream = s;
   wglb.Quote_illegal = FALSE;
+  wglb.out = NULL;
   putAtom(atom, 0, &wglb);
 }
 
@@ -712,7 +774,7 @@ static int IsCodesTerm(Term string) /* checks whether this is a string */
 static void putString(Term string, struct write_globs *wglb)
 
 {
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
   wrputc('"', stream);
   while (string != TermNil) {
     wchar_t ch = IntOfTerm(HeadOfTerm(string));
@@ -727,7 +789,7 @@ static void putString(Term string, struct write_globs *wglb)
 static void putUnquotedString(Term string, struct write_globs *wglb)
 
 {
-  wrf stream = wglb->stream;
+  wrf stream = wglb;
   while (string != TermNil) {
     int ch = IntOfTerm(HeadOfTerm(string));
     wrputc(ch, stream);
@@ -740,9 +802,9 @@ static void write_var(CELL *t, struct write_globs *wglb,
                       struct rewind_term *rwt) {
   CACHE_REGS
   if (lastw == alphanum) {
-    wrputc(' ', wglb->stream);
+    wrputc(' ', wglb);
   }
-  wrputc('_', wglb->stream);
+  wrputc('_', wglb);
   /* make sure we don't get no creepy spaces where they shouldn't be */
   lastw = separator;
   if (IsAttVar(t)) {
@@ -758,12 +820,12 @@ static void write_var(CELL *t, struct write_globs *wglb,
         attvar_record *attv = RepAttVar(t);
         CELL *l = &attv->Value; /* dirty low-level hack, check atts.h */
 
-        wrputs("$AT(", wglb->stream);
+        wrputs("$AT(", wglb);
         write_var(t, wglb, rwt);
-        wrputc(',', wglb->stream);
+        wrputc(',', wglb);
         PROTECT(*t, writeTerm(*l, 999, 1, FALSE, wglb, &nrwt));
         attv = RepAttVar(t);
-        wrputc(',', wglb->stream);
+        wrputc(',', wglb);
         l++;
         writeTerm(*l, 999, 1, FALSE, wglb, &nrwt);
         wrclose_bracket(wglb, TRUE);
@@ -771,7 +833,7 @@ static void write_var(CELL *t, struct write_globs *wglb,
       wglb->Portray_delays = TRUE;
       return;
     }
-    wrputc('D', wglb->stream);
+    wrputc('D', wglb);
     wrputn(vcount, wglb);
   } else {
     wrputn(((Int)(t - H0)), wglb);
@@ -780,6 +842,7 @@ static void write_var(CELL *t, struct write_globs *wglb,
 
 static void write_list(Term t, Term hot, int direction, int depth,
                        struct write_globs *wglb, struct rewind_term *rwt) {
+  CACHE_REGS
   Term ti;
   struct rewind_term nrwt;
   nrwt.parent = rwt;
@@ -793,16 +856,16 @@ static void write_list(Term t, Term hot, int direction, int depth,
       break;
     if (wglb->MaxDepth != 0 && depth > wglb->MaxDepth) {
       if (lastw == symbol || lastw == separator) {
-        wrputc(' ', wglb->stream);
+        wrputc(' ', wglb);
       }
-      wrputc('|', wglb->stream);
+      wrputc('|', wglb);
       putAtom(Atom3Dots, wglb->Quote_illegal, wglb);
       done_visiting(t, wglb);
       return;
     }
     lastw = separator;
     depth++;
-    wrputc(',', wglb->stream);
+    wrputc(',', wglb);
     if ((was_visited(ti, wglb, &hot))) {
       break;
     }
@@ -813,14 +876,14 @@ static void write_list(Term t, Term hot, int direction, int depth,
   if (IsPairTerm(ti)) {
     /* we found an infinite loop */
     /* keep going on the list */
-    wrputc(',', wglb->stream);
+    wrputc(',', wglb);
     write_list(ti, hot, direction, depth, wglb, &nrwt);
     done_visiting(ti, wglb);
   } else if (ti != TermNil) {
     if (lastw == symbol || lastw == separator) {
-      wrputc(' ', wglb->stream);
+      wrputc(' ', wglb);
     }
-    wrputc('|', wglb->stream);
+    wrputc('|', wglb);
     lastw = separator;
     writeTerm(ti, 999, depth, FALSE, wglb, &nrwt);
     done_visiting(ti, wglb);
@@ -859,11 +922,11 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
         return;
       }
     if (wglb->Ignore_ops) {
-        wrputs("'.'(", wglb->stream);
+        wrputs("'.'(", wglb);
       lastw = separator;
 
       PROTECT(t, writeTerm(hot, 999, depth + 1, FALSE, wglb, &nrwt));
-      wrputs(",", wglb->stream);
+      wrputs(",", wglb);
       writeTerm(TailOfTerm(t), 999, depth + 1, FALSE, wglb, &nrwt);
       done_visiting(t, wglb);
       wrclose_bracket(wglb, TRUE);
@@ -871,7 +934,7 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
     }
     if (wglb->Use_portray) {
             done_visiting(t, wglb);
-        if (callPortray(t, wglb->stream - GLOBAL_Stream PASS_REGS)) {
+        if (callPortray(t, wglb PASS_REGS)) {
         return;
       }
     if ((was_visited(t, wglb, &hot))) {
@@ -882,12 +945,12 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
     if (trueGlobalPrologFlag(WRITE_STRINGS_FLAG) && IsCodesTerm(t)) {
       putString(t, wglb);
     } else {
-      wrputc('[', wglb->stream);
+      wrputc('[', wglb);
       lastw = separator;
       /* we assume t was already saved in the stack */
       write_list(t, hot, 0, depth, wglb, rwt);
       done_visiting(t, wglb);
-      wrputc(']', wglb->stream);
+      wrputc(']', wglb);
       lastw = separator;
     }
   } else { /* compound term */
@@ -937,7 +1000,7 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
         Int sl = 0;
 
         while (argno < *p) {
-          wrputc('_', wglb->stream), wrputc(',', wglb->stream);
+          wrputc('_', wglb), wrputc(',', wglb);
           ++argno;
         }
         *p++;
@@ -945,7 +1008,7 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
         /* cannot use the term directly with the SBA */
         PROTECT(t, writeTerm(*p, 999, depth + 1, FALSE, wglb, &nrwt));
         if (*p)
-          wrputc(',', wglb->stream);
+          wrputc(',', wglb);
         argno++;
       }
       wrclose_bracket(wglb, TRUE);
@@ -954,7 +1017,7 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
 #endif
     if (wglb->Use_portray) {
       done_visiting(t, wglb);
-      if (callPortray(t, wglb->stream - GLOBAL_Stream PASS_REGS)) {
+      if (callPortray(t, wglb PASS_REGS)) {
         return;
       }
       Term tf;
@@ -1015,20 +1078,20 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
       }
       if (Arity > 1) {
         if (atom == AtomEmptyBrackets) {
-          wrputc('(', wglb->stream);
+          wrputc('(', wglb);
         } else if (atom == AtomEmptySquareBrackets) {
-          wrputc('[', wglb->stream);
+          wrputc('[', wglb);
         } else if (atom == AtomCurly) {
-          wrputc('{', wglb->stream);
+          wrputc('{', wglb);
         }
         lastw = separator;
           writeTerm(tleft, 0, rinfixarg,  depth, wglb, rwt);
         if (atom == AtomEmptyBrackets) {
-          wrputc(')', wglb->stream);
+          wrputc(')', wglb);
         } else if (atom == AtomEmptySquareBrackets) {
-          wrputc(']', wglb->stream);
+          wrputc(']', wglb);
         } else if (atom == AtomCurly) {
-          wrputc('}', wglb->stream);
+          wrputc('}', wglb);
         }
         lastw = separator;
       } else {
@@ -1061,13 +1124,13 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
       }
       /* avoid quoting commas and bars */
       if (!strcmp((char *)RepAtom(atom)->StrOfAE, ",")) {
-        wrputc(',', wglb->stream);
+        wrputc(',', wglb);
         lastw = separator;
       } else if (!strcmp((char *)RepAtom(atom)->StrOfAE, "|")) {
         if (lastw == symbol || lastw == separator) {
-          wrputc(' ', wglb->stream);
+          wrputc(' ', wglb);
         }
-        wrputc('|', wglb->stream);
+        wrputc('|', wglb);
         lastw = separator;
       } else
         putAtom(atom, wglb->Quote_illegal, wglb);
@@ -1084,7 +1147,7 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
     } else if (functor == FunctorDollarVar) {
       Term ti = ArgOfTerm(1, t);
       if (lastw == alphanum) {
-        wrputc(' ', wglb->stream);
+        wrputc(' ', wglb);
       }
       if (wglb->Handle_vars && !IsVarTerm(ti) &&
           (IsIntTerm(ti) || IsCodesTerm(ti) || IsAtomTerm(ti) ||
@@ -1092,12 +1155,12 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
         if (IsIntTerm(ti)) {
           Int k = IntOfTerm(ti);
           if (k == -1) {
-            wrputc('_', wglb->stream);
+            wrputc('_', wglb);
             lastw = alphanum;
             done_visiting(t, wglb);
             return;
           } else {
-            wrputc((k % 26) + 'A', wglb->stream);
+            wrputc((k % 26) + 'A', wglb);
             if (k >= 26) {
               /* make sure we don't get confused about our context */
               lastw = separator;
@@ -1113,36 +1176,36 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
           putUnquotedString(ti, wglb);
         }
       } else {
-        wrputs("'$VAR'(", wglb->stream);
+        wrputs("'$VAR'(", wglb);
         lastw = separator;
         writeTerm(ArgOfTerm(1, t), 999, depth + 1, FALSE, wglb, &nrwt);
         wrclose_bracket(wglb, TRUE);
       }
     } else if (!wglb->Ignore_ops && functor == FunctorBraces) {
-      wrputc('{', wglb->stream);
+      wrputc('{', wglb);
       lastw = separator;
       writeTerm(ArgOfTerm(1, t), GLOBAL_MaxPriority, depth + 1, FALSE, wglb,
                 &nrwt);
-      wrputc('}', wglb->stream);
+      wrputc('}', wglb);
       lastw = separator;
     } else if (atom == AtomArray) {
-      wrputc('{', wglb->stream);
+      wrputc('{', wglb);
       lastw = separator;
       for (op = 1; op <= Arity; ++op) {
         if (op == wglb->MaxArgs) {
-          wrputs("...", wglb->stream);
+          wrputs("...", wglb);
           break;
         }
         writeTerm(ArgOfTerm(op, t), 999, depth + 1, FALSE, wglb, &nrwt);
         if (op != Arity) {
           PROTECT(t, writeTerm(ArgOfTerm(op, t), 999, depth + 1, FALSE, wglb,
                                &nrwt));
-          wrputc(',', wglb->stream);
+          wrputc(',', wglb);
           lastw = separator;
         }
       }
       writeTerm(ArgOfTerm(op, t), 999, depth + 1, FALSE, wglb, &nrwt);
-      wrputc('}', wglb->stream);
+      wrputc('}', wglb);
       lastw = separator;
     } else {
       if (!wglb->Ignore_ops && atom == AtomHeap) {
@@ -1153,14 +1216,14 @@ static void writeTerm(Term t, int p, int depth, int rinfixarg,
       wropen_bracket(wglb, FALSE);
       for (op = 1; op < Arity; ++op) {
         if (op == wglb->MaxArgs) {
-          wrputc('.', wglb->stream);
-          wrputc('.', wglb->stream);
-          wrputc('.', wglb->stream);
+          wrputc('.', wglb);
+          wrputc('.', wglb);
+          wrputc('.', wglb);
           break;
         }
         PROTECT(
             t, writeTerm(ArgOfTerm(op, t), 999, depth + 1, FALSE, wglb, &nrwt));
-        wrputc(',', wglb->stream);
+        wrputc(',', wglb);
         lastw = separator;
       }
       writeTerm(ArgOfTerm(op, t), 999, depth + 1, FALSE, wglb, &nrwt);
@@ -1181,9 +1244,11 @@ void Yap_plwrite(Term t, StreamDesc *mywrite, int max_depth, int flags,
   yhandle_t lvl = push_text_stack();
   struct write_globs wglb;
   struct rewind_term rwt;
+  unsigned char block[WRITE_BLOCK];
   t = Deref(t);
   rwt.parent = NULL;
   wglb.stream = mywrite;
+  wrblock(&wglb, block);
   wglb.Ignore_ops = flags & Ignore_ops_f;
   wglb.Write_strings = flags & BackQuote_String_f;
   wglb.Use_portray = flags & Use_portray_f;
@@ -1199,8 +1264,10 @@ void Yap_plwrite(Term t, StreamDesc *mywrite, int max_depth, int flags,
 
   if (true && (flags & Handle_cyclics_f)) {
     // tp = Yap_CyclesInTerm(t PASS_REGS);
-    wglb.visited = Malloc(1024 * sizeof(CELL)), wglb.visited0 = wglb.visited,
+    wglb.visited = Malloc(1024 * sizeof(CELL) PASS_REGS), wglb.visited0 = wglb.visited,
     wglb.visited_top = wglb.visited + 1024;
+  } else {
+    wglb.visited = wglb.visited0 = wglb.visited_top = NULL;
   }
   tp = t;
 
@@ -1208,16 +1275,17 @@ void Yap_plwrite(Term t, StreamDesc *mywrite, int max_depth, int flags,
   writeTerm(tp, priority, 1, false, &wglb, &rwt);
   if (flags & New_Line_f) {
     if (flags & Fullstop_f) {
-      wrputc('.', wglb.stream);
-      wrputc('\n', wglb.stream);
+      wrputc('.', &wglb);
+      wrputc('\n', &wglb);
     } else {
-      wrputc('\n', wglb.stream);
+      wrputc('\n', &wglb);
     }
   } else {
     if (flags & Fullstop_f) {
-      wrputc('.', wglb.stream);
-      wrputc(' ', wglb.stream);
+      wrputc('.', &wglb);
+      wrputc(' ', &wglb);
     }
   }
+  wrflush(&wglb);
   pop_text_stack(lvl);
 }
@@ -217,7 +217,7 @@ static bool load_file(const char *b_file USES_REGS) {
 		FunctorOfTerm(t) == functor_command1)) {
       t = ArgOfTerm(1, t);
       if (IsApplTerm(t) && FunctorOfTerm(t) == functor_compile2) {
-	load_file(RepAtom(AtomOfTerm(ArgOfTerm(1, t)))->StrOfAE);
+	load_file(RepAtom(AtomOfTerm(ArgOfTerm(1, t)))->StrOfAE PASS_REGS);
 	Yap_ResetException(LOCAL_ActiveError);
 	continue;
       } else {
@@ -577,9 +577,11 @@ static int dump_runtime_variables(void) {
 
 X_API YAP_file_type_t Yap_InitDefaults(void *x, char *saved_state, int argc,
 				       char *argv[]) {
-
+#ifndef THREADS
+  /* a thread gets its buffer with the rest of its locals */
   if (!LOCAL_TextBuffer)
     LOCAL_TextBuffer = Yap_InitTextAllocator();
+#endif
   YAP_init_args *iap = x;
   memset(iap, 0, sizeof(YAP_init_args));
   iap->Argc = argc;
@@ -1104,6 +1106,7 @@ static void init_hw(YAP_init_args *yap_init, struct ssz_t *spt) {
 }
 
 static void end_init(YAP_init_args *iap) {
+  CACHE_REGS
   YAP_initialized = true;
   if (iap->HaltAfterBoot)
     Yap_exit(0);
@@ -1113,6 +1116,7 @@ static void end_init(YAP_init_args *iap) {
 }
 
 static void start_modules(void) {
+  CACHE_REGS
   Term cm = CurrentModule;
   size_t i;
   for (i = 0; i < n_mdelays; i++) {
@@ -1135,8 +1139,11 @@ X_API void YAP_Init(YAP_init_args *yap_init) {
   if (YAP_initialized)
     /* ignore repeated calls to YAP_Init */
     return;
+#ifndef THREADS
+  /* a thread gets its buffer with the rest of its locals */
   if (!LOCAL_TextBuffer)
     LOCAL_TextBuffer = Yap_InitTextAllocator();
+#endif
 
   Yap_Embedded = yap_init->Embedded;
 
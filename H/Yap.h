@@ -509,6 +509,9 @@ typedef enum e_restore_t {
 
 #define MAX_PROMPT 256
 
+/* entries in the per-thread cache of atom lengths, a power of two */
+#define ATOM_LENGTH_CACHE 256
+
 #if USE_THREADED_CODE
 
 /*************************************************************************************************
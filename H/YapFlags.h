@@ -120,6 +120,7 @@ INLINE_ONLY Term aro(Term inp) {
 
 static inline Term booleanFlag(Term inp) {
   if (IsStringTerm(inp)) {
+    CACHE_REGS
     inp = MkStringTerm(RepAtom(AtomOfTerm(inp))->StrOfAE);
   }
   if (inp == TermTrue || inp == TermOn)
@@ -143,6 +144,7 @@ static inline Term booleanFlag(Term inp) {
 
 static Term synerr(Term inp) {
   if (IsStringTerm(inp)) {
+    CACHE_REGS
     inp = MkStringTerm(RepAtom(AtomOfTerm(inp))->StrOfAE);
   }
   if (inp == TermDec10 || inp == TermFail || inp == TermError ||
@@ -179,6 +181,7 @@ static inline Term isatom(Term inp) {
     return TermZERO;
   }
   if (IsStringTerm(inp)) {
+    CACHE_REGS
     inp = MkStringTerm(RepAtom(AtomOfTerm(inp))->StrOfAE);
   }
   if (IsAtomTerm(inp))
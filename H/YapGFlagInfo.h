@@ -238,12 +238,12 @@ vxu    `on` consider `$` a lower case character.
 
     C-library `printf()` format specification used by write/1 and
     friends to determine how floating point numbers are printed. The
-    default is `%.15g`. The specified value is passed to `printf()`
-    without further checking. For example, if you want less digits
-    printed, `%g` will print all floats using 6 digits instead of the
-    default 15.
+    default, `''`, prints the shortest text that reads back as the
+    same float. Any other value is passed to `printf()` without
+    further checking. For example, if you want less digits printed,
+    `%g` will print all floats using 6 digits.
  */
-  YAP_FLAG(FLOAT_FORMAT_FLAG, "float_format", true, isatom, "%.16f", NULL),
+  YAP_FLAG(FLOAT_FORMAT_FLAG, "float_format", true, isatom, "", NULL),
    
  /**< `gc`
 
@@ -540,7 +540,17 @@ and if it is bound to `off` disable them. The default for YAP is
 
  */
   YAP_FLAG(STRICT_ISO_FLAG, "strict_iso", true, booleanFlag, "false", NULL),
-   
+
+ /**<  `superinstructions `
+
+    If `true`, static clauses compiled from now on run the sequences of
+    instructions listed in `H/supers.h` as single superinstructions. If
+    `false` (default) clauses keep one instruction per step. Clauses
+    that were already compiled do not change.
+ */
+  YAP_FLAG(SUPERINSTRUCTIONS_FLAG, "superinstructions", true, booleanFlag,
+             "false", NULL),
+
  /**<  `system_options `
 
     This read only flag tells which options were used to compile
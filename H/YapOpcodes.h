@@ -421,6 +421,7 @@
   OPCODE(trie_try_gterm             ,e),
   OPCODE(trie_retry_gterm           ,e),
 #endif
+  OPCODE(native_run                 ,lp),
   /* this instruction is hardwired */
   /* or_last must be the last instruction. */
 #ifdef YAPOR
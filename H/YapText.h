@@ -33,8 +33,8 @@ extern void *Realloc(void *buf, size_t sz USES_REGS);
 extern void Free(void *buf USES_REGS);
 
 extern void *MallocAtLevel(size_t sz, int atL USES_REGS);
-#define BaseMalloc(sz) MallocAtLevel(sz, 1)
-extern const void *MallocExportAsRO(const void *blk);
+#define BaseMalloc(sz) MallocAtLevel(sz, 1 PASS_REGS)
+extern const void *MallocExportAsRO(const void *blk USES_REGS);
 
 #ifndef Yap_Min
 #define Yap_Min(x, y) (x < y ? x : y)
@@ -358,6 +358,7 @@ extern unsigned char *Yap_readText(seq_tv_t *inp USES_REGS);
 extern bool write_Text(unsigned char *inp, seq_tv_t *out USES_REGS);
 extern bool Yap_CVT_Text(seq_tv_t *inp, seq_tv_t *out USES_REGS);
 extern bool Yap_Concat_Text(int n, seq_tv_t inp[], seq_tv_t *out USES_REGS);
+extern size_t Yap_AtomCharLength(Atom at USES_REGS);
 extern bool Yap_Splice_Text(int n, size_t cuts[], seq_tv_t *inp,
 			    seq_tv_t outv[] USES_REGS);
 
@@ -517,7 +518,7 @@ static inline size_t Yap_AtomToUnicodeLength(Term t0 USES_REGS) {
   if (!IsAtomTerm(t0)) {
     return -TYPE_ERROR_ATOM;
   }
-  return strlen_utf8(RepAtom(AtomOfTerm(t0))->UStrOfAE);
+  return Yap_AtomCharLength(AtomOfTerm(t0) PASS_REGS);
 }
 
 static inline Term Yap_AtomToListOfAtoms(Term t0 USES_REGS) {
@@ -74,6 +74,7 @@ extern void Yap_init_agc(void);
 extern void Yap_FreeCodeSpace(void *);
 extern void *Yap_AllocAtomSpace(size_t);
 extern void *Yap_AllocCodeSpace(size_t);
+extern void *Yap_AllocCounterSpace(size_t);
 extern void *Yap_ReallocCodeSpace(void *, size_t);
 extern ADDR Yap_AllocFromForeignArea(size_t);
 extern int Yap_ExtendWorkSpace(Int);
@@ -87,6 +88,7 @@ extern OPCODE Yap_opcode(op_numbers);
 
 /* analyst.c */
 #ifdef ANALYST
+extern void Yap_CountOpTriple(op_numbers, op_numbers, op_numbers);
 extern void Yap_InitAnalystPreds(void);
 #endif /* ANALYST */
 
@@ -175,6 +177,8 @@ extern int Yap_DBTrailOverflow(void);
 extern CELL Yap_EvalMasks(Term, CELL *);
 extern void Yap_InitBackDB(void);
 extern void Yap_InitDBPreds(void);
+extern void Yap_LUReclaimAll(void);
+extern void Yap_LULeaveEpoch(void);
 extern void Yap_InitDBLoadPreds(void);
 
 /* errors.c */
@@ -239,6 +243,7 @@ extern void Yap_inform_profiler_of_clause__(void *, void *, struct pred_entry *,
 #define Yap_inform_profiler_of_clause(CODE0, CODEF, AP, MODE)
 #endif
 extern void Yap_tell_gprof(yamop *);
+extern void Yap_AllocProfile(struct pred_entry *pe, bool call USES_REGS);
 
 /* globals.c */
 extern Term Yap_NewArena(size_t, CELL *);
@@ -345,6 +350,12 @@ extern bool Yap_CharacterEscapes(Term mt);
 extern bool Yap_constPred(struct pred_entry *pt);
 extern bool Yap_isSystemModule(Term mod);
 
+/* native.c */
+extern void Yap_InitNativePreds(void);
+extern yamop *Yap_NativeRun(yamop *pc USES_REGS);
+extern void Yap_NativeWatch(struct pred_entry *pe);
+extern void Yap_NativeReset(void);
+
 #if HAVE_MPI
 /* mpi.c */
 extern void Yap_InitMPI(void);
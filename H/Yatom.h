@@ -1011,6 +1011,69 @@ INLINE_ONLY bool IsMutexProperty(PropFlags flags) {
 
 /* end of code for named mutexes */
 
+/*** compiled format/2 control atoms */
+
+/*              compiled format property entry structure */
+typedef struct format_entry {
+  Prop NextOfPE;           /* used to chain properties             */
+  PropFlags KindOfPE;      /* kind of property                     */
+  UInt NOfOps;             /* number of directives in Program      */
+  CELL Program[MIN_ARRAY]; /* directives and then text, see format.c */
+} FormatEntry;
+
+#if USE_OFFSETS_IN_PROPS
+
+INLINE_ONLY FormatEntry *RepFormatProp(Prop p);
+
+INLINE_ONLY FormatEntry *RepFormatProp(Prop p) {
+  return (FormatEntry *)(AtomBase + Unsigned(p));
+}
+
+INLINE_ONLY Prop AbsFormatProp(FormatEntry *p);
+
+INLINE_ONLY Prop AbsFormatProp(FormatEntry *p) {
+  return (Prop)(Addr(p) - AtomBase);
+}
+
+#else
+
+INLINE_ONLY FormatEntry *RepFormatProp(Prop p);
+
+INLINE_ONLY FormatEntry *RepFormatProp(Prop p) { return (FormatEntry *)(p); }
+
+INLINE_ONLY Prop AbsFormatProp(FormatEntry *p);
+
+INLINE_ONLY Prop AbsFormatProp(FormatEntry *p) { return (Prop)(p); }
+
+#endif
+#define FormatProperty 0xfff3
+
+FormatEntry *Yap_PutAtomFormat(Atom a, FormatEntry *fe);
+
+/* get the compiled format for an atom;               */
+static inline FormatEntry *Yap_GetFormatProp(Atom at) {
+  Prop p0;
+  AtomEntry *ae = RepAtom(at);
+  FormatEntry *p;
+
+  READ_LOCK(ae->ARWLock);
+  p = RepFormatProp(p0 = ae->PropsOfAE);
+  while (p0 && p->KindOfPE != FormatProperty)
+    p = RepFormatProp(p0 = p->NextOfPE);
+  READ_UNLOCK(ae->ARWLock);
+  if (p0 == NIL)
+    return NULL;
+  return p;
+}
+
+INLINE_ONLY bool IsFormatProperty(PropFlags);
+
+INLINE_ONLY bool IsFormatProperty(PropFlags flags) {
+  return flags == FormatProperty;
+}
+
+/* end of code for compiled formats */
+
 typedef enum {
   STATIC_ARRAY = 1,
   DYNAMIC_ARRAY = 2,
@@ -1529,6 +1592,7 @@ extern bool Yap_HasException(void);
 extern yap_error_descriptor_t *Yap_GetException();
 extern void Yap_PrintException(yap_error_descriptor_t *i);
 INLINE_ONLY bool Yap_HasException(void) {
+  CACHE_REGS
   extern yap_error_number Yap_MathException__(USES_REGS1);
   yap_error_number me;
   if ((me = Yap_MathException__(PASS_REGS1)) && LOCAL_ActiveError->errorNo != YAP_NO_ERROR) {
@@ -1538,6 +1602,7 @@ INLINE_ONLY bool Yap_HasException(void) {
 }
 
 INLINE_ONLY Term MkSysError(yap_error_descriptor_t *i) {
+  CACHE_REGS
   Term et = MkAddressTerm(i);
   return Yap_MkApplTerm(FunctorException, 1, &et);
 }
@@ -1185,6 +1185,15 @@ typedef CELL label;
 #define always_set_pc()
 #endif /* BP_FREE */
 
+/* entering a logical update predicate: tell dbase.c which epoch we
+   have seen, so that it can free the clauses erased before */
+#define LU_SEE_EPOCH()                                                         \
+  if (LOCAL_LUEpoch != GLOBAL_LUEpoch) {                                       \
+    saveregs();                                                                \
+    Yap_LUSeenEpoch();                                                         \
+    setregs();                                                                 \
+  }
+
 /************************************************************
 
 Macros to check the limits of stacks
@@ -1319,6 +1328,16 @@ Macros to check the limits of stacks
 #endif /* YAPOR_SBA && YAPOR */
 #endif /* YAP_DBG_PREDS */
 
+/* allocation profiler: charge what was allocated since the last call
+   or exit to the predicate that was running, and switch to PE, which
+   we are calling if CALL is set, or returning to */
+#define alloc_profile(PE, CALL)                                                \
+  if (__builtin_expect(LOCAL_AllocProfile != NULL, 0)) {                       \
+    saveregs();                                                                \
+    Yap_AllocProfile(PE, CALL PASS_REGS);                                      \
+    setregs();                                                                 \
+  }
+
 /***************************************************************
  * Macros for choice point manipulation                         *
  ***************************************************************/
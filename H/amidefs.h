@@ -1026,6 +1026,7 @@ struct pred_entry *EnvPreg(yamop *p)
 
 #if USE_THREADED_CODE
 extern void **Yap_ABSMI_OPCODES;
+extern void **Yap_ABSMI_SUPERS;
 
 #define absmadr(i) ((OPCODE)(Yap_ABSMI_OPCODES[(i)]))
 #else
@@ -277,6 +277,7 @@ typedef struct dbterm_list {
 
 /* amasm.c */
 wamreg Yap_emit_x(CELL);
+yamop *Yap_assemble_fact(Term, Term);
 COUNT Yap_compile_cmp_flags(PredEntry *);
 void Yap_InitComma(void);
 yamop *Yap_InitCommaContinuation(PredEntry *);
@@ -293,6 +294,7 @@ ClauseUnion *Yap_find_owner_index(yamop *, PredEntry *);
 void Yap_ErCl(DynamicClause *);
 void Yap_ErLogUpdCl(LogUpdClause *);
 void Yap_ErLogUpdIndex(LogUpdIndex *);
+void Yap_LUSeenEpoch(void);
 Int Yap_Recordz(Atom, Term);
 Int Yap_db_nth_recorded(PredEntry *, Int USES_REGS);
 Int Yap_unify_immediate_ref(DBRef ref USES_REGS);
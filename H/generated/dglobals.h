@@ -51,6 +51,27 @@
 
 #define GLOBAL_BGL Yap_global->BGL_
 #endif
+
+
+#define GLOBAL_LUEpoch Yap_global->LUEpoch_
+#define GLOBAL_LULimbo Yap_global->LULimbo_
+#define GLOBAL_LULimboN Yap_global->LULimboN_
+#define GLOBAL_LULimboSz Yap_global->LULimboSz_
+#if defined(YAPOR) || defined(THREADS)
+#define GLOBAL_LUEpochLock Yap_global->LUEpochLock_
+#endif
+
+
+#define GLOBAL_CounterSpace Yap_global->CounterSpace_
+#define GLOBAL_CounterSpaceLeft Yap_global->CounterSpaceLeft_
+#if defined(YAPOR) || defined(THREADS)
+#define GLOBAL_CounterSpaceLock Yap_global->CounterSpaceLock_
+#endif
+
+
+#if defined(YAPOR) || defined(THREADS)
+#define GLOBAL_NativeLock Yap_global->NativeLock_
+#endif
 #if defined(YAPOR) || defined(TABLING)
 #define GLOBAL_optyap_data Yap_global->optyap_data_
 #endif /* YAPOR || TABLING */
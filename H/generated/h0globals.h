@@ -51,6 +51,28 @@ EXTERNAL  lockvar  GLOBAL_ThreadHandlesLock;
 // protect long critical regions
 EXTERNAL  lockvar  GLOBAL_BGL;
 #endif
+// dbase.c
+/* erased logical update clauses wait in limbo until no worker can see
+   them any more */
+EXTERNAL  UInt  GLOBAL_LUEpoch;
+EXTERNAL  struct lu_limbo *  GLOBAL_LULimbo;
+EXTERNAL  UInt  GLOBAL_LULimboN;
+EXTERNAL  UInt  GLOBAL_LULimboSz;
+#if defined(YAPOR) || defined(THREADS)
+EXTERNAL  lockvar  GLOBAL_LUEpochLock;
+#endif
+// alloc.c
+/* counters that are updated as code runs have pages of their own */
+EXTERNAL  char *  GLOBAL_CounterSpace;
+EXTERNAL  UInt  GLOBAL_CounterSpaceLeft;
+#if defined(YAPOR) || defined(THREADS)
+EXTERNAL  lockvar  GLOBAL_CounterSpaceLock;
+#endif
+
+
+#if defined(YAPOR) || defined(THREADS)
+EXTERNAL  lockvar  GLOBAL_NativeLock;
+#endif
 #if defined(YAPOR) || defined(TABLING)
 EXTERNAL    struct global_optyap_data  GLOBAL_optyap_data;
 #endif /* YAPOR || TABLING */
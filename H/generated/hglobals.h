@@ -51,6 +51,28 @@ typedef struct global_data {
 // protect long critical regions
   lockvar  BGL_;
 #endif
+// dbase.c
+/* erased logical update clauses wait in limbo until no worker can see
+   them any more */
+  UInt  LUEpoch_;
+  struct lu_limbo *  LULimbo_;
+  UInt  LULimboN_;
+  UInt  LULimboSz_;
+#if defined(YAPOR) || defined(THREADS)
+  lockvar  LUEpochLock_;
+#endif
+// alloc.c
+/* counters that are updated as code runs have pages of their own */
+  char *  CounterSpace_;
+  UInt  CounterSpaceLeft_;
+#if defined(YAPOR) || defined(THREADS)
+  lockvar  CounterSpaceLock_;
+#endif
+
+
+#if defined(YAPOR) || defined(THREADS)
+  lockvar  NativeLock_;
+#endif
 #if defined(YAPOR) || defined(TABLING)
   struct global_optyap_data  optyap_data_;
 #endif /* YAPOR || TABLING */
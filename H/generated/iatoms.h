@@ -184,11 +184,13 @@
   AtomGlobalSp = Yap_LookupAtom("global_sp"); TermGlobalSp = MkAtomTerm(AtomGlobalSp);
   AtomGlobalTrie = Yap_LookupAtom("global_trie"); TermGlobalTrie = MkAtomTerm(AtomGlobalTrie);
   AtomGoalExpansion = Yap_LookupAtom("goal_expansion"); TermGoalExpansion = MkAtomTerm(AtomGoalExpansion);
+  AtomGzip = Yap_LookupAtom("gzip"); TermGzip = MkAtomTerm(AtomGzip);
   AtomHat = Yap_LookupAtom("^"); TermHat = MkAtomTerm(AtomHat);
   AtomDoubleHat = Yap_LookupAtom("^^"); TermDoubleHat = MkAtomTerm(AtomDoubleHat);
   AtomHERE = Yap_LookupAtom("\n   <====HERE====>  \n"); TermHERE = MkAtomTerm(AtomHERE);
   AtomHandleThrow = Yap_FullLookupAtom("$handle_throw"); TermHandleThrow = MkAtomTerm(AtomHandleThrow);
   AtomHeap = Yap_LookupAtom("heap"); TermHeap = MkAtomTerm(AtomHeap);
+  AtomHeapA = Yap_LookupAtom("aheap"); TermHeapA = MkAtomTerm(AtomHeapA);
   AtomHeapUsed = Yap_LookupAtom("heapused"); TermHeapUsed = MkAtomTerm(AtomHeapUsed);
   AtomHugeInt = Yap_LookupAtom("huge_int"); TermHugeInt = MkAtomTerm(AtomHugeInt);
   AtomIDB = Yap_LookupAtom("idb"); TermIDB = MkAtomTerm(AtomIDB);
@@ -229,6 +231,7 @@
   AtomLocal = Yap_LookupAtom("local"); TermLocal = MkAtomTerm(AtomLocal);
   AtomLocalSp = Yap_LookupAtom("local_sp"); TermLocalSp = MkAtomTerm(AtomLocalSp);
   AtomLocalTrie = Yap_LookupAtom("local_trie"); TermLocalTrie = MkAtomTerm(AtomLocalTrie);
+  AtomLz = Yap_LookupAtom("lz"); TermLz = MkAtomTerm(AtomLz);
   AtomMax = Yap_LookupAtom("max"); TermMax = MkAtomTerm(AtomMax);
   AtomMaximum = Yap_LookupAtom("maximum"); TermMaximum = MkAtomTerm(AtomMaximum);
   AtomMaxArity = Yap_LookupAtom("max_arity"); TermMaxArity = MkAtomTerm(AtomMaxArity);
@@ -256,6 +259,7 @@
   AtomMyddasVersionName = Yap_FullLookupAtom("$myddas_version_name"); TermMyddasVersionName = MkAtomTerm(AtomMyddasVersionName);
   AtomNan = Yap_LookupAtom("nan"); TermNan = MkAtomTerm(AtomNan);
   AtomNb = Yap_LookupAtom("nb"); TermNb = MkAtomTerm(AtomNb);
+  AtomNbMap = Yap_LookupAtom("nb_map"); TermNbMap = MkAtomTerm(AtomNbMap);
   AtomNbTerm = Yap_LookupAtom("nb_term"); TermNbTerm = MkAtomTerm(AtomNbTerm);
   AtomNew = Yap_LookupAtom("new"); TermNew = MkAtomTerm(AtomNew);
   AtomNewLine = Yap_LookupAtom("nl"); TermNewLine = MkAtomTerm(AtomNewLine);
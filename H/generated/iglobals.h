@@ -51,6 +51,27 @@ static void InitGlobal(void) {
 
   INIT_LOCK(GLOBAL_BGL);
 #endif
+
+
+  GLOBAL_LUEpoch = 1;
+  GLOBAL_LULimbo = NULL;
+  GLOBAL_LULimboN = 0;
+  GLOBAL_LULimboSz = 0;
+#if defined(YAPOR) || defined(THREADS)
+  INIT_LOCK(GLOBAL_LUEpochLock);
+#endif
+
+
+  GLOBAL_CounterSpace = NULL;
+  GLOBAL_CounterSpaceLeft = 0;
+#if defined(YAPOR) || defined(THREADS)
+  INIT_LOCK(GLOBAL_CounterSpaceLock);
+#endif
+
+
+#if defined(YAPOR) || defined(THREADS)
+  INIT_LOCK(GLOBAL_NativeLock);
+#endif
 #if defined(YAPOR) || defined(TABLING)
 
 #endif /* YAPOR || TABLING */
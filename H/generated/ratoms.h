@@ -184,11 +184,13 @@
   AtomGlobalSp = AtomAdjust(AtomGlobalSp); TermGlobalSp = MkAtomTerm(AtomGlobalSp);
   AtomGlobalTrie = AtomAdjust(AtomGlobalTrie); TermGlobalTrie = MkAtomTerm(AtomGlobalTrie);
   AtomGoalExpansion = AtomAdjust(AtomGoalExpansion); TermGoalExpansion = MkAtomTerm(AtomGoalExpansion);
+  AtomGzip = AtomAdjust(AtomGzip); TermGzip = MkAtomTerm(AtomGzip);
   AtomHat = AtomAdjust(AtomHat); TermHat = MkAtomTerm(AtomHat);
   AtomDoubleHat = AtomAdjust(AtomDoubleHat); TermDoubleHat = MkAtomTerm(AtomDoubleHat);
   AtomHERE = AtomAdjust(AtomHERE); TermHERE = MkAtomTerm(AtomHERE);
   AtomHandleThrow = AtomAdjust(AtomHandleThrow); TermHandleThrow = MkAtomTerm(AtomHandleThrow);
   AtomHeap = AtomAdjust(AtomHeap); TermHeap = MkAtomTerm(AtomHeap);
+  AtomHeapA = AtomAdjust(AtomHeapA); TermHeapA = MkAtomTerm(AtomHeapA);
   AtomHeapUsed = AtomAdjust(AtomHeapUsed); TermHeapUsed = MkAtomTerm(AtomHeapUsed);
   AtomHugeInt = AtomAdjust(AtomHugeInt); TermHugeInt = MkAtomTerm(AtomHugeInt);
   AtomIDB = AtomAdjust(AtomIDB); TermIDB = MkAtomTerm(AtomIDB);
@@ -229,6 +231,7 @@
   AtomLocal = AtomAdjust(AtomLocal); TermLocal = MkAtomTerm(AtomLocal);
   AtomLocalSp = AtomAdjust(AtomLocalSp); TermLocalSp = MkAtomTerm(AtomLocalSp);
   AtomLocalTrie = AtomAdjust(AtomLocalTrie); TermLocalTrie = MkAtomTerm(AtomLocalTrie);
+  AtomLz = AtomAdjust(AtomLz); TermLz = MkAtomTerm(AtomLz);
   AtomMax = AtomAdjust(AtomMax); TermMax = MkAtomTerm(AtomMax);
   AtomMaximum = AtomAdjust(AtomMaximum); TermMaximum = MkAtomTerm(AtomMaximum);
   AtomMaxArity = AtomAdjust(AtomMaxArity); TermMaxArity = MkAtomTerm(AtomMaxArity);
@@ -256,6 +259,7 @@
   AtomMyddasVersionName = AtomAdjust(AtomMyddasVersionName); TermMyddasVersionName = MkAtomTerm(AtomMyddasVersionName);
   AtomNan = AtomAdjust(AtomNan); TermNan = MkAtomTerm(AtomNan);
   AtomNb = AtomAdjust(AtomNb); TermNb = MkAtomTerm(AtomNb);
+  AtomNbMap = AtomAdjust(AtomNbMap); TermNbMap = MkAtomTerm(AtomNbMap);
   AtomNbTerm = AtomAdjust(AtomNbTerm); TermNbTerm = MkAtomTerm(AtomNbTerm);
   AtomNew = AtomAdjust(AtomNew); TermNew = MkAtomTerm(AtomNew);
   AtomNewLine = AtomAdjust(AtomNewLine); TermNewLine = MkAtomTerm(AtomNewLine);
@@ -56,6 +56,27 @@ static void RestoreGlobal(void) {
 
   REINIT_LOCK(GLOBAL_BGL);
 #endif
+
+
+
+
+
+
+#if defined(YAPOR) || defined(THREADS)
+  REINIT_LOCK(GLOBAL_LUEpochLock);
+#endif
+
+
+
+
+#if defined(YAPOR) || defined(THREADS)
+  REINIT_LOCK(GLOBAL_CounterSpaceLock);
+#endif
+
+
+#if defined(YAPOR) || defined(THREADS)
+  REINIT_LOCK(GLOBAL_NativeLock);
+#endif
 #if defined(YAPOR) || defined(TABLING)
 
 #endif /* YAPOR || TABLING */
@@ -20,4 +20,12 @@ static void RestoreWorker(int wid USES_REGS) {
 #include "locals.h"
 }
 
+// LOCAL is again the current worker's area, as in Regs.h
+#undef LOCAL
+#if defined(YAPOR) || defined(THREADS)
+#define LOCAL (Yap_REGS.worker_local_)
+#else
+#define LOCAL (&Yap_local)
+#endif
+
 #endif
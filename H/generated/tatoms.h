@@ -184,11 +184,13 @@ X_API EXTERNAL Atom AtomGlobal; X_API EXTERNAL Term TermGlobal;
 X_API EXTERNAL Atom AtomGlobalSp; X_API EXTERNAL Term TermGlobalSp;
 X_API EXTERNAL Atom AtomGlobalTrie; X_API EXTERNAL Term TermGlobalTrie;
 X_API EXTERNAL Atom AtomGoalExpansion; X_API EXTERNAL Term TermGoalExpansion;
+X_API EXTERNAL Atom AtomGzip; X_API EXTERNAL Term TermGzip;
 X_API EXTERNAL Atom AtomHat; X_API EXTERNAL Term TermHat;
 X_API EXTERNAL Atom AtomDoubleHat; X_API EXTERNAL Term TermDoubleHat;
 X_API EXTERNAL Atom AtomHERE; X_API EXTERNAL Term TermHERE;
 X_API EXTERNAL Atom AtomHandleThrow; X_API EXTERNAL Term TermHandleThrow;
 X_API EXTERNAL Atom AtomHeap; X_API EXTERNAL Term TermHeap;
+X_API EXTERNAL Atom AtomHeapA; X_API EXTERNAL Term TermHeapA;
 X_API EXTERNAL Atom AtomHeapUsed; X_API EXTERNAL Term TermHeapUsed;
 X_API EXTERNAL Atom AtomHugeInt; X_API EXTERNAL Term TermHugeInt;
 X_API EXTERNAL Atom AtomIDB; X_API EXTERNAL Term TermIDB;
@@ -229,6 +231,7 @@ X_API EXTERNAL Atom AtomLoadAnswers; X_API EXTERNAL Term TermLoadAnswers;
 X_API EXTERNAL Atom AtomLocal; X_API EXTERNAL Term TermLocal;
 X_API EXTERNAL Atom AtomLocalSp; X_API EXTERNAL Term TermLocalSp;
 X_API EXTERNAL Atom AtomLocalTrie; X_API EXTERNAL Term TermLocalTrie;
+X_API EXTERNAL Atom AtomLz; X_API EXTERNAL Term TermLz;
 X_API EXTERNAL Atom AtomMax; X_API EXTERNAL Term TermMax;
 X_API EXTERNAL Atom AtomMaximum; X_API EXTERNAL Term TermMaximum;
 X_API EXTERNAL Atom AtomMaxArity; X_API EXTERNAL Term TermMaxArity;
@@ -256,6 +259,7 @@ X_API EXTERNAL Atom AtomMyddasUser; X_API EXTERNAL Term TermMyddasUser;
 X_API EXTERNAL Atom AtomMyddasVersionName; X_API EXTERNAL Term TermMyddasVersionName;
 X_API EXTERNAL Atom AtomNan; X_API EXTERNAL Term TermNan;
 X_API EXTERNAL Atom AtomNb; X_API EXTERNAL Term TermNb;
+X_API EXTERNAL Atom AtomNbMap; X_API EXTERNAL Term TermNbMap;
 X_API EXTERNAL Atom AtomNbTerm; X_API EXTERNAL Term TermNbTerm;
 X_API EXTERNAL Atom AtomNew; X_API EXTERNAL Term TermNew;
 X_API EXTERNAL Atom AtomNewLine; X_API EXTERNAL Term TermNewLine;
@@ -56,6 +56,31 @@ GLOBAL_INITF(lockvar, ThreadHandlesLock, MkLock);
 GLOBAL_INITF(lockvar, BGL, MkLock);
 #endif
 
+// dbase.c
+/* erased logical update clauses wait in limbo until no worker can see
+   them any more */
+GLOBAL_INIT(UInt, LUEpoch, 1);
+GLOBAL_INIT(struct lu_limbo *, LULimbo, NULL);
+GLOBAL_INIT(UInt, LULimboN, 0);
+GLOBAL_INIT(UInt, LULimboSz, 0);
+#if defined(YAPOR) || defined(THREADS)
+GLOBAL_INITF(lockvar, LUEpochLock, MkLock);
+#endif
+
+// alloc.c
+/* counters that are updated as code runs have pages of their own */
+GLOBAL_INIT(char *, CounterSpace, NULL);
+GLOBAL_INIT(UInt, CounterSpaceLeft, 0);
+#if defined(YAPOR) || defined(THREADS)
+GLOBAL_INITF(lockvar, CounterSpaceLock, MkLock);
+#endif
+
+// native.c
+/* the list of predicates with native code */
+#if defined(YAPOR) || defined(THREADS)
+GLOBAL_INITF(lockvar, NativeLock, MkLock);
+#endif
+
 #if defined(YAPOR) || defined(TABLING);
 GLOBAL(struct global_optyap_data, optyap_data);
 #endif /* YAPOR || TABLING */
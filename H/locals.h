@@ -21,6 +21,13 @@
 LOCAL_INIT(int, c_input_stream, 0);
 LOCAL_INIT(int, c_output_stream, 1);
 LOCAL_INIT(int, c_error_stream, 2);
+/// the descriptor last used to read from the text of an atom or string
+LOCAL_INIT(int, TextStream, -1);
+/// the length in characters of recently measured atoms, and the atom
+/// garbage collection the cache is valid for
+LOCAL_ARRAY(Atom, AtomLengthKey, ATOM_LENGTH_CACHE);
+LOCAL_ARRAY(size_t, AtomLengthValue, ATOM_LENGTH_CACHE);
+LOCAL_INIT(int, AtomLengthEpoch, -1);
 LOCAL_INIT(bool, sockets_io, false);
 LOCAL_INIT(bool, within_print_message, false);
 //
@@ -91,6 +98,9 @@ LOCAL_INIT(struct pred_entry *, LastAssertedPred, NULL);
 LOCAL_INIT(struct pred_entry *, TmpPred, NULL);
 LOCAL_INIT(char *, ScannerStack, NULL);
 LOCAL_INIT(struct scanner_extra_alloc *, ScannerExtraBlocks, NULL);
+/// the text of the token being scanned, kept from one read to the next
+LOCAL_INIT(char *, ScannerImage, NULL);
+LOCAL_INIT(size_t, ScannerImageSize, 0);
 
 /// worker control information
 /// stack limit after which the stack is managed by C-code.
@@ -102,6 +112,12 @@ LOCAL_INIT(uint64_t, Signals, 0L);
 /// indexing help data?
 LOCAL_INIT(UInt, IPredArity, 0L);
 LOCAL_INIT(yamop *, ProfEnd, NULL);
+/// call stacks sampled for this thread, see gprof.c
+LOCAL_INIT(struct stack_profile *, StackProfile, NULL);
+/// what each predicate allocated in this thread, see gprof.c; only
+/// set while we are collecting
+LOCAL_INIT(struct alloc_profile *, AllocProfile, NULL);
+LOCAL_INIT(struct alloc_profile *, AllocProfileData, NULL);
 LOCAL_INIT(int, DoingUndefp, FALSE);
 LOCAL_INIT(Int, StartCharCount, 0L);
 LOCAL_INIT(Int, StartLineCount, 0L);
@@ -228,19 +244,26 @@ LOCAL_INIT(int, CritLocks, 0);
 LOCAL(union flagTerm *, Flags);
 LOCAL(UInt, flagCount);
 // analyst.c
-/* used to find out how many instructions of each kind are executed */
+/* used to find out how many instructions of each kind are executed, and
+   how often each pair and each triple of instructions follow each other */
 #ifdef ANALYST
 LOCAL_ARRAY(YAP_ULONG_LONG, opcount, _std_top + 1);
-LOCAL_ARRAY_ARRAY(YAP_ULONG_LONG, 2opcount, _std_top + 1, _std_top + 1);
+LOCAL_ARRAY(YAP_ULONG_LONG, opcount2, (_std_top + 1) * (_std_top + 1));
+LOCAL_INIT(YAP_ULONG_LONG *, opcount3, NULL);
 #endif /* ANALYST */
 
 // dbase.c
 LOCAL(struct db_globs *, s_dbg);
+/// the last logical update epoch this worker has seen, 0 for none
+LOCAL_INIT(UInt, LUEpoch, 0);
 
 // eval.c
 LOCAL(Term, mathtt);
 LOCAL_INIT(char *, mathstring, NULL);
 LOCAL_INIT(struct eval_context *, ctx, NULL);
+#if USE_GMP
+LOCAL_INIT(MP_INT *, BigScratch, NULL);
+#endif
 
 
 // grow.c
@@ -0,0 +1,69 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V. Santos Costa and Universidade do Porto 1985-2016 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		native.h						 *
+ * comments:	stencils for the copy-and-patch native code tier	 *
+ *									 *
+ *************************************************************************/
+
+#ifndef NATIVE_H
+#define NATIVE_H 1
+
+/*
+ * A stencil is a small C function, compiled ahead of time, that does
+ * the work of one abstract machine instruction on the register file it
+ * gets as argument. Whatever depends on the instruction operands, or
+ * on where the stencil will end up, is loaded from a 64-bit immediate,
+ * a hole, that the native compiler patches in the copy.
+ *
+ * A stencil ends by tail-calling the next stencil, or by returning the
+ * next instruction for the emulator to run. When it meets a case it
+ * does not handle, a stencil returns its own instruction, so that the
+ * emulator runs it again from scratch.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__linux__) &&         \
+    !defined(YAPOR)
+#define NATIVE_STENCILS 1
+#endif
+
+typedef yamop *(*native_fn)(REGSTORE *);
+
+/* holes: these values should never show up in real code */
+#define NATIVE_HOLE_NEXT 0x5ae7c0de5ae7c001
+#define NATIVE_HOLE_PC 0x5ae7c0de5ae7c002
+#define NATIVE_HOLE_A 0x5ae7c0de5ae7c003
+#define NATIVE_HOLE_B 0x5ae7c0de5ae7c004
+#define NATIVE_HOLE_C 0x5ae7c0de5ae7c005
+#define NATIVE_HOLE_D 0x5ae7c0de5ae7c006
+
+#define NATIVE_HOLES 6
+
+typedef enum {
+  NATIVE_MOVE,     /* X[B] = X[A] */
+  NATIVE_MOVE2,    /* X[B] = X[A], X[D] = X[C] */
+  NATIVE_STORE_Y,  /* Y[A] = X[B] */
+  NATIVE_LOAD_Y,   /* X[B] = Y[A] */
+  NATIVE_NEW_X,    /* X[A] = X[B] = new variable in the global stack */
+  NATIVE_NEW_Y,    /* X[B] = Y[A] = new variable */
+  NATIVE_CONST,    /* X[A] = B */
+  NATIVE_GET_CONST, /* X[A] == B, or go back to the emulator */
+  NATIVE_ALLOCATE, /* push an environment */
+  NATIVE_EXIT,     /* continue the emulator at PC */
+  NATIVE_STENCILS_N
+} native_stencil;
+
+#if NATIVE_STENCILS
+/* in code order, followed by the end of the last stencil; all NULL if
+   the stencils could not be compiled the way we need them */
+extern native_fn Yap_NativeStencils[NATIVE_STENCILS_N + 1];
+#endif
+
+#endif /* NATIVE_H */
@@ -930,6 +930,12 @@ restore_opcodes(yamop *pc, yamop *max USES_REGS)
       pc = NEXTOP(pc,e);
       break;
 #endif
+      /* instructions type lp */
+    case _native_run:
+      pc->y_u.lp.l = PtoOpAdjust(pc->y_u.lp.l);
+      pc->y_u.lp.p = PtoPredAdjust(pc->y_u.lp.p);
+      pc = NEXTOP(pc,lp);
+      break;
       /* this instruction is hardwired */
     case _or_last:
 #ifdef YAPOR
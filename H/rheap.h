@@ -1346,6 +1346,11 @@ static void RestoreEntries(PropEntry *pp, int int_key USES_REGS) {
       TranslationEntry *he = (TranslationEntry *)pp;
       he->NextOfPE = PropAdjust(he->NextOfPE);
     } break;
+    case FormatProperty: {
+      /* the program has no pointers */
+      FormatEntry *he = (FormatEntry *)pp;
+      he->NextOfPE = PropAdjust(he->NextOfPE);
+    } break;
     case FlagProperty: {
       FlagEntry *he = (FlagEntry *)pp;
       he->NextOfPE = PropAdjust(he->NextOfPE);
@@ -954,6 +954,12 @@
       pc = NEXTOP(pc,e);
       break;
 #endif
+      /* instructions type lp */
+    case _native_run:
+      CHECK(save_PtoOp(stream, pc->y_u.lp.l));
+      CHECK(save_PtoPred(stream, pc->y_u.lp.p));
+      pc = NEXTOP(pc,lp);
+      break;
 default:
 	return -1;
      }
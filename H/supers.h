@@ -0,0 +1,36 @@
+
+  /* This file was generated automatically by "yap -L misc/buildsupers"
+     please do not update */
+
+  SUPER2(super_unify_l_y_var__get_y_var, unify_l_y_var, get_y_var, oy)
+  SUPER2(super_put_atom__put_x_val, put_atom, put_x_val, xc)
+  SUPER2(super_put_y_val__put_x_val, put_y_val, put_x_val, yx)
+  SUPER2(super_unify_y_var__unify_l_x_var, unify_y_var, unify_l_x_var, oy)
+  SUPER3(super_put_x_var__put_atom__put_x_val, put_x_var, put_atom, put_x_val, xx, xc)
+  SUPER3(super_put_x_val__put_y_val__allocate, put_x_val, put_y_val, allocate, xx, yx)
+  SUPER3(super_unify_l_y_var__get_y_var__put_x_var, unify_l_y_var, get_y_var, put_x_var, oy, yx)
+  SUPER3(super_get_y_var__put_x_var__put_atom, get_y_var, put_x_var, put_atom, yx, xx)
+  SUPER3(super_put_atom__put_x_val__put_y_val, put_atom, put_x_val, put_y_val, xc, xx)
+  SUPER2(super_put_y_val__allocate, put_y_val, allocate, yx)
+  SUPER2(super_put_x_val__put_y_val, put_x_val, put_y_val, xx)
+  SUPER2(super_put_x_var__put_atom, put_x_var, put_atom, xx)
+  SUPER2(super_get_y_var__put_x_var, get_y_var, put_x_var, yx)
+  SUPER2(super_get_yy_var__put_y_val, get_yy_var, put_y_val, yyxx)
+  SUPER3(super_unify_l_y_var__get_y_var__put_y_vals, unify_l_y_var, get_y_var, put_y_vals, oy, yx)
+  SUPER3(super_unify_y_var__unify_l_y_var__get_y_var, unify_y_var, unify_l_y_var, get_y_var, oy, oy)
+  SUPER2(super_unify_y_var__unify_l_y_var, unify_y_var, unify_l_y_var, oy)
+  SUPER2(super_get_y_var__put_y_vals, get_y_var, put_y_vals, yx)
+  SUPER2(super_put_y_val__put_y_var, put_y_val, put_y_var, yx)
+  SUPER3(super_get_yy_var__put_y_val__put_y_var, get_yy_var, put_y_val, put_y_var, yyxx, yx)
+  SUPER2(super_put_y_val__put_list, put_y_val, put_list, yx)
+  SUPER2(super_put_y_var__put_y_var, put_y_var, put_y_var, yx)
+  SUPER3(super_put_y_val__put_y_var__put_y_var, put_y_val, put_y_var, put_y_var, yx, yx)
+  SUPER2(super_put_y_var__put_y_val, put_y_var, put_y_val, yx)
+  SUPER2(super_get_y_var__put_y_var, get_y_var, put_y_var, yx)
+  SUPER2(super_put_x_val__put_y_var, put_x_val, put_y_var, xx)
+  SUPER2(super_get_yy_var__get_yy_var, get_yy_var, get_yy_var, yyxx)
+  SUPER2(super_put_atom__put_y_var, put_atom, put_y_var, xc)
+  SUPER3(super_get_yy_var__get_yy_var__put_y_val, get_yy_var, get_yy_var, put_y_val, yyxx, yyxx)
+  SUPER3(super_unify_l_y_var__put_y_val__put_atom, unify_l_y_var, put_y_val, put_atom, oy, yx)
+  SUPER2(super_put_y_val__put_atom, put_y_val, put_atom, yx)
+  SUPER2(super_unify_l_y_var__put_y_val, unify_l_y_var, put_y_val, oy)
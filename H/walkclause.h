@@ -720,6 +720,10 @@
       pc = NEXTOP(pc,e);
       break;
 #endif
+      /* instructions type lp */
+    case _native_run:
+      pc = NEXTOP(pc,lp);
+      break;
       /* this instruction is hardwired */
     case _or_last:
 #ifdef YAPOR
@@ -30,7 +30,6 @@ if (WITH_Threads)
   set( THREADS_PREFER_PTHREAD_FLAG ON)
 
   if (CMAKE_USE_PTHREADS_INIT)
-    target_link_libraries(libYap pthread)
     set (HAVE_READLINE_READLINE_H 1)
 #    set( CMAKE_REQUIRED_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT} )
     check_function_exists( pthread_mutexattr_setkind_np HAVE_PTHREAD_MUTEXATTR_SETKIND_NP )
@@ -38,6 +37,7 @@ if (WITH_Threads)
     check_function_exists( pthread_setconcurrency HAVE_PTHREAD_SETCONCURRENCY )
   endif (CMAKE_USE_PTHREADS_INIT)
   set(YAP_SYSTEM_OPTIONS "threads " ${YAP_SYSTEM_OPTIONS})
+  set(THREADS 1)
  set_property( DIRECTORY  APPEND PROPERTY COMPILE_DEFINITIONS  THREADS=1)
   #
   # Please note that the compiler flag can only be used with the imported
@@ -54,8 +54,11 @@ IF(WITH_Pthread_Lockin)
   set_DIRECTORY_properties(PROPERTIES APPEND COMPILE_DEFINITIONS USE_PTHREAD_LOCKING=1)
 ENDIF()
 
-CMAKE_DEPENDENT_OPTION (WITH_MAX_Threads 1024
-  "maximum number of threads" "WITH_Threads" 1)
+if (WITH_Threads)
+  set (WITH_MAX_Threads 1024 CACHE STRING "maximum number of threads")
+else (WITH_Threads)
+  set (WITH_MAX_Threads 1)
+endif (WITH_Threads)
 
 CMAKE_DEPENDENT_OPTION (WITH_MAX_Workers 64
   "maximum number of or-parallel workers" "WITH_MAX_Workers" 1)
@@ -12,8 +12,10 @@ OPTION(WITH_YAP_MALLOC
         ory" OFF)
 
 if (WITH_SYSTEM_MALLOC)
+    set(USE_SYSTEM_MALLOC 1)
     set_property(DIRECTORY APPEND PROPERTY COMPILE_DEFINITIONS USE_SYSTEM_MALLOC=1)
 elseif (WITH_DL_MALLOC)
+    set(USE_DL_MALLOC 1)
     set_property(DIRECTORY APPEND PROPERTY COMPILE_DEFINITIONS USE_DL_MALLOC=1)
 elseif (WITH_YAP_MALLOC)
     set_property(DIRECTORY APPEND PROPERTY COMPILE_DEFINITIONS USE_YAP_MALLOC=1)
@@ -52,6 +54,7 @@ check_include_file(mysql/mysql.h HAVE_MYSQL_MYSQL_H)
 check_include_file(netdb.h HAVE_NETDB_H)
 check_include_file(netinet/in.h HAVE_NETINET_IN_H)
 check_include_file(netinet/tcp.h HAVE_NETINET_TCP_H)
+check_include_file(poll.h HAVE_POLL_H)
 check_include_file(pthread.h HAVE_PTHREAD_H)
 check_include_file(pwd.h HAVE_PWD_H)
 check_include_file(regex.h HAVE_REGEX_H)
@@ -68,6 +71,7 @@ check_include_file(stropts.h HAVE_STROPTS_H)
 check_include_file(syslog.h HAVE_SYSLOG_H)
 check_include_file(sys/conf.h HAVE_SYS_CONF_H)
 check_include_file(sys/dir.h HAVE_SYS_DIR_H)
+check_include_file(sys/epoll.h HAVE_SYS_EPOLL_H)
 check_include_file(sys/file.h HAVE_SYS_FILE_H)
 check_include_file(sys/mman.h HAVE_SYS_MMAN_H)
 check_include_file(sys/ndir.h HAVE_SYS_NDIR_H)
@@ -97,6 +101,7 @@ check_include_file(windows.h HAVE_WINDOWS_H)
 check_include_file(winsock2.h HAVE_WINSOCK2_H)
 check_include_file(winsock.h HAVE_WINSOCK_H)
 check_include_file(wordexp.h HAVE_WORDEXP_H)
+check_include_file(zlib.h HAVE_ZLIB_H)
 
 check_include_file(Python.h HAVE_PYTHON_H)
 
@@ -205,6 +210,12 @@ if (HAVE_LIBPTHREAD)
     set(EXTRALIBS ${EXTRALIBS} pthread)
   endif (HAVE_LIBPTHREAD)
 
+check_library_exists(z deflate "" HAVE_LIBZ)
+if (HAVE_LIBZ AND HAVE_ZLIB_H)
+    target_link_libraries(libYap z)
+    set(EXTRALIBS ${EXTRALIBS} z)
+endif (HAVE_LIBZ AND HAVE_ZLIB_H)
+
 
 
 check_library_exists(unicode main "" HAVE_LIBUNICODE)
@@ -259,6 +270,7 @@ check_function_exists(fpurge HAVE_FPURGE)
 check_function_exists(ftime HAVE_FTIME)
 check_function_exists(ftruncate HAVE_FTRUNCATE)
 check_function_exists(funopen HAVE_FUNOPEN)
+check_function_exists(fopencookie HAVE_FOPENCOOKIE)
 #check_function_exists(gcc HAVE_GCC)
 check_function_exists(getcwd HAVE_GETCWD)
 check_function_exists(getenv HAVE_GETENV)
@@ -293,6 +305,7 @@ check_function_exists(mbscasecoll HAVE_MBSCASECOLL)
 check_function_exists(mbsnrtowcs HAVE_MBSNRTOWCS)
 check_function_exists(memmove HAVE_MEMCPY)
 check_function_exists(memmove HAVE_MEMMOVE)
+check_function_exists(memmem HAVE_MEMMEM)
 check_function_exists(mkstemp HAVE_MKSTEMP)
 check_function_exists(mktemp HAVE_MKTEMP)
 check_function_exists(nanosleep HAVE_NANOSLEEP)
@@ -362,6 +375,7 @@ check_function_exists(tcflush HAVE_TCFLUSH)
 check_function_exists(time HAVE_TIME)
 check_function_exists(timegm HAVE_TIMEGM)
 check_function_exists(times HAVE_TIMES)
+check_function_exists(timer_create HAVE_TIMER_CREATE)
 check_symbol_exists(timezone time.h HAVE_VAR_TIMEZONE)
 check_function_exists(tmpnam HAVE_TMPNAM)
 check_function_exists(ttyname HAVE_TTYNAME)
@@ -50,6 +50,8 @@ set (ENGINE_SOURCES
   C/depth_bound.c
   C/mavar.c
   C/modules.c
+  C/native.c
+  C/native_stencils.c
   C/other.c
   C/parser.c
   C/qlyr.c
@@ -168,6 +170,7 @@ BEAM/beam.h
     ${CMAKE_SOURCE_DIR}/H/inline-only.h
     ${CMAKE_SOURCE_DIR}/H/iswiatoms.h
     ${CMAKE_SOURCE_DIR}/H/locals.h
+    ${CMAKE_SOURCE_DIR}/H/native.h
     ${CMAKE_SOURCE_DIR}/H/nolocks.h
     ${CMAKE_SOURCE_DIR}/H/qly.h
     ${CMAKE_SOURCE_DIR}/H/rclause.h
@@ -175,6 +178,7 @@ BEAM/beam.h
     ${CMAKE_SOURCE_DIR}/H/saveclause.h
     ${CMAKE_SOURCE_DIR}/H/sig.h
     ${CMAKE_SOURCE_DIR}/H/sshift.h
+    ${CMAKE_SOURCE_DIR}/H/supers.h
     ${CMAKE_SOURCE_DIR}/H/threads.h
     ${CMAKE_SOURCE_DIR}/H/tracer.h
     ${CMAKE_SOURCE_DIR}/H/trim_trail.h
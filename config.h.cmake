@@ -38,7 +38,12 @@
 
 /* Are we compiling with support for threads? */
 #ifndef THREADS
-#cmakedefine THREADS  "$YAP_THREADS"
+#cmakedefine THREADS 1
+#endif
+
+/* Are we counting the abstract machine instructions that are run? */
+#ifndef ANALYST
+#cmakedefine ANALYST 1
 #endif
 
 /* Are we compiling with support for clause just-in-time compilationT? */
@@ -425,6 +430,11 @@ function. */
 #undef HAVE_FMEMOPEN
 #endif
 
+/* Define to 1 if you have the `fopencookie' function. */
+#ifndef HAVE_FOPENCOOKIE
+#cmakedefine HAVE_FOPENCOOKIE ${HAVE_FOPENCOOKIE}
+#endif
+
 /* Define to 1 if you have the `fpclass' function. */
 #ifndef HAVE_FPCLASS
 #cmakedefine HAVE_FPCLASS ${HAVE_FPCLASS}
@@ -771,6 +781,11 @@ function. */
 #define HAVE_LIBPTHREAD ${HAVE_LIBPTHREAD}
 #endif
 
+/* Define to 1 if you have the `z' library (-lz). */
+#ifndef HAVE_LIBZ
+#cmakedefine HAVE_LIBZ ${HAVE_LIBZ}
+#endif
+
 /* Define to 1 if you have the `raptor' library (-lraptor). */
 #ifndef HAVE_LIBRAPTOR
 #define HAVE_LIBRAPTOR ${HAVE_LIBRAPTOR}
@@ -902,6 +917,11 @@ function. */
 #cmakedefine HAVE_MEMCPY ${HAVE_MEMCPY}
 #endif
 
+/* Define to 1 if you have the `memmem' function. */
+#ifndef HAVE_MEMMEM
+#cmakedefine HAVE_MEMMEM ${HAVE_MEMMEM}
+#endif
+
 /* Define to 1 if you have the `memmove' function. */
 #ifndef HAVE_MEMMOVE
 #cmakedefine HAVE_MEMMOVE ${HAVE_MEMMOVE}
@@ -1011,6 +1031,11 @@ function. */
 #cmakedefine HAVE_POPEN ${HAVE_POPEN}
 #endif
 
+/* Define to 1 if you have the <poll.h> header file. */
+#ifndef HAVE_POLL_H
+#cmakedefine HAVE_POLL_H ${HAVE_POLL_H}
+#endif
+
 /* Define to 1 if you have the <pthread.h> header file. */
 #ifndef HAVE_PTHREAD_H
 #cmakedefine HAVE_PTHREAD_H ${HAVE_PTHREAD_H}
@@ -1423,6 +1448,11 @@ signal. */
 #cmakedefine HAVE_SYS_DIR_H ${HAVE_SYS_DIR_H}
 #endif
 
+/* Define to 1 if you have the <sys/epoll.h> header file. */
+#ifndef HAVE_SYS_EPOLL_H
+#cmakedefine HAVE_SYS_EPOLL_H ${HAVE_SYS_EPOLL_H}
+#endif
+
 /* Define to 1 if you have the <sys/file.h> header file. */
 #ifndef HAVE_SYS_FILE_H
 #cmakedefine HAVE_SYS_FILE_H ${HAVE_SYS_FILE_H}
@@ -1525,6 +1555,11 @@ signal. */
 #cmakedefine HAVE_TIMES ${HAVE_TIMES}
 #endif
 
+/* Define to 1 if you have the `timer_create' function. */
+#ifndef HAVE_TIMER_CREATE
+#cmakedefine HAVE_TIMER_CREATE ${HAVE_TIMER_CREATE}
+#endif
+
 /* Define to 1 if you have the <time.h> header file. */
 #ifndef HAVE_TIME_H
 #cmakedefine HAVE_TIME_H ${HAVE_TIME_H}
@@ -1903,7 +1938,7 @@ signal. */
 
 /* Use mmap in or-parallel copying */
 #ifndef USE_SYSTEM_MMAP
-#cmakedefine USE_SYSTEM_MMAP  ${WITH_SYSTEM_MMAP}
+#cmakedefine USE_SYSTEM_MMAP 1
 #endif
 
 /* Whether daylight savings time offset is set via the altzone variable */
@@ -2101,7 +2136,10 @@ calls it, or to nothing if 'inline' is not supported under any name.  */
 /* use the OS malloc or some other external library to implement the data-base
 */
 #ifndef USE_SYSTEM_MALLOC
-#define USE_SYSTEM_MALLOC ${WITH_SYSTEM_MALLOC}
+#cmakedefine USE_SYSTEM_MALLOC 1
+#endif
+#ifndef USE_DL_MALLOC
+#cmakedefine USE_DL_MALLOC 1
 #endif
 #endif
 
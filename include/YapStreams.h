@@ -56,6 +56,11 @@ static char SccsId[] = "%W% %G%";
 
 #include <wchar.h>
 
+#if defined(YAPOR) || defined(THREADS)
+/* the lockvar of Yap.h, for those who do not include it */
+#include <pthread.h>
+#endif
+
 /************ SWI compatible support for unicode representations  ************/
 typedef struct yap_io_position {
   int64_t byteno;       /* byte-position in file */
@@ -171,6 +176,7 @@ typedef struct mem_desc {
   YAP_Int max_size; /* maximum buffer size (may be changed dynamically) */
   YAP_UInt pos;     /* cursor */
   volatile void *error_handler;
+  YAP_Int text;     /* handle to the string a text stream reads, or 0 */
 } memHandle;
 
 #if HAVE_SOCKET
@@ -247,7 +253,7 @@ typedef struct stream_desc {
   YAP_Int charcount, linecount, linepos;
   stream_flags_t status;
 #if defined(YAPOR) || defined(THREADS)
-  lockvar streamlock; /* protect stream access */
+  pthread_mutex_t streamlock; /* protect stream access */
 #endif
   int (*stream_putc)(
       int, int); /** function the stream uses for writing a single octet */
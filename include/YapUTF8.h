@@ -30,6 +30,8 @@
 #define CHARCODE_MAX 0x10ffff
 #endif
 
+#include <string.h>
+
 #include "utf8proc.h"
 
 #ifndef INLINE_ONLY
@@ -49,6 +51,7 @@ INLINE_ONLY utf8proc_ssize_t get_utf8(const utf8proc_uint8_t *ptr,
           *valp = 0;
           return 2;
       }
+       CACHE_REGS
        LOCAL_ActiveError->errorNo = REPRESENTATION_ERROR_IN_CHARACTER_CODE;
   }
   return rc < 1 ? 1 : rc;
@@ -61,16 +64,53 @@ INLINE_ONLY utf8proc_ssize_t put_utf8(utf8proc_uint8_t *ptr,
                                                     utf8proc_int32_t val) {
     utf8proc_ssize_t rc = utf8proc_encode_char(val, ptr);
   if (rc <= 0) {
+      CACHE_REGS
       LOCAL_ActiveError->errorNo = REPRESENTATION_ERROR_CHARACTER_CODE;
   }
   return rc < 1 ? 1 : rc;
 }
 
+/* length of the run of ASCII characters, other than NUL, at the
+   start of pt, looking at most at max bytes. The text is examined a word
+   at a time once pt is aligned, so the reads never cross a page. */
+inline static size_t utf8_ascii_prefix(const utf8proc_uint8_t *pt, size_t max) {
+  const utf8proc_uint8_t *p0 = pt, *pmax;
+  const size_t ones = (size_t)-1 / 0xff, highs = ones * 0x80;
+
+  if (max > UINTPTR_MAX - (uintptr_t)pt)
+    pmax = (const utf8proc_uint8_t *)UINTPTR_MAX;
+  else
+    pmax = pt + max;
+  while (pt < pmax && ((uintptr_t)pt & (sizeof(size_t) - 1))) {
+    if (*pt == 0 || *pt >= 0x80)
+      return pt - p0;
+    pt++;
+  }
+#if !defined(__SANITIZE_ADDRESS__)
+  while ((size_t)(pmax - pt) >= sizeof(size_t)) {
+    size_t w;
+    memcpy(&w, pt, sizeof(size_t));
+    if ((w & highs) || ((w - ones) & ~w & highs))
+      break;
+    pt += sizeof(size_t);
+  }
+#endif
+  while (pt < pmax && *pt && *pt < 0x80)
+    pt++;
+  return pt - p0;
+}
+
 inline static const utf8proc_uint8_t *skip_utf8(const utf8proc_uint8_t *pt,
 						utf8proc_ssize_t n) {
   utf8proc_ssize_t i;
   utf8proc_int32_t b;
   for (i = 0; i < n; i++) {
+    size_t k = utf8_ascii_prefix(pt, n - i);
+    if (k) {
+      pt += k;
+      i += k - 1;
+      continue;
+    }
     utf8proc_ssize_t l = utf8proc_iterate(pt, -1, &b);
     if (b == 0)
       return pt;
@@ -91,6 +131,9 @@ inline static utf8proc_ssize_t strlen_utf8(const utf8proc_uint8_t *pt) {
   utf8proc_ssize_t rc = 0;
   utf8proc_int32_t b;
   while (true) {
+    size_t k = utf8_ascii_prefix(pt, (size_t)-1);
+    pt += k;
+    rc += k;
     utf8proc_ssize_t l = utf8proc_iterate(pt, -1, &b);
     if (b == 0)
       return rc;
@@ -22,6 +22,7 @@
 #if HAVE_STRING_H
 #include <string.h>
 #endif
+#include "matrix_kernels.h"
 
 /*
   A matrix is something of the form
@@ -1264,60 +1265,25 @@ static YAP_Bool matrix_sum(void) {
   }
   if (mat[MAT_TYPE] == INT_MATRIX) {
     long int *data = matrix_long_data(mat, mat[MAT_NDIMS]);
-    int i;
-    long int sum = 0;
 
-    for (i = 0; i < mat[MAT_SIZE]; i++) {
-      sum += data[i];
-    }
-    tf = YAP_MkIntTerm(sum);
+    tf = YAP_MkIntTerm(mat_sum_long(mat[MAT_SIZE], data));
   } else {
     double *data = matrix_double_data(mat, mat[MAT_NDIMS]);
-    int i;
-    double sum = 0.0;
-    // function KahanSum(input)
-    double c = 0.0; // A running compensation for lost low-order bits.
-    for (i = 0; i < mat[MAT_SIZE]; i++) {
-      double y = data[i] - c; // So far, so good: c is zero.
-      double t =
-          sum +
-          y; // Alas, sum is big, y small, so low-order digits of y are lost.
-      c = (t - sum) - y; // (t - sum) cancels the high-order part of y;
-                         // subtracting y recovers negative (low part of y)
-      sum = t;           // Algebraically, c should always be zero. Beware
-                         // overly-aggressive optimizing compilers!
-    }
-    tf = YAP_MkFloatTerm(sum);
+
+    /* Kahan summation, see mat_sum_double() */
+    tf = YAP_MkFloatTerm(mat_sum_double(mat[MAT_SIZE], data));
   }
   return YAP_Unify(YAP_ARG2, tf);
 }
 
 static void add_int_lines(int total, int nlines, long int *mat0,
                           long int *matf) {
-  int ncols = total / nlines, i;
-  for (i = 0; i < ncols; i++) {
-    long int sum = 0;
-    int j;
-
-    for (j = i; j < total; j += ncols) {
-      sum += mat0[j];
-    }
-    matf[i] = sum;
-  }
+  mat_agg_lines_long(nlines, total / nlines, mat0, matf);
 }
 
 static void add_double_lines(int total, int nlines, double *mat0,
                              double *matf) {
-  int ncols = total / nlines, i;
-  for (i = 0; i < ncols; i++) {
-    double sum = 0;
-    int j;
-
-    for (j = i; j < total; j += ncols) {
-      sum += mat0[j];
-    }
-    matf[i] = sum;
-  }
+  mat_agg_lines_double(nlines, total / nlines, mat0, matf);
 }
 
 static YAP_Bool matrix_agg_lines(void) {
@@ -1358,9 +1324,10 @@ static YAP_Bool matrix_agg_lines(void) {
     int *nmat;
 
     tf = new_float_matrix(dims - 1, mat + (MAT_DIMS + 1), NULL);
-    nmat = (int *)YAP_BlobOfTerm(tf);
     if (tf == YAP_TermNil())
       return FALSE;
+    mat = (int *)YAP_BlobOfTerm(YAP_ARG1);
+    nmat = (int *)YAP_BlobOfTerm(tf);
     data = matrix_double_data(mat, dims);
     ndata = matrix_double_data(nmat, dims - 1);
     if (op == MAT_PLUS) {
@@ -1373,29 +1340,11 @@ static YAP_Bool matrix_agg_lines(void) {
 
 static void add_int_cols(int total, int nlines, long int *mat0,
                          long int *matf) {
-  int ncols = total / nlines, i, j = 0;
-  for (i = 0; i < nlines; i++) {
-    long int sum = 0;
-    int max = (i + 1) * ncols;
-
-    for (; j < max; j++) {
-      sum += mat0[j];
-    }
-    matf[i] = sum;
-  }
+  mat_agg_cols_long(nlines, total / nlines, mat0, matf);
 }
 
 static void add_double_cols(int total, int nlines, double *mat0, double *matf) {
-  int ncols = total / nlines, i, j = 0;
-  for (i = 0; i < nlines; i++) {
-    double sum = 0;
-    int max = (i + 1) * ncols;
-
-    for (; j < max; j++) {
-      sum += mat0[j];
-    }
-    matf[i] = sum;
-  }
+  mat_agg_cols_double(nlines, total / nlines, mat0, matf);
 }
 
 static YAP_Bool matrix_agg_cols(void) {
@@ -1438,6 +1387,7 @@ static YAP_Bool matrix_agg_cols(void) {
     tf = new_float_matrix(1, mat + MAT_DIMS, NULL);
     if (tf == YAP_TermNil())
       return FALSE;
+    mat = (int *)YAP_BlobOfTerm(YAP_ARG1);
     nmat = (int *)YAP_BlobOfTerm(tf);
     data = matrix_double_data(mat, dims);
     ndata = matrix_double_data(nmat, 1);
@@ -1576,6 +1526,7 @@ static void matrix_long_add_data(long int *nmat, int siz, long int mat1[],
                                  long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] + mat2[i];
   }
@@ -1585,6 +1536,7 @@ static void matrix_long_double_add_data(double *nmat, int siz, long int mat1[],
                                         double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] + mat2[i];
   }
@@ -1594,6 +1546,7 @@ static void matrix_double_add_data(double *nmat, int siz, double mat1[],
                                    double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] + mat2[i];
   }
@@ -1603,6 +1556,7 @@ static void matrix_long_sub_data(long int *nmat, int siz, long int mat1[],
                                  long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] - mat2[i];
   }
@@ -1612,6 +1566,7 @@ static void matrix_long_double_sub_data(double *nmat, int siz, long int mat1[],
                                         double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] - mat2[i];
   }
@@ -1621,6 +1576,7 @@ static void matrix_long_double_rsub_data(double *nmat, int siz, double mat1[],
                                          long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat2[i] - mat1[i];
   }
@@ -1630,6 +1586,7 @@ static void matrix_double_sub_data(double *nmat, int siz, double mat1[],
                                    double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] - mat2[i];
   }
@@ -1639,6 +1596,7 @@ static void matrix_long_mult_data(long int *nmat, int siz, long int mat1[],
                                   long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] * mat2[i];
   }
@@ -1648,6 +1606,7 @@ static void matrix_long_double_mult_data(double *nmat, int siz, long int mat1[],
                                          double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] * mat2[i];
   }
@@ -1657,6 +1616,7 @@ static void matrix_double_mult_data(double *nmat, int siz, double mat1[],
                                     double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] * mat2[i];
   }
@@ -1666,6 +1626,7 @@ static void matrix_long_div_data(long int *nmat, int siz, long int mat1[],
                                  long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] / mat2[i];
   }
@@ -1675,6 +1636,7 @@ static void matrix_long_double_div_data(double *nmat, int siz, long int mat1[],
                                         double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] / mat2[i];
   }
@@ -1684,6 +1646,7 @@ static void matrix_long_double_div2_data(double *nmat, int siz, double mat1[],
                                          long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] / mat2[i];
   }
@@ -1693,6 +1656,7 @@ static void matrix_double_div_data(double *nmat, int siz, double mat1[],
                                    double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     nmat[i] = mat1[i] / mat2[i];
   }
@@ -1702,6 +1666,7 @@ static void matrix_long_zdiv_data(long int *nmat, int siz, long int mat1[],
                                   long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     if (mat1[i] == 0)
       nmat[i] = 0;
@@ -1714,6 +1679,7 @@ static void matrix_long_double_zdiv_data(double *nmat, int siz, long int mat1[],
                                          double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     if (mat1[i] == 0)
       nmat[i] = 0;
@@ -1726,6 +1692,7 @@ static void matrix_long_double_zdiv2_data(double *nmat, int siz, double mat1[],
                                           long int mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     if (mat1[i] == 0.0)
       nmat[i] = 0;
@@ -1738,6 +1705,7 @@ static void matrix_double_zdiv_data(double *nmat, int siz, double mat1[],
                                     double mat2[]) {
   int i;
 
+  MAT_PAR_FOR_SIMD(siz)
   for (i = 0; i < siz; i++) {
     if (mat1[i] == 0.0) {
       nmat[i] = 0.0;
@@ -2251,6 +2219,17 @@ static YAP_Bool matrix_transpose(void) {
     dimsn[i] = dims[j];
     tconv = YAP_TailOfTerm(tconv);
   }
+  if (ndims == 2 && conv[0] == 1 && conv[1] == 0) {
+    /* a plain transpose, we can do it by blocks */
+    if (mat[MAT_TYPE] == INT_MATRIX) {
+      mat_transpose_long(dims[0], dims[1], matrix_long_data(mat, 2),
+                         matrix_long_data(nmat, 2));
+    } else {
+      mat_transpose_double(dims[0], dims[1], matrix_double_data(mat, 2),
+                           matrix_double_data(nmat, 2));
+    }
+    return YAP_Unify(YAP_ARG3, tf);
+  }
   /*
     we now got all the dimensions set up, so what we need to do
     next is to copy the elements to the new matrix.
@@ -2287,6 +2266,68 @@ static YAP_Bool matrix_transpose(void) {
   return YAP_Unify(YAP_ARG3, tf);
 }
 
+/* given two 2-dimensional matrices A and B, compute the matrix product
+   A x B. The result is an integer matrix only if both A and B are. */
+static YAP_Bool matrix_product(void) {
+  int dims[2], n, k, m;
+  YAP_Term tf;
+  int *mat1 = (int *)YAP_BlobOfTerm(YAP_ARG1), *mat2, *nmat;
+
+  if (!mat1) {
+    /* Error */
+    return FALSE;
+  }
+  mat2 = (int *)YAP_BlobOfTerm(YAP_ARG2);
+  if (!mat2) {
+    /* Error */
+    return FALSE;
+  }
+  if (mat1[MAT_NDIMS] != 2 || mat2[MAT_NDIMS] != 2 ||
+      mat1[MAT_DIMS + 1] != mat2[MAT_DIMS]) {
+    return FALSE;
+  }
+  n = dims[0] = mat1[MAT_DIMS];
+  k = mat1[MAT_DIMS + 1];
+  m = dims[1] = mat2[MAT_DIMS + 1];
+  if (mat1[MAT_TYPE] == INT_MATRIX && mat2[MAT_TYPE] == INT_MATRIX) {
+    tf = new_int_matrix(2, dims, NULL);
+    if (tf == YAP_TermNil())
+      return FALSE;
+    /* in case the matrices moved */
+    mat1 = (int *)YAP_BlobOfTerm(YAP_ARG1);
+    mat2 = (int *)YAP_BlobOfTerm(YAP_ARG2);
+    nmat = (int *)YAP_BlobOfTerm(tf);
+    mat_product_long(n, k, m, matrix_long_data(mat1, 2),
+                     matrix_long_data(mat2, 2), matrix_long_data(nmat, 2));
+  } else {
+    double *data1, *data2, *tmp = NULL;
+
+    tf = new_float_matrix(2, dims, NULL);
+    if (tf == YAP_TermNil())
+      return FALSE;
+    /* in case the matrices moved */
+    mat1 = (int *)YAP_BlobOfTerm(YAP_ARG1);
+    mat2 = (int *)YAP_BlobOfTerm(YAP_ARG2);
+    nmat = (int *)YAP_BlobOfTerm(tf);
+    /* mixed products: convert the integer matrix first */
+    if (mat1[MAT_TYPE] == INT_MATRIX || mat2[MAT_TYPE] == INT_MATRIX) {
+      int *imat = (mat1[MAT_TYPE] == INT_MATRIX ? mat1 : mat2), i;
+      long int *idata = matrix_long_data(imat, 2);
+
+      if (!(tmp = malloc(imat[MAT_SIZE] * sizeof(double))))
+        return FALSE;
+      for (i = 0; i < imat[MAT_SIZE]; i++)
+        tmp[i] = idata[i];
+    }
+    data1 = (mat1[MAT_TYPE] == INT_MATRIX ? tmp : matrix_double_data(mat1, 2));
+    data2 = (mat2[MAT_TYPE] == INT_MATRIX ? tmp : matrix_double_data(mat2, 2));
+    mat_product_double(n, k, m, data1, data2, matrix_double_data(nmat, 2));
+    if (tmp)
+      free(tmp);
+  }
+  return YAP_Unify(YAP_ARG3, tf);
+}
+
 /* given a matrix M and a set of dims, fold one of the dimensions of the
    matrix on one of the elements
 */
@@ -2458,7 +2499,8 @@ static YAP_Bool matrix_column(void) {
  */
 static YAP_Bool matrix_sum_out(void) {
   int ndims, i, j, newdims, prdim;
-  int indx[MAX_DIMS], nindx[MAX_DIMS];
+  int nindx[MAX_DIMS];
+  long int outer = 1, inner = 1;
   YAP_Term tpdim, tf;
   int *mat = (int *)YAP_BlobOfTerm(YAP_ARG1), *nmat;
   if (!mat) {
@@ -2472,12 +2514,20 @@ static YAP_Bool matrix_sum_out(void) {
     return FALSE;
   }
   prdim = YAP_IntOfTerm(tpdim);
+  if (prdim < 0 || prdim >= ndims) {
+    return FALSE;
+  }
   newdims = ndims - 1;
   for (i = 0, j = 0; i < ndims; i++) {
     if (i != prdim) {
       nindx[j] = (mat + MAT_DIMS)[i];
       j++;
     }
+    /* the matrix is outer x dim x inner */
+    if (i < prdim)
+      outer *= (mat + MAT_DIMS)[i];
+    else if (i > prdim)
+      inner *= (mat + MAT_DIMS)[i];
   }
   if (mat[MAT_TYPE] == INT_MATRIX) {
     long int *data, *ndata;
@@ -2491,23 +2541,7 @@ static YAP_Bool matrix_sum_out(void) {
     nmat = (int *)YAP_BlobOfTerm(tf);
     data = matrix_long_data(mat, ndims);
     ndata = matrix_long_data(nmat, newdims);
-    /* create a new matrix with smaller size */
-    for (i = 0; i < nmat[MAT_SIZE]; i++)
-      ndata[i] = 0;
-    for (i = 0; i < mat[MAT_SIZE]; i++) {
-      int j, k;
-      /*
-        not very efficient, we could try to take advantage of the fact
-        that we usually only change an index at a time
-      */
-      matrix_get_index(mat, i, indx);
-      for (j = 0, k = 0; j < ndims; j++) {
-        if (j != prdim) {
-          nindx[k++] = indx[j];
-        }
-      }
-      ndata[matrix_get_offset(nmat, nindx)] += data[i];
-    }
+    mat_sum_out_long(outer, mat[MAT_DIMS + prdim], inner, data, ndata);
   } else {
     double *data, *ndata;
 
@@ -2520,23 +2554,7 @@ static YAP_Bool matrix_sum_out(void) {
     nmat = (int *)YAP_BlobOfTerm(tf);
     data = matrix_double_data(mat, ndims);
     ndata = matrix_double_data(nmat, newdims);
-    /* create a new matrix with smaller size */
-    for (i = 0; i < nmat[MAT_SIZE]; i++)
-      ndata[i] = 0.0;
-    for (i = 0; i < mat[MAT_SIZE]; i++) {
-      int j, k;
-      /*
-        not very efficient, we could try to take advantage of the fact
-        that we usually only change an index at a time
-      */
-      matrix_get_index(mat, i, indx);
-      for (j = 0, k = 0; j < ndims; j++) {
-        if (j != prdim) {
-          nindx[k++] = indx[j];
-        }
-      }
-      ndata[matrix_get_offset(nmat, nindx)] += data[i];
-    }
+    mat_sum_out_double(outer, mat[MAT_DIMS + prdim], inner, data, ndata);
   }
   return YAP_Unify(YAP_ARG3, tf);
 }
@@ -3048,6 +3066,23 @@ static YAP_Bool is_matrix(void) {
   return TRUE;
 }
 
+/* where the elements of a matrix start, for foreign code that wants to
+   share them */
+static YAP_Bool matrix_data_address(void) {
+  int *mat = (int *)YAP_BlobOfTerm(YAP_ARG1);
+  void *data;
+
+  if (!mat) {
+    return FALSE;
+  }
+  if (mat[MAT_TYPE] == INT_MATRIX) {
+    data = matrix_long_data(mat, mat[MAT_NDIMS]);
+  } else {
+    data = matrix_double_data(mat, mat[MAT_NDIMS]);
+  }
+  return YAP_Unify(YAP_ARG2, YAP_MkIntTerm((YAP_Int)data));
+}
+
 static YAP_Bool get_float_from_address(void) {
   YAP_Float *fp = (YAP_Float *)YAP_IntOfTerm(YAP_ARG1);
   YAP_Int off = YAP_IntOfTerm(YAP_ARG2);
@@ -3100,6 +3135,7 @@ X_API void init_matrix(void) {
   YAP_UserCPredicate("matrixn_minarg", matrix_minarg, 2);
   YAP_UserCPredicate("matrix_sum", matrix_sum, 2);
   YAP_UserCPredicate("matrix_shuffle", matrix_transpose, 3);
+  YAP_UserCPredicate("matrix_product", matrix_product, 3);
   YAP_UserCPredicate("matrix_expand", matrix_expand, 3);
   YAP_UserCPredicate("matrix_select", matrix_select, 4);
   YAP_UserCPredicate("matrix_column", matrix_column, 3);
@@ -3123,6 +3159,7 @@ X_API void init_matrix(void) {
   YAP_UserCPredicate("do_matrix_op_to_cols", matrix_op_to_cols, 4);
   YAP_UserCPredicate("matrix_m", matrix_m, 2);
   YAP_UserCPredicate("matrix", is_matrix, 1);
+  YAP_UserCPredicate("matrix_data_address", matrix_data_address, 2);
   YAP_UserCPredicate("get_float_from_address", get_float_from_address, 3);
   YAP_UserCPredicate("set_float_from_address", set_float_from_address, 3);
 }
@@ -0,0 +1,221 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		matrix_bench.c *
+ * comments:	compare matrix kernels with the original loops *
+ *									 *
+ *************************************************************************/
+
+/*
+  Standalone program, it does not need YAP. For every kernel in
+  matrix_kernels.h it runs the scalar loop that library(matrix) used
+  before, checks that both agree, and reports the time taken by
+  each.
+
+  usage: matrix_bench [N]
+
+  where N is the side of the square matrices (default 1024).
+*/
+
+#include "matrix_kernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+static double now(void) {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* the original loops */
+
+static void old_add_double_lines(int total, int nlines, double *mat0,
+                                 double *matf) {
+  int ncols = total / nlines, i;
+  for (i = 0; i < ncols; i++) {
+    double sum = 0;
+    int j;
+
+    for (j = i; j < total; j += ncols) {
+      sum += mat0[j];
+    }
+    matf[i] = sum;
+  }
+}
+
+static void old_sum_out(int ndims, int *dims, int prdim, double *data,
+                        double *ndata) {
+  int i, nsize = 1, size = 1, indx[8], nindx[8], ndims2[8];
+
+  for (i = 0; i < ndims; i++) {
+    size *= dims[i];
+  }
+  for (i = 0; i < ndims - 1; i++) {
+    ndims2[i] = dims[i < prdim ? i : i + 1];
+    nsize *= ndims2[i];
+  }
+  for (i = 0; i < nsize; i++)
+    ndata[i] = 0.0;
+  for (i = 0; i < size; i++) {
+    int j, k, pos = size, off = i, noff = 0;
+
+    for (j = 0; j < ndims; j++) {
+      pos /= dims[j];
+      indx[j] = off / pos;
+      off = off % pos;
+    }
+    for (j = 0, k = 0; j < ndims; j++) {
+      if (j != prdim) {
+        nindx[k++] = indx[j];
+      }
+    }
+    pos = nsize;
+    for (j = 0; j < ndims - 1; j++) {
+      pos /= ndims2[j];
+      noff += pos * nindx[j];
+    }
+    ndata[noff] += data[i];
+  }
+}
+
+static void old_transpose(int rows, int cols, double *in, double *out) {
+  int i;
+
+  for (i = 0; i < rows * cols; i++) {
+    int r = i / cols, c = i % cols;
+    out[c * rows + r] = in[i];
+  }
+}
+
+static void old_product(int n, int k, int m, double *a, double *b,
+                        double *c) {
+  int i, j, l;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < m; j++) {
+      double s = 0.0;
+      for (l = 0; l < k; l++)
+        s += a[i * k + l] * b[l * m + j];
+      c[i * m + j] = s;
+    }
+}
+
+static void old_add(int siz, double *a, double *b, double *c) {
+  int i;
+
+  for (i = 0; i < siz; i++)
+    c[i] = a[i] + b[i];
+}
+
+static void new_add(int siz, double *a, double *b, double *c) {
+  int i;
+
+  MAT_PAR_FOR_SIMD(siz)
+  for (i = 0; i < siz; i++)
+    c[i] = a[i] + b[i];
+}
+
+static int same(long int n, double *a, double *b) {
+  long int i;
+
+  for (i = 0; i < n; i++) {
+    if (fabs(a[i] - b[i]) > 1e-6 * (1.0 + fabs(a[i])))
+      return 0;
+  }
+  return 1;
+}
+
+static void report(const char *what, double t0, double t1, int ok) {
+  printf("%-12s old %9.2f ms  new %9.2f ms  speedup %6.2fx  %s\n", what,
+         t0 * 1e3, t1 * 1e3, t0 / t1, ok ? "ok" : "MISMATCH");
+}
+
+int main(int argc, char **argv) {
+  int n = (argc > 1 ? atoi(argv[1]) : 1024), dims[3];
+  long int sz = (long int)n * n, i;
+  double *a = malloc(sz * sizeof(double)), *b = malloc(sz * sizeof(double)),
+         *c0 = malloc(sz * sizeof(double)), *c1 = malloc(sz * sizeof(double));
+  double t, t0, t1;
+
+  if (!a || !b || !c0 || !c1)
+    return 1;
+  for (i = 0; i < sz; i++) {
+    a[i] = (double)(i % 97) / 7.0;
+    b[i] = (double)(i % 89) / 3.0;
+  }
+#ifdef _OPENMP
+  printf("%d x %d doubles, %d threads\n", n, n, omp_get_max_threads());
+#else
+  printf("%d x %d doubles, no OpenMP\n", n, n);
+#endif
+
+  t = now();
+  old_add(sz, a, b, c0);
+  t0 = now() - t;
+  t = now();
+  new_add(sz, a, b, c1);
+  t1 = now() - t;
+  report("op(+)", t0, t1, same(sz, c0, c1));
+
+  t = now();
+  old_add_double_lines(sz, n, a, c0);
+  t0 = now() - t;
+  t = now();
+  mat_agg_lines_double(n, n, a, c1);
+  t1 = now() - t;
+  report("agg_lines", t0, t1, same(n, c0, c1));
+
+  t = now();
+  c0[0] = mat_kahan(sz, a);
+  t0 = now() - t;
+  t = now();
+  c1[0] = mat_sum_double(sz, a);
+  t1 = now() - t;
+  report("sum", t0, t1, same(1, c0, c1));
+
+  /* sum out the middle dimension of a n/8 x 8 x n cube */
+  dims[0] = n / 8;
+  dims[1] = 8;
+  dims[2] = n;
+  t = now();
+  old_sum_out(3, dims, 1, a, c0);
+  t0 = now() - t;
+  t = now();
+  mat_sum_out_double(dims[0], dims[1], dims[2], a, c1);
+  t1 = now() - t;
+  report("sum_out", t0, t1, same((long int)dims[0] * dims[2], c0, c1));
+
+  t = now();
+  old_transpose(n, n, a, c0);
+  t0 = now() - t;
+  t = now();
+  mat_transpose_double(n, n, a, c1);
+  t1 = now() - t;
+  report("transpose", t0, t1, same(sz, c0, c1));
+
+  /* the naive product is slow, keep it reasonable */
+  if (n > 1024)
+    n = 1024;
+  t = now();
+  old_product(n, n, n, a, b, c0);
+  t0 = now() - t;
+  t = now();
+  mat_product_double(n, n, n, a, b, c1);
+  t1 = now() - t;
+  report("product", t0, t1, same((long int)n * n, c0, c1));
+
+  free(a);
+  free(b);
+  free(c0);
+  free(c1);
+  return 0;
+}
@@ -0,0 +1,222 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		matrix_kernels.h *
+ * comments:	bulk numerical kernels for matrix.c *
+ *									 *
+ *************************************************************************/
+
+/*
+  These are the loops that do the actual work in library(matrix). They
+  only see flat C arrays, so that they can also be used by the
+  benchmark in matrix_bench.c.
+
+  All loops walk memory in storage order, work on cache-sized blocks
+  when they cannot, and are written so that the compiler can
+  vectorise the inner loop. If the library is compiled with OpenMP,
+  loops over large matrices are also split among threads.
+*/
+
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+#include <stdlib.h>
+#include <string.h>
+
+/* below this number of elements threads cost more than they give */
+#ifndef MAT_PAR_THRESHOLD
+#define MAT_PAR_THRESHOLD (64 * 1024)
+#endif
+
+/* block side for transpose and product, 3 blocks fit in L1 */
+#define MAT_BLOCK 64
+
+#ifdef _OPENMP
+#include <omp.h>
+#define MAT_PRAGMA(X) _Pragma(#X)
+#define MAT_SIMD MAT_PRAGMA(omp simd)
+#define MAT_SIMD_SUM(V) MAT_PRAGMA(omp simd reduction(+ : V))
+#define MAT_PAR_FOR(N) MAT_PRAGMA(omp parallel for if ((N) > MAT_PAR_THRESHOLD))
+#define MAT_PAR_FOR_SIMD(N)                                                    \
+  MAT_PRAGMA(omp parallel for simd if ((N) > MAT_PAR_THRESHOLD))
+#else
+#define MAT_SIMD
+#define MAT_SIMD_SUM(V)
+#define MAT_PAR_FOR(N)
+#define MAT_PAR_FOR_SIMD(N)
+#endif
+
+/* sum of n doubles: Kahan summation within blocks, so that blocks can be
+   done in parallel, and then Kahan summation of the blocks */
+#define MAT_SUM_BLOCK 4096
+
+static inline double mat_kahan(long int n, const double *data) {
+  double sum = 0.0, c = 0.0;
+  long int i;
+
+  for (i = 0; i < n; i++) {
+    double y = data[i] - c;
+    double t = sum + y;
+    c = (t - sum) - y;
+    sum = t;
+  }
+  return sum;
+}
+
+static inline double mat_sum_double(long int n, const double *data) {
+  long int nblocks = (n + MAT_SUM_BLOCK - 1) / MAT_SUM_BLOCK, b;
+  double *partial, sum;
+
+  if (nblocks <= 1)
+    return mat_kahan(n, data);
+  if (!(partial = malloc(nblocks * sizeof(double))))
+    return mat_kahan(n, data);
+  MAT_PAR_FOR(n)
+  for (b = 0; b < nblocks; b++) {
+    long int start = b * MAT_SUM_BLOCK,
+             len = (b == nblocks - 1 ? n - start : MAT_SUM_BLOCK);
+    partial[b] = mat_kahan(len, data + start);
+  }
+  sum = mat_kahan(nblocks, partial);
+  free(partial);
+  return sum;
+}
+
+static inline long int mat_sum_long(long int n, const long int *data) {
+  long int sum = 0, i;
+
+#ifdef _OPENMP
+#pragma omp parallel for simd reduction(+ : sum) if (n > MAT_PAR_THRESHOLD)
+#endif
+  for (i = 0; i < n; i++) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+/*
+  The remaining kernels exist for both long int and double data. A
+  matrix with dimensions D0 x ... x Dn is seen as a 3-dimensional
+  block outer x d x inner, where d is the dimension we are working on.
+*/
+#define MAT_TYPED_KERNELS(T, S)                                                \
+                                                                               \
+  /* out[o*inner+k] = sum_j in[(o*d+j)*inner+k] */                             \
+  static inline void mat_sum_out_##S(long int outer, long int d,               \
+                                     long int inner, const T *in, T *out) {    \
+    long int o;                                                                \
+                                                                               \
+    MAT_PAR_FOR(outer *d *inner)                                               \
+    for (o = 0; o < outer; o++) {                                              \
+      T *dst = out + o * inner;                                                \
+      const T *src = in + o * d * inner;                                       \
+      long int j, k;                                                           \
+                                                                               \
+      if (inner == 1) {                                                        \
+        T sum = 0;                                                             \
+        MAT_SIMD_SUM(sum)                                                      \
+        for (j = 0; j < d; j++)                                                \
+          sum += src[j];                                                       \
+        dst[0] = sum;                                                          \
+        continue;                                                              \
+      }                                                                        \
+      for (k = 0; k < inner; k++)                                              \
+        dst[k] = 0;                                                            \
+      for (j = 0; j < d; j++, src += inner) {                                  \
+        MAT_SIMD                                                               \
+        for (k = 0; k < inner; k++)                                            \
+          dst[k] += src[k];                                                    \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* add all lines: one output per column, rows are walked in order, and       \
+     threads share out blocks of columns */                                    \
+  static inline void mat_agg_lines_##S(long int nlines, long int ncols,        \
+                                       const T *in, T *out) {                  \
+    long int cb, nblocks = (ncols + MAT_BLOCK * 16 - 1) / (MAT_BLOCK * 16);    \
+                                                                               \
+    MAT_PAR_FOR(nlines *ncols)                                                 \
+    for (cb = 0; cb < nblocks; cb++) {                                         \
+      long int c0 = cb * MAT_BLOCK * 16, c1 = c0 + MAT_BLOCK * 16, l, c;       \
+                                                                               \
+      if (c1 > ncols)                                                          \
+        c1 = ncols;                                                            \
+      for (c = c0; c < c1; c++)                                                \
+        out[c] = 0;                                                            \
+      for (l = 0; l < nlines; l++) {                                           \
+        const T *row = in + l * ncols;                                         \
+        MAT_SIMD                                                               \
+        for (c = c0; c < c1; c++)                                              \
+          out[c] += row[c];                                                    \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* add all columns: one output per line */                                   \
+  static inline void mat_agg_cols_##S(long int nlines, long int ncols,         \
+                                      const T *in, T *out) {                   \
+    mat_sum_out_##S(nlines, ncols, 1, in, out);                                \
+  }                                                                            \
+                                                                               \
+  /* out is the transpose of the rows x cols matrix in */                      \
+  static inline void mat_transpose_##S(long int rows, long int cols,           \
+                                       const T *in, T *out) {                  \
+    long int ib;                                                               \
+                                                                               \
+    MAT_PAR_FOR(rows *cols)                                                    \
+    for (ib = 0; ib < rows; ib += MAT_BLOCK) {                                 \
+      long int jb, i, j, imax = ib + MAT_BLOCK < rows ? ib + MAT_BLOCK : rows; \
+                                                                               \
+      for (jb = 0; jb < cols; jb += MAT_BLOCK) {                               \
+        long int jmax = jb + MAT_BLOCK < cols ? jb + MAT_BLOCK : cols;         \
+        for (i = ib; i < imax; i++) {                                          \
+          for (j = jb; j < jmax; j++)                                          \
+            out[j * rows + i] = in[i * cols + j];                              \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* c (n x m) = a (n x k) * b (k x m), blocked i-k-j order so that the        \
+     innermost loop streams over rows of b and c */                            \
+  static inline void mat_product_##S(long int n, long int k, long int m,       \
+                                     const T *a, const T *b, T *c) {           \
+    long int ib;                                                               \
+                                                                               \
+    memset(c, 0, n * m * sizeof(T));                                           \
+    MAT_PAR_FOR(n *k *m)                                                       \
+    for (ib = 0; ib < n; ib += MAT_BLOCK) {                                    \
+      long int imax = ib + MAT_BLOCK < n ? ib + MAT_BLOCK : n, kb, jb, i, l,   \
+               j;                                                              \
+                                                                               \
+      for (kb = 0; kb < k; kb += MAT_BLOCK) {                                  \
+        long int lmax = kb + MAT_BLOCK < k ? kb + MAT_BLOCK : k;               \
+        for (jb = 0; jb < m; jb += MAT_BLOCK * 4) {                            \
+          long int jmax = jb + MAT_BLOCK * 4 < m ? jb + MAT_BLOCK * 4 : m;     \
+          for (i = ib; i < imax; i++) {                                        \
+            T *ci = c + i * m;                                                 \
+            for (l = kb; l < lmax; l++) {                                      \
+              T ail = a[i * k + l];                                            \
+              const T *bl = b + l * m;                                         \
+              MAT_SIMD                                                         \
+              for (j = jb; j < jmax; j++)                                      \
+                ci[j] += ail * bl[j];                                          \
+            }                                                                  \
+          }                                                                    \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+  }
+
+MAT_TYPED_KERNELS(long int, long)
+MAT_TYPED_KERNELS(double, double)
+
+#endif /* MATRIX_KERNELS_H */
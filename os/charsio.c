@@ -109,6 +109,7 @@ int Yap_peekWithGetc(int sno) {
 }
 
 int Yap_peekWideWithSeek(int sno) {
+  CACHE_REGS
   StreamDesc *s;
   s = GLOBAL_Stream + sno;
   Int pos = IntegerOfTerm(Yap_StreamPosition(sno));
@@ -121,7 +122,7 @@ int Yap_peekWideWithSeek(int sno) {
     s->status &= ~Eof_Error_Stream_f;
     // do not try doing error processing
   } else {
-    Yap_SetCurInpPos(sno, pos);
+    Yap_SetCurInpPos(sno, pos PASS_REGS);
     s->charcount = pos;
     s->linecount = line;
     s->linepos = lpos;
@@ -130,6 +131,7 @@ int Yap_peekWideWithSeek(int sno) {
 }
 
 int Yap_peekWithSeek(int sno) {
+  CACHE_REGS
   StreamDesc *s;
   s = GLOBAL_Stream + sno;
   Int pos = IntegerOfTerm(Yap_StreamPosition(sno));
@@ -142,7 +144,7 @@ int Yap_peekWithSeek(int sno) {
     s->status &= ~Eof_Error_Stream_f;
     // do not try doing error processing
   } else {
-    Yap_SetCurInpPos(sno, pos);
+    Yap_SetCurInpPos(sno, pos PASS_REGS);
     s->charcount = pos;
     s->linecount = line;
     s->linepos = lpos;
@@ -477,7 +479,7 @@ code with  _C_. A byte is represented as either a number between 1 and 255, or a
 
 
 */
-static Int get_byte(USES_REGS) { /* '$get_byte'(Stream,-N) */
+static Int get_byte(USES_REGS1) { /* '$get_byte'(Stream,-N) */
   Term out = Deref(ARG2);
 
   if (!IsVarTerm(out)) {
@@ -81,7 +81,22 @@ static Int p_change_type_of_char(USES_REGS1);
 Term Yap_StringToNumberTerm(const char *s, encoding_t *encp, bool error_on) {
   CACHE_REGS
   int sno;
-  int i = push_text_stack();
+  int i;
+  encoding_t enc = (encp ? *encp : LOCAL_encoding);
+
+  if (enc == ENC_ISO_UTF8) {
+    /* the common case: no FILE, no copy and no new atom */
+    Term t;
+
+    sno = Yap_OpenTextReadStream((const unsigned char *)s, strlen(s), 0);
+    if (sno < 0)
+      return FALSE;
+    GLOBAL_Stream[sno].status |= CloseOnException_Stream_f;
+    t = Yap_scan_num(GLOBAL_Stream + sno, error_on);
+    Yap_CloseTextReadStream(sno);
+    return t;
+  }
+  i = push_text_stack();
   Atom nat = Yap_LookupAtom(Yap_StrPrefix(s, 16));
   sno = Yap_open_buf_read_stream(s, strlen(s), encp, MEM_BUF_USER, nat, MkAtomTerm(Yap_LookupAtom("eval")));
   if (sno < 0)
@@ -199,6 +214,8 @@ static Int p_encoding(USES_REGS1) { /* '$encoding'(Stream,N) */
     return Yap_unify(ARG2, MkIntegerTerm(GLOBAL_Stream[sno].encoding));
   }
   GLOBAL_Stream[sno].encoding = IntegerOfTerm(Deref(ARG2));
+  /* the character readers depend on the encoding */
+  Yap_DefaultStreamOps(GLOBAL_Stream + sno);
   UNLOCK(GLOBAL_Stream[sno].streamlock);
   return TRUE;
 }
@@ -0,0 +1,698 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		compress.c *
+ * comments:	streams that compress or decompress their data *
+ *									 *
+ *************************************************************************/
+
+/*
+  open/4 with compression(gzip) or compression(lz) reads or writes
+  compressed files without an external process. The stream still has a
+  FILE, but a FILE from fopencookie() whose reads decompress the file
+  below, and whose writes compress to it; the rest of the stream layer
+  does not know the difference.
+
+  Output is cut in blocks of COMPRESS_BLOCK bytes, each compressed on
+  its own: gzip blocks are gzip members, and a file of members is a
+  valid gzip file, as bgzip and pigz write it. Blocks being independent,
+  a batch of them is compressed by several threads, and written in
+  order, so the file does not depend on the number of threads.
+
+  lz is a fast LZ77 codec in the style of LZ4, with no dependencies. An
+  lz file starts with the magic "YLZ1", and has blocks of
+
+    raw size (32 bits) | stored size (32 bits) | data
+
+  all little endian. If the top bit of the stored size is set, the data
+  did not compress and is stored as it was. The magic may appear again
+  where a block would start, so that lz files can be appended to.
+
+  A file that is cut, or that is not in the format asked for, makes
+  reads fail with EIO, and the stream raises an error instead of
+  taking it for the end of the file.
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "sysbits.h"
+
+#if HAVE_FOPENCOOKIE
+
+#if HAVE_ZLIB_H && HAVE_LIBZ
+#include <zlib.h>
+#endif
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#define COMPRESS_BLOCK (1024 * 1024)
+#define COMPRESS_MAX_THREADS 16
+
+#define LZ_MAGIC 0x315a4c59 /* "YLZ1" */
+#define LZ_STORED 0x80000000
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+typedef struct {
+  compression_t kind;
+  const unsigned char *in;
+  size_t n;
+  unsigned char *out;
+  size_t out_size, out_len;
+  bool failed;
+} zblock;
+
+#if HAVE_PTHREAD_H
+/*
+  The threads that help compress a batch are made with the first batch
+  that has more than one block, and live as long as the stream. The
+  writer takes blocks too, and waits until the last one is done.
+*/
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t work, done;
+  zblock *blocks;
+  size_t next, nblocks; /* next block to take, and how many there are */
+  size_t pending;       /* blocks still being compressed */
+  int nworkers;
+  bool stop;
+  pthread_t workers[COMPRESS_MAX_THREADS];
+} zpool;
+#endif
+
+typedef struct {
+  FILE *raw;
+  compression_t kind;
+  bool writing;
+  int threads;
+  /* output: the batch being filled, and a block for each thread */
+  unsigned char *in;
+  size_t in_len, in_size;
+  bool written; /* some block went out */
+  zblock blocks[COMPRESS_MAX_THREADS];
+#if HAVE_PTHREAD_H
+  zpool *pool;
+#endif
+  /* input: decompressed bytes not yet read, and compressed ones */
+  unsigned char *out;
+  size_t out_pos, out_len;
+  unsigned char *src;
+  size_t src_len;
+  bool eof, started;
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  z_stream z;
+  bool z_open;
+  bool in_member; /* a gzip member was started, and has not ended */
+#endif
+} zfile;
+
+static inline uint32_t load32(const unsigned char *p) {
+  uint32_t v;
+
+  memcpy(&v, p, 4);
+  return v;
+}
+
+static inline uint32_t get_le32(const unsigned char *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void put_le32(unsigned char *p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static unsigned char *lz_length(unsigned char *op, size_t l) {
+  while (l >= 255) {
+    *op++ = 255;
+    l -= 255;
+  }
+  *op++ = l;
+  return op;
+}
+
+/*
+  Compress n bytes, and return the size of the result, or 0 if it did
+  not fit in cap bytes. A sequence is a token, with the number of
+  literals in the high nibble and the match length - 4 in the low
+  one, 15 meaning that more bytes follow; then the literals, and the
+  offset of the match in two bytes. The last sequence has literals
+  only.
+*/
+static size_t lz_compress(const unsigned char *src, size_t n,
+                          unsigned char *dst, size_t cap) {
+  uint32_t table[1 << LZ_HASH_BITS];
+  const unsigned char *ip = src, *anchor = src, *end = src + n;
+  const unsigned char *mflimit = (n > 12 ? end - 12 : src);
+  unsigned char *op = dst, *oend = dst + cap;
+  size_t lit;
+
+  memset(table, 0, sizeof(table));
+  while (ip < mflimit) {
+    uint32_t seq = load32(ip);
+    uint32_t h = (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+    const unsigned char *ref = src + table[h];
+
+    table[h] = ip - src;
+    if (ref < ip && ip - ref <= LZ_MAX_OFFSET && load32(ref) == seq) {
+      const unsigned char *p = ip + LZ_MIN_MATCH, *q = ref + LZ_MIN_MATCH;
+      const unsigned char *limit = end - 5;
+      unsigned char *token;
+      size_t mlen;
+
+      while (p < limit && *p == *q) {
+        p++;
+        q++;
+      }
+      lit = ip - anchor;
+      mlen = p - ip - LZ_MIN_MATCH;
+      if ((size_t)(oend - op) < lit + lit / 255 + mlen / 255 + 8)
+        return 0;
+      token = op++;
+      if (lit >= 15) {
+        *token = 15 << 4;
+        op = lz_length(op, lit - 15);
+      } else {
+        *token = lit << 4;
+      }
+      memcpy(op, anchor, lit);
+      op += lit;
+      *op++ = (ip - ref) & 0xff;
+      *op++ = (ip - ref) >> 8;
+      if (mlen >= 15) {
+        *token |= 15;
+        op = lz_length(op, mlen - 15);
+      } else {
+        *token |= mlen;
+      }
+      ip = anchor = p;
+    } else {
+      ip++;
+    }
+  }
+  lit = end - anchor;
+  if ((size_t)(oend - op) < lit + lit / 255 + 2)
+    return 0;
+  if (lit >= 15) {
+    *op++ = 15 << 4;
+    op = lz_length(op, lit - 15);
+  } else {
+    *op++ = lit << 4;
+  }
+  memcpy(op, anchor, lit);
+  op += lit;
+  return op - dst;
+}
+
+/* decompress exactly raw bytes, checking every length */
+static bool lz_decompress(const unsigned char *ip, size_t n,
+                          unsigned char *dst, size_t raw) {
+  const unsigned char *iend = ip + n;
+  unsigned char *op = dst, *oend = dst + raw;
+
+  while (ip < iend) {
+    unsigned int token = *ip++, b;
+    size_t lit = token >> 4, mlen = token & 15, off;
+    const unsigned char *ref;
+
+    if (lit == 15) {
+      do {
+        if (ip == iend)
+          return false;
+        lit += (b = *ip++);
+      } while (b == 255);
+    }
+    if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op))
+      return false;
+    memcpy(op, ip, lit);
+    op += lit;
+    ip += lit;
+    if (ip == iend)
+      break;
+    if (iend - ip < 2)
+      return false;
+    off = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (off == 0 || off > (size_t)(op - dst))
+      return false;
+    if (mlen == 15) {
+      do {
+        if (ip == iend)
+          return false;
+        mlen += (b = *ip++);
+      } while (b == 255);
+    }
+    mlen += LZ_MIN_MATCH;
+    if (mlen > (size_t)(oend - op))
+      return false;
+    /* the match may overlap what it writes */
+    ref = op - off;
+    while (mlen--)
+      *op++ = *ref++;
+  }
+  return op == oend;
+}
+
+static size_t block_bound(compression_t kind, size_t n) {
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  if (kind == COMPRESS_GZIP)
+    return compressBound(n) + 64;
+#endif
+  return n + 8;
+}
+
+/* compress a block, in whatever thread */
+static void *compress_block(void *arg) {
+  zblock *b = arg;
+
+  b->failed = false;
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  if (b->kind == COMPRESS_GZIP) {
+    z_stream z;
+
+    memset(&z, 0, sizeof(z));
+    /* 16 + 15: a gzip header and trailer, and the largest window */
+    if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + 15, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      b->failed = true;
+      return NULL;
+    }
+    z.next_in = (Bytef *)b->in;
+    z.avail_in = b->n;
+    z.next_out = b->out;
+    z.avail_out = b->out_size;
+    if (deflate(&z, Z_FINISH) != Z_STREAM_END)
+      b->failed = true;
+    b->out_len = z.total_out;
+    deflateEnd(&z);
+    return NULL;
+  }
+#endif
+  {
+    size_t len = lz_compress(b->in, b->n, b->out + 8, b->out_size - 8);
+
+    put_le32(b->out, b->n);
+    if (len == 0) {
+      put_le32(b->out + 4, b->n | LZ_STORED);
+      memcpy(b->out + 8, b->in, b->n);
+      len = b->n;
+    } else {
+      put_le32(b->out + 4, len);
+    }
+    b->out_len = len + 8;
+  }
+  return NULL;
+}
+
+#if HAVE_PTHREAD_H
+/* take blocks from the batch until there are none left; lock is held */
+static void pool_take(zpool *pool) {
+  while (pool->next < pool->nblocks) {
+    zblock *b = pool->blocks + pool->next++;
+
+    pthread_mutex_unlock(&pool->lock);
+    compress_block(b);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0)
+      pthread_cond_signal(&pool->done);
+  }
+}
+
+static void *pool_worker(void *arg) {
+  zpool *pool = arg;
+
+  pthread_mutex_lock(&pool->lock);
+  while (!pool->stop) {
+    if (pool->next < pool->nblocks)
+      pool_take(pool);
+    else
+      pthread_cond_wait(&pool->work, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/* NULL if there is no memory; then the writer compresses on its own */
+static zpool *pool_start(zfile *zf) {
+  zpool *pool = calloc(1, sizeof(zpool));
+  int i;
+
+  if (pool == NULL)
+    return NULL;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->blocks = zf->blocks;
+  for (i = 1; i < zf->threads; i++) {
+    if (pthread_create(pool->workers + pool->nworkers, NULL, pool_worker,
+                       pool) != 0)
+      break;
+    pool->nworkers++;
+  }
+  return pool;
+}
+
+static void pool_stop(zpool *pool) {
+  int i;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+  for (i = 0; i < pool->nworkers; i++)
+    pthread_join(pool->workers[i], NULL);
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->work);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool);
+}
+
+static void pool_run(zpool *pool, size_t nblocks) {
+  pthread_mutex_lock(&pool->lock);
+  pool->next = 0;
+  pool->nblocks = pool->pending = nblocks;
+  pthread_cond_broadcast(&pool->work);
+  pool_take(pool);
+  while (pool->pending)
+    pthread_cond_wait(&pool->done, &pool->lock);
+  pool->next = pool->nblocks = 0;
+  pthread_mutex_unlock(&pool->lock);
+}
+#endif
+
+/*
+  compress what is in the batch, and write it out. A gzip file needs at
+  least one member, even if it has no data.
+*/
+static bool flush_batch(zfile *zf) {
+  size_t nblocks = (zf->in_len + COMPRESS_BLOCK - 1) / COMPRESS_BLOCK, i;
+
+  if (nblocks == 0 && !zf->written && zf->kind == COMPRESS_GZIP)
+    nblocks = 1;
+  for (i = 0; i < nblocks; i++) {
+    zblock *b = zf->blocks + i;
+    size_t n = zf->in_len - i * COMPRESS_BLOCK;
+
+    b->in = zf->in + i * COMPRESS_BLOCK;
+    b->n = (n > COMPRESS_BLOCK ? COMPRESS_BLOCK : n);
+  }
+#if HAVE_PTHREAD_H
+  if (nblocks > 1 && zf->pool == NULL)
+    zf->pool = pool_start(zf);
+  if (nblocks > 1 && zf->pool != NULL)
+    pool_run(zf->pool, nblocks);
+  else
+#endif
+    for (i = 0; i < nblocks; i++)
+      compress_block(zf->blocks + i);
+  for (i = 0; i < nblocks; i++) {
+    zblock *b = zf->blocks + i;
+
+    if (b->failed ||
+        fwrite(b->out, 1, b->out_len, zf->raw) != b->out_len) {
+      errno = EIO;
+      return false;
+    }
+    zf->written = true;
+  }
+  zf->in_len = 0;
+  return true;
+}
+
+static ssize_t zfile_write(void *cookie, const char *buf, size_t size) {
+  zfile *zf = cookie;
+  size_t done = 0;
+
+  while (done < size) {
+    size_t n = zf->in_size - zf->in_len;
+
+    if (n > size - done)
+      n = size - done;
+    memcpy(zf->in + zf->in_len, buf + done, n);
+    zf->in_len += n;
+    done += n;
+    if (zf->in_len == zf->in_size && !flush_batch(zf))
+      return -1;
+  }
+  return size;
+}
+
+/* read more compressed bytes; false at the end of the file */
+static bool fill_src(zfile *zf, size_t want) {
+  size_t n;
+
+  if (zf->src_len >= want)
+    return true;
+  n = fread(zf->src + zf->src_len, 1, want - zf->src_len, zf->raw);
+  zf->src_len += n;
+  return zf->src_len >= want;
+}
+
+/* decompress the next lz block into zf->out; 0 at the end, -1 on error */
+static int lz_next_block(zfile *zf) {
+  uint32_t raw, stored;
+
+  do {
+    zf->src_len = 0;
+    if (!fill_src(zf, 4))
+      return (zf->src_len == 0 ? 0 : -1);
+    raw = get_le32(zf->src);
+    /* not an lz file at all */
+    if (!zf->started && raw != LZ_MAGIC)
+      return -1;
+    zf->started = true;
+  } while (raw == LZ_MAGIC);
+  if (!fill_src(zf, 8))
+    return -1;
+  stored = get_le32(zf->src + 4);
+  if (raw > COMPRESS_BLOCK || (stored & ~LZ_STORED) > COMPRESS_BLOCK + 8)
+    return -1;
+  zf->src_len = 0;
+  if (!fill_src(zf, stored & ~LZ_STORED))
+    return -1;
+  if (stored & LZ_STORED) {
+    if (stored != (raw | LZ_STORED))
+      return -1;
+    memcpy(zf->out, zf->src, raw);
+  } else if (!lz_decompress(zf->src, stored, zf->out, raw)) {
+    return -1;
+  }
+  zf->out_pos = 0;
+  zf->out_len = raw;
+  return 1;
+}
+
+#if HAVE_ZLIB_H && HAVE_LIBZ
+/* inflate into buf, going on through the members of the file */
+static ssize_t gzip_read(zfile *zf, char *buf, size_t size) {
+  if (zf->eof && zf->in_member) {
+    /* the file was cut, after the data we gave */
+    errno = EIO;
+    return -1;
+  }
+  zf->z.next_out = (Bytef *)buf;
+  zf->z.avail_out = size;
+  while (zf->z.avail_out == size && !zf->eof) {
+    int rc;
+
+    if (zf->z.avail_in == 0) {
+      zf->src_len = fread(zf->src, 1, COMPRESS_BLOCK, zf->raw);
+      if (zf->src_len == 0) {
+        zf->eof = true;
+        if (zf->in_member && zf->z.avail_out == size) {
+          /* the file was cut */
+          errno = EIO;
+          return -1;
+        }
+        break;
+      }
+      zf->z.next_in = zf->src;
+      zf->z.avail_in = zf->src_len;
+    }
+    rc = inflate(&zf->z, Z_NO_FLUSH);
+    if (rc == Z_STREAM_END) {
+      inflateReset(&zf->z);
+      zf->in_member = false;
+    } else if (rc == Z_OK || rc == Z_BUF_ERROR) {
+      /* even a header that was cut short */
+      zf->in_member = true;
+    } else {
+      zf->eof = true;
+      errno = EIO;
+      return -1;
+    }
+  }
+  return size - zf->z.avail_out;
+}
+#endif
+
+static ssize_t zfile_read(void *cookie, char *buf, size_t size) {
+  zfile *zf = cookie;
+  size_t n;
+
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  if (zf->kind == COMPRESS_GZIP)
+    return gzip_read(zf, buf, size);
+#endif
+  if (zf->out_pos == zf->out_len) {
+    int rc;
+
+    if (zf->eof)
+      return 0;
+    if ((rc = lz_next_block(zf)) <= 0) {
+      zf->eof = true;
+      if (rc < 0) {
+        errno = EIO;
+        return -1;
+      }
+      return 0;
+    }
+  }
+  n = zf->out_len - zf->out_pos;
+  if (n > size)
+    n = size;
+  memcpy(buf, zf->out + zf->out_pos, n);
+  zf->out_pos += n;
+  return n;
+}
+
+static void zfile_free(zfile *zf) {
+  int i;
+
+#if HAVE_PTHREAD_H
+  if (zf->pool)
+    pool_stop(zf->pool);
+#endif
+  for (i = 0; i < COMPRESS_MAX_THREADS; i++)
+    free(zf->blocks[i].out);
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  if (zf->z_open)
+    inflateEnd(&zf->z);
+#endif
+  free(zf->in);
+  free(zf->out);
+  free(zf->src);
+  free(zf);
+}
+
+static int zfile_close(void *cookie) {
+  zfile *zf = cookie;
+  bool ok = true;
+
+  if (zf->writing && (zf->in_len || !zf->written))
+    ok = flush_batch(zf);
+  if (fclose(zf->raw) != 0)
+    ok = false;
+  zfile_free(zf);
+  return (ok ? 0 : EOF);
+}
+
+/*
+  Put a compressing or decompressing FILE over raw, that it will close.
+  threads is how many blocks are compressed at a time, or 0 for as
+  many as there are processors. Returns NULL,
+  with errno set, if kind is not available or there is no memory.
+*/
+FILE *Yap_CompressedFile(FILE *raw, const char *io_mode, compression_t kind,
+                         int threads) {
+  cookie_io_functions_t io = {zfile_read, zfile_write, NULL, zfile_close};
+  zfile *zf;
+  FILE *f;
+  int i;
+
+#if HAVE_ZLIB_H && HAVE_LIBZ
+  if (kind != COMPRESS_GZIP && kind != COMPRESS_LZ) {
+#else
+  if (kind != COMPRESS_LZ) {
+#endif
+    errno = ENOTSUP;
+    return NULL;
+  }
+  if (threads <= 0)
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1)
+    threads = 1;
+  else if (threads > COMPRESS_MAX_THREADS)
+    threads = COMPRESS_MAX_THREADS;
+  if ((zf = calloc(1, sizeof(zfile))) == NULL)
+    return NULL;
+  zf->raw = raw;
+  zf->kind = kind;
+  zf->writing = (strchr(io_mode, 'r') == NULL);
+  zf->threads = threads;
+  if (zf->writing) {
+    zf->in_size = threads * COMPRESS_BLOCK;
+    if ((zf->in = malloc(zf->in_size)) == NULL)
+      goto failed;
+    for (i = 0; i < threads; i++) {
+      zf->blocks[i].kind = kind;
+      zf->blocks[i].out_size = block_bound(kind, COMPRESS_BLOCK);
+      if ((zf->blocks[i].out = malloc(zf->blocks[i].out_size)) == NULL)
+        goto failed;
+    }
+    if (kind == COMPRESS_LZ) {
+      unsigned char magic[4];
+
+      put_le32(magic, LZ_MAGIC);
+      if (fwrite(magic, 1, 4, raw) != 4)
+        goto failed;
+    }
+  } else {
+    if ((zf->src = malloc(COMPRESS_BLOCK + 8)) == NULL ||
+        (zf->out = malloc(COMPRESS_BLOCK)) == NULL)
+      goto failed;
+#if HAVE_ZLIB_H && HAVE_LIBZ
+    if (kind == COMPRESS_GZIP) {
+      /* 32 + 15: gzip or zlib, as the header says */
+      if (inflateInit2(&zf->z, 32 + 15) != Z_OK) {
+        errno = ENOMEM;
+        goto failed;
+      }
+      zf->z_open = true;
+    }
+#endif
+  }
+  if ((f = fopencookie(zf, io_mode, io)) == NULL)
+    goto failed;
+  return f;
+
+failed:
+  zfile_free(zf);
+  return NULL;
+}
+
+#else
+
+FILE *Yap_CompressedFile(FILE *raw, const char *io_mode, compression_t kind,
+                         int threads) {
+  errno = ENOTSUP;
+  return NULL;
+}
+
+#endif /* HAVE_FOPENCOOKIE */
+
+/* the codec named by t, for the compression/1 option of open/4 */
+bool Yap_CompressionKind(Term t, compression_t *kindp) {
+  if (t == TermNone)
+    *kindp = COMPRESS_NONE;
+  else if (t == TermGzip)
+    *kindp = COMPRESS_GZIP;
+  else if (t == TermLz)
+    *kindp = COMPRESS_LZ;
+  else
+    return false;
+  return true;
+}
@@ -43,6 +43,7 @@ static int ConsolePutc(int, int);
 
 
 bool Yap_DoPrompt(StreamDesc *s) {
+  CACHE_REGS
   if (s->status & Tty_Stream_f) {
     if (GLOBAL_Stream[LOCAL_c_input_stream].status & Tty_Stream_f &&
 	GLOBAL_Stream[LOCAL_c_error_stream].status & Tty_Stream_f) {
@@ -55,6 +56,7 @@ bool Yap_DoPrompt(StreamDesc *s) {
 
 /* check if we read a newline or an EOF */
 int console_post_process_read_char(int ch, StreamDesc *s) {
+  CACHE_REGS
   /* the character is also going to be output by the console handler */
   console_count_output_char(ch, GLOBAL_Stream + LOCAL_c_error_stream);
   if (ch == '\r') {
@@ -77,6 +79,7 @@ int console_post_process_read_char(int ch, StreamDesc *s) {
 }
 
 bool is_same_tty(FILE *f1, FILE *f2) {
+  CACHE_REGS
 #if HAVE_TTYNAME
   return ttyname_r(fileno(f1), LOCAL_FileNameBuf, YAP_FILENAME_MAX - 1) ==
          ttyname_r(fileno(f2), LOCAL_FileNameBuf, YAP_FILENAME_MAX - 1);
@@ -111,6 +114,7 @@ void Yap_ConsoleOps(StreamDesc *s) {
 
 /* static */
 static int ConsolePutc(int sno, int ch) {
+  CACHE_REGS
   StreamDesc *s = &GLOBAL_Stream[sno];
   if (ch == 10) {
 #if MAC || _WIN32
@@ -0,0 +1,604 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		evloop.c *
+ * comments:	wait for many streams at once, with epoll or poll *
+ *									 *
+ *************************************************************************/
+
+/*
+  An event loop watches a set of streams, usually sockets, and tells
+  which of them are ready to be read or written. On Linux it is an
+  epoll instance, so that the cost of a wait does not grow with the
+  number of streams watched; elsewhere the loop keeps the set itself
+  and asks poll(). socket_select/5 and stream_select/3 still use
+  select(), as they must work everywhere.
+
+  Streams are watched for read and/or write readiness. With epoll they
+  can also be edge_triggered, reported only when new data comes in, and
+  oneshot, reported once and then disarmed until they are watched again.
+  poll() has no edges, so there edge_triggered streams are reported as
+  long as they stay ready.
+
+  The streams should be in non-blocking mode, see '$set_stream_nonblocking'/2,
+  and read with '$read_pending_codes'/3, that takes whatever is there
+  and returns at once. The Prolog side is library(event_loop).
+*/
+
+#include "sysbits.h"
+
+#if HAVE_SYS_EPOLL_H || HAVE_POLL_H
+
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+/* most events taken from the kernel in one wait */
+#define EVENT_LOOP_BATCH 64
+
+/* largest block '$read_pending_codes'/3 takes at a time */
+#define READ_PENDING_BLOCK (64 * 1024)
+
+#define EV_READ 0x1
+#define EV_WRITE 0x2
+#define EV_EDGE 0x4
+#define EV_ONESHOT 0x8
+
+/*
+  A stream number is reused as soon as its stream is closed, and so may
+  be its descriptor, while the kernel still reports the old one if it
+  was shared with another process. Each registration gets a new
+  generation, that epoll hands back with the events, and a source is
+  only believed while its stream still has the descriptor it was
+  watched with.
+*/
+typedef struct event_source {
+  int sno, fd;
+  int flags;    /* EV_* */
+  uint32_t gen; /* of the registration */
+} event_source;
+
+typedef struct event_loop {
+  int efd; /* the epoll instance, -1 with poll() */
+  event_source *sources;
+  int nsources, maxsources;
+  uint32_t gen; /* last generation given */
+} event_loop;
+
+static event_loop **event_loops;
+static int n_event_loops;
+
+static Functor FunctorEventLoop;
+static Atom AtomEdgeTriggered, AtomOneshot, AtomHangup;
+
+static int get_event_loop(Term t, const char *msg) {
+  Term ti;
+  Int i;
+
+  t = Deref(t);
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, msg);
+    return -1;
+  }
+  if (!IsApplTerm(t) || FunctorOfTerm(t) != FunctorEventLoop ||
+      !IsIntegerTerm(ti = Deref(ArgOfTerm(1, t))) ||
+      (i = IntegerOfTerm(ti)) < 0 || i >= n_event_loops ||
+      event_loops[i] == NULL) {
+    Yap_Error(DOMAIN_ERROR_GENERIC_ARGUMENT, t, msg);
+    return -1;
+  }
+  return i;
+}
+
+/* any open stream with a descriptor, unlocked */
+static int get_stream_fd(Term t, int *fdp, const char *msg) {
+  int sno = Yap_CheckStream(t, Input_Stream_f | Output_Stream_f, msg);
+
+  if (sno < 0)
+    return -1;
+  UNLOCK(GLOBAL_Stream[sno].streamlock);
+  if ((*fdp = Yap_GetStreamFd(sno)) < 0) {
+    Yap_Error(PERMISSION_ERROR_INPUT_STREAM, t, msg);
+    return -1;
+  }
+  return sno;
+}
+
+static event_source *find_source(event_loop *loop, int sno) {
+  int i;
+
+  for (i = 0; i < loop->nsources; i++)
+    if (loop->sources[i].sno == sno)
+      return loop->sources + i;
+  return NULL;
+}
+
+/* the source still watches the stream it was made for */
+static bool live_source(event_source *src) {
+  return !(GLOBAL_Stream[src->sno].status & Free_Stream_f) &&
+         Yap_GetStreamFd(src->sno) == src->fd;
+}
+
+static void drop_source(event_loop *loop, event_source *src) {
+#if HAVE_SYS_EPOLL_H
+  int i;
+
+  /* the descriptor may be gone already, or now belong to another
+     stream in the loop */
+  for (i = 0; i < loop->nsources; i++)
+    if (loop->sources + i != src && loop->sources[i].fd == src->fd)
+      break;
+  if (i == loop->nsources)
+    epoll_ctl(loop->efd, EPOLL_CTL_DEL, src->fd, NULL);
+#endif
+  *src = loop->sources[--loop->nsources];
+}
+
+/* the EV_* flags for a list of atoms */
+static bool event_flags(Term t, int *flags, const char *msg) {
+  Term t0 = t;
+
+  while (true) {
+    Term hd;
+    Atom a;
+
+    t = Deref(t);
+    if (t == TermNil)
+      return true;
+    if (IsVarTerm(t)) {
+      Yap_Error(INSTANTIATION_ERROR, t0, msg);
+      return false;
+    }
+    if (!IsPairTerm(t)) {
+      Yap_Error(TYPE_ERROR_LIST, t0, msg);
+      return false;
+    }
+    hd = Deref(HeadOfTerm(t));
+    if (IsVarTerm(hd)) {
+      Yap_Error(INSTANTIATION_ERROR, hd, msg);
+      return false;
+    }
+    if (!IsAtomTerm(hd)) {
+      Yap_Error(TYPE_ERROR_ATOM, hd, msg);
+      return false;
+    }
+    a = AtomOfTerm(hd);
+    if (a == AtomRead)
+      *flags |= EV_READ;
+    else if (a == AtomWrite)
+      *flags |= EV_WRITE;
+    else if (a == AtomEdgeTriggered)
+      *flags |= EV_EDGE;
+    else if (a == AtomOneshot)
+      *flags |= EV_ONESHOT;
+    else {
+      Yap_Error(DOMAIN_ERROR_GENERIC_ARGUMENT, hd, msg);
+      return false;
+    }
+    t = TailOfTerm(t);
+  }
+}
+
+static void event_loop_error(const char *msg, const char *call) {
+#if HAVE_STRERROR
+  Yap_Error(SYSTEM_ERROR_INTERNAL, TermNil, "%s (%s: %s)", msg, call,
+            strerror(errno));
+#else
+  Yap_Error(SYSTEM_ERROR_INTERNAL, TermNil, "%s (%s)", msg, call);
+#endif
+}
+
+#if HAVE_SYS_EPOLL_H
+static uint32_t epoll_flags(int flags) {
+  uint32_t ev = 0;
+
+  if (flags & EV_READ)
+    ev |= EPOLLIN | EPOLLRDHUP;
+  if (flags & EV_WRITE)
+    ev |= EPOLLOUT;
+  if (flags & EV_EDGE)
+    ev |= EPOLLET;
+  if (flags & EV_ONESHOT)
+    ev |= EPOLLONESHOT;
+  return ev;
+}
+
+/* (re)register src; a closed descriptor has left the epoll set, so
+   then it is added again */
+static bool epoll_watch(event_loop *loop, event_source *src, bool fresh) {
+  struct epoll_event ev;
+
+  ev.events = epoll_flags(src->flags);
+  if (!fresh) {
+    ev.data.u64 = (uint64_t)src->gen << 32 | (uint32_t)src->sno;
+    if (epoll_ctl(loop->efd, EPOLL_CTL_MOD, src->fd, &ev) == 0)
+      return true;
+    if (errno != ENOENT)
+      return false;
+    src->gen = ++loop->gen;
+  }
+  ev.data.u64 = (uint64_t)src->gen << 32 | (uint32_t)src->sno;
+  return epoll_ctl(loop->efd, EPOLL_CTL_ADD, src->fd, &ev) == 0;
+}
+#endif
+
+/** @pred '$event_loop_create'(- _Loop_)
+
+Create a new event loop, with no streams to watch.
+*/
+static Int event_loop_create(USES_REGS1) {
+  event_loop *loop;
+  Term t;
+  int i;
+
+  for (i = 0; i < n_event_loops; i++)
+    if (event_loops[i] == NULL)
+      break;
+  if (i == n_event_loops) {
+    event_loop **nloops =
+        realloc(event_loops, (n_event_loops + 8) * sizeof(event_loop *));
+
+    if (nloops == NULL) {
+      Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "event_loop_create/1");
+      return false;
+    }
+    memset(nloops + n_event_loops, 0, 8 * sizeof(event_loop *));
+    event_loops = nloops;
+    n_event_loops += 8;
+  }
+  if ((loop = calloc(1, sizeof(event_loop))) == NULL) {
+    Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "event_loop_create/1");
+    return false;
+  }
+#if HAVE_SYS_EPOLL_H
+  if ((loop->efd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    free(loop);
+    event_loop_error("event_loop_create/1", "epoll_create1");
+    return false;
+  }
+#else
+  loop->efd = -1;
+#endif
+  event_loops[i] = loop;
+  t = MkIntegerTerm(i);
+  return Yap_unify(ARG1, Yap_MkApplTerm(FunctorEventLoop, 1, &t));
+}
+
+/** @pred '$event_loop_close'(+ _Loop_)
+
+Close an event loop. The streams it watched are left open.
+*/
+static Int event_loop_close(USES_REGS1) {
+  int i = get_event_loop(ARG1, "event_loop_close/1");
+  event_loop *loop;
+
+  if (i < 0)
+    return false;
+  loop = event_loops[i];
+  if (loop->efd >= 0)
+    close(loop->efd);
+  free(loop->sources);
+  free(loop);
+  event_loops[i] = NULL;
+  return true;
+}
+
+/** @pred '$event_loop_watch'(+ _Loop_, + _Stream_, + _Events_, + _Options_)
+
+Watch  _Stream_ for the  _Events_ `read` and `write`. The  _Options_
+may be `edge_triggered` and `oneshot`. If  _Stream_ is watched already,
+its events and options are replaced, which also rearms a `oneshot`
+stream.
+*/
+static Int event_loop_watch(USES_REGS1) {
+  int i = get_event_loop(ARG1, "$event_loop_watch/4"), sno, fd, flags = 0;
+  event_loop *loop;
+  event_source *src;
+  bool fresh = false;
+
+  if (i < 0)
+    return false;
+  loop = event_loops[i];
+  if (!event_flags(ARG3, &flags, "$event_loop_watch/4") ||
+      !event_flags(ARG4, &flags, "$event_loop_watch/4"))
+    return false;
+  if ((sno = get_stream_fd(ARG2, &fd, "$event_loop_watch/4")) < 0)
+    return false;
+  if ((src = find_source(loop, sno)) != NULL && src->fd != fd) {
+    /* the stream was closed, and its number went to this one */
+    drop_source(loop, src);
+    src = NULL;
+  }
+  if (src == NULL) {
+    if (loop->nsources == loop->maxsources) {
+      int n = loop->maxsources ? 2 * loop->maxsources : 16;
+      event_source *nsrcs = realloc(loop->sources, n * sizeof(event_source));
+
+      if (nsrcs == NULL) {
+        Yap_Error(RESOURCE_ERROR_HEAP, TermNil, "$event_loop_watch/4");
+        return false;
+      }
+      loop->sources = nsrcs;
+      loop->maxsources = n;
+    }
+    src = loop->sources + loop->nsources;
+    src->sno = sno;
+    src->fd = fd;
+    src->gen = ++loop->gen;
+    fresh = true;
+  }
+  src->flags = flags;
+#if HAVE_SYS_EPOLL_H
+  if (!epoll_watch(loop, src, fresh)) {
+    event_loop_error("$event_loop_watch/4", "epoll_ctl");
+    if (!fresh)
+      drop_source(loop, src);
+    return false;
+  }
+#endif
+  if (fresh)
+    loop->nsources++;
+  return true;
+}
+
+/** @pred '$event_loop_unwatch'(+ _Loop_, + _Stream_)
+
+Stop watching  _Stream_. Fails if it was not being watched.
+*/
+static Int event_loop_unwatch(USES_REGS1) {
+  int i = get_event_loop(ARG1, "event_loop_remove/2"), sno, fd;
+  event_loop *loop;
+  event_source *src;
+
+  if (i < 0)
+    return false;
+  loop = event_loops[i];
+  if ((sno = get_stream_fd(ARG2, &fd, "event_loop_remove/2")) < 0)
+    return false;
+  if ((src = find_source(loop, sno)) == NULL)
+    return false;
+  drop_source(loop, src);
+  return true;
+}
+
+/* Stream-Events, where events are read, write, hangup and error */
+static Term ready_term(int sno, bool rd, bool wr, bool hup, bool err) {
+  CACHE_REGS
+  Term ts[2], evs = TermNil;
+
+  if (err)
+    evs = MkPairTerm(MkAtomTerm(AtomError), evs);
+  if (hup)
+    evs = MkPairTerm(MkAtomTerm(AtomHangup), evs);
+  if (wr)
+    evs = MkPairTerm(MkAtomTerm(AtomWrite), evs);
+  if (rd)
+    evs = MkPairTerm(MkAtomTerm(AtomRead), evs);
+  ts[0] = Yap_MkStream(sno);
+  ts[1] = evs;
+  return Yap_MkApplTerm(FunctorMinus, 2, ts);
+}
+
+/* milliseconds, or -1 to wait for ever */
+static bool wait_timeout(Term t, int *msp, const char *msg) {
+  t = Deref(t);
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, msg);
+    return false;
+  }
+  if (t == TermOff || t == TermInf) {
+    *msp = -1;
+  } else if (IsIntegerTerm(t) && IntegerOfTerm(t) >= 0) {
+    Int s = IntegerOfTerm(t);
+    *msp = (s > INT_MAX / 1000 ? INT_MAX : s * 1000);
+  } else if (IsFloatTerm(t) && FloatOfTerm(t) >= 0.0) {
+    Float s = FloatOfTerm(t);
+    *msp = (s * 1000.0 > INT_MAX ? INT_MAX : (int)(s * 1000.0 + 0.5));
+  } else {
+    Yap_Error(DOMAIN_ERROR_TIMEOUT_SPEC, t, msg);
+    return false;
+  }
+  return true;
+}
+
+/** @pred '$event_loop_wait'(+ _Loop_, + _Timeout_, - _Ready_)
+
+Wait until one or more of the streams watched by  _Loop_ are ready, or
+for  _Timeout_ seconds, that may be `inf` or `off` to wait for ever.
+ _Ready_ is a list of  _Stream_-_Events_, where  _Events_ is a list
+of `read`, `write`, `hangup` and `error`; it is empty on a timeout or
+if the wait was interrupted by a signal.
+*/
+static Int event_loop_wait(USES_REGS1) {
+  int i = get_event_loop(ARG1, "event_loop_wait/3"), ms, n, j;
+  event_loop *loop;
+  Term ready = TermNil;
+
+  if (i < 0 || !wait_timeout(ARG2, &ms, "event_loop_wait/3"))
+    return false;
+  loop = event_loops[i];
+  if (ASP - HR < EVENT_LOOP_BATCH * 16 + 1024) {
+    if (!Yap_gcl(EVENT_LOOP_BATCH * 16 * sizeof(CELL), 3, ENV, Yap_gcP())) {
+      Yap_Error(RESOURCE_ERROR_STACK, ARG1, "event_loop_wait/3");
+      return false;
+    }
+  }
+#if HAVE_SYS_EPOLL_H
+  {
+    struct epoll_event evs[EVENT_LOOP_BATCH];
+
+    n = epoll_wait(loop->efd, evs, EVENT_LOOP_BATCH, ms);
+    if (n < 0 && errno != EINTR) {
+      event_loop_error("event_loop_wait/3", "epoll_wait");
+      return false;
+    }
+    for (j = n - 1; j >= 0; j--) {
+      uint32_t ev = evs[j].events;
+      int sno = (uint32_t)evs[j].data.u64;
+      event_source *src = find_source(loop, sno);
+
+      /* left over from a stream that was closed */
+      if (src == NULL || src->gen != (uint32_t)(evs[j].data.u64 >> 32))
+        continue;
+      if (!live_source(src)) {
+        drop_source(loop, src);
+        continue;
+      }
+      ready = MkPairTerm(
+          ready_term(sno, ev & EPOLLIN, ev & EPOLLOUT,
+                     ev & (EPOLLHUP | EPOLLRDHUP), ev & EPOLLERR),
+          ready);
+    }
+  }
+#else
+  {
+    struct pollfd pfds[EVENT_LOOP_BATCH];
+    int k, nfds = 0, srcs[EVENT_LOOP_BATCH];
+
+    /* only the first EVENT_LOOP_BATCH armed streams are asked */
+    for (k = 0; k < loop->nsources && nfds < EVENT_LOOP_BATCH; k++) {
+      event_source *src = loop->sources + k;
+
+      if (!(src->flags & (EV_READ | EV_WRITE)) || !live_source(src))
+        continue;
+      pfds[nfds].fd = src->fd;
+      pfds[nfds].events = (src->flags & EV_READ ? POLLIN : 0) |
+                          (src->flags & EV_WRITE ? POLLOUT : 0);
+      pfds[nfds].revents = 0;
+      srcs[nfds++] = k;
+    }
+    n = poll(pfds, nfds, ms);
+    if (n < 0 && errno != EINTR) {
+      event_loop_error("event_loop_wait/3", "poll");
+      return false;
+    }
+    for (j = nfds - 1; n > 0 && j >= 0; j--) {
+      event_source *src = loop->sources + srcs[j];
+      short ev = pfds[j].revents;
+
+      if (ev == 0)
+        continue;
+      if (src->flags & EV_ONESHOT)
+        src->flags &= ~(EV_READ | EV_WRITE);
+      ready = MkPairTerm(ready_term(src->sno, ev & POLLIN, ev & POLLOUT,
+                                    ev & POLLHUP, ev & (POLLERR | POLLNVAL)),
+                         ready);
+    }
+  }
+#endif
+  return Yap_unify(ARG3, ready);
+}
+
+/** @pred '$set_stream_nonblocking'(+ _Stream_, + _Boolean_)
+
+If  _Boolean_ is `true`, reads and writes on  _Stream_ return at once
+instead of waiting for the other side. Use '$read_pending_codes'/3 to
+read from such a stream.
+*/
+static Int set_stream_nonblocking(USES_REGS1) {
+  Term t2 = Deref(ARG2);
+  int sno, fd, fl;
+
+  if (IsVarTerm(t2)) {
+    Yap_Error(INSTANTIATION_ERROR, t2, "set_stream_nonblocking/2");
+    return false;
+  }
+  if (t2 != TermTrue && t2 != TermFalse) {
+    Yap_Error(TYPE_ERROR_BOOLEAN, t2, "set_stream_nonblocking/2");
+    return false;
+  }
+  if ((sno = get_stream_fd(ARG1, &fd, "set_stream_nonblocking/2")) < 0)
+    return false;
+  if ((fl = fcntl(fd, F_GETFL)) < 0 ||
+      fcntl(fd, F_SETFL,
+            t2 == TermTrue ? (fl | O_NONBLOCK) : (fl & ~O_NONBLOCK)) < 0) {
+    event_loop_error("set_stream_nonblocking/2", "fcntl");
+    return false;
+  }
+  return true;
+}
+
+/** @pred '$read_pending_codes'(+ _Stream_, - _Codes_, ? _Tail_)
+
+ _Codes_ is the difference list, ending in  _Tail_, of the bytes that
+can be read from  _Stream_ without waiting, possibly none. At the end
+of the stream  _Codes_ is `[]`. The codes are the bytes as they came,
+as from a binary stream, so that a UTF-8 character is never split
+between two calls.
+*/
+static Int read_pending_codes(USES_REGS1) {
+  int sno = Yap_CheckStream(ARG1, Input_Stream_f, "read_pending_codes/3");
+  StreamDesc *st;
+  Int room, n;
+  unsigned char *buf;
+  CELL *h0 = HR, *pt;
+  bool eof;
+
+  if (sno < 0)
+    return false;
+  st = GLOBAL_Stream + sno;
+  room = ((ASP - HR) - 1024) / 2;
+  if (room < 4 * 1024) {
+    UNLOCK(st->streamlock);
+    if (!Yap_gcl(2 * READ_PENDING_BLOCK * sizeof(CELL), 3, ENV, Yap_gcP())) {
+      Yap_Error(RESOURCE_ERROR_STACK, ARG1, "read_pending_codes/3");
+      return false;
+    }
+    return read_pending_codes(PASS_REGS1);
+  }
+  if (room > READ_PENDING_BLOCK)
+    room = READ_PENDING_BLOCK;
+  if (room > (unsigned char *)LOCAL_TrailTop - (unsigned char *)TR)
+    room = (unsigned char *)LOCAL_TrailTop - (unsigned char *)TR;
+  buf = (unsigned char *)TR;
+  n = Yap_StreamReadPending(st, buf, room, &eof);
+  UNLOCK(st->streamlock);
+  if (n < 0) {
+    event_loop_error("read_pending_codes/3", "read");
+    return false;
+  }
+  if (n == 0)
+    return Yap_unify(ARG2, eof ? TermNil : ARG3);
+  for (pt = h0; n > 0; n--, buf++) {
+    pt[0] = MkIntTerm(*buf);
+    pt[1] = AbsPair(pt + 2);
+    pt += 2;
+  }
+  HR = pt;
+  RESET_VARIABLE(pt - 1);
+  return Yap_unify(ARG2, AbsPair(h0)) && Yap_unify((CELL)(pt - 1), ARG3);
+}
+
+#endif /* HAVE_SYS_EPOLL_H || HAVE_POLL_H */
+
+void Yap_InitEventLoops(void) {
+#if HAVE_SYS_EPOLL_H || HAVE_POLL_H
+  FunctorEventLoop = Yap_MkFunctor(Yap_LookupAtom("$event_loop"), 1);
+  AtomEdgeTriggered = Yap_LookupAtom("edge_triggered");
+  AtomOneshot = Yap_LookupAtom("oneshot");
+  AtomHangup = Yap_LookupAtom("hangup");
+  Yap_InitCPred("$event_loop_create", 1, event_loop_create,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$event_loop_close", 1, event_loop_close,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$event_loop_watch", 4, event_loop_watch,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$event_loop_unwatch", 2, event_loop_unwatch,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$event_loop_wait", 3, event_loop_wait,
+                SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$set_stream_nonblocking", 2, set_stream_nonblocking,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
+  Yap_InitCPred("$read_pending_codes", 3, read_pending_codes,
+                SyncPredFlag | HiddenPredFlag);
+#endif
+}
@@ -44,10 +44,10 @@ static char SccsId[] = "%W% %G%";
 #endif
 
 const char *Yap_GetFileName(Term t USES_REGS) {
-  char *buf = Malloc(YAP_FILENAME_MAX + 1);
+  char *buf = Malloc(YAP_FILENAME_MAX + 1 PASS_REGS);
   if (IsApplTerm(t) && FunctorOfTerm(t) == FunctorSlash) {
-    snprintf(buf, YAP_FILENAME_MAX, "%s/%s", Yap_GetFileName(ArgOfTerm(1, t)),
-             Yap_GetFileName(ArgOfTerm(2, t)));
+    snprintf(buf, YAP_FILENAME_MAX, "%s/%s", Yap_GetFileName(ArgOfTerm(1, t) PASS_REGS),
+             Yap_GetFileName(ArgOfTerm(2, t) PASS_REGS));
   }
   if (IsAtomTerm(t)) {
     return RepAtom(AtomOfTerm(t))->StrOfAE;
@@ -84,7 +84,7 @@ static Int file_name_extension(USES_REGS1) {
   int l = push_text_stack();
   if (!IsVarTerm(t3)) {
     // full path is given.
-    const char *f = Yap_GetFileName(t3);
+    const char *f = Yap_GetFileName(t3 PASS_REGS);
     const char *ext;
     char *base;
     bool rc = true;
@@ -103,12 +103,12 @@ static Int file_name_extension(USES_REGS1) {
       lenb_b = len_b;
       ext = "";
     }
-    base = Malloc(lenb_b + 1);
+    base = Malloc(lenb_b + 1 PASS_REGS);
     memmove(base, f, lenb_b);
     base[lenb_b] = '\0';
     if (IsVarTerm(t1 = Deref(ARG1))) {
       // should always succeed
-      rc = Yap_unify(t1, Yap_MkTextTerm(base, typ));
+      rc = Yap_unify(t1, Yap_MkTextTerm(base, typ PASS_REGS));
     } else {
       char *f_a = (char *)Yap_GetFileName(t1 PASS_REGS);
 #if __APPLE__ || _WIN32
@@ -120,7 +120,7 @@ static Int file_name_extension(USES_REGS1) {
     if (rc) {
       if (IsVarTerm(t2 = Deref(ARG2))) {
         // should always succeed
-        rc = Yap_unify(t2, Yap_MkTextTerm(ext, typ));
+        rc = Yap_unify(t2, Yap_MkTextTerm(ext, typ PASS_REGS));
       } else {
         char *f_a = (char *)Yap_TextTermToText(t2 PASS_REGS);
         if (f_a[0] == '.') {
@@ -160,11 +160,11 @@ static Int file_name_extension(USES_REGS1) {
     }
 
     size_t lenb_b = strlen(f);
-    char *o = Realloc((void *)f, lenb_b + strlen(f2) + 2);
+    char *o = Realloc((void *)f, lenb_b + strlen(f2) + 2 PASS_REGS);
     o[lenb_b] = '.';
     o += lenb_b + 1;
     pop_text_stack(l);
-    return strcpy(o, f2) && (t3 = Yap_MkTextTerm(o, typ)) &&
+    return strcpy(o, f2) && (t3 = Yap_MkTextTerm(o, typ PASS_REGS)) &&
            Yap_unify(t3, ARG3);
   }
 }
@@ -185,7 +185,6 @@ static Int access_path(USES_REGS1) {
           if ((vfs = vfs_owner(s))) {
               vfs_stat st;
               bool rc = vfs->stat(vfs, s, &st);
-              UNLOCK(GLOBAL_Stream[sno].streamlock);
               return rc;
           }
 #if HAVE_STAT
@@ -221,7 +220,6 @@ static Int exists_file(USES_REGS1) {
       if ((vfs = vfs_owner(s))) {
           vfs_stat st;
           bool rc = vfs->stat(vfs, s, &st);
-          UNLOCK(GLOBAL_Stream[sno].streamlock);
 return rc;
       }
 #if HAVE_STAT
@@ -539,7 +537,6 @@ static Int exists_directory(USES_REGS1) {
 bool rc = true;
       return vfs->isdir(vfs, s);
 
-      UNLOCK(GLOBAL_Stream[sno].streamlock);
       return rc;
     }
 #if HAVE_STAT
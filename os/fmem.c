@@ -84,27 +84,20 @@ bool fill_pads(int sno, int sno0, int total, format_info *fg USES_REGS)
   lfill_space = nchars % nfillers;
 
   int i = fg->phys_start;
-  gap_t *padi = fg->gap;
-  while (i < phys_end) {
-    if (i == padi->phys) {
-      int j;
-      for (j = 0; j < fill_space; j++)
+  gap_t *padi = fg->gap, *pade = fg->gap + fg->gapi;
+  while (true) {
+    /* the last gap also takes what is left over */
+    while (padi < pade && padi->phys == i) {
+      int j, n = fill_space + (padi == pade - 1 ? lfill_space : 0);
+
+      for (j = 0; j < n; j++)
         f_putc(sno0, padi->filler);
       padi++;
-      /* last gap??*/
-      if (padi - fg->gap == fg->gapi) {
-        for (j = 0; j < fill_space; j++)
-          f_putc(sno0, (padi - 1)->filler);
-      }
     }
+    if (i == phys_end)
+      break;
     f_putc(sno0, buf[i++]);
   }
-  // final gap
-  if (i == padi->phys) {
-    int j;
-    for (j = 0; j < fill_space + lfill_space; j++)
-      f_putc(sno0, padi->filler);
-  };
 
   rewind(GLOBAL_Stream[sno].file);
   Yap_flush(sno0);
@@ -182,7 +175,7 @@ open_mem_read_stream(USES_REGS1) /* $open_mem_read_stream(+List,-Stream) */
 
   ti = Deref(ARG1);
   int l = push_text_stack();
-  buf = Yap_TextTermToText(ti);
+  buf = Yap_TextTermToText(ti PASS_REGS);
   if (!buf) {
     pop_text_stack(l);
     return false;
@@ -214,6 +207,7 @@ int Yap_open_buf_write_stream(encoding_t enc, memBufSource src) {
   st->vfs = NULL;
   st->buf.on = true;
   st->nbuf = NULL;
+  st->u.mem_string.pos = 0;
   st->status |= Seekable_Stream_f;
 #if HAVE_OPEN_MEMSTREAM
   st->file = open_memstream(&st->nbuf, &st->nsize);
@@ -313,6 +307,10 @@ static Int peek_mem_write_stream(
 }
 
 void Yap_MemOps(StreamDesc *st) {
+  if (st->file == NULL && st->u.mem_string.src == MEM_BUF_TEXT) {
+    Yap_TextStreamOps(st);
+    return;
+  }
   st->stream_putc = FilePutc;
 
   st->stream_getc = PlGetc;
@@ -0,0 +1,108 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		fmtfloat.c *
+ * comments:	shortest text for a float that reads back the same *
+ *									 *
+ *************************************************************************/
+
+/*
+  David Gay's dtoa(), as shipped with the SWI compatibility library, is
+  compiled here for YAP's own use. In mode 0 it gives the fewest
+  digits that read back to the same double, so that floats are written
+  exactly without the noise of a fixed precision.
+
+  The functions are renamed, so that they do not clash with the C
+  library nor with the copy in the SWI library.
+*/
+
+#include "YapConfig.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if WORDS_BIGENDIAN
+#define IEEE_MC68k 1
+#else
+#define IEEE_8087 1
+#endif
+
+#define dtoa Yap_dtoa
+#define freedtoa Yap_freedtoa
+#define strtod Yap_strtod
+
+#define MALLOC malloc
+#define FREE free
+
+/* dtoa needs a 32-bit Long */
+#define Long int
+
+#if THREADS
+#include <pthread.h>
+
+#define MULTIPLE_THREADS
+
+static pthread_mutex_t dtoa_locks[2] = {PTHREAD_MUTEX_INITIALIZER,
+                                        PTHREAD_MUTEX_INITIALIZER};
+
+#define ACQUIRE_DTOA_LOCK(n) pthread_mutex_lock(dtoa_locks + (n))
+#define FREE_DTOA_LOCK(n) pthread_mutex_unlock(dtoa_locks + (n))
+#endif
+
+#include "../library/dialect/swi/os/dtoa.c"
+
+/*
+  Write f to buf, that must hold at least 32 bytes, in Prolog syntax:
+  there is always a digit on both sides of the dot, and an exponent
+  when the number is very large or very small, as in 1.0e20 or
+  2.5e-7. NaN and infinities are not handled here. Returns buf.
+*/
+char *Yap_FormatShortestFloat(double f, char *buf) {
+  int decpt, sign, n;
+  char *end, *digits = dtoa(f, 0, 0, &decpt, &sign, &end), *s = buf;
+
+  n = end - digits;
+  if (sign)
+    *s++ = '-';
+  if (decpt <= -4 || decpt > 15) {
+    /* d.ddde[-]x */
+    *s++ = digits[0];
+    *s++ = '.';
+    if (n > 1) {
+      memcpy(s, digits + 1, n - 1);
+      s += n - 1;
+    } else {
+      *s++ = '0';
+    }
+    sprintf(s, "e%d", decpt - 1);
+  } else if (decpt <= 0) {
+    /* 0.000ddd */
+    *s++ = '0';
+    *s++ = '.';
+    memset(s, '0', -decpt);
+    s += -decpt;
+    memcpy(s, digits, n);
+    s[n] = '\0';
+  } else if (n <= decpt) {
+    /* ddd000.0 */
+    memcpy(s, digits, n);
+    memset(s + n, '0', decpt - n);
+    strcpy(s + decpt, ".0");
+  } else {
+    /* ddd.ddd */
+    memcpy(s, digits, decpt);
+    s[decpt] = '.';
+    memcpy(s + decpt + 1, digits + decpt, n - decpt);
+    s[n + 1] = '\0';
+  }
+  freedtoa(digits);
+  return buf;
+}
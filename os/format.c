@@ -354,6 +354,7 @@ static Int format_copy_args(Term args, Term *targs, Int tsz) {
 static void
 
 format_clean_up(int sno, int sno0, format_info *finfo) {
+  CACHE_REGS
   if (sno >= 0 && sno != sno0) {
     sno = format_synch(sno, sno0, finfo);
     Yap_CloseStream(sno);
@@ -385,6 +386,178 @@ static wchar_t base_dig(Int dig, Int ch) {
     return (dig - 10) + 'A';
 }
 
+/*
+  A control text is compiled into a program: a sequence of directives,
+  that refer to runs of text stored after them. Programs for atoms are
+  kept as a property of the atom, so the text of a control atom is
+  parsed only once; other control texts are compiled at each call.
+  A program has offsets, not pointers, so it survives saved states.
+*/
+#define FORMAT_END -1  /* end of the program */
+#define FORMAT_TEXT -2 /* copy len bytes of text, from arg */
+#define FORMAT_NL -3   /* a newline */
+
+#define FORMAT_HAS_REPEATS 1 /* ~N */
+#define FORMAT_STAR 2        /* ~*: N is the next argument */
+
+typedef struct format_op {
+  int op;    /* the directive letter, or one of the above */
+  int flags;
+  Int arg;   /* N, or where the text starts */
+  Int len;   /* bytes of text */
+} format_op;
+
+#define FormatOps(fe) ((format_op *)(fe)->Program)
+#define FormatText(fe) ((const unsigned char *)(FormatOps(fe) + (fe)->NOfOps))
+
+/* column stops are filled from a buffer of their own */
+static bool format_has_columns(const format_op *op) {
+  for (; op->op != FORMAT_END; op++)
+    if (op->op == 't' || op->op == '|' || op->op == '+')
+      return true;
+  return false;
+}
+
+/* the next character, but never past the end of s */
+static inline int next_format_char(const unsigned char **s) {
+  int ch;
+
+  if (**s == '\0')
+    return '\0';
+  *s += get_utf8(*s, -1, &ch);
+  return ch;
+}
+
+/* how many directives does s need? an upper bound is enough */
+static UInt format_ops_needed(const unsigned char *s) {
+  UInt n = 1;
+  int ch;
+
+  while (*s) {
+    ch = *s++;
+    if (ch == '~' || ch == '\n')
+      n += 2;
+  }
+  return n + 1;
+}
+
+static FormatEntry *compile_format(const unsigned char *s,
+                                   bool in_heap USES_REGS) {
+  UInt nops = format_ops_needed(s), n = 0;
+  size_t sz =
+      sizeof(FormatEntry) + nops * sizeof(format_op) + strlen((char *)s);
+  FormatEntry *fe;
+  format_op *ops;
+  unsigned char *text, *tp;
+  int ch;
+
+  if (in_heap)
+    fe = (FormatEntry *)Yap_AllocAtomSpace(sz);
+  else
+    fe = (FormatEntry *)Malloc(sz PASS_REGS);
+  if (fe == NULL)
+    return NULL;
+  fe->NOfOps = nops;
+  ops = FormatOps(fe);
+  tp = text = (unsigned char *)(ops + nops);
+  while (*s) {
+    if (*s == '\n') {
+      ops[n].op = FORMAT_NL;
+      n++;
+      s++;
+    } else if (*s == '~') {
+      format_op *op = ops + n++;
+
+      op->flags = 0;
+      op->arg = 0;
+      op->len = 0;
+      s++;
+      ch = next_format_char(&s);
+      if (ch == '*') {
+        op->flags = FORMAT_STAR | FORMAT_HAS_REPEATS;
+        ch = next_format_char(&s);
+      } else if (ch == '`') {
+        /* next character is kept as code */
+        op->flags = FORMAT_HAS_REPEATS;
+        op->arg = next_format_char(&s);
+        ch = next_format_char(&s);
+      } else if (ch >= '0' && ch <= '9') {
+        op->flags = FORMAT_HAS_REPEATS;
+        while (ch >= '0' && ch <= '9') {
+          op->arg = op->arg * 10 + (ch - '0');
+          ch = next_format_char(&s);
+        }
+      }
+      op->op = ch;
+      if (ch == '\0')
+        break;
+    } else {
+      const unsigned char *s0 = s;
+
+      while (*s && *s != '~' && *s != '\n')
+        s++;
+      ops[n].op = FORMAT_TEXT;
+      ops[n].arg = tp - text;
+      ops[n].len = s - s0;
+      memcpy(tp, s0, s - s0);
+      tp += s - s0;
+      n++;
+    }
+  }
+  ops[n].op = FORMAT_END;
+  return fe;
+}
+
+/*
+  the program for a control text, or NULL if it is not text. Only the
+  atoms that '$format_compile'/1 was given keep their program: atoms
+  made at run time would each hold on to one for ever.
+*/
+static FormatEntry *format_program(Term tail USES_REGS) {
+  const unsigned char *s;
+  FormatEntry *fe;
+
+  if (IsAtomTerm(tail) && tail != TermNil) {
+    Atom at = AtomOfTerm(tail);
+
+    if ((fe = Yap_GetFormatProp(at)) != NULL)
+      return fe;
+    return compile_format(RepAtom(at)->UStrOfAE, false PASS_REGS);
+  }
+  if ((s = Yap_TextToUTF8Buffer(tail PASS_REGS)) == NULL)
+    return NULL;
+  return compile_format(s, false PASS_REGS);
+}
+
+/** @pred '$format_compile'(+ _Atom_)
+
+Keep the program of the control atom  _Atom_, so that format/2,3 do
+not parse it again. Called when a goal with a constant control is
+compiled.
+*/
+static Int format_compile(USES_REGS1) {
+  Term t = Deref(ARG1);
+  Atom at;
+  FormatEntry *fe;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "$format_compile/1");
+    return false;
+  }
+  if (!IsAtomTerm(t)) {
+    Yap_Error(TYPE_ERROR_ATOM, t, "$format_compile/1");
+    return false;
+  }
+  if (t == TermNil || Yap_GetFormatProp(at = AtomOfTerm(t)) != NULL)
+    return true;
+  if ((fe = compile_format(RepAtom(at)->UStrOfAE, true PASS_REGS)) == NULL) {
+    Yap_Error(RESOURCE_ERROR_HEAP, t, "$format_compile/1");
+    return false;
+  }
+  Yap_PutAtomFormat(at, fe);
+  return true;
+}
+
 #define TMP_STRING_SIZE 1024
 
 static Int doformat(volatile Term otail, volatile Term oargs,
@@ -393,7 +566,9 @@ static Int doformat(volatile Term otail, volatile Term oargs,
   int ch;
   Term *targs;
   Int tnum, targ;
-  const unsigned char *fstr, *fptr;
+  FormatEntry *fe;
+  const format_op *op;
+  const unsigned char *text;
   Term args;
   Term tail;
   int (*f_putc)(int, wchar_t);
@@ -402,11 +577,10 @@ static Int doformat(volatile Term otail, volatile Term oargs,
   volatile void *old_handler;
   volatile int old_pos;
   Term fmod = CurrentModule;
-  bool alloc_fstr = false;
   LOCAL_Error_TYPE = YAP_NO_ERROR;
   int l = push_text_stack();
-  tmp1 = Malloc(TMP_STRING_SIZE+1);
-  format_info *finfo = Malloc(sizeof(format_info));
+  tmp1 = Malloc(TMP_STRING_SIZE+1 PASS_REGS);
+  format_info *finfo = Malloc(sizeof(format_info) PASS_REGS);
   // it starts here
   finfo->gapi = 0;
   finfo->phys_start = 0;
@@ -442,9 +616,8 @@ static Int doformat(volatile Term otail, volatile Term oargs,
     format_clean_up(sno0, sno, finfo );
     Yap_ThrowError(INSTANTIATION_ERROR, tail, "format/2");
     return (FALSE);
-  } else if ((fstr = Yap_TextToUTF8Buffer(tail))) {
-    fptr = fstr;
-    alloc_fstr = true;
+  } else if ((fe = format_program(tail PASS_REGS)) != NULL) {
+    text = FormatText(fe);
   } else {
     format_clean_up(sno0, sno, finfo);
     Yap_ThrowError(TYPE_ERROR_TEXT, tail, "format/2");
@@ -481,7 +654,7 @@ static Int doformat(volatile Term otail, volatile Term oargs,
   if (IsPairTerm(args)) {
     Int tsz = 16;
 
-    targs = Malloc(32*sizeof(Term));
+    targs = Malloc(32*sizeof(Term) PASS_REGS);
     do {
       tnum = format_copy_args(args, targs, tsz);
       if (tnum == FORMAT_COPY_ARGS_ERROR ||
@@ -492,24 +665,23 @@ static Int doformat(volatile Term otail, volatile Term oargs,
       }
       else if (tnum == tsz ) {
 	tnum += 32;
-	targs = Realloc(targs, tnum*sizeof(Term));
+	targs = Realloc(targs, tnum*sizeof(Term) PASS_REGS);
       }
       break;
     } while (true);      
   } else if (args != TermNil) {
     tnum = 1;
-     targs = Malloc(sizeof(Term));
+     targs = Malloc(sizeof(Term) PASS_REGS);
      targs[0] = args;
   } else {
     tnum = 0;
   }
 
-  if ( !(GLOBAL_Stream[sno].status & InMemory_Stream_f)) {
-    sno = Yap_OpenBufWriteStream(PASS_REGS1);	\
+  if (!(GLOBAL_Stream[sno].status & InMemory_Stream_f) ||
+      format_has_columns(FormatOps(fe))) {
+    sno = Yap_OpenBufWriteStream(PASS_REGS1);
   }
   if (sno < 0) {
-    if (!alloc_fstr)
-      fstr = NULL;
 
     format_clean_up(sno, sno0, finfo);
     pop_text_stack(l);
@@ -517,35 +689,33 @@ static Int doformat(volatile Term otail, volatile Term oargs,
   }
   GLOBAL_Stream[sno].status |= CloseOnException_Stream_f;
   f_putc = GLOBAL_Stream[sno].stream_wputc;
-  while ((fptr += get_utf8(fptr, -1, &ch)) && ch) {
+  for (op = FormatOps(fe); op->op != FORMAT_END; op++) {
     Term t = TermNil;
-    int has_repeats = false;
-    int repeats = 0;
+    int has_repeats;
+    int repeats;
 
-    if (ch == '~') {
-      /* start command */
-      fptr += get_utf8(fptr, -1, &ch);
-      if (ch == '*') {
-	fptr += get_utf8(fptr, -1, &ch);
-	has_repeats = TRUE;
+    if (op->op == FORMAT_TEXT) {
+      const unsigned char *pt = text + op->arg, *end = pt + op->len;
+
+      while (pt < end) {
+	pt += get_utf8(pt, end - pt, &ch);
+	f_putc(sno, ch);
+      }
+    } else if (op->op == FORMAT_NL) {
+      sno = format_synch(sno, sno0, finfo);
+      f_putc(sno, '\n');
+    } else {
+      /* a command */
+      ch = op->op;
+      has_repeats = (op->flags & FORMAT_HAS_REPEATS) != 0;
+      repeats = op->arg;
+      if (op->flags & FORMAT_STAR) {
 	if (targ > tnum - 1) {
 	  goto do_format_control_sequence_error;
 	}
 	repeats = fetch_index_from_args(targs[targ++]);
 	if (repeats == -1)
 	  goto do_format_control_sequence_error;
-      } else if (ch == '`') {
-	/* next character is kept as code */
-	has_repeats = TRUE;
-	fptr += get_utf8(fptr, -1, &repeats);
-	fptr += get_utf8(fptr, -1, &ch);
-      } else if (ch >= '0' && ch <= '9') {
-	has_repeats = TRUE;
-	repeats = 0;
-	while (ch >= '0' && ch <= '9') {
-	  repeats = repeats * 10 + (ch - '0');
-	  fptr += get_utf8(fptr, -1, &ch);
-	}
       }
       switch (ch) {
       case 'a':
@@ -827,8 +997,6 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 			    if (Yap_HasException())
 			      goto ex_handler;
 			    if (!res) {
-			      if (!alloc_fstr)
-				fstr = NULL;
 			      format_clean_up(sno, sno0, finfo);
 			      pop_text_stack(l);
 			      return false;
@@ -855,14 +1023,9 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 			    ex_handler:
 			      if (tnum <= 8)
 				targs = NULL;
-			      if (IsAtomTerm(tail)) {
-				fstr = NULL;
-			      }
 			      if (GLOBAL_Stream[sno].status & InMemory_Stream_f) {
 				GLOBAL_Stream[sno].u.mem_string.error_handler = old_handler;
 			      }
-			      if (!alloc_fstr)
-				fstr = NULL;
 			      if (tnum == 0) {
 				targs = NULL;
 			      }
@@ -943,16 +1106,16 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 					    fill_pads(sno, sno0, finfo->lstart + repeats, finfo PASS_REGS);
 					    break;
 					    case 't': {
-#if MAY_WRITR
-					      if (fflush(GLOBAL_Stream[sno].file) == 0) {
+					      /* fill_pads() reads the gaps back from the FILE */
+					      if (GLOBAL_Stream[sno].file &&
+						  fflush(GLOBAL_Stream[sno].file) == 0) {
 						finfo->gap[finfo->gapi].phys = ftell(GLOBAL_Stream[sno].file);
+					      } else {
+						finfo->gap[finfo->gapi].phys = GLOBAL_Stream[sno].u.mem_string.pos;
 					      }
-#else
-					      finfo->gap[finfo->gapi].phys = GLOBAL_Stream[sno].u.mem_string.pos;
-#endif
 					      finfo->gap[finfo->gapi].log = GLOBAL_Stream[sno].linepos;
 					      if (has_repeats)
-						finfo->gap[finfo->gapi].filler = fptr[-2];
+						finfo->gap[finfo->gapi].filler = repeats;
 					      else
 						finfo->gap[finfo->gapi].filler = ' ';
 					      finfo-> gapi++;
@@ -983,9 +1146,6 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 	    do_default_error:
 					      if (tnum <= 8)
 						targs = NULL;
-					      if (IsAtomTerm(tail)) {
-						fstr = NULL;
-					      }
 					      {
 						Term ta[2];
 						ta[0] = otail;
@@ -998,8 +1158,6 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 					      if (GLOBAL_Stream[sno].status & InMemory_Stream_f) {
 						GLOBAL_Stream[sno].u.mem_string.error_handler = old_handler;
 					      }
-					      if (!alloc_fstr)
-						fstr = NULL;
 					      if (tnum == 0) {
 						targs = NULL;
 					      }
@@ -1011,23 +1169,14 @@ static Int doformat(volatile Term otail, volatile Term oargs,
       }
 	/* ok, now we should have a command */
       }
-    } else {
-      if (ch == '\n') {
-	sno = format_synch(sno, sno0, finfo);
-      }
-      f_putc(sno, ch);
     }
   }
   //    fill_pads( sno, 0, finfo);
-  if (IsAtomTerm(tail) || IsStringTerm(tail)) {
-    fstr = NULL;
-  }
   if (tnum <= 8)
     targs = NULL;
   if (GLOBAL_Stream[sno].status & InMemory_Stream_f) {
     GLOBAL_Stream[sno].u.mem_string.error_handler = old_handler;
   }
-  fstr = NULL;
   targs = NULL;
   format_clean_up(sno, sno0, finfo);
   pop_text_stack(l);
@@ -1035,6 +1184,7 @@ static Int doformat(volatile Term otail, volatile Term oargs,
 }
 
 static Term memStreamToTerm(int output_stream, Functor f, Term inp) {
+  CACHE_REGS
   const char *s = Yap_MemExportStreamPtr(output_stream);
 
   encoding_t enc = GLOBAL_Stream[output_stream].encoding;
@@ -1211,6 +1361,8 @@ static Int format3(USES_REGS1) {
 void Yap_InitFormat(void) {
   Yap_InitCPred("format", 2, format2, SyncPredFlag);
   Yap_InitCPred("format", 3, format3, SyncPredFlag);
+  Yap_InitCPred("$format_compile", 1, format_compile,
+                SafePredFlag | SyncPredFlag | HiddenPredFlag);
   Yap_InitCPred("with_output_to", 2, with_output_to, SyncPredFlag);
 }
 
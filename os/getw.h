@@ -5,7 +5,8 @@
 
 static int post_process_f_weof(StreamDesc *st)
 {
-  if (ferror(st->file)) {
+  /* post_process_weof() raises the errors of compressed files */
+  if (ferror(st->file) && fileno(st->file) >= 0) {
     clearerr(st->file);
     return 1;
   } else {
@@ -117,8 +117,10 @@ static char SccsId[] = "%W% %G%";
 #include "iopreds.h"
 
 #include "getw.h"
+#include "utf8block.h"
 
 static int get_wchar_from_file(int);
+static int get_wchar_UTF8_from_file(int);
 
 FILE *Yap_stdin;
 FILE *Yap_stdout;
@@ -257,6 +259,7 @@ static int EOFGetc(int sno) {
 }
 
 static void unix_upd_stream_info(StreamDesc *s) {
+  CACHE_REGS
   if (s->status & InMemory_Stream_f) {
     s->status |= Seekable_Stream_f;
     return;
@@ -296,6 +299,11 @@ static void unix_upd_stream_info(StreamDesc *s) {
       return;
     }
     filedes = fileno(s->file);
+    if (filedes < 0) {
+      /* a FILE with no descriptor, such as a compressed file, that
+         cannot be repositioned */
+      return;
+    }
     if (isatty(filedes)) {
 #if HAVE_TTYNAME
       int rc = ttyname_r(filedes, LOCAL_FileNameBuf, YAP_FILENAME_MAX - 1);
@@ -367,6 +375,10 @@ void Yap_DefaultStreamOps(StreamDesc *st) {
       st->stream_wgetc = get_wchar_from_file;
     }
 #endif
+    if (st->encoding == ENC_ISO_UTF8 && st->stream_getc == PlGetc &&
+        !(st->status & (Tty_Stream_f | Promptable_Stream_f))) {
+      st->stream_wgetc = get_wchar_UTF8_from_file;
+    }
     if (st->buf.on) {
       st->stream_getc = Yap_popChar;
       st->stream_wgetc = Yap_popChar;
@@ -486,6 +498,7 @@ void Yap_InitStdStreams(void) { InitStdStreams(); }
 
 Int PlIOError__(const char *file, const char *function, int lineno,
                 yap_error_number type, Term culprit, ...) {
+  CACHE_REGS
   if (trueLocalPrologFlag(FILEERRORS_FLAG) ||
       type == RESOURCE_ERROR_MAX_STREAMS /* do not catch resource errors */) {
     va_list args;
@@ -699,7 +712,7 @@ int post_process_read_wchar(int ch, size_t n, StreamDesc *s) {
   }
 #endif
   s->charcount += n;
-  s->linepos += n;
+  s->linepos++;
   if (ch == '\n') {
     ++s->linecount;
     s->linepos = 0;
@@ -711,6 +724,16 @@ int post_process_read_wchar(int ch, size_t n, StreamDesc *s) {
 }
 
 int post_process_weof(StreamDesc *s) {
+  if (s->file && ferror(s->file)) {
+    clearerr(s->file);
+    /* a FILE with no descriptor is a compressed file, and if it failed
+       it is cut or corrupt, not at its end */
+    if (fileno(s->file) < 0 && !(s->status & InMemory_Stream_f)) {
+      Yap_Error(SYSTEM_ERROR_OPERATING_SYSTEM, MkAtomTerm(s->name),
+                "cannot read compressed stream: %s", strerror(EIO));
+      return EOFCHAR;
+    }
+  }
   if (!ResetEOF(s)) {
     s->status |= Eof_Stream_f;
     s->stream_wgetc = EOFWGetc;
@@ -749,6 +772,291 @@ static inline int get_wchar_from_file(int sno) {
                                  GLOBAL_Stream + sno);
 }
 
+/*
+  Block reads.
+
+  Streams that read through PlGetc are plain FILEs, so we can take
+  many bytes from the FILE at a time, instead of paying for an
+  indirect call and a lock per byte. The stream lock is held by our
+  caller, so we only need to lock the FILE once per block.
+*/
+
+#if _WIN32
+#define flockfile _lock_file
+#define funlockfile _unlock_file
+#define getc_unlocked _getc_nolock
+#endif
+
+/* true if sno reads from its FILE with no layer in between */
+bool Yap_StreamReadsBlocks(StreamDesc *st) {
+  return st->file != NULL && st->vfs == NULL && st->stream_getc == PlGetc &&
+         st->stream_wgetc_for_read == st->stream_wgetc &&
+         !(st->status & (Eof_Stream_f | Tty_Stream_f | Promptable_Stream_f));
+}
+
+/* update the character and line counts after reading or writing n
+   bytes */
+static void count_block(StreamDesc *st, const unsigned char *buf,
+                              size_t n) {
+  const unsigned char *p = buf, *end = buf + n, *nl;
+  /* the line position counts characters, the character count bytes */
+  bool utf8 = (st->encoding == ENC_ISO_UTF8);
+
+  st->charcount += n;
+  while ((nl = memchr(p, '\n', end - p)) != NULL) {
+    st->linecount++;
+    p = nl + 1;
+  }
+  n = (utf8 ? utf8_count(p, end - p) : (size_t)(end - p));
+  if (p == buf)
+    st->linepos += n;
+  else
+    st->linepos = n;
+}
+
+/*
+  Read the bytes up to and including the next newline, but no more
+  than max. Sets *eolp if the newline was found.
+*/
+size_t Yap_StreamReadLine(StreamDesc *st, unsigned char *buf, size_t max,
+                          bool *eolp) {
+  FILE *f = st->file;
+  size_t n = 0;
+  int ch = 0;
+
+  flockfile(f);
+  while (n < max && (ch = getc_unlocked(f)) != EOF) {
+    buf[n++] = ch;
+    if (ch == '\n')
+      break;
+  }
+  funlockfile(f);
+  *eolp = (n > 0 && buf[n - 1] == '\n');
+  count_block(st, buf, n);
+  if (ch == EOF)
+    post_process_weof(st);
+  return n;
+}
+
+/* read up to max bytes, less only at the end of the stream */
+size_t Yap_StreamReadBlock(StreamDesc *st, unsigned char *buf, size_t max) {
+  size_t n = fread(buf, 1, max, st->file);
+
+  count_block(st, buf, n);
+  if (n < max)
+    post_process_weof(st);
+  return n;
+}
+
+/* true if whole blocks of UTF-8 can be written to st with fwrite() */
+bool Yap_StreamWritesBlocks(StreamDesc *st) {
+#if MAC || _MSC_VER
+  return false;
+#else
+  return st->file != NULL && st->vfs == NULL && st->stream_putc == FilePutc &&
+         st->stream_wputc == put_wchar && st->encoding == ENC_ISO_UTF8;
+#endif
+}
+
+/* write n bytes of UTF-8, as FilePutc would have done one at a time */
+void Yap_StreamWriteBlock(StreamDesc *st, const unsigned char *buf, size_t n) {
+  fwrite(buf, 1, n, st->file);
+  count_block(st, buf, n);
+}
+
+/* UTF-8 from a plain FILE: as get_wchar_UTF8, but the bytes are taken
+   straight from the FILE, which only this stream uses */
+static int get_wchar_UTF8_from_file(int sno) {
+  StreamDesc *st = GLOBAL_Stream + sno;
+  FILE *f = st->file;
+  unsigned char b[4];
+  int ch, cp, n = 1, l;
+
+  if (st->buf.on) {
+    /* a peek left the next character here, and changed our ops */
+    ch = Yap_popChar(sno);
+    return post_process_read_wchar(ch, utf8_width(ch), st);
+  }
+  if ((ch = getc_unlocked(f)) == EOF)
+    return post_process_weof(st);
+  if (ch < 0x80)
+    return post_process_read_wchar(ch, 1, st);
+  b[0] = ch;
+  while ((l = utf8_sequence(b, n, &cp)) < 0) {
+    if ((ch = getc_unlocked(f)) == EOF) {
+      return post_process_weof(st);
+    }
+    b[n++] = ch;
+  }
+  if (l == 0) {
+    /* the last byte does not belong to the sequence, give it back */
+    if (n > 1)
+      ungetc(b[--n], f);
+    return post_process_read_wchar(UTF8_REPLACEMENT_CHAR, n, st);
+  }
+  return post_process_read_wchar(cp, l, st);
+}
+
+/*
+  The scanner asks for runs of characters straight from the buffer of
+  the FILE, as gnulib's freadptr() does. This needs to know how the C
+  library lays out a FILE, so elsewhere there is no fast path and the
+  scanner reads one character at a time. Characters given back with
+  ungetc() may sit in a separate area, and then the FILE is left to
+  getc.
+*/
+#if defined _IO_EOF_SEEN || defined _IO_ftrylockfile || __GNU_LIBRARY__ == 1
+#ifndef _IO_IN_BACKUP
+#define _IO_IN_BACKUP 0x100
+#endif
+#define file_read_ptr(f) ((unsigned char *)(f)->_IO_read_ptr)
+#define file_read_end(f) ((unsigned char *)(f)->_IO_read_end)
+#define file_read_skip(f, n) ((f)->_IO_read_ptr += (n))
+#define file_read_backup(f) ((f)->_flags & _IO_IN_BACKUP)
+#elif defined __sferror || defined __DragonFly__ || defined __ANDROID__
+#define file_read_ptr(f) ((unsigned char *)(f)->_p)
+#define file_read_end(f) ((unsigned char *)(f)->_p + (f)->_r)
+#define file_read_skip(f, n) ((f)->_p += (n), (f)->_r -= (n))
+#define file_read_backup(f) ((f)->_ub._base != NULL)
+#endif
+
+/*
+  Consume the run of characters of the given kind that is already
+  buffered for st, and return how many bytes it takes. If out is not
+  NULL, copy up to max bytes of the run there. Returns 0 if the run
+  was not buffered, or if st does not read UTF-8 straight from a FILE
+  or from the text of an atom or string; the caller then goes on with
+  getc.
+*/
+size_t Yap_StreamScanRun(StreamDesc *st, scan_run_t kind, int quote,
+                         unsigned char *out, size_t max) {
+  const unsigned char *p, *end;
+  size_t n;
+
+  if (st->stream_wgetc == Yap_TextWGetc &&
+      st->stream_wgetc_for_read == Yap_TextWGetc) {
+    p = (const unsigned char *)st->u.mem_string.buf + st->u.mem_string.pos;
+    end = (const unsigned char *)st->u.mem_string.buf +
+          st->u.mem_string.max_size;
+  } else {
+#ifdef file_read_ptr
+    if (st->stream_wgetc != get_wchar_UTF8_from_file ||
+        st->stream_wgetc_for_read != get_wchar_UTF8_from_file ||
+        file_read_backup(st->file))
+      return 0;
+    p = file_read_ptr(st->file);
+    end = file_read_end(st->file);
+#else
+    return 0;
+#endif
+  }
+  if (p == NULL || p >= end)
+    return 0;
+  n = end - p;
+  if (out && n > max)
+    n = max;
+  if (kind == scan_run_line && scan_run(p, n, kind, quote) == n) {
+    /* leave a sequence that may go on past the buffer to getc */
+    while (n > 0 && p[n - 1] >= 0x80)
+      n--;
+  } else {
+    n = scan_run(p, n, kind, quote);
+  }
+  if (n == 0)
+    return 0;
+  if (out)
+    memcpy(out, p, n);
+  if (st->file == NULL)
+    st->u.mem_string.pos += n;
+#ifdef file_read_ptr
+  else
+    file_read_skip(st->file, n);
+#endif
+  count_block(st, p, n);
+  return n;
+}
+
+/*
+  Read whatever input st has ready, up to max bytes, without waiting
+  for more: first a character left by peek, then the bytes left in the
+  buffer of its FILE, and only if there were none one read() from its
+  descriptor, that should be in non-blocking mode. max must leave room
+  for one UTF-8 character. Returns the number of bytes read, 0 if there
+  was nothing to read yet, or -1 on error, with errno set. *eofp tells
+  whether the stream has reached its end.
+*/
+Int Yap_StreamReadPending(StreamDesc *st, unsigned char *buf, size_t max,
+                          bool *eofp) {
+  Int n = 0;
+  int fd;
+
+  *eofp = false;
+  if (st->status & Eof_Stream_f) {
+    *eofp = true;
+    return 0;
+  }
+  if (st->buf.on) {
+    /* peek_char/2 and friends decode the character they keep */
+    bool wide = st->stream_wgetc != NULL;
+    int ch = Yap_popChar(st - GLOBAL_Stream);
+
+    if (wide && ch >= 0x80 && st->encoding == ENC_ISO_UTF8)
+      n = put_utf8(buf, ch);
+    else
+      buf[n++] = ch;
+    count_block(st, buf, n);
+  }
+#ifdef file_read_ptr
+  if (st->file) {
+    FILE *f = st->file;
+    const unsigned char *p, *end;
+    Int n0 = n;
+
+    /* characters given back with ungetc() are in their own area, and
+       only getc knows how to go back to the buffer from there */
+    while (file_read_backup(f) && (size_t)n < max &&
+           file_read_ptr(f) < file_read_end(f))
+      buf[n++] = getc_unlocked(f);
+    count_block(st, buf + n0, n - n0);
+    p = file_read_ptr(f);
+    end = file_read_end(f);
+    if (!file_read_backup(f) && p != NULL && p < end && (size_t)n < max) {
+      Int m = end - p;
+
+      if ((size_t)m > max - n)
+        m = max - n;
+      memcpy(buf + n, p, m);
+      file_read_skip(f, m);
+      count_block(st, buf + n, m);
+      n += m;
+    }
+  }
+#endif
+  if (n > 0)
+    return n;
+  if ((fd = GetStreamFd(st - GLOBAL_Stream)) < 0)
+    return 0;
+#if _MSC_VER || defined(__MINGW32__)
+  if (st->status & Socket_Stream_f)
+    n = recv(fd, (char *)buf, max, 0);
+  else
+#endif
+    n = read(fd, buf, max);
+  if (n > 0) {
+    count_block(st, buf, n);
+  } else if (n == 0) {
+#if HAVE_SOCKET
+    if (st->status & Socket_Stream_f)
+      st->u.socket.flags = closed_socket;
+#endif
+    post_process_weof(st);
+    *eofp = true;
+  } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+    n = 0;
+  }
+  return n;
+}
+
 #ifndef MB_LEN_MAX
 #define MB_LEN_MAX 6
 #endif
@@ -1129,6 +1437,7 @@ static void check_bom(int sno, StreamDesc *st) {
 bool Yap_initStream(int sno, FILE *fd, Atom name, const char *io_mode,
                     Term file_name, encoding_t encoding, stream_flags_t flags,
                     void *vfs) {
+  CACHE_REGS
   // fprintf(stderr,"+ %s --> %d\n", name, sno);
   StreamDesc *st = &GLOBAL_Stream[sno];
   __android_log_print(
@@ -1205,6 +1514,8 @@ static bool open_header(int sno, Atom open_mode) {
   PAR("alias", isatom, OPEN_ALIAS)                                             \
   , PAR("bom", booleanFlag, OPEN_BOM), PAR("buffer", isatom, OPEN_BUFFER),     \
       PAR("close_on_abort", booleanFlag, OPEN_CLOSE_ON_ABORT),                 \
+      PAR("compression", isatom, OPEN_COMPRESSION),                            \
+      PAR("compression_threads", nat, OPEN_COMPRESSION_THREADS),               \
       PAR("create", isatom, OPEN_CREATE),                                      \
       PAR("encoding", isatom, OPEN_ENCODING),                                  \
       PAR("eof_action", isatom, OPEN_EOF_ACTION),                              \
@@ -1230,6 +1541,7 @@ static const param_t open_defs[] = {OPEN_DEFS()};
 
 static bool fill_stream(int sno, StreamDesc *st, Term tin, const char *io_mode,
                         Term user_name, encoding_t enc) {
+  CACHE_REGS
   struct vfs *vfsp = NULL;
   const char *fname;
 
@@ -1437,11 +1749,49 @@ static Int do_open(Term file_name, Term t2, Term tlist USES_REGS) {
     }
   }
 
+  compression_t compression = COMPRESS_NONE;
+  if (args[OPEN_COMPRESSION].used &&
+      !Yap_CompressionKind(args[OPEN_COMPRESSION].tvalue, &compression)) {
+    Term tc = args[OPEN_COMPRESSION].tvalue;
+
+    free(args);
+    st->status = Free_Stream_f;
+    UNLOCK(st->streamlock);
+    Yap_Error(DOMAIN_ERROR_STREAM_OPTION, tc,
+              "compression must be one of gzip, lz or none");
+    return false;
+  }
+
   st = &GLOBAL_Stream[sno];
 
   if (!fill_stream(sno, st, file_name, io_mode, st->user_name, st->encoding)) {
     return false;
   }
+  if (compression != COMPRESS_NONE) {
+    FILE *zf = NULL;
+    int threads = (args[OPEN_COMPRESSION_THREADS].used
+                       ? IntegerOfTerm(args[OPEN_COMPRESSION_THREADS].tvalue)
+                       : 0);
+
+    if (st->file && !st->vfs &&
+        !(st->status & (Popen_Stream_f | InMemory_Stream_f)))
+      zf = Yap_CompressedFile(st->file, io_mode, compression, threads);
+    if (zf == NULL) {
+      int err = errno;
+
+      free(args);
+      if (st->file && !st->vfs &&
+          !(st->status & (Popen_Stream_f | InMemory_Stream_f)))
+        fclose(st->file);
+      st->file = NULL;
+      st->status = Free_Stream_f;
+      UNLOCK(st->streamlock);
+      return PlIOError(PERMISSION_ERROR_OPEN_SOURCE_SINK, file_name,
+                       "compressed stream: %s", strerror(err));
+    }
+    st->file = zf;
+    st->status &= ~Seekable_Stream_f;
+  }
 
   if (args[OPEN_BOM].used) {
     if (args[OPEN_BOM].tvalue == TermTrue) {
@@ -1588,6 +1938,20 @@ static Int open3(USES_REGS1) {
   The default behavior is given by the Prolog flag
   open_expands_filename.
 
+  + `compression( + _Codec_ )` YAP extension.
+
+  Read or write the file compressed with  _Codec_: `gzip`, `lz`, a
+  fast codec in the style of LZ4, or `none`. Output is compressed by
+  blocks of one megabyte, so a gzip file written by YAP is a series of
+  gzip members, as written by bgzip or pigz, and any gzip tool reads
+  it. Compressed streams cannot be repositioned.
+
+  + `compression_threads( + _N_ )` YAP extension.
+
+  Compress up to  _N_ blocks at the same time, each in its own thread.
+  By default, YAP uses as many threads as there are processors, up to
+  16. The file written does not depend on  _N_.
+
   + `script( + _Boolean_ )` YAP extension.
 
   The file may be a Prolog script. In `read` mode just check for
@@ -1724,11 +2088,8 @@ static int CheckStream__(const char *file, const char *f, int line, Term arg,
       }
     }
     if ((sno = Yap_CheckAlias(sname)) < 0) {
-      UNLOCK(GLOBAL_Stream[sno].streamlock);
       PlIOError__(file, f, line, EXISTENCE_ERROR_STREAM, arg, msg);
       return -1;
-    } else {
-      LOCK(GLOBAL_Stream[sno].streamlock);
     }
   } else if (IsApplTerm(arg) && FunctorOfTerm(arg) == FunctorStream) {
     arg = ArgOfTerm(1, arg);
@@ -2113,6 +2474,7 @@ void Yap_InitIOPreds(void) {
   Yap_InitReadlinePreds();
 #endif
   Yap_InitSockets();
+  Yap_InitEventLoops();
   Yap_InitSignalPreds();
   Yap_InitSysPreds();
   Yap_InitTimePreds();
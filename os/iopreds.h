@@ -23,6 +23,10 @@
 #include <wchar.h>
 
 #include "YapStreams.h"
+#include "scanrun.h"
+
+/* the C file behind user_error, for debugging and profiling output */
+#define GLOBAL_stderr GLOBAL_Stream[LOCAL_c_error_stream].file
 
 INLINE_ONLY UInt PRED_HASH(FunctorEntry *, Term, UInt);
 INLINE_ONLY bool IsStreamTerm(Term t) {
@@ -129,6 +133,9 @@ extern Term Yap_scan_num(struct stream_desc *, bool);
 extern void Yap_DefaultStreamOps(StreamDesc *st);
 extern void Yap_PipeOps(StreamDesc *st);
 extern void Yap_MemOps(StreamDesc *st);
+extern void Yap_TextStreamOps(StreamDesc *st);
+extern int Yap_TextWGetc(int sno);
+extern void Yap_SeekTextStream(StreamDesc *st, size_t pos);
 extern bool Yap_CloseMemoryStream(int sno);
 extern void Yap_ConsolePipeOps(StreamDesc *st);
 extern void Yap_SocketOps(StreamDesc *st);
@@ -147,6 +154,14 @@ extern void Yap_InitMem(void);
 extern void Yap_InitSockets(void);
 extern void Yap_InitSocketLayer(void);
 extern void Yap_InitMems(void);
+extern void Yap_InitEventLoops(void);
+
+/* compressed streams, see compress.c */
+typedef enum { COMPRESS_NONE, COMPRESS_GZIP, COMPRESS_LZ } compression_t;
+
+extern FILE *Yap_CompressedFile(FILE *raw, const char *io_mode,
+                                compression_t kind, int threads);
+extern bool Yap_CompressionKind(Term t, compression_t *kindp);
 extern void Yap_InitConsole(void);
 extern void Yap_InitReadlinePreds(void);
 extern bool Yap_InitReadline(Term);
@@ -191,6 +206,18 @@ extern Term read_line(int sno);
 extern int PlGets(int sno, UInt size, char *buf);
 extern GetsFunc PlGetsFunc(void);
 extern int PlGetc(int sno);
+extern bool Yap_StreamReadsBlocks(StreamDesc *st);
+extern size_t Yap_StreamReadLine(StreamDesc *st, unsigned char *buf,
+                                 size_t max, bool *eolp);
+extern size_t Yap_StreamReadBlock(StreamDesc *st, unsigned char *buf,
+                                  size_t max);
+extern bool Yap_StreamWritesBlocks(StreamDesc *st);
+extern void Yap_StreamWriteBlock(StreamDesc *st, const unsigned char *buf,
+                                 size_t n);
+extern size_t Yap_StreamScanRun(StreamDesc *st, scan_run_t kind, int quote,
+                                unsigned char *out, size_t max);
+extern Int Yap_StreamReadPending(StreamDesc *st, unsigned char *buf,
+                                 size_t max, bool *eofp);
 extern int FilePutc(int sno, int c);
 extern int DefaultGets(int, UInt, char *);
 extern int put_wchar(int sno, wchar_t ch);
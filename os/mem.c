@@ -78,27 +78,20 @@ bool fill_pads(int sno, int sno0, int total, format_info *fg USES_REGS) {
   lfill_space = nchars % nfillers;
 
   int i = fg->phys_start;
-  gap_t *padi = fg->gap;
-  while (i < phys_end) {
-    if (i == padi->phys) {
-      int j;
-      for (j = 0; j < fill_space; j++)
+  gap_t *padi = fg->gap, *pade = fg->gap + fg->gapi;
+  while (true) {
+    /* the last gap also takes what is left over */
+    while (padi < pade && padi->phys == i) {
+      int j, n = fill_space + (padi == pade - 1 ? lfill_space : 0);
+
+      for (j = 0; j < n; j++)
         f_putc(sno0, padi->filler);
       padi++;
-      /* last gap??*/
-      if (padi - fg->gap == fg->gapi) {
-        for (j = 0; j < fill_space; j++)
-          f_putc(sno0, (padi - 1)->filler);
-      }
     }
+    if (i == phys_end)
+      break;
     f_putc(sno0, buf[i++]);
   }
-  // final gap
-  if (i == padi->phys) {
-    int j;
-    for (j = 0; j < fill_space + lfill_space; j++)
-      f_putc(sno0, padi->filler);
-  };
 
   GLOBAL_Stream[sno].u.mem_string.pos = 0;
   GLOBAL_Stream[sno].linecount = 1;
@@ -359,6 +352,10 @@ restart:
 }
 
 void Yap_MemOps(StreamDesc *st) {
+  if (st->file == NULL && st->u.mem_string.src == MEM_BUF_TEXT) {
+    Yap_TextStreamOps(st);
+    return;
+  }
   st->stream_putc = MemPutc;
 
   st->stream_getc = MemGetc;
@@ -0,0 +1,146 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		memtext.c *
+ * comments:	read streams over the text of atoms and strings *
+ *									 *
+ *************************************************************************/
+
+/*
+  read_term_from_atom/3, atom_to_term/3 and friends read a term from
+  text that is already in memory, as UTF-8. A text stream reads that
+  text where it is, with no FILE and no copy, and decodes it without
+  going through a getc per byte.
+
+  Opening one is cheap: each thread keeps the descriptor of its last
+  text stream, and takes it again if it is still free, so that the
+  stream table is not searched and the descriptor needs little setting
+  up.
+
+  Atoms do not move while they are being read. Strings live in the
+  global stack, and may be moved by a garbage collection while the
+  term is parsed; the reader then rescans the text, so the stream
+  keeps a handle to the string, and Yap_SeekTextStream() finds the
+  text again.
+*/
+
+#include "sysbits.h"
+#include "utf8block.h"
+
+/* one UTF-8 character, straight from the text */
+int Yap_TextWGetc(int sno) {
+  StreamDesc *st = GLOBAL_Stream + sno;
+  const unsigned char *p =
+      (const unsigned char *)st->u.mem_string.buf + st->u.mem_string.pos;
+  size_t n = st->u.mem_string.max_size - st->u.mem_string.pos;
+  int cp, l;
+
+  if (n == 0)
+    return post_process_weof(st);
+  if (*p < 0x80) {
+    st->u.mem_string.pos++;
+    return post_process_read_wchar(*p, 1, st);
+  }
+  if ((l = utf8_sequence(p, n, &cp)) <= 0) {
+    cp = UTF8_REPLACEMENT_CHAR;
+    l = 1;
+  }
+  st->u.mem_string.pos += l;
+  return post_process_read_wchar(cp, l, st);
+}
+
+/* one byte */
+static int TextGetc(int sno) {
+  StreamDesc *st = GLOBAL_Stream + sno;
+
+  if (st->u.mem_string.pos == (YAP_UInt)st->u.mem_string.max_size)
+    return EOF;
+  return ((unsigned char *)st->u.mem_string.buf)[st->u.mem_string.pos++];
+}
+
+void Yap_TextStreamOps(StreamDesc *st) {
+  st->stream_getc = TextGetc;
+  st->stream_wgetc = Yap_TextWGetc;
+}
+
+/* go back to pos, and find the text again if it is a string */
+void Yap_SeekTextStream(StreamDesc *st, size_t pos) {
+  CACHE_REGS
+
+  if (st->u.mem_string.src == MEM_BUF_TEXT && st->u.mem_string.text)
+    st->u.mem_string.buf =
+        (char *)UStringOfTerm(Yap_GetFromHandle(st->u.mem_string.text));
+  st->u.mem_string.pos = pos;
+  st->charcount = pos;
+  st->status &= ~Eof_Stream_f;
+  Yap_DefaultStreamOps(st);
+}
+
+/*
+  Open a stream that reads the n bytes of UTF-8 at s. If s is the text
+  of a string, text is a handle to that string, otherwise 0. Returns
+  the stream, or -1 if no stream is free.
+*/
+int Yap_OpenTextReadStream(const unsigned char *s, size_t n,
+                           yhandle_t text) {
+  CACHE_REGS
+  int sno = LOCAL_TextStream;
+  StreamDesc *st;
+
+  LOCK(GLOBAL_StreamDescLock);
+  if (sno >= 0 && (GLOBAL_Stream[sno].status & Free_Stream_f)) {
+    LOCK(GLOBAL_Stream[sno].streamlock);
+    GLOBAL_Stream[sno].status &= ~Free_Stream_f;
+    UNLOCK(GLOBAL_StreamDescLock);
+  } else {
+    UNLOCK(GLOBAL_StreamDescLock);
+    if ((sno = GetFreeStreamD()) < 0) {
+      PlIOError(RESOURCE_ERROR_MAX_STREAMS, TermNil,
+                "new stream not available for reading text");
+      return -1;
+    }
+    LOCAL_TextStream = sno;
+  }
+  st = GLOBAL_Stream + sno;
+  st->status = Input_Stream_f | InMemory_Stream_f | Seekable_Stream_f;
+  st->name = AtomCharsio;
+  st->user_name = (text ? TermString : TermNone);
+  st->file = NULL;
+  st->vfs = NULL;
+  st->nbuf = NULL;
+  st->buf.on = false;
+  st->encoding = ENC_ISO_UTF8;
+  st->charcount = 0;
+  st->linecount = 1;
+  st->linepos = 0;
+  st->u.mem_string.buf = (char *)s;
+  st->u.mem_string.max_size = n;
+  st->u.mem_string.pos = 0;
+  st->u.mem_string.src = MEM_BUF_TEXT;
+  st->u.mem_string.error_handler = NULL;
+  st->u.mem_string.text = text;
+  Yap_DefaultStreamOps(st);
+  UNLOCK(st->streamlock);
+  return sno;
+}
+
+/* there is nothing to release, the descriptor is only marked free */
+void Yap_CloseTextReadStream(int sno) {
+  CACHE_REGS
+
+  if (LOCAL_c_input_stream == sno)
+    LOCAL_c_input_stream = StdInStream;
+  /* the next owner of the descriptor may be a memory stream, that
+     counts from 0 */
+  GLOBAL_Stream[sno].u.mem_string.src = MEM_BUF_USER;
+  GLOBAL_Stream[sno].u.mem_string.buf = NULL;
+  GLOBAL_Stream[sno].u.mem_string.pos = 0;
+  GLOBAL_Stream[sno].status = Free_Stream_f;
+}
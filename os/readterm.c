@@ -230,6 +230,7 @@ static const param_t read_defs[] = { READ_DEFS() };
 
 static Term add_output(Term t, Term tail)
 {
+  CACHE_REGS
   Term topt = Yap_MkNewApplTerm(Yap_MkFunctor(AtomOutput, 1), 1);
 
   tail = Deref(tail);
@@ -254,6 +255,7 @@ static Term add_output(Term t, Term tail)
 
 static Term add_names(Term t, Term tail)
 {
+  CACHE_REGS
   Term topt = Yap_MkNewApplTerm(Yap_MkFunctor(AtomVariableNames, 1), 1);
 
   Yap_unify(t, ArgOfTerm(1, topt));
@@ -273,6 +275,7 @@ static Term add_names(Term t, Term tail)
 
 static Term add_priority(Term t, Term tail)
 {
+  CACHE_REGS
   Term topt = Yap_MkNewApplTerm(Yap_MkFunctor(AtomPriority, 1), 1);
 
   Yap_unify(t, ArgOfTerm(1, topt));
@@ -292,6 +295,7 @@ static Term add_priority(Term t, Term tail)
 
 static Term scanToList(TokEntry *tok, TokEntry *errtok)
 {
+  CACHE_REGS
   TokEntry *tok0 = tok;
   CELL *Hi = HR;
   Term ts[1];
@@ -388,16 +392,16 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
   Int end_line = GetCurInpLine(GLOBAL_Stream + sno);
  Int endpos = GetCurInpPos(GLOBAL_Stream + sno);
 
-  Yap_local.ActiveError->prologConsulting = Yap_Consulting();
-  Yap_local.ActiveError->parserFirstLine = start_line;
-  Yap_local.ActiveError->parserLine = err_line;
-  Yap_local.ActiveError->parserLastLine = end_line;
-  Yap_local.ActiveError->parserFirstPos = startpos;
-  Yap_local.ActiveError->parserPos = errpos;
-  Yap_local.ActiveError->parserLastPos = endpos;
-  Yap_local.ActiveError->parserFile =
+  LOCAL_ActiveError->prologConsulting = Yap_Consulting(PASS_REGS1);
+  LOCAL_ActiveError->parserFirstLine = start_line;
+  LOCAL_ActiveError->parserLine = err_line;
+  LOCAL_ActiveError->parserLastLine = end_line;
+  LOCAL_ActiveError->parserFirstPos = startpos;
+  LOCAL_ActiveError->parserPos = errpos;
+  LOCAL_ActiveError->parserLastPos = endpos;
+  LOCAL_ActiveError->parserFile =
     RepAtom(AtomOfTerm((GLOBAL_Stream + sno)->user_name))->StrOfAE;
-  Yap_local.ActiveError->parserReadingCode = code;
+  LOCAL_ActiveError->parserReadingCode = code;
 
   if (GLOBAL_Stream[sno].status & Seekable_Stream_f)
     {
@@ -429,7 +433,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
                     Yap_Error(EVALUATION_ERROR_READ_STREAM, GLOBAL_Stream[sno].user_name, "%s", strerror(errno));
               o[sza - 1] = '\0';
             }
-          Yap_local.ActiveError->parserTextA = o;
+          LOCAL_ActiveError->parserTextA = o;
           if (endpos <= errpos)
             {
               o2 = malloc(1);
@@ -447,7 +451,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
                  
               o2[sza - 1] = '\0';
             }
-          Yap_local.ActiveError->parserTextB = o2;
+          LOCAL_ActiveError->parserTextB = o2;
 	    }
 	    }
 	}
@@ -462,7 +466,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
               if (tok->Tok == Error_tok || tok == LOCAL_toktide )
                 {
                   o = realloc(o, strlen(o) + 1);
-                  Yap_local.ActiveError->parserTextA = o;
+                  LOCAL_ActiveError->parserTextA = o;
                   o = malloc(1024);
                   sz = 1024;
                   err_line = tok->TokLine;
@@ -486,19 +490,19 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
               tok = tok->TokNext;
             }
           o = realloc(o, strlen(o) + 1);
-          Yap_local.ActiveError->parserTextB = o;
+          LOCAL_ActiveError->parserTextB = o;
         }
     }
-  Yap_local.ActiveError->parserPos = errpos;
-  Yap_local.ActiveError->parserLine = err_line;
+  LOCAL_ActiveError->parserPos = errpos;
+  LOCAL_ActiveError->parserLine = err_line;
   /* 0:  strat, error, end line */
   /*2 msg */
   /* 1: file */
-      Yap_local.ActiveError->culprit =
+      LOCAL_ActiveError->culprit =
 	(char*)msg;
-      if (Yap_local.ActiveError->errorMsg) {
-        Yap_local.ActiveError->errorMsg = (char*)msg;
-	Yap_local.ActiveError->errorMsgLen = strlen(Yap_local.ActiveError->errorMsg);
+      if (LOCAL_ActiveError->errorMsg) {
+        LOCAL_ActiveError->errorMsg = (char*)msg;
+	LOCAL_ActiveError->errorMsgLen = strlen(LOCAL_ActiveError->errorMsg);
       }
       
       clean_vars(LOCAL_VarTable);
@@ -512,6 +516,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
 
   Term Yap_syntax_error(TokEntry *errtok, int sno, const char *msg)
   {
+    CACHE_REGS
     return syntax_error(errtok, sno, CurrentModule, -1, false, msg);
   }
 
@@ -1031,6 +1036,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
   static parser_state_t initparser(Term opts, FEnv *fe, REnv *re, int inp_stream,
                                    bool clause)
   {
+    CACHE_REGS
     LOCAL_ErrorMessage = NULL;
     fe->old_TR = TR;
     LOCAL_Error_TYPE = YAP_NO_ERROR;
@@ -1151,9 +1157,10 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
       }
     if (re->seekable)
       {
-        if (GLOBAL_Stream[inp_stream].status & InMemory_Stream_f)
+        if ((GLOBAL_Stream[inp_stream].status & InMemory_Stream_f) &&
+            GLOBAL_Stream[inp_stream].file == NULL)
           {
-            GLOBAL_Stream[inp_stream].u.mem_string.pos = re->cpos;
+            Yap_SeekTextStream(GLOBAL_Stream + inp_stream, re->cpos);
           }
         else if (GLOBAL_Stream[inp_stream].status)
           {
@@ -1241,14 +1248,15 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
  */
   Term Yap_read_term(int sno, Term opts, bool clause)
   {
+    CACHE_REGS
 #if EMACS
     int emacs_cares = FALSE;
 #endif
     int lvl = push_text_stack();
     Term rc;
     yap_error_descriptor_t *new = malloc(sizeof *new);
-    FEnv *fe = Malloc(sizeof *fe);
-    REnv *re = Malloc(sizeof *re);
+    FEnv *fe = Malloc(sizeof *fe PASS_REGS);
+    REnv *re = Malloc(sizeof *re PASS_REGS);
     bool err = Yap_pushErrorContext(true, new);
     parser_state_t state = YAP_START_PARSING;
     yhandle_t yopts = Yap_InitHandle(opts);
@@ -1705,33 +1713,53 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
   }
 
   Term Yap_BufferToTerm(const char *s, Term opts)
+  {
+    return Yap_UBufferToTerm((const unsigned char *)s, opts);
+  }
+
+  Term Yap_UBufferToTerm(const unsigned char *s, Term opts)
   {
     Term rval;
     int sno;
-    encoding_t l = ENC_ISO_UTF8;
-
-    sno =
-      Yap_open_buf_read_stream((char*)s, strlen(s) + 1, &l, MEM_BUF_USER,
-                               Yap_LookupAtom(Yap_StrPrefix(s, 16)), TermNone);
 
+    sno = Yap_OpenTextReadStream(s, strlen((const char *)s), 0);
+    if (sno < 0)
+      return 0;
     GLOBAL_Stream[sno].status |= CloseOnException_Stream_f;
     rval = Yap_read_term(sno, opts, false);
-    Yap_CloseStream(sno);
+    Yap_CloseTextReadStream(sno);
     return rval;
   }
 
-  Term Yap_UBufferToTerm(const unsigned char *s, Term opts)
+  /*
+    Read from the text of an atom or a string, where it is. A string may
+    move if the stack is collected while it is read, so the stream gets
+    a handle to find it again.
+  */
+  static Term text_to_term(Term t, Term opts, bool clause USES_REGS)
   {
     Term rval;
     int sno;
-    encoding_t l = ENC_ISO_UTF8;
+    yhandle_t h = 0;
+    const unsigned char *s;
 
-    sno = Yap_open_buf_read_stream(
-      (char*)s, strlen((const char*)s), &l, MEM_BUF_USER,
-      Yap_LookupAtom(Yap_StrPrefix((char*)s, 16)), TermNone);
+    if (IsAtomTerm(t))
+      {
+        s = RepAtom(AtomOfTerm(t))->UStrOfAE;
+      }
+    else
+      {
+        h = Yap_InitHandle(t);
+        s = UStringOfTerm(t);
+      }
+    sno = Yap_OpenTextReadStream(s, strlen((const char *)s), h);
+    if (sno < 0)
+      return 0;
     GLOBAL_Stream[sno].status |= CloseOnException_Stream_f;
-    rval = Yap_read_term(sno, opts, false);
-    Yap_CloseStream(sno);
+    rval = Yap_read_term(sno, opts, clause);
+    Yap_CloseTextReadStream(sno);
+    if (h)
+      Yap_CloseHandles(h);
     return rval;
   }
 
@@ -1773,8 +1801,6 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
   static Int read_term_from_atom(USES_REGS1)
   {
     Term t1 = Deref(ARG1);
-    Atom at;
-    const unsigned char *s;
 
     if (IsVarTerm(t1))
       {
@@ -1786,14 +1812,9 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
         Yap_Error(TYPE_ERROR_ATOM, t1, "style_check/1");
         return false;
       }
-    else
-      {
-        at = AtomOfTerm(t1);
-        s = at->UStrOfAE;
-      }
     Term ctl = add_output(ARG2, ARG3);
 
-    return Yap_UBufferToTerm(s, ctl);
+    return text_to_term(Deref(ARG1), ctl, false PASS_REGS);
   }
 
   /**
@@ -1826,13 +1847,12 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
         Yap_Error(TYPE_ERROR_ATOMIC, t1, "read_term_from_atomic/3");
         return(FALSE);
       }
-    else
-      {
-        Term t = Yap_AtomicToString(t1 PASS_REGS);
-        s = UStringOfTerm(t);
-      }
     Term ctl = add_output(ARG2, ARG3);
 
+    t1 = Deref(ARG1);
+    if (IsAtomTerm(t1) || IsStringTerm(t1))
+      return text_to_term(t1, ctl, false PASS_REGS);
+    s = UStringOfTerm(Yap_AtomicToString(t1 PASS_REGS));
     return Yap_UBufferToTerm(s, ctl);
   }
 
@@ -1851,10 +1871,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
   static Int read_term_from_string(USES_REGS1)
   {
     Term t1 = Deref(ARG1), rc;
-    const unsigned char *s;
-    size_t len;
 
-    BACKUP_H()
     if (IsVarTerm(t1))
       {
         Yap_Error(INSTANTIATION_ERROR, t1, "read_term_from_string/3");
@@ -1865,20 +1882,7 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
         Yap_Error(TYPE_ERROR_STRING, t1, "read_term_from_string/3");
         return(FALSE);
       }
-    else
-      {
-        s = UStringOfTerm(t1);
-        len = strlen_utf8(s);
-      }
-    char *ss = (char*)s;
-    encoding_t enc = ENC_ISO_UTF8;
-    int sno = Yap_open_buf_read_stream(ss, len, &enc, MEM_BUF_USER,
-                                       Yap_LookupAtom(Yap_StrPrefix(ss, 16)),
-                                       TermString);
-    GLOBAL_Stream[sno].status |= CloseOnException_Stream_f;
-    rc = Yap_read_term(sno, Deref(ARG3), 3);
-    Yap_CloseStream(sno);
-    RECOVER_H();
+    rc = text_to_term(t1, Deref(ARG3), 3 PASS_REGS);
     if (!rc)
       return false;
     return Yap_unify(rc, ARG2);
@@ -1917,9 +1921,8 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
       }
     else
       {
-        Term t = Yap_AtomicToString(t1 PASS_REGS);
-        const unsigned char *us = UStringOfTerm(t);
-        return Yap_UBufferToTerm(us, add_output(ARG2, add_names(ARG3, TermNil)));
+        Term ctl = add_output(ARG2, add_names(ARG3, TermNil));
+        return text_to_term(Deref(ARG1), ctl, false PASS_REGS);
       }
   }
 
@@ -1939,11 +1942,249 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
       }
     else
       {
-        const unsigned char *us = UStringOfTerm(t1);
-        return Yap_UBufferToTerm(us, add_output(ARG2, add_names(ARG3, TermNil)));
+        Term ctl = add_output(ARG2, add_names(ARG3, TermNil));
+        return text_to_term(Deref(ARG1), ctl, false PASS_REGS);
       }
   }
 
+  /*
+    Splitting a file of clauses for parallel loading.
+
+    A clause ends at a `.` that is not part of a symbol atom and that is
+    followed by layout. We only split where that layout is a newline, so
+    that the reader of the previous chunk stops exactly at the split.
+    To know whether a `.` is inside a quoted item or a comment we must
+    follow the file from the current position, but that only takes a
+    small state machine over blocks read with pread(), and it does not
+    move the stream.
+  */
+
+#define CHUNK_SCAN_BLOCK (256 * 1024)
+#define MAX_LOAD_CHUNKS 256
+
+  typedef enum {
+    scan_code,       /* outside quotes and comments */
+    scan_quoted,     /* inside 'atom', "string" or `codes` */
+    scan_escape,     /* after a backslash in a quoted item */
+    scan_char,       /* after 0' */
+    scan_char_quote, /* after 0'' */
+    scan_char_esc,   /* after 0'\ */
+    scan_block,      /* inside a block comment */
+    scan_line        /* inside a line comment */
+  } chunk_scan_t;
+
+#if THREADS && !_WIN32
+  static bool chunk_symbol_char(int c)
+  {
+    return c && strchr("#$&*+-./:<=>?@^~\\", c) != NULL;
+  }
+
+  static int chunk_workers(Term t)
+  {
+    Int n = 0;
+
+    if (IsIntegerTerm(t))
+      n = IntegerOfTerm(t);
+#if defined(_SC_NPROCESSORS_ONLN)
+    if (n <= 0)
+      n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (n <= 0)
+      n = 1;
+    if (n > MAX_LOAD_CHUNKS)
+      n = MAX_LOAD_CHUNKS;
+    return n;
+  }
+
+  /* scan fd from start, and store up to n-1 split points in splits, and
+     their line numbers in lines; returns how many were found */
+  static int find_clause_splits(int fd, off_t start, off_t size, Int line,
+                                int n, off_t *splits, Int *lines)
+  {
+    unsigned char *buf = malloc(CHUNK_SCAN_BLOCK);
+    chunk_scan_t state = scan_code;
+    int prev = ' ', quote = 0, found = 0, ndigits = 0, base = 0;
+    bool dot = false;
+    off_t off = start, step = (size - start) / n, next = start + step;
+
+    if (!buf)
+      return 0;
+    while (off < size && found < n - 1)
+      {
+        ssize_t nb = pread(fd, buf, CHUNK_SCAN_BLOCK, off), i;
+
+        if (nb <= 0)
+          break;
+        for (i = 0; i < nb && found < n - 1; i++)
+          {
+            int c = buf[i];
+
+            if (c == '\n')
+              line++;
+            switch (state)
+              {
+              case scan_code:
+                if (dot && c == '\n' && off + i + 1 >= next)
+                  {
+                    splits[found] = off + i + 1;
+                    lines[found++] = line;
+                    next = off + i + 1 + step;
+                  }
+                dot = false;
+                if (c == '%')
+                  state = scan_line;
+                else if (c == '*' && prev == '/')
+                  state = scan_block;
+                else if (c == '\'' && ndigits > 0 && ndigits <= 2)
+                  {
+                    /* as in the scanner, 0'c is a character code and
+                       16'FF a number in base 16: no quoted atom here */
+                    if (base == 0)
+                      state = scan_char;
+                  }
+                else if (c == '\'' || c == '"' || c == '`')
+                  {
+                    quote = c;
+                    state = scan_quoted;
+                  }
+                else if (c == '.' && !chunk_symbol_char(prev))
+                  dot = true;
+                /* the digits of a number that starts here */
+                if (isdigit(c) &&
+                    (ndigits > 0 || !(isalnum(prev) || prev == '_')))
+                  {
+                    if (ndigits++ == 0)
+                      base = 0;
+                    if (ndigits <= 2)
+                      base = 10 * base + c - '0';
+                  }
+                else
+                  ndigits = 0;
+                break;
+              case scan_quoted:
+                if (c == '\\')
+                  state = scan_escape;
+                else if (c == quote)
+                  state = scan_code;
+                break;
+              case scan_escape:
+                state = scan_quoted;
+                break;
+              case scan_char:
+                if (c == '\\')
+                  state = scan_char_esc;
+                else if (c == '\'')
+                  state = scan_char_quote;
+                else
+                  state = scan_code;
+                c = ' ';
+                break;
+              case scan_char_quote:
+                /* 0''' is the quote character, as 0'\' is */
+                if (c == '\'')
+                  c = ' ';
+                state = scan_code;
+                break;
+              case scan_char_esc:
+                state = scan_code;
+                c = ' ';
+                break;
+              case scan_block:
+                if (c == '/' && prev == '*')
+                  {
+                    state = scan_code;
+                    c = ' ';
+                  }
+                break;
+              case scan_line:
+                if (c == '\n')
+                  state = scan_code;
+                break;
+              }
+            prev = c;
+          }
+        off += nb;
+      }
+    free(buf);
+    return found;
+  }
+#endif
+
+  /** @pred '$clause_chunks'(+ _Stream_, + _Workers_, - _Chunks_)
+   *
+   * Split what is left to read from _Stream_ into up to _Workers_
+   * pieces of similar size that start and end at clause boundaries.
+   * _Chunks_ is a list of terms `chunk(Start, Line, End)`, where _Start_
+   * and _End_ are byte offsets, and _Line_ is the line at _Start_. The
+   * first chunk starts at the current position of _Stream_, and the last
+   * one ends at the end of the file. If _Workers_ is not a positive
+   * integer, it defaults to the number of processors.
+   *
+   * There is a single chunk if YAP was built without threads, or if
+   * _Stream_ is not a plain file in a byte-oriented encoding.
+   *
+   */
+  static Int clause_chunks(USES_REGS1)
+  {
+    int sno = Yap_CheckTextStream(ARG1, Input_Stream_f, "$clause_chunks/3");
+    StreamDesc *st;
+    off_t start, size = -1, splits[MAX_LOAD_CHUNKS];
+    Int line, lines[MAX_LOAD_CHUNKS];
+    int found = 0, i;
+    Functor f = Yap_MkFunctor(Yap_LookupAtom("chunk"), 3);
+    Term t = TermNil;
+
+    if (sno < 0)
+      return false;
+    st = GLOBAL_Stream + sno;
+    line = st->linecount;
+    if (st->file == NULL || st->vfs || (start = ftello(st->file)) < 0)
+      {
+        start = st->charcount;
+      }
+    else
+      {
+        struct stat buf;
+
+        if (fstat(fileno(st->file), &buf) == 0 && S_ISREG(buf.st_mode))
+          size = buf.st_size;
+      }
+#if THREADS && !_WIN32
+    if (size > start &&
+        (st->encoding == ENC_ISO_UTF8 || st->encoding == ENC_ISO_LATIN1 ||
+         st->encoding == ENC_ISO_ASCII) &&
+        !(st->status & (Tty_Stream_f | Pipe_Stream_f | Socket_Stream_f)))
+      {
+        int n = chunk_workers(Deref(ARG2));
+
+        if (n > 1)
+          found = find_clause_splits(fileno(st->file), start, size, line, n,
+                                     splits, lines);
+      }
+#endif
+    UNLOCK(st->streamlock);
+    if (HR + 6 * (found + 1) > ASP - 1024)
+      {
+        Yap_Error(RESOURCE_ERROR_STACK, ARG1, "$clause_chunks/3");
+        return false;
+      }
+    for (i = found; i >= 0; i--)
+      {
+        Term ts[3];
+
+        ts[0] = MkIntegerTerm(i == 0 ? start : splits[i - 1]);
+        ts[1] = MkIntegerTerm(i == 0 ? line : lines[i - 1]);
+        if (i < found)
+          ts[2] = MkIntegerTerm(splits[i]);
+        else if (size >= 0)
+          ts[2] = MkIntegerTerm(size);
+        else
+          ts[2] = MkVarTerm();
+        t = MkPairTerm(Yap_MkApplTerm(f, 3, ts), t);
+      }
+    return Yap_unify(ARG3, t);
+  }
+
   void Yap_InitReadTPreds(void)
   {
     Yap_InitCPred("read_term", 2, read_term2, SyncPredFlag);
@@ -1964,6 +2205,8 @@ static Term syntax_error(TokEntry *errtok, int sno, Term cmod, Int newpos, bool
     Yap_InitCPred("fileerrors", 0, fileerrors, SyncPredFlag);
     Yap_InitCPred("nofileeleerrors", 0, nofileerrors, SyncPredFlag);
     Yap_InitCPred("source_location", 2, source_location, SyncPredFlag);
+    Yap_InitCPred("$clause_chunks", 3, clause_chunks,
+                  SyncPredFlag | HiddenPredFlag);
     Yap_InitCPred("$style_checker", 1, style_checker,
                   SyncPredFlag | HiddenPredFlag);
   }
@@ -25,16 +25,212 @@ static char SccsId[] = "%W% %G%";
 #include "YapEncoding.h"
 #include "iopreds.h"
 #include "yapio.h"
+#include "utf8block.h"
 
 /// @addtogroup readutil
 
+/*
+  Plain file streams are read by blocks, see Yap_StreamReadLine(), and
+  the bytes are turned into codes or strings in one pass. Other
+  streams still go a character at a time.
+*/
+
+/* bytes from sno can be read by blocks, and decoded as UTF-8 or not */
+static bool block_readable(StreamDesc *st, bool *utf8) {
+  if (!Yap_StreamReadsBlocks(st))
+    return false;
+  switch (st->encoding) {
+  case ENC_ISO_UTF8:
+    *utf8 = true;
+    return true;
+  case ENC_OCTET:
+  case ENC_ISO_LATIN1:
+  case ENC_ISO_ASCII:
+    *utf8 = false;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/*
+  Store the list of codes for the n bytes at s at pt, that must have
+  room for two cells per byte, and return the next free cell. If more
+  input follows, an incomplete sequence at the end is left out, and
+  *usedp tells how many bytes were used.
+*/
+static CELL *bytes_to_codes(const unsigned char *s, size_t n, bool utf8,
+                            bool more, CELL *pt, size_t *usedp) {
+  size_t i = 0;
+
+  while (i < n) {
+    size_t a = (utf8 ? utf8_ascii_span(s + i, n - i) : n - i), j;
+    int cp, l;
+
+    for (j = i; j < i + a; j++) {
+      pt[0] = MkIntTerm(s[j]);
+      pt[1] = AbsPair(pt + 2);
+      pt += 2;
+    }
+    i += a;
+    if (i == n)
+      break;
+    l = utf8_sequence(s + i, n - i, &cp);
+    if (l < 0 && more)
+      break;
+    if (l <= 0) {
+      cp = UTF8_REPLACEMENT_CHAR;
+      l = 1;
+    }
+    pt[0] = MkIntTerm(cp);
+    pt[1] = AbsPair(pt + 2);
+    pt += 2;
+    i += l;
+  }
+  *usedp = i;
+  return pt;
+}
+
+/* read_line_to_codes/2,3 and read_line_to_string/2 by blocks; the
+   stream is locked */
+static Int read_line_by_blocks(int sno, bool utf8, int arity, bool to_string
+                               USES_REGS) {
+  StreamDesc *st = GLOBAL_Stream + sno;
+  Int max_inp = (ASP - HR) / 2 - 1024;
+  unsigned char *buf = (unsigned char *)TR;
+  size_t buf_sz = (unsigned char *)LOCAL_TrailTop - buf, sz, used;
+  bool eol;
+
+  if (buf_sz > max_inp)
+    buf_sz = max_inp;
+  /* strings may need room to fix bad UTF-8 */
+  buf_sz = (to_string ? buf_sz / 5 : buf_sz - 1);
+  sz = Yap_StreamReadLine(st, buf, buf_sz, &eol);
+  UNLOCK(st->streamlock);
+  if (sz == 0 && (st->status & Eof_Stream_f)) {
+    return Yap_unify_constant(ARG2, MkAtomTerm(AtomEof));
+  }
+  if (!eol && sz == buf_sz) {
+    PlIOError(RESOURCE_ERROR_STACK, ARG1, "read_line_to_codes/%d", arity);
+    return false;
+  }
+  /* read_line_to_codes/3 keeps the newline */
+  if (eol && arity == 2) {
+    sz--;
+    /* handle CR before NL */
+    if (sz > 0 && buf[sz - 1] == 13)
+      sz--;
+  }
+  if (to_string) {
+    if (!utf8) {
+      buf[sz] = '\0';
+      return Yap_unify(
+          ARG2, Yap_CharsToString((const char *)buf, ENC_ISO_LATIN1 PASS_REGS));
+    }
+    if (!utf8_valid(buf, sz)) {
+      unsigned char *out = buf + sz + 1, *o = out;
+      size_t i = 0;
+
+      while (i < sz) {
+        int cp, l = utf8_sequence(buf + i, sz - i, &cp);
+        if (l <= 0) {
+          cp = UTF8_REPLACEMENT_CHAR;
+          l = 1;
+        }
+        o += put_utf8(o, cp);
+        i += l;
+      }
+      buf = out;
+      sz = o - out;
+    }
+    buf[sz] = '\0';
+    return Yap_unify(ARG2, Yap_UTF8ToString((const char *)buf PASS_REGS));
+  } else {
+    CELL *h0 = HR, *pt;
+
+    if (sz == 0) {
+      return Yap_unify(ARG2, (arity == 2 ? TermNil : ARG3));
+    }
+    pt = bytes_to_codes(buf, sz, utf8, false, h0, &used);
+    HR = pt;
+    if (arity == 2) {
+      pt[-1] = TermNil;
+      return Yap_unify(ARG2, AbsPair(h0));
+    }
+    RESET_VARIABLE(pt - 1);
+    return Yap_unify(ARG2, AbsPair(h0)) && Yap_unify((CELL)(pt - 1), ARG3);
+  }
+}
+
+/* largest block read_stream_to_codes/3 asks for */
+#define READ_STREAM_BLOCK (256 * 1024)
+
+static Int read_stream_by_blocks(int sno, bool utf8 USES_REGS) {
+  StreamDesc *st = GLOBAL_Stream + sno;
+  CELL *first = NULL, *tail = NULL;
+  unsigned char carry[4];
+  size_t ncarry = 0;
+
+  while (!(st->status & Eof_Stream_f)) {
+    Int room = ((ASP - HR) - 1024) / 2;
+    size_t trail_room =
+        (unsigned char *)LOCAL_TrailTop - (unsigned char *)TR, n, used;
+    unsigned char *buf = (unsigned char *)TR;
+    CELL *pt;
+
+    if (room < 4 * 1024) {
+      yhandle_t news = 0, news1 = 0, sl = Yap_StartSlots();
+
+      if (first) {
+        RESET_VARIABLE(tail);
+        news = Yap_InitSlot(AbsPair(first));
+        news1 = Yap_InitSlot((CELL)tail);
+      }
+      if (!Yap_gcl(2 * READ_STREAM_BLOCK * sizeof(CELL), 3, ENV, Yap_gcP())) {
+        UNLOCK(st->streamlock);
+        Yap_Error(RESOURCE_ERROR_STACK, ARG1, "read_stream_to_codes/3");
+        return false;
+      }
+      if (first) {
+        first = RepPair(Yap_GetFromSlot(news));
+        tail = (CELL *)Yap_GetFromSlot(news1);
+      }
+      Yap_CloseSlots(sl);
+      continue;
+    }
+    if (room > READ_STREAM_BLOCK)
+      room = READ_STREAM_BLOCK;
+    if (room > trail_room)
+      room = trail_room;
+    memcpy(buf, carry, ncarry);
+    n = ncarry + Yap_StreamReadBlock(st, buf + ncarry, room - ncarry);
+    pt = bytes_to_codes(buf, n, utf8, !(st->status & Eof_Stream_f), HR,
+                        &used);
+    ncarry = n - used;
+    memcpy(carry, buf + used, ncarry);
+    if (pt > HR) {
+      if (first)
+        *tail = AbsPair(HR);
+      else
+        first = HR;
+      tail = pt - 1;
+      HR = pt;
+    }
+  }
+  UNLOCK(st->streamlock);
+  if (!first)
+    return Yap_unify(ARG2, ARG3);
+  RESET_VARIABLE(tail);
+  return Yap_unify((CELL)tail, ARG3) && Yap_unify(AbsPair(first), ARG2);
+}
+
 static Int rl_to_codes(Term TEnd, int do_as_binary, int arity USES_REGS) {
   int sno = Yap_CheckStream(ARG1, Input_Stream_f, "read_line_to_codes/2");
   StreamDesc *st = GLOBAL_Stream + sno;
   Int status;
   UInt max_inp, buf_sz, sz;
   unsigned char *buf;
-  bool binary_stream;
+  bool binary_stream, utf8;
   int ch;
 
   if (sno < 0)
@@ -45,6 +241,9 @@ static Int rl_to_codes(Term TEnd, int do_as_binary, int arity USES_REGS) {
     UNLOCK(GLOBAL_Stream[sno].streamlock);
     return Yap_unify_constant(ARG2, MkAtomTerm(AtomEof));
   }
+  if (!binary_stream && block_readable(st, &utf8)) {
+    return read_line_by_blocks(sno, utf8, arity, false PASS_REGS);
+  }
   max_inp = (ASP - HR) / 2 - 1024;
   buf = (unsigned char *)TR;
   buf_sz = (unsigned char *)LOCAL_TrailTop - buf;
@@ -69,7 +268,7 @@ static Int rl_to_codes(Term TEnd, int do_as_binary, int arity USES_REGS) {
           }
           *pt++ = ch;
         } else {
-            pt += get_utf8(pt, 4, &ch);
+            pt += put_utf8(pt, ch);
             if (pt + 4 == buf + buf_sz)
             break;
          }
@@ -131,6 +330,7 @@ static Int read_line_to_string(USES_REGS1) {
   size_t sz;
   StreamDesc *st = GLOBAL_Stream + sno;
   int ch;
+  bool utf8;
 
   if (sno < 0)
     return false;
@@ -139,6 +339,9 @@ static Int read_line_to_string(USES_REGS1) {
     UNLOCK(GLOBAL_Stream[sno].streamlock);
     return Yap_unify_constant(ARG2, MkAtomTerm(AtomEof));
   }
+  if (!(status & Binary_Stream_f) && block_readable(st, &utf8)) {
+    return read_line_by_blocks(sno, utf8, 2, true PASS_REGS);
+  }
   max_inp = (ASP - HR) / 2 - 1024;
   buf = (unsigned char *)TR;
   buf_sz = (unsigned char *)LOCAL_TrailTop - buf;
@@ -159,7 +362,7 @@ static Int read_line_to_string(USES_REGS1) {
           }
           *pt++ = ch;
         } else {
-          pt += get_utf8(pt, 4, &ch);
+          pt += put_utf8(pt, ch);
           if (pt + 4 == buf + buf_sz)
             break;
         }
@@ -212,9 +415,14 @@ static Int read_stream_to_codes(USES_REGS1) {
                             "reaMkAtomTerm (AtomEofd_line_to_codes/2");
   CELL *HBASE = HR;
   CELL *h0 = &ARG4;
+  bool utf8;
 
   if (sno < 0)
     return FALSE;
+  if (!(GLOBAL_Stream[sno].status & Binary_Stream_f) &&
+      block_readable(GLOBAL_Stream + sno, &utf8)) {
+    return read_stream_by_blocks(sno, utf8 PASS_REGS);
+  }
   while (!(GLOBAL_Stream[sno].status & Eof_Stream_f)) {
     /* skip errors */
     Int ch = GLOBAL_Stream[sno].stream_getc(sno);
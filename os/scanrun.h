@@ -0,0 +1,122 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		scanrun.h *
+ * comments:	find runs of characters of the same kind for the scanner *
+ *									 *
+ *************************************************************************/
+
+/*
+  Most of the text the scanner sees comes in runs: the letters of a
+  name, the digits of a number, the layout between tokens, the body of
+  a comment or of a quoted atom. Instead of classifying the text one
+  character at a time, these routines find where the run ends, sixteen
+  bytes at a time with SSE2, or one byte at a time elsewhere.
+
+  Runs only ever contain ASCII, except for the body of a line comment,
+  so that the scanner can copy them as they are.
+
+  The header does not depend on the rest of YAP, so that it can be
+  used by the benchmark in scanrun_bench.c.
+*/
+
+#ifndef SCANRUN_H
+#define SCANRUN_H
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+typedef enum {
+  scan_run_alnum,  /* [A-Za-z0-9_], the rest of a name or variable */
+  scan_run_digits, /* [0-9] */
+  scan_run_layout, /* ASCII layout, including newlines */
+  scan_run_line,   /* anything but a newline */
+  scan_run_quoted  /* printable ASCII, but the quote and backslash */
+} scan_run_t;
+
+static inline int scan_run_char(int c, scan_run_t kind, int quote) {
+  switch (kind) {
+  case scan_run_alnum:
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+  case scan_run_digits:
+    return c >= '0' && c <= '9';
+  case scan_run_layout:
+    return c <= ' ' || c == 127;
+  case scan_run_line:
+    return c != '\n';
+  case scan_run_quoted:
+    return c >= ' ' && c < 127 && c != quote && c != '\\';
+  }
+  return 0;
+}
+
+#if defined(__SSE2__)
+/* a mask with the bytes of v in [lo,hi]; bytes above 127 are negative,
+   so they are never in range */
+static inline __m128i scan_run_range(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+static inline __m128i scan_run_mask(__m128i v, scan_run_t kind, int quote) {
+  switch (kind) {
+  case scan_run_alnum:
+    return _mm_or_si128(
+        _mm_or_si128(scan_run_range(v, 'a', 'z'), scan_run_range(v, 'A', 'Z')),
+        _mm_or_si128(scan_run_range(v, '0', '9'),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+  case scan_run_digits:
+    return scan_run_range(v, '0', '9');
+  case scan_run_layout:
+    return _mm_or_si128(scan_run_range(v, 0, ' '),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8(127)));
+  case scan_run_line:
+    return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                         _mm_set1_epi8(-1));
+  case scan_run_quoted:
+    return _mm_andnot_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)quote)),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+        scan_run_range(v, ' ', 126));
+  }
+  return _mm_setzero_si128();
+}
+#endif
+
+/* length of the run of kind at the start of the n bytes at s */
+static inline size_t scan_run(const unsigned char *s, size_t n,
+                              scan_run_t kind, int quote) {
+  size_t i = 0;
+
+  if (kind == scan_run_line) {
+    const unsigned char *nl = (const unsigned char *)memchr(s, '\n', n);
+    return nl ? (size_t)(nl - s) : n;
+  }
+#if defined(__SSE2__)
+  while (i + 16 <= n) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+    unsigned int m = _mm_movemask_epi8(scan_run_mask(v, kind, quote));
+
+    if (m != 0xffff)
+      return i + __builtin_ctz(~m);
+    i += 16;
+  }
+#endif
+  while (i < n && scan_run_char(s[i], kind, quote))
+    i++;
+  return i;
+}
+
+#endif /* SCANRUN_H */
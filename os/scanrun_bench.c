@@ -0,0 +1,211 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		scanrun_bench.c *
+ * comments:	tokens per second, by character and by runs *
+ *									 *
+ *************************************************************************/
+
+/*
+  Standalone program, it does not need YAP. It writes a file of Prolog
+  clauses, and then splits it into tokens the way the scanner does:
+
+  - one character at a time, through an indirect call per character,
+    as getchr() did;
+
+  - taking runs of letters, digits, layout, comments and quoted text
+    straight from the FILE buffer, as Yap_StreamScanRun() does now.
+
+  Both must find the same tokens and lines.
+
+  usage: scanrun_bench [MB] [file]
+*/
+
+#include "scanrun.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+static double now(void) {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static FILE *in;
+static long int charcount, linecount, linepos;
+
+static int post_process(int ch) {
+  charcount++;
+  linepos++;
+  if (ch == '\n') {
+    linecount++;
+    linepos = 0;
+  }
+  return ch;
+}
+
+static int plgetc(void) {
+  int ch = getc_unlocked(in);
+
+  return ch == EOF ? EOF : post_process(ch);
+}
+
+static int (*getchr)(void) = plgetc;
+
+#if defined _IO_EOF_SEEN || defined _IO_ftrylockfile || __GNU_LIBRARY__ == 1
+#define file_read_ptr(f) ((unsigned char *)(f)->_IO_read_ptr)
+#define file_read_end(f) ((unsigned char *)(f)->_IO_read_end)
+#define file_read_skip(f, n) ((f)->_IO_read_ptr += (n))
+#elif defined __sferror || defined __DragonFly__ || defined __ANDROID__
+#define file_read_ptr(f) ((unsigned char *)(f)->_p)
+#define file_read_end(f) ((unsigned char *)(f)->_p + (f)->_r)
+#define file_read_skip(f, n) ((f)->_p += (n), (f)->_r -= (n))
+#endif
+
+static int use_runs;
+
+static size_t run(scan_run_t kind, int quote, unsigned char *out,
+                  size_t max) {
+#ifdef file_read_ptr
+  const unsigned char *p = file_read_ptr(in), *end = file_read_end(in), *nl;
+  size_t n;
+
+  if (!use_runs || p == NULL || p >= end)
+    return 0;
+  n = end - p;
+  if (out && n > max)
+    n = max;
+  if ((n = scan_run(p, n, kind, quote)) == 0)
+    return 0;
+  if (out)
+    memcpy(out, p, n);
+  file_read_skip(in, n);
+  charcount += n;
+  for (nl = p; (nl = memchr(nl, '\n', p + n - nl)) != NULL; nl++)
+    linecount++;
+  return n;
+#else
+  return 0;
+#endif
+}
+
+#define is_alnum(c) scan_run_char(c, scan_run_alnum, 0)
+#define is_layout(c) ((c) >= 0 && scan_run_char(c, scan_run_layout, 0))
+#define is_symbol(c) ((c) > 0 && strchr("#$&*+-./:<=>?@^~\\", c))
+
+/* returns the number of tokens, and the bytes of text in names and
+   quoted items, so that both ways can be compared */
+static long int tokenize(long int *text) {
+  unsigned char image[64 * 1024], *p;
+  long int tokens = 0;
+  int ch = getchr();
+
+  *text = 0;
+  for (;;) {
+    while (is_layout(ch)) {
+      run(scan_run_layout, 0, NULL, 0);
+      ch = getchr();
+    }
+    if (ch == EOF)
+      return tokens;
+    tokens++;
+    p = image;
+    if (is_alnum(ch)) {
+      while (is_alnum(ch)) {
+        *p++ = ch;
+        p += run(scan_run_alnum, 0, p, image + sizeof(image) - 1 - p);
+        ch = getchr();
+      }
+    } else if (ch == '%') {
+      tokens--;
+      while ((ch = getchr()) != '\n' && ch != EOF)
+        run(scan_run_line, 0, NULL, 0);
+    } else if (ch == '\'' || ch == '"') {
+      int quote = ch;
+
+      while ((ch = getchr()) != quote && ch != EOF) {
+        if (ch == '\\')
+          ch = getchr();
+        *p++ = ch;
+        p += run(scan_run_quoted, quote, p, image + sizeof(image) - 1 - p);
+      }
+      ch = getchr();
+    } else if (is_symbol(ch)) {
+      while (is_symbol(ch))
+        ch = getchr();
+    } else {
+      ch = getchr();
+    }
+    *text += p - image;
+  }
+}
+
+static const char *samples[] = {
+    "append([], L, L).\n",
+    "append([H|T], L, [H|R]) :-\n    append(T, L, R).\n",
+    "% a comment about the next clause, as long as most comments are\n",
+    "edge(node_1234, node_5678, 'Some Label', 3.14159, \"a string\").\n",
+    "fact(12345678, abcdefgh_ijklmnop, 'Quoted atom with spaces').\n",
+    "long_predicate_name(VariableOne, VariableTwo) :-\n"
+    "    VariableOne > 1000, VariableTwo is VariableOne * 2 + 17.\n",
+};
+
+static void bench(const char *name, const char *file, long int size) {
+  long int tokens, text;
+  double t;
+
+  in = fopen(file, "r");
+  charcount = linecount = linepos = 0;
+  t = now();
+  tokens = tokenize(&text);
+  t = now() - t;
+  fclose(in);
+  printf("%-16s %8.2f Mtokens/s %8.1f MB/s  %ld tokens, %ld bytes of text, "
+         "%ld lines\n",
+         name, tokens / t / 1e6, size / t / (1024.0 * 1024.0), tokens, text,
+         linecount);
+}
+
+int main(int argc, char **argv) {
+  long int mb = (argc > 1 ? atol(argv[1]) : 64), size = 0, i;
+  char file[] = "/tmp/scanrunXXXXXX";
+  const char *name = file;
+
+  if (argc > 2) {
+    FILE *f = fopen(name = argv[2], "r");
+
+    if (!f)
+      return 1;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fclose(f);
+  } else {
+    int fd = mkstemp(file);
+    FILE *out;
+
+    if (fd < 0 || !(out = fdopen(fd, "w")))
+      return 1;
+    for (i = 0; size < mb * 1024 * 1024; i++) {
+      const char *s = samples[i % (sizeof(samples) / sizeof(samples[0]))];
+      fputs(s, out);
+      size += strlen(s);
+    }
+    fclose(out);
+  }
+  use_runs = 0;
+  bench("by character", name, size);
+  use_runs = 1;
+  bench("by runs", name, size);
+  if (name == file)
+    remove(file);
+  return 0;
+}
@@ -336,6 +336,7 @@ bool Yap_SetCurInpPos(
 }
 
 Atom Yap_guessFileName(FILE *file, int sno, size_t max) {
+  CACHE_REGS
   size_t maxs = Yap_Max(1023, max - 1);
   if (!file) {
     Atom at = Yap_LookupAtom("mem");
@@ -349,7 +350,7 @@ Atom Yap_guessFileName(FILE *file, int sno, size_t max) {
 
   int i = push_text_stack();
 #if __linux__
-  char *path = Malloc(1024), *nameb = Malloc(maxs + 1);
+  char *path = Malloc(1024 PASS_REGS), *nameb = Malloc(maxs + 1 PASS_REGS);
   size_t len;
   if ((len = snprintf(path, 1023, "/proc/self/fd/%d", f)) >= 0 &&
       (len = readlink(path, nameb, maxs)) > 0) {
@@ -736,11 +737,9 @@ static Int cont_stream_property(USES_REGS1) { /* current_stream */
     }
     cut_fail();
   }
-  LOCK(GLOBAL_Stream[i].streamlock);
   if (IsAtomTerm(args[STREAM_PROPERTY_ALIAS].tvalue)) {
     // one solution only
     i = Yap_CheckAlias(AtomOfTerm(args[STREAM_PROPERTY_ALIAS].tvalue));
-    UNLOCK(GLOBAL_Stream[i].streamlock);
     if (i < 0 || !Yap_unify(ARG1, Yap_MkStream(i))) {
       free(args);
       cut_fail();
@@ -802,12 +801,13 @@ static Int stream_property(USES_REGS1) { /* Init current_stream */
     i = Yap_CheckStream(t1, Input_Stream_f | Output_Stream_f | Append_Stream_f,
                         "current_stream/3");
     if (i < 0) {
-      UNLOCK(GLOBAL_Stream[i].streamlock);
       Yap_ThrowError(LOCAL_Error_TYPE, t1, "bad stream descriptor");
       return false; // error...
     }
     EXTRA_CBACK_ARG(2, 1) = MkIntTerm(i);
     if (IsVarTerm(t2)) {
+      // it takes the lock itself
+      UNLOCK(GLOBAL_Stream[i].streamlock);
       return cont_stream_property(PASS_REGS1);
     }
     args = Yap_ArgListToVector(Deref(ARG2), stream_property_defs,
@@ -817,6 +817,7 @@ static Int stream_property(USES_REGS1) { /* Init current_stream */
       if (LOCAL_Error_TYPE != YAP_NO_ERROR) {
         if (LOCAL_Error_TYPE == DOMAIN_ERROR_PROLOG_FLAG)
           LOCAL_Error_TYPE = DOMAIN_ERROR_STREAM_PROPERTY_OPTION;
+        UNLOCK(GLOBAL_Stream[i].streamlock);
         Yap_Error(LOCAL_Error_TYPE, ARG2, NULL);
         return false;
       }
@@ -1115,6 +1116,7 @@ static Int current_input(USES_REGS1) { /* current_input(?Stream) */
 }
 
 bool Yap_SetInputStream(Term sd) {
+  CACHE_REGS
   int sno = Yap_CheckStream(sd, Input_Stream_f, "set_input/1");
   if (sno < 0)
     return false;
@@ -1162,6 +1164,7 @@ bool Yap_SetOutputStream(Term sd) {
 }
 
 bool Yap_SetErrorStream(Term sd) {
+  CACHE_REGS
   int sno =
       Yap_CheckStream(sd, Output_Stream_f | Append_Stream_f, "set_error/2");
   if (sno < 0)
@@ -149,6 +149,7 @@ char *libdir = NULL;
 #endif
 
 bool Yap_IsAbsolutePath(const char *p0, bool expand) {
+  CACHE_REGS
   // verify first if expansion is needed: ~/ or $HOME/
   const char *p = p0;
   bool nrc;
@@ -173,7 +174,7 @@ static const char *PlExpandVars(const char *source, const char *root) {
   CACHE_REGS
   int lvl = push_text_stack();
   const char *src = source;
-  char *result = Malloc(YAP_FILENAME_MAX + 1);
+  char *result = Malloc(YAP_FILENAME_MAX + 1 PASS_REGS);
 
   if (strlen(source) >= YAP_FILENAME_MAX) {
     Yap_Error(SYSTEM_ERROR_OPERATING_SYSTEM, TermNil,
@@ -351,6 +352,7 @@ static char *PrologPath(const char *Y, char *X) { return (char *)Y; }
 extern char *virtual_cwd;
 
 bool Yap_ChDir(const char *path) {
+  CACHE_REGS
   bool rc = false;
   int lvl = push_text_stack();
 
@@ -395,13 +397,14 @@ static char *close_path(char *b0, char *o0, char *o) {
 }
 
 static char *clean_path(const char *path) {
+  CACHE_REGS
   const char *p, *p0;
   int lvl = push_text_stack();
 
   //__android_log_print(ANDROID_LOG_INFO, "YAPDroid ", " looking at %s", path);
-  char *o0 = Malloc(FILENAME_MAX + 1), *o = o0;
+  char *o0 = Malloc(FILENAME_MAX + 1 PASS_REGS), *o = o0;
   int ch;
-  char *b0 = Malloc(FILENAME_MAX + 1), *b = b0;
+  char *b0 = Malloc(FILENAME_MAX + 1 PASS_REGS), *b = b0;
   p = p0 = path;
   while ((ch = *p++)) {
     if (dir_separator(ch)) {
@@ -438,7 +441,7 @@ static const char *myrealpath(const char *path USES_REGS) {
     return pop_output_text_stack(lvl, o);
 
   } else {
-    out = Malloc(FILENAME_MAX + 1);
+    out = Malloc(FILENAME_MAX + 1 PASS_REGS);
     Yap_getcwd(out, FILENAME_MAX);
     strcat(out, "/");
     strcat(out, path);
@@ -467,7 +470,7 @@ static const char *myrealpath(const char *path USES_REGS) {
     }
     // rc = NULL;
     if (errno == ENOENT || errno == EACCES) {
-      char *base = Malloc(FILENAME_MAX + 1);
+      char *base = Malloc(FILENAME_MAX + 1 PASS_REGS);
       strncpy(base, path, FILENAME_MAX);
       char *p = base + strlen(base);
       while (p > base && !dir_separator(*--p))
@@ -476,7 +479,7 @@ static const char *myrealpath(const char *path USES_REGS) {
         p[1] = '\0';
       else
         p[0] = '\0';
-      char *tmp = Malloc(FILENAME_MAX + 1);
+      char *tmp = Malloc(FILENAME_MAX + 1 PASS_REGS);
       rc = realpath(base, tmp);
 
       if (rc) {
@@ -490,7 +493,7 @@ static const char *myrealpath(const char *path USES_REGS) {
         size_t bs = strlen(b);
 
         if (rc != out && rc != base) {
-          rc = Realloc(rc, e + bs + 2);
+          rc = Realloc(rc, e + bs + 2 PASS_REGS);
         }
 #if _WIN32
         if (rc[e - 1] != '\\' && rc[e - 1] != '/') {
@@ -543,6 +546,7 @@ static const char *expandVars(const char *spec, char *u) {
  * @return tmp, or NULL, in malloced memory
  */
 const char *Yap_AbsoluteFile(const char *spec, bool ok) {
+  CACHE_REGS
   const char *rc;
   const char *spec1;
   const char *spec2;
@@ -943,7 +947,7 @@ static Int expand_file_name3(USES_REGS1) {
 static Int absolute_file_system_path(USES_REGS1) {
   Term t = Deref(ARG1);
   int l = push_text_stack();
-  const char *text = Yap_TextTermToText(t);
+  const char *text = Yap_TextTermToText(t PASS_REGS);
   const char *fp;
   bool rc;
 
@@ -955,7 +959,7 @@ static Int absolute_file_system_path(USES_REGS1) {
     pop_text_stack(l);
     return false;
   }
-  rc = Yap_unify(Yap_MkTextTerm(fp, Yap_TextType(t)), ARG2);
+  rc = Yap_unify(Yap_MkTextTerm(fp, Yap_TextType(t) PASS_REGS), ARG2);
   pop_text_stack(l);
   return rc;
 }
@@ -1205,7 +1209,7 @@ static Int p_expand_file_name(USES_REGS1) {
     return FALSE;
   }
   int l = push_text_stack();
-  text = Yap_TextTermToText(t);
+  text = Yap_TextTermToText(t PASS_REGS);
   if (!text) {
     pop_text_stack(l);
     return false;
@@ -1214,7 +1218,7 @@ static Int p_expand_file_name(USES_REGS1) {
     pop_text_stack(l);
     return false;
   }
-  bool rc = Yap_unify(ARG2, Yap_MkTextTerm(text2, Yap_TextType(t)));
+  bool rc = Yap_unify(ARG2, Yap_MkTextTerm(text2, Yap_TextType(t) PASS_REGS));
   pop_text_stack(l);
   return rc;
 }
@@ -1645,7 +1649,6 @@ static Int p_env_separator(USES_REGS1) {
  * predicates
  */
 void Yap_InitSysbits(int wid) {
-  CACHE_REGS
 #if __simplescalar__
   {
     char *pwd = getenv("PWD");
@@ -1655,7 +1658,7 @@ void Yap_InitSysbits(int wid) {
   Yap_InitWTime();
   Yap_InitRandom();
   /* let the caller control signals as it sees fit */
-  Yap_InitOSSignals(worker_id);
+  Yap_InitOSSignals(wid);
 }
 
 static Int p_unix(USES_REGS1) {
@@ -1934,12 +1937,149 @@ static Int p_sleep(USES_REGS1) {
 #endif
 }
 
+#if !defined(__MINGW32__) && !_MSC_VER
+
+/* the workers started by '$prefork'/2, for '$prefork_wait'/1 */
+static pid_t *prefork_pids;
+static Int prefork_n;
+
+/*
+  '$prefork'(+N, -I): start N worker processes that share the program
+  loaded so far, copy-on-write. I is 0 in the parent, and goes from 1
+  to N in the workers.
+*/
+static Int p_prefork(USES_REGS1) {
+  Term t = Deref(ARG1);
+  Int n, i;
+
+  if (IsVarTerm(t)) {
+    Yap_Error(INSTANTIATION_ERROR, t, "prefork/2");
+    return false;
+  }
+  if (!IsIntegerTerm(t)) {
+    Yap_Error(TYPE_ERROR_INTEGER, t, "prefork/2");
+    return false;
+  }
+  if ((n = IntegerOfTerm(t)) < 0) {
+    Yap_Error(DOMAIN_ERROR_NOT_LESS_THAN_ZERO, t, "prefork/2");
+    return false;
+  }
+#ifdef THREADS
+  if (GLOBAL_NOfThreads != 1) {
+    Yap_Error(SYSTEM_ERROR_INTERNAL, t,
+              "prefork/2: more than a thread running");
+    return false;
+  }
+#endif
+  if (prefork_pids) {
+    Yap_Error(SYSTEM_ERROR_INTERNAL, t, "prefork/2: workers already running");
+    return false;
+  }
+  if (!(prefork_pids = malloc((n + 1) * sizeof(pid_t)))) {
+    Yap_Error(RESOURCE_ERROR_HEAP, t, "prefork/2");
+    return false;
+  }
+  /* whatever the workers do not need to free or to write out */
+  Yap_LUReclaimAll();
+  Yap_FlushStreams();
+  for (i = 0; i < n; i++) {
+    pid_t pid = fork();
+
+    if (pid < 0) {
+      int err = errno;
+
+      /* all or none */
+      while (i--) {
+        kill(prefork_pids[i], SIGTERM);
+        waitpid(prefork_pids[i], NULL, 0);
+      }
+      free(prefork_pids);
+      prefork_pids = NULL;
+      Yap_Error(SYSTEM_ERROR_OPERATING_SYSTEM, t, "prefork/2: fork(): %s",
+                strerror(err));
+      return false;
+    } else if (pid == 0) {
+      free(prefork_pids);
+      prefork_pids = NULL;
+      return Yap_unify(ARG2, MkIntegerTerm(i + 1));
+    }
+    prefork_pids[i] = pid;
+  }
+  prefork_n = n;
+  return Yap_unify(ARG2, MkIntTerm(0));
+}
+
+/*
+  '$prefork_wait'(-F): wait until all workers have exited; F is how
+  many did not exit with status 0.
+*/
+static Int p_prefork_wait(USES_REGS1) {
+  Int i, failed = 0;
+
+  for (i = 0; i < prefork_n; i++) {
+    int status;
+
+    while (waitpid(prefork_pids[i], &status, 0) < 0) {
+      if (errno != EINTR) {
+        status = -1;
+        break;
+      }
+    }
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      failed++;
+  }
+  free(prefork_pids);
+  prefork_pids = NULL;
+  prefork_n = 0;
+  return Yap_unify(ARG1, MkIntegerTerm(failed));
+}
+
+#endif
+
+/*
+  '$memory_sharing'(-S, -P): resident memory of this process, in
+  kbytes, that is shared with other processes, and that is private.
+*/
+static Int p_memory_sharing(USES_REGS1) {
+#if defined(__linux__)
+  FILE *f;
+  char line[256];
+  UInt shared = 0, private = 0;
+
+  /* smaps_rollup has the sums, smaps has them per mapping */
+  if (!(f = fopen("/proc/self/smaps_rollup", "r")) &&
+      !(f = fopen("/proc/self/smaps", "r"))) {
+    Yap_Error(SYSTEM_ERROR_OPERATING_SYSTEM, TermNil,
+              "statistics/2: cannot open /proc/self/smaps: %s",
+              strerror(errno));
+    return false;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long kb;
+
+    if (sscanf(line, "Shared_Clean: %lu", &kb) == 1 ||
+        sscanf(line, "Shared_Dirty: %lu", &kb) == 1)
+      shared += kb;
+    else if (sscanf(line, "Private_Clean: %lu", &kb) == 1 ||
+             sscanf(line, "Private_Dirty: %lu", &kb) == 1)
+      private += kb;
+  }
+  fclose(f);
+  return Yap_unify(ARG1, MkIntegerTerm(shared)) &&
+         Yap_unify(ARG2, MkIntegerTerm(private));
+#else
+  Yap_Error(SYSTEM_ERROR_OPERATING_SYSTEM, TermNil,
+            "statistics/2: memory_sharing is only available on Linux");
+  return false;
+#endif
+}
+
 #if MCHECK_H
 #include <mcheck.h>
 #endif
 
 static Int
-  p_mtrace()
+  p_mtrace(USES_REGS1)
   {
 #ifdef HAVE_MTRACE
     Term t = Deref(ARG1);
@@ -1987,6 +2127,11 @@ void Yap_InitSysPreds(void) {
 #endif
   Yap_InitCPred("rmdir", 2, p_rmdir, SyncPredFlag);
   Yap_InitCPred("sleep", 1, p_sleep, SyncPredFlag);
+#if !defined(__MINGW32__) && !_MSC_VER
+  Yap_InitCPred("$prefork", 2, p_prefork, SyncPredFlag);
+  Yap_InitCPred("$prefork_wait", 1, p_prefork_wait, SyncPredFlag);
+#endif
+  Yap_InitCPred("$memory_sharing", 2, p_memory_sharing, SyncPredFlag);
   Yap_InitCPred("make_directory", 1, make_directory, SyncPredFlag);
   Yap_InitCPred("mtrace", 1, p_mtrace, SyncPredFlag);
 }
@@ -0,0 +1,178 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		utf8block.h *
+ * comments:	validate and decode UTF-8 a block at a time *
+ *									 *
+ *************************************************************************/
+
+/*
+  Routines to go over a block of bytes that was read in one go from a
+  stream. Text is mostly ASCII, so runs of ASCII are found eight bytes
+  at a time, by checking the top bit of every byte in a word, and only
+  the remaining bytes are decoded one sequence at a time.
+
+  Validation follows RFC 3629: no overlong forms, no surrogates, and
+  nothing above U+10FFFF.
+
+  The header does not depend on the rest of YAP, so that it can be
+  used by the benchmark in utf8block_bench.c.
+*/
+
+#ifndef UTF8BLOCK_H
+#define UTF8BLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* what an invalid byte is decoded to */
+#define UTF8_REPLACEMENT_CHAR 0xFFFD
+
+#define UTF8_HIGH_BITS ((uint64_t)0x8080808080808080ULL)
+
+/* length of the run of ASCII bytes at the start of s */
+static inline size_t utf8_ascii_span(const unsigned char *s, size_t n) {
+  size_t i = 0;
+
+  while (i + 8 <= n) {
+    uint64_t w;
+
+    memcpy(&w, s + i, 8);
+    if (w & UTF8_HIGH_BITS)
+      break;
+    i += 8;
+  }
+  while (i < n && s[i] < 0x80)
+    i++;
+  return i;
+}
+
+#define utf8_is_cont(c) (((c)&0xc0) == 0x80)
+
+/* how many bytes code point cp takes */
+#define utf8_width(cp)                                                         \
+  ((cp) < 0x80 ? 1 : (cp) < 0x800 ? 2 : (cp) < 0x10000 ? 3 : 4)
+
+/* number of code points in the n bytes at s, one per byte that does
+   not continue a sequence */
+static inline size_t utf8_count(const unsigned char *s, size_t n) {
+  size_t i = 0, cps = 0;
+
+  while (i < n) {
+    size_t a = utf8_ascii_span(s + i, n - i);
+
+    i += a;
+    cps += a;
+    for (; i < n && s[i] >= 0x80; i++)
+      cps += !utf8_is_cont(s[i]);
+  }
+  return cps;
+}
+
+/*
+  Decode the sequence at s into *cp. Returns its length, 0 if s does
+  not start a valid sequence, or -1 if the sequence is valid so far
+  but needs more than the n bytes available.
+*/
+static inline int utf8_sequence(const unsigned char *s, size_t n, int *cp) {
+  unsigned int c = s[0], lo = 0x80, hi = 0xbf;
+  int len, i, v;
+
+  if (c < 0x80) {
+    *cp = c;
+    return 1;
+  } else if (c < 0xc2) {
+    return 0;
+  } else if (c < 0xe0) {
+    len = 2;
+    v = c & 0x1f;
+  } else if (c < 0xf0) {
+    len = 3;
+    v = c & 0x0f;
+    if (c == 0xe0)
+      lo = 0xa0;
+    else if (c == 0xed)
+      hi = 0x9f;
+  } else if (c < 0xf5) {
+    len = 4;
+    v = c & 0x07;
+    if (c == 0xf0)
+      lo = 0x90;
+    else if (c == 0xf4)
+      hi = 0x8f;
+  } else {
+    return 0;
+  }
+  for (i = 1; i < len; i++) {
+    if ((size_t)i == n)
+      return -1;
+    c = s[i];
+    if (i == 1 ? (c < lo || c > hi) : !utf8_is_cont(c))
+      return 0;
+    v = (v << 6) | (c & 0x3f);
+  }
+  *cp = v;
+  return len;
+}
+
+/* true if the n bytes at s are valid UTF-8 */
+static inline int utf8_valid(const unsigned char *s, size_t n) {
+  size_t i = 0;
+
+  while (i < n) {
+    int cp, l;
+
+    i += utf8_ascii_span(s + i, n - i);
+    if (i == n)
+      break;
+    if ((l = utf8_sequence(s + i, n - i, &cp)) <= 0)
+      return 0;
+    i += l;
+  }
+  return 1;
+}
+
+/*
+  Decode the bytes at s into code points at out, which must have room
+  for n of them. Invalid bytes become UTF8_REPLACEMENT_CHAR. If the
+  block ends in the middle of a sequence, and more input may follow,
+  the sequence is left for the next block. Returns the number of
+  bytes used and sets *ncodes to the number of code points.
+*/
+static inline size_t utf8_decode_block(const unsigned char *s, size_t n,
+                                       int more, int *out, size_t *ncodes) {
+  size_t i = 0, k = 0;
+
+  while (i < n) {
+    size_t a = utf8_ascii_span(s + i, n - i), j;
+    int cp, l;
+
+    for (j = 0; j < a; j++)
+      out[k + j] = s[i + j];
+    i += a;
+    k += a;
+    if (i == n)
+      break;
+    l = utf8_sequence(s + i, n - i, &cp);
+    if (l < 0 && more)
+      break;
+    if (l <= 0) {
+      cp = UTF8_REPLACEMENT_CHAR;
+      l = 1;
+    }
+    out[k++] = cp;
+    i += l;
+  }
+  *ncodes = k;
+  return i;
+}
+
+#endif /* UTF8BLOCK_H */
@@ -0,0 +1,249 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		utf8block_bench.c *
+ * comments:	throughput of block reads against character reads *
+ *									 *
+ *************************************************************************/
+
+/*
+  Standalone program, it does not need YAP. It writes a file of UTF-8
+  text, and then reads it back line by line into arrays of codes:
+
+  - as read_line_to_codes/2 did before, one indirect call per
+    character, one locked fgetc() per byte, and a second pass to decode
+    the UTF-8 that was collected;
+
+  - as Yap_StreamReadLine() and readutil.c do now, a block per line
+    and one decoding pass over it;
+
+  and then in one go, as read_stream_to_codes/3 does now.
+
+  usage: utf8block_bench [MB]
+*/
+
+#include "utf8block.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define LINE_MAX_BYTES 4096
+
+static double now(void) {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static long int charcount, linecount, linepos;
+
+static int post_process(int ch, int n) {
+  charcount += n;
+  linepos += n;
+  if (ch == '\n') {
+    linecount++;
+    linepos = 0;
+  }
+  return ch;
+}
+
+/* the old layering: stream_getc and stream_wgetc */
+
+static FILE *in;
+
+static int plgetc(void) { return fgetc(in); }
+
+static int (*stream_getc)(void) = plgetc;
+
+static int get_wchar_utf8(void) {
+  int ch = stream_getc(), c1, c2, c3;
+
+  if (ch == EOF)
+    return EOF;
+  if (ch < 0x80)
+    return post_process(ch, 1);
+  if (ch < 0xe0) {
+    c1 = stream_getc();
+    return post_process(((ch & 0x1f) << 6) | (c1 & 0x3f), 2);
+  }
+  if (ch < 0xf0) {
+    c1 = stream_getc();
+    c2 = stream_getc();
+    return post_process(((ch & 0xf) << 12) | ((c1 & 0x3f) << 6) | (c2 & 0x3f),
+                        3);
+  }
+  c1 = stream_getc();
+  c2 = stream_getc();
+  c3 = stream_getc();
+  return post_process(((ch & 7) << 18) | ((c1 & 0x3f) << 12) |
+                          ((c2 & 0x3f) << 6) | (c3 & 0x3f),
+                      4);
+}
+
+static int (*stream_wgetc)(void) = get_wchar_utf8;
+
+static int put_utf8(unsigned char *s, int cp) {
+  if (cp < 0x80) {
+    s[0] = cp;
+    return 1;
+  } else if (cp < 0x800) {
+    s[0] = 0xc0 | (cp >> 6);
+    s[1] = 0x80 | (cp & 0x3f);
+    return 2;
+  } else if (cp < 0x10000) {
+    s[0] = 0xe0 | (cp >> 12);
+    s[1] = 0x80 | ((cp >> 6) & 0x3f);
+    s[2] = 0x80 | (cp & 0x3f);
+    return 3;
+  }
+  s[0] = 0xf0 | (cp >> 18);
+  s[1] = 0x80 | ((cp >> 12) & 0x3f);
+  s[2] = 0x80 | ((cp >> 6) & 0x3f);
+  s[3] = 0x80 | (cp & 0x3f);
+  return 4;
+}
+
+static long int old_lines(int *codes, long int *ncodes) {
+  unsigned char buf[LINE_MAX_BYTES + 8];
+  long int lines = 0;
+
+  *ncodes = 0;
+  for (;;) {
+    unsigned char *pt = buf;
+    int ch;
+    size_t i, n, k;
+
+    do {
+      ch = stream_wgetc();
+      if (ch < 0)
+        break;
+      pt += put_utf8(pt, ch);
+    } while (ch != '\n');
+    if (pt == buf)
+      return lines;
+    n = pt - buf;
+    for (i = 0, k = 0; i < n; k++) {
+      int cp;
+      i += utf8_sequence(buf + i, n - i, &cp);
+      codes[k] = cp;
+    }
+    *ncodes += k;
+    lines++;
+  }
+}
+
+/* the new way */
+
+static void count_block(const unsigned char *buf, size_t n) {
+  const unsigned char *p = buf, *end = buf + n, *nl;
+
+  charcount += n;
+  while ((nl = memchr(p, '\n', end - p)) != NULL) {
+    linecount++;
+    p = nl + 1;
+  }
+  linepos = (p == buf ? linepos + n : end - p);
+}
+
+static size_t read_line(unsigned char *buf, size_t max) {
+  size_t n = 0;
+  int ch;
+
+  flockfile(in);
+  while (n < max && (ch = getc_unlocked(in)) != EOF) {
+    buf[n++] = ch;
+    if (ch == '\n')
+      break;
+  }
+  funlockfile(in);
+  count_block(buf, n);
+  return n;
+}
+
+static long int new_lines(int *codes, long int *ncodes) {
+  unsigned char buf[LINE_MAX_BYTES];
+  long int lines = 0;
+  size_t n, k;
+
+  *ncodes = 0;
+  while ((n = read_line(buf, LINE_MAX_BYTES)) > 0) {
+    utf8_decode_block(buf, n, 0, codes, &k);
+    *ncodes += k;
+    lines++;
+  }
+  return lines;
+}
+
+static long int new_stream(int *codes, long int *ncodes) {
+  static unsigned char buf[256 * 1024 + 4];
+  size_t n, carry = 0, used, k;
+
+  *ncodes = 0;
+  do {
+    n = fread(buf + carry, 1, 256 * 1024, in);
+    count_block(buf + carry, n);
+    n += carry;
+    used = utf8_decode_block(buf, n, !feof(in), codes, &k);
+    *ncodes += k;
+    carry = n - used;
+    memmove(buf, buf + used, carry);
+  } while (!feof(in));
+  return 0;
+}
+
+static const char *samples[] = {
+    "2018-03-04 12:00:01 INFO  request served in 12ms from 10.0.0.1\n",
+    "2018-03-04 12:00:02 WARN  utilisateur \xc3\xa9trang\xc3\xa8re: "
+    "caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9"
+    "e\n",
+    "2018-03-04 12:00:03 INFO  total \xe2\x82\xac 42.00 paid\n",
+    "2018-03-04 12:00:04 DEBUG emoji \xf0\x9f\x98\x80 in user agent\n",
+    "2018-03-04 12:00:05 INFO  GET /index.html HTTP/1.1 200 5120 bytes\n",
+};
+
+static void run(const char *name, const char *file, long int size,
+                long int (*f)(int *, long int *), int *codes) {
+  long int ncodes, lines;
+  double t;
+
+  in = fopen(file, "r");
+  charcount = linecount = linepos = 0;
+  t = now();
+  lines = f(codes, &ncodes);
+  t = now() - t;
+  fclose(in);
+  printf("%-24s %8.1f MB/s  %ld codes, %ld lines\n", name,
+         size / t / (1024.0 * 1024.0), ncodes, lines ? lines : linecount);
+}
+
+int main(int argc, char **argv) {
+  long int mb = (argc > 1 ? atol(argv[1]) : 64), size = 0, i;
+  char file[] = "/tmp/utf8benchXXXXXX";
+  int fd = mkstemp(file), *codes;
+  FILE *out;
+
+  if (fd < 0 || !(out = fdopen(fd, "w")))
+    return 1;
+  for (i = 0; size < mb * 1024 * 1024; i++) {
+    /* mostly ASCII, as logs are */
+    const char *s = samples[(i % 10 < 7 ? (i % 2) * 4 : 1 + i % 3)];
+    fputs(s, out);
+    size += strlen(s);
+  }
+  fclose(out);
+  codes = malloc(256 * 1024 * sizeof(int) + LINE_MAX_BYTES * sizeof(int));
+  run("character reads", file, size, old_lines, codes);
+  run("block line reads", file, size, new_lines, codes);
+  run("block stream read", file, size, new_stream, codes);
+  remove(file);
+  free(codes);
+  return 0;
+}
@@ -0,0 +1,192 @@
+/*************************************************************************
+ *									 *
+ *	 YAP Prolog 							 *
+ *									 *
+ *	Yap Prolog was developed at NCCUP - Universidade do Porto	 *
+ *									 *
+ * Copyright L.Damas, V.S.Costa and Universidade do Porto 1985-1997	 *
+ *									 *
+ **************************************************************************
+ *									 *
+ * File:		wrblock_bench.c *
+ * comments:	throughput of block writes against character writes *
+ *									 *
+ *************************************************************************/
+
+/*
+  Standalone program, it only needs fmtfloat.c. It writes answer terms
+  as write/1, writeq/1 and write_canonical/1 would print them, to
+  /dev/null, so that only the cost of writing is measured:
+
+  - as C/write.c did before, one indirect call to stream_wputc per
+    character, that goes through put_wchar() and FilePutc();
+
+  - as C/write.c does now, putting the term together in a block that
+    is written with fwrite().
+
+  Floats are printed either with printf(), or with the fewest digits
+  that read back the same.
+
+  usage: wrblock_bench [terms]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define WRITE_BLOCK 4096
+
+extern char *Yap_FormatShortestFloat(double f, char *buf);
+
+static double now(void) {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static FILE *out;
+static long int charcount, linecount, linepos;
+
+static void count_output_char(int ch) {
+  ++charcount;
+  if (ch == '\n') {
+    ++linecount;
+    linepos = 0;
+  } else {
+    ++linepos;
+  }
+}
+
+/* the old layering: stream_wputc, put_wchar and stream_putc */
+
+static int file_putc(int ch) {
+  putc(ch, out);
+  count_output_char(ch);
+  return ch;
+}
+
+static int (*volatile stream_putc)(int) = file_putc;
+
+static int put_wchar(int ch) {
+  if (ch < 0x80) {
+    stream_putc(ch);
+  } else if (ch < 0x800) {
+    stream_putc(0xC0 | ch >> 6);
+    stream_putc(0x80 | (ch & 0x3F));
+  } else {
+    stream_putc(0xE0 | ch >> 12);
+    stream_putc(0x80 | (ch >> 6 & 0x3F));
+    stream_putc(0x80 | (ch & 0x3F));
+  }
+  return ch;
+}
+
+static int (*volatile stream_wputc)(int) = put_wchar;
+
+/* the new way */
+
+static unsigned char block[WRITE_BLOCK], *bptr = block;
+
+static void block_flush(void) {
+  const unsigned char *p = block, *nl;
+
+  fwrite(block, 1, bptr - block, out);
+  charcount += bptr - block;
+  while ((nl = memchr(p, '\n', bptr - p)) != NULL) {
+    linecount++;
+    p = nl + 1;
+  }
+  bptr = block;
+}
+
+static void block_putc(int ch) {
+  if (bptr + 4 > block + WRITE_BLOCK)
+    block_flush();
+  *bptr++ = ch;
+}
+
+static int blocks, shortest;
+
+static void wrputc(int ch) {
+  if (blocks)
+    block_putc(ch);
+  else
+    stream_wputc(ch);
+}
+
+static void wrputs(const char *s) {
+  while (*s)
+    wrputc(*s++);
+}
+
+static void wrputf(double f) {
+  char buf[64];
+
+  if (shortest)
+    Yap_FormatShortestFloat(f, buf);
+  else
+    sprintf(buf, "%.15g", f);
+  wrputs(buf);
+}
+
+static void wrputn(long int i) {
+  char buf[32];
+
+  sprintf(buf, "%ld", i);
+  wrputs(buf);
+}
+
+typedef enum { plain, quoted, canonical } wmode;
+
+/* answer(N, 'hello world', F, [a,b,c], "text") */
+static void write_answer(long int i, wmode mode) {
+  double f = i / 7.0;
+
+  wrputs("answer(");
+  wrputn(i);
+  wrputc(',');
+  wrputs(mode == plain ? "hello world" : "'hello world'");
+  wrputc(',');
+  wrputf(f);
+  wrputc(',');
+  wrputs(mode == canonical ? "'[|]'(a,'[|]'(b,'[|]'(c,[])))" : "[a,b,c]");
+  wrputc(',');
+  wrputs(mode == plain ? "text" : "\"text\"");
+  wrputc(')');
+  wrputc('\n');
+  if (blocks)
+    block_flush();
+}
+
+static void run(const char *name, long int n, wmode mode) {
+  double t;
+  long int i;
+
+  if (!(out = fopen("/dev/null", "w")))
+    exit(1);
+  charcount = linecount = linepos = 0;
+  t = now();
+  for (i = 0; i < n; i++)
+    write_answer(i, mode);
+  fflush(out);
+  t = now() - t;
+  fclose(out);
+  printf("%-16s %-10s %-8s %8.2f Mterms/s  %ld bytes, %ld lines\n", name,
+         blocks ? "blocks" : "chars", shortest ? "shortest" : "%.15g",
+         n / t / 1e6, charcount, linecount);
+}
+
+int main(int argc, char **argv) {
+  long int n = (argc > 1 ? atol(argv[1]) : 2000000);
+
+  for (blocks = 0; blocks < 2; blocks++) {
+    for (shortest = 0; shortest < 2; shortest++) {
+      run("write", n, plain);
+      run("writeq", n, quoted);
+      run("write_canonical", n, canonical);
+    }
+  }
+  return 0;
+}
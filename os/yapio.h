@@ -118,7 +118,8 @@ extern int Yap_growtrail_in_parser(tr_fr_ptr *, TokEntry **, VarEntry **);
 
 typedef enum mem_buf_source {
   MEM_BUF_MALLOC = 1,
-  MEM_BUF_USER = 2
+  MEM_BUF_USER = 2,
+  MEM_BUF_TEXT = 3 /* the text of an atom or string, see memtext.c */
 } memBufSource;
 
 extern char *Yap_MemStreamBuf(int sno);
@@ -128,10 +129,14 @@ extern char *Yap_StrPrefix(const char *buf, size_t n);
 extern Term Yap_StringToNumberTerm(const char *s, encoding_t *encp,
                                    bool error_on);
 extern int Yap_FormatFloat(Float f, char **s, size_t sz);
+extern char *Yap_FormatShortestFloat(double f, char *buf);
 extern int Yap_open_buf_read_stream(const char *buf, size_t nchars,
                                     encoding_t *encp, memBufSource src,
                                     Atom name, Term uname);
 extern int Yap_open_buf_write_stream(encoding_t enc, memBufSource src);
+extern int Yap_OpenTextReadStream(const unsigned char *s, size_t n,
+                                  yhandle_t text);
+extern void Yap_CloseTextReadStream(int sno);
 extern Term Yap_BufferToTerm(const char *s, Term opts);
 
 extern X_API Term Yap_BufferToTermWithPrioBindings(const char *s, Term opts,
@@ -22,7 +22,7 @@ static foreign_t array_to_python_list(term_t addr, term_t type, term_t szt,
   } else {
     YAP_Int *v = (YAP_Int *)src;
     for (i = 0; i < sz; i++) {
-      PyObject *x = PyFloat_FromDouble(v[i]);
+      PyObject *x = PyLong_FromLong(v[i]);
       PyList_SET_ITEM(list, i, x);
     }
   }
@@ -56,7 +56,7 @@ static foreign_t array_to_python_tuple(term_t addr, term_t type, term_t szt,
       }
     }
   } else {
-    int32_t *v = (int32_t *)src;
+    YAP_Int *v = (YAP_Int *)src;
     PyObject *x;
     for (i = 0; i < sz; i++) {
 #if PY_MAJOR_VERSION < 3
@@ -76,31 +76,78 @@ static foreign_t array_to_python_tuple(term_t addr, term_t type, term_t szt,
   return assign_to_symbol(py, list);
 }
 
+/* buffer format for YAP's two kinds of numeric storage */
+static char *array_format(int is_float) {
+  if (is_float)
+    return "d";
+  return (sizeof(YAP_Int) == sizeof(long) ? "l" : "q");
+}
+
+#define MAX_VIEW_DIMS 16
+
+/* the shape is either a list of dimensions, or the number of columns: 0
+   means a vector */
+static bool get_view_shape(term_t dimst, Py_ssize_t sz, Py_ssize_t *shape,
+                           int *ndims) {
+  Py_ssize_t cols, total = 1;
+  term_t head, tail;
+  int n = 0;
+
+  if (PL_get_intptr(dimst, &cols)) {
+    if (cols <= 0) {
+      shape[0] = sz;
+      *ndims = 1;
+      return true;
+    }
+    if (sz % cols)
+      return false;
+    shape[0] = sz / cols;
+    shape[1] = cols;
+    *ndims = 2;
+    return true;
+  }
+  head = PL_new_term_ref();
+  tail = PL_copy_term_ref(dimst);
+  while (PL_get_list(tail, head, tail)) {
+    if (n == MAX_VIEW_DIMS || !PL_get_intptr(head, shape + n) || shape[n] < 0)
+      return false;
+    total *= shape[n++];
+  }
+  if (!PL_get_nil(tail) || n == 0 || total != sz)
+    return false;
+  *ndims = n;
+  return true;
+}
+
+/*
+  Make a memoryview over sz numbers at addr. The view shares storage
+  with YAP, so nothing is copied, and NumPy can wrap it with
+  numpy.asarray(). The caller must keep the storage alive for as long
+  as the view is in use.
+*/
 static foreign_t array_to_python_view(term_t addr, term_t type, term_t szt,
-                                      term_t colt, term_t py) {
+                                      term_t dimst, term_t py) {
   void *src;
-  Py_ssize_t sz, rows;
-  int is_float;
-  Py_ssize_t shape[2];
+  Py_ssize_t sz;
+  int is_float, ndims;
+  Py_ssize_t shape[MAX_VIEW_DIMS];
+  Py_buffer buf;
 
   if (!PL_get_pointer(addr, &src) || !PL_get_bool(type, &is_float) ||
-      !PL_get_intptr(szt, &sz) || !PL_get_intptr(colt, &rows))
+      !PL_get_intptr(szt, &sz) || !get_view_shape(dimst, sz, shape, &ndims))
     return false;
-  Py_buffer buf;
   buf.buf = src;
-  if (is_float) {
-    buf.len = sz * sizeof(double);
-    buf.itemsize = sizeof(double);
-  } else {
-    buf.len = sz * sizeof(YAP_Int);
-    buf.itemsize = sizeof(YAP_Int);
-  }
+  buf.obj = NULL;
+  buf.itemsize = (is_float ? sizeof(double) : sizeof(YAP_Int));
+  buf.len = sz * buf.itemsize;
   buf.readonly = false;
-  buf.format = NULL;
-  buf.ndim = 2;
+  buf.format = array_format(is_float);
+  buf.ndim = ndims;
+  /* the memoryview takes its own copy of shape and strides */
   buf.shape = shape;
   buf.strides = NULL;
   buf.suboffsets = NULL;
+  buf.internal = NULL;
   PyObject *o = PyMemoryView_FromBuffer(&buf);
   if (!o) {
     PyErr_Print();
@@ -112,6 +159,89 @@ static foreign_t array_to_python_view(term_t addr, term_t type, term_t szt,
   return assign_to_symbol(py, o);
 }
 
+/* buffers exported by Python objects to YAP, they are held until
+   released */
+typedef struct python_export {
+  Py_buffer view;
+  struct python_export *next;
+} python_export_t;
+
+static python_export_t *exports;
+
+/*
+  Get the storage of a Python object that supports the buffer protocol,
+  such as a NumPy array. The storage must be writable, C contiguous, and
+  hold doubles or YAP integers. The object stays alive and the storage
+  stays in place until python_release_buffer/1 is called on Ptr.
+*/
+static foreign_t python_export_buffer(term_t tobj, term_t ptr, term_t szt,
+                                      term_t type) {
+  PyObject *o;
+  python_export_t *e;
+  const char *fmt;
+  int is_float;
+
+  PyStart();
+  o = term_to_python(tobj, true, NULL, true);
+  if (o == NULL) {
+    pyErrorAndReturn(false);
+  }
+  if (!(e = malloc(sizeof(python_export_t)))) {
+    return false;
+  }
+  if (PyObject_GetBuffer(o, &e->view, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE |
+                                          PyBUF_FORMAT) < 0) {
+    free(e);
+    pyErrorAndReturn(false);
+  }
+  fmt = (e->view.format ? e->view.format : "B");
+  /* native byte order and alignment */
+  if (fmt[0] == '@' || fmt[0] == '=')
+    fmt++;
+  if (!strcmp(fmt, "d") && e->view.itemsize == sizeof(double)) {
+    is_float = true;
+  } else if (fmt[1] == '\0' && strchr("lq", fmt[0]) &&
+             e->view.itemsize == sizeof(YAP_Int)) {
+    is_float = false;
+  } else {
+    PyBuffer_Release(&e->view);
+    free(e);
+    PyErr_Format(PyExc_TypeError,
+                 "buffer of '%s' cannot be shared, need doubles or %d-byte "
+                 "integers",
+                 fmt, (int)sizeof(YAP_Int));
+    pyErrorAndReturn(false);
+  }
+  if (!PL_unify_pointer(ptr, e->view.buf) ||
+      !PL_unify_int64(szt, e->view.len / e->view.itemsize) ||
+      !PL_unify_bool(type, is_float)) {
+    PyBuffer_Release(&e->view);
+    free(e);
+    return false;
+  }
+  e->next = exports;
+  exports = e;
+  return true;
+}
+
+static foreign_t python_release_buffer(term_t ptr) {
+  void *buf;
+  python_export_t **ep = &exports, *e;
+
+  if (!PL_get_pointer(ptr, &buf))
+    return false;
+  while ((e = *ep)) {
+    if (e->view.buf == buf) {
+      *ep = e->next;
+      PyBuffer_Release(&e->view);
+      free(e);
+      return true;
+    }
+    ep = &e->next;
+  }
+  return false;
+}
+
 static foreign_t prolog_list_to_python_list(term_t plist, term_t pyt, term_t tlen) {
   size_t sz, i;
    
@@ -147,5 +277,7 @@ install_t install_pl2pl(void) {
   PL_register_foreign("array_to_python_list", 4, array_to_python_list, 0);
   PL_register_foreign("array_to_python_tuple", 4, array_to_python_tuple, 0);
   PL_register_foreign("array_to_python_view", 5, array_to_python_view, 0);
+  PL_register_foreign("python_export_buffer", 4, python_export_buffer, 0);
+  PL_register_foreign("python_release_buffer", 1, python_release_buffer, 0);
   PL_register_foreign("prolog_list_to_python_list", 3, prolog_list_to_python_list, 0);
 }
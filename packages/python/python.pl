@@ -28,6 +28,10 @@
 	   array_to_python_list/4,
 	   array_to_python_tuple/4,
 	   array_to_python_view/5,
+	   static_array_to_python/2,
+	   matrix_to_python/2,
+	   python_to_static_array/2,
+	   python_release_static_array/1,
 	   python/2,
 	   python_string_to/1,
 	   acquire_GIL/0,
@@ -183,6 +187,65 @@ add_cwd_to_python :-
 	python:python_command("sys.argv = [\"yap\"]").
 	% done
 
+/** @pred static_array_to_python(+ _Name_, - _View_)
+
+Unify  _View_ with a Python `memoryview` over the static array
+ _Name_, of integers or floats. The view shares the storage of
+the array, so no data is copied, and `numpy.asarray()` over it
+gives a NumPy array that also shares it. The view must not be
+used after the array is resized or closed.
+*/
+static_array_to_python(Name, Py) :-
+	static_array_properties(Name, Size, Type),
+	array_type_is_float(Type, IsFloat),
+	static_array_location(Name, Ptr),
+	array_to_python_view(Ptr, IsFloat, Size, 0, Py).
+
+/** @pred matrix_to_python(+ _Matrix_, - _View_)
+
+Unify  _View_ with a Python `memoryview` over the integer or float
+matrix  _Matrix_, with the same dimensions. The view shares the
+storage of the matrix, which lives in the global stack, so it must
+only be used until the next garbage collection or backtracking;
+copy it, or use a static array, to keep it longer.
+*/
+matrix_to_python(M, Py) :-
+	matrix:matrix_type(M, Type),
+	array_type_is_float(Type, IsFloat),
+	matrix:matrix_dims(M, Dims),
+	matrix:matrix_size(M, Size),
+	matrix:matrix_data_address(M, Ptr),
+	array_to_python_view(Ptr, IsFloat, Size, Dims, Py).
+
+/** @pred python_to_static_array(+ _Object_, + _Name_)
+
+Create a static array  _Name_ whose storage is the storage of the
+Python object  _Object_, usually a NumPy array, through the buffer
+protocol. Nothing is copied, and updates on either side are seen by
+the other. The object must be writable, C-contiguous, and hold
+`float64` or integers of the size of a YAP integer. It is held until
+python_release_static_array/1 is called on  _Name_.
+*/
+python_to_static_array(Obj, Name) :-
+	python_export_buffer(Obj, Ptr, Size, IsFloat),
+	array_type_is_float(Type, IsFloat),
+	static_array(Name, Size, [type(Type), address(Ptr)]).
+
+/** @pred python_release_static_array(+ _Name_)
+
+Close the static array  _Name_ created by python_to_static_array/2,
+and let Python release the object that holds its storage.
+*/
+python_release_static_array(Name) :-
+	static_array_location(Name, Ptr),
+	close_static_array(Name),
+	python_release_buffer(Ptr).
+
+array_type_is_float(float, true).
+array_type_is_float(floats, true).
+array_type_is_float(int, false).
+array_type_is_float(ints, false).
+
 :- initialization( load_foreign_files(['YAPPython'], [], init_python_dll), now ).
 
 %% @}